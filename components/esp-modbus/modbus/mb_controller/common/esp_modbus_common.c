@@ -88,4 +88,46 @@ esp_err_t mbc_get_handler_count(void *ctx, uint16_t *count)
         ret = mbs_get_handler_count(mb_controller->mb_base, count);
     }
     return  MB_ERR_TO_ESP_ERR(ret);
+}
+
+/**
+ * Get the transaction statistics of the controller port
+ */
+esp_err_t mbc_get_stats(void *ctx, mb_stats_group_t group, mb_stats_info_t *info, uint16_t max_count, uint16_t *count)
+{
+    MB_RETURN_ON_FALSE((ctx && count), ESP_ERR_INVALID_STATE, TAG,
+                            "Controller interface is not correctly initialized.");
+    mb_controller_common_t *mb_controller = (mb_controller_common_t *)(ctx);
+    mb_base_t *mb_obj = (mb_base_t *)mb_controller->mb_base;
+    MB_RETURN_ON_FALSE((mb_obj && mb_obj->port_obj), ESP_ERR_INVALID_STATE, TAG,
+                            "Controller interface is not correctly initialized.");
+#if MB_STATS_ENABLED
+    MB_RETURN_ON_FALSE(mb_obj->port_obj->stats_obj, ESP_ERR_NOT_SUPPORTED, TAG,
+                            "Statistics are not supported by the port.");
+    *count = mb_stats_get(mb_obj->port_obj->stats_obj, group, info, max_count);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * Clear the transaction statistics of the controller port
+ */
+esp_err_t mbc_reset_stats(void *ctx)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                            "Controller interface is not correctly initialized.");
+    mb_controller_common_t *mb_controller = (mb_controller_common_t *)(ctx);
+    mb_base_t *mb_obj = (mb_base_t *)mb_controller->mb_base;
+    MB_RETURN_ON_FALSE((mb_obj && mb_obj->port_obj), ESP_ERR_INVALID_STATE, TAG,
+                            "Controller interface is not correctly initialized.");
+#if MB_STATS_ENABLED
+    MB_RETURN_ON_FALSE(mb_obj->port_obj->stats_obj, ESP_ERR_NOT_SUPPORTED, TAG,
+                            "Statistics are not supported by the port.");
+    mb_stats_reset(mb_obj->port_obj->stats_obj);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,624 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// esp_modbus_gateway.c
+// Gateway which forwards the requests of the Modbus TCP slave to the serial bus
+
+#include <string.h>                 // for memcmp
+#include <stdatomic.h>              // for the stop flag
+#include "esp_err.h"                // for esp_err_t
+#include "esp_timer.h"              // for esp_timer_get_time
+#include "esp_heap_caps.h"          // for heap_caps_calloc
+#include "sdkconfig.h"              // for KConfig values
+#include "esp_modbus_common.h"      // for common defines
+#include "esp_modbus_master.h"      // for mbc_master_send_request
+#include "esp_modbus_gateway.h"     // for public gateway types
+#include "mbc_master.h"             // for private master interface types
+#include "mbc_slave.h"              // for private slave interface types
+#include "mb_proto.h"               // for function codes
+#include "port_common.h"            // for critical section
+
+static const char TAG[] __attribute__((unused)) = "MB_CONTROLLER_GATEWAY";
+
+#define MB_GATEWAY_JOBS_MAX             (CONFIG_FMB_CONTROLLER_GATEWAY_QUEUE_SIZE)
+#define MB_GATEWAY_TASK_NAME            "mbc_gateway"
+
+#define MB_GATEWAY_GET_U16(buf, offset) ((uint16_t)(((buf)[(offset)] << 8) | (buf)[(offset) + 1]))
+#define MB_GATEWAY_IS_READ(func) (((func) == MB_FUNC_READ_COILS) || ((func) == MB_FUNC_READ_DISCRETE_INPUTS) \
+                                    || ((func) == MB_FUNC_READ_HOLDING_REGISTER) || ((func) == MB_FUNC_READ_INPUT_REGISTER))
+
+// The functions forwarded to the bus
+static const uint8_t mb_gateway_functions[] = {
+    MB_FUNC_READ_COILS, MB_FUNC_READ_DISCRETE_INPUTS, MB_FUNC_READ_HOLDING_REGISTER, MB_FUNC_READ_INPUT_REGISTER,
+    MB_FUNC_WRITE_SINGLE_COIL, MB_FUNC_WRITE_REGISTER, MB_FUNC_WRITE_MULTIPLE_COILS, MB_FUNC_WRITE_MULTIPLE_REGISTERS
+};
+
+#define MB_GATEWAY_FUNC_COUNT (sizeof(mb_gateway_functions) / sizeof(mb_gateway_functions[0]))
+
+typedef enum {
+    MB_GATEWAY_JOB_FREE = 0,
+    MB_GATEWAY_JOB_PENDING,             // waits for the bus
+    MB_GATEWAY_JOB_ACTIVE,              // the transaction is on the bus
+    MB_GATEWAY_JOB_DONE                 // the response is received
+} mb_gateway_job_state_t;
+
+/**
+ * @brief Bus transaction of the gateway shared by the identical read requests
+ */
+typedef struct {
+    mb_gateway_job_state_t state;
+    uint8_t slave_addr;
+    bool is_read;
+    bool is_stale;                      // a write was done after the read, the data can not answer new requests
+    uint16_t refs;                      // number of the requests which wait for the response
+    uint32_t seq;                       // the transactions are put on the bus in the order of creation
+    uint64_t create_tick;
+    uint64_t start_tick;
+    uint16_t request_len;
+    uint16_t response_len;
+    uint8_t request[MB_GATEWAY_PDU_SIZE_MAX];
+    uint8_t response[MB_GATEWAY_PDU_SIZE_MAX];
+} mb_gateway_job_t;
+
+typedef struct {
+    mb_gateway_config_t config;
+    mb_gateway_route_t *routes;
+    _lock_t lock;                       // protects the jobs and the statistics
+    SemaphoreHandle_t work_sema;        // wakes the gateway task up on the new job
+    SemaphoreHandle_t done_sema;        // wakes the slave task up on the completed job
+    SemaphoreHandle_t exit_sema;        // the gateway task is finished
+    TaskHandle_t task_handle;
+    _Atomic(bool) stop;
+    uint32_t seq;
+    uint64_t scan_tick;                 // the queued requests up to this time are already seen
+    uint64_t done_tick;                 // the time of the last completed transaction
+    mb_gateway_job_t *waiting;          // the job the slave task waits for
+    mb_fn_handler_fp prev_handlers[MB_GATEWAY_FUNC_COUNT];
+    mb_gateway_stats_t stats;
+    mb_gateway_job_t jobs[MB_GATEWAY_JOBS_MAX];
+} mb_gateway_t;
+
+static bool mbc_gateway_get_route(mb_gateway_t *gw, uint8_t uid, uint8_t *slave_addr)
+{
+    for (int i = 0; i < gw->config.route_count; i++) {
+        if (gw->routes[i].unit_id == uid) {
+            *slave_addr = gw->routes[i].slave_addr;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Checks the request fields which are not checked by the bus transfer
+static mb_exception_t mbc_gateway_check_request(const uint8_t *pdu, uint16_t len)
+{
+    if (len < 5) {
+        return MB_EX_ILLEGAL_DATA_VALUE;
+    }
+    uint16_t count = MB_GATEWAY_GET_U16(pdu, 3);
+    bool is_valid = false;
+    switch (pdu[0]) {
+        case MB_FUNC_READ_COILS:
+        case MB_FUNC_READ_DISCRETE_INPUTS:
+            is_valid = (len == 5) && (count >= 1) && (count <= 2000);
+            break;
+        case MB_FUNC_READ_HOLDING_REGISTER:
+        case MB_FUNC_READ_INPUT_REGISTER:
+            is_valid = (len == 5) && (count >= 1) && (count <= 125);
+            break;
+        case MB_FUNC_WRITE_SINGLE_COIL:
+            is_valid = (len == 5) && ((count == 0xFF00) || (count == 0x0000));
+            break;
+        case MB_FUNC_WRITE_REGISTER:
+            is_valid = (len == 5);
+            break;
+        case MB_FUNC_WRITE_MULTIPLE_COILS:
+            is_valid = (len > 6) && (count >= 1) && (count <= 1968)
+                        && (pdu[5] == ((count + 7) >> 3)) && (len == (6 + pdu[5]));
+            break;
+        case MB_FUNC_WRITE_MULTIPLE_REGISTERS:
+            is_valid = (len > 6) && (count >= 1) && (count <= 123)
+                        && (pdu[5] == (count << 1)) && (len == (6 + pdu[5]));
+            break;
+        default:
+            return MB_EX_ILLEGAL_FUNCTION;
+    }
+    return is_valid ? MB_EX_NONE : MB_EX_ILLEGAL_DATA_VALUE;
+}
+
+// The read can answer the request if its data is taken from the slave after the request is received
+static bool mbc_gateway_job_is_eligible(const mb_gateway_job_t *job, uint8_t slave_addr,
+                                        const uint8_t *pdu, uint16_t len, uint64_t tick)
+{
+    if ((job->state == MB_GATEWAY_JOB_FREE) || !job->is_read || (job->slave_addr != slave_addr)
+            || (job->request_len != len) || memcmp(job->request, pdu, len)) {
+        return false;
+    }
+    switch (job->state) {
+        case MB_GATEWAY_JOB_PENDING:
+            return true;
+        case MB_GATEWAY_JOB_ACTIVE:
+            return (job->start_tick >= tick);
+        case MB_GATEWAY_JOB_DONE:
+            return !job->is_stale && (job->start_tick >= tick);
+        default:
+            return false;
+    }
+}
+
+// Finds the read to share, the reads started for the queued requests go first
+static mb_gateway_job_t *mbc_gateway_find_job(mb_gateway_t *gw, uint8_t slave_addr,
+                                                const uint8_t *pdu, uint16_t len, uint64_t tick)
+{
+    mb_gateway_job_t *found = NULL;
+    for (int i = 0; i < MB_GATEWAY_JOBS_MAX; i++) {
+        mb_gateway_job_t *job = &gw->jobs[i];
+        if (mbc_gateway_job_is_eligible(job, slave_addr, pdu, len, tick)) {
+            if (job->refs) {
+                return job;
+            }
+            found = found ? found : job;
+        }
+    }
+    return found;
+}
+
+// Takes the free job or the oldest completed one, the completed job may be kept
+// for the queued request which was answered by other job or was dropped
+static mb_gateway_job_t *mbc_gateway_alloc_job(mb_gateway_t *gw)
+{
+    mb_gateway_job_t *oldest = NULL;
+    for (int i = 0; i < MB_GATEWAY_JOBS_MAX; i++) {
+        mb_gateway_job_t *job = &gw->jobs[i];
+        if (job->state == MB_GATEWAY_JOB_FREE) {
+            return job;
+        }
+        if ((job->state == MB_GATEWAY_JOB_DONE) && (job != gw->waiting)
+                && (!oldest || ((int32_t)(job->seq - oldest->seq) < 0))) {
+            oldest = job;
+        }
+    }
+    return oldest;
+}
+
+static mb_gateway_job_t *mbc_gateway_add_job(mb_gateway_t *gw, uint8_t slave_addr, const uint8_t *pdu, uint16_t len)
+{
+    mb_gateway_job_t *job = mbc_gateway_alloc_job(gw);
+    if (job) {
+        job->state = MB_GATEWAY_JOB_PENDING;
+        job->slave_addr = slave_addr;
+        job->is_read = MB_GATEWAY_IS_READ(pdu[0]);
+        job->is_stale = false;
+        job->refs = 1;
+        job->seq = ++gw->seq;
+        job->create_tick = esp_timer_get_time();
+        job->start_tick = 0;
+        job->request_len = len;
+        job->response_len = 0;
+        memcpy(job->request, pdu, len);
+    }
+    return job;
+}
+
+// Starts the reads waiting in the queue of the slave on the bus, the identical reads share one job.
+// The visitor is called under the lock of gateway.
+static bool mbc_gateway_prefetch(void *arg, uint8_t uid, uint64_t tick, const uint8_t *pdu, uint16_t len)
+{
+    mb_gateway_t *gw = (mb_gateway_t *)arg;
+    uint8_t slave_addr = 0;
+    if (tick <= gw->scan_tick) {
+        return true;
+    }
+    // The reads are not started ahead of the queued writes
+    if (!len || !MB_GATEWAY_IS_READ(pdu[0])) {
+        return false;
+    }
+    if (mbc_gateway_get_route(gw, uid, &slave_addr) && (mbc_gateway_check_request(pdu, len) == MB_EX_NONE)) {
+        mb_gateway_job_t *job = mbc_gateway_find_job(gw, slave_addr, pdu, len, tick);
+        if (job) {
+            job->refs++;
+            gw->stats.merged_count++;
+        } else {
+            job = mbc_gateway_add_job(gw, slave_addr, pdu, len);
+            if (!job) {
+                return false;
+            }
+            gw->stats.prefetch_count++;
+        }
+    }
+    gw->scan_tick = tick;
+    return true;
+}
+
+// Releases the reference of the request to the job, the job is freed when it is not needed
+static void mbc_gateway_release_job(mb_gateway_job_t *job)
+{
+    job->refs = job->refs ? (job->refs - 1) : 0;
+    if (!job->refs && (job->state == MB_GATEWAY_JOB_DONE)) {
+        job->state = MB_GATEWAY_JOB_FREE;
+    }
+}
+
+// The function handler of the slave which forwards the request to the bus
+static mb_exception_t mbc_gateway_forward(void *inst, uint8_t *frame, uint16_t *len)
+{
+    mb_base_t *pbase = (mb_base_t *)inst;
+    mbs_controller_iface_t *mbs_iface = pbase ? (mbs_controller_iface_t *)pbase->descr.parent : NULL;
+    mb_gateway_t *gw = mbs_iface ? (mb_gateway_t *)mbs_iface->opts.gateway : NULL;
+    mb_gateway_job_t *job = NULL;
+    mb_exception_t exception = MB_EX_NONE;
+    uint8_t uid = 0;
+    uint8_t slave_addr = 0;
+    uint64_t tick = 0;
+
+    if (!gw || !frame || !len || !(*len) || (*len > MB_GATEWAY_PDU_SIZE_MAX)) {
+        return MB_EX_GATEWAY_PATH_FAILED;
+    }
+    if (!mbs_iface->get_request_info || !mbs_iface->get_request_info(mbs_iface, &uid, &tick)) {
+        // Serial slave, the requests of the single unit
+        uid = MB_TCP_PSEUDO_ADDRESS;
+        tick = esp_timer_get_time();
+    }
+    uint16_t request_len = *len;
+    uint32_t tout_ms = gw->config.response_tout_ms;
+    TickType_t start_time = xTaskGetTickCount();
+
+    CRITICAL_SECTION_LOCK(gw->lock);
+    gw->stats.request_count++;
+    if (!mbc_gateway_get_route(gw, uid, &slave_addr)) {
+        exception = MB_EX_GATEWAY_PATH_FAILED;
+    } else {
+        exception = mbc_gateway_check_request(frame, request_len);
+    }
+    if (exception == MB_EX_NONE) {
+        job = MB_GATEWAY_IS_READ(frame[0]) ? mbc_gateway_find_job(gw, slave_addr, frame, request_len, tick) : NULL;
+        if (job && job->refs) {
+            // Take the job started for the queued request
+        } else if (job) {
+            job->refs++;
+            gw->stats.merged_count++;
+        } else {
+            // All jobs are waiting for the bus, wait for the first completed one
+            while (!(job = mbc_gateway_add_job(gw, slave_addr, frame, request_len))) {
+                CRITICAL_SECTION_UNLOCK(gw->lock);
+                (void)xSemaphoreGive(gw->work_sema);
+                bool is_done = xSemaphoreTake(gw->done_sema, pdMS_TO_TICKS(tout_ms));
+                CRITICAL_SECTION_LOCK(gw->lock);
+                if (!is_done || ((xTaskGetTickCount() - start_time) >= pdMS_TO_TICKS(tout_ms))) {
+                    break;
+                }
+            }
+        }
+        if (job) {
+            gw->waiting = job;
+            if (mbs_iface->foreach_request) {
+                (void)mbs_iface->foreach_request(mbs_iface, mbc_gateway_prefetch, gw);
+            }
+        } else {
+            exception = MB_EX_GATEWAY_TGT_FAILED;
+        }
+    }
+    CRITICAL_SECTION_UNLOCK(gw->lock);
+
+    if (job) {
+        (void)xSemaphoreGive(gw->work_sema);
+        for (;;) {
+            bool is_done = false;
+            CRITICAL_SECTION(gw->lock) {
+                if (job->state == MB_GATEWAY_JOB_DONE) {
+                    if (job->response[0] & MB_FUNC_ERROR) {
+                        exception = (job->response_len > 1) ? (mb_exception_t)job->response[1] : MB_EX_SLAVE_DEVICE_FAILURE;
+                    } else {
+                        memcpy(frame, job->response, job->response_len);
+                        *len = job->response_len;
+                    }
+                    is_done = true;
+                }
+                if (is_done || ((xTaskGetTickCount() - start_time) >= pdMS_TO_TICKS(tout_ms))) {
+                    exception = is_done ? exception : MB_EX_GATEWAY_TGT_FAILED;
+                    mbc_gateway_release_job(job);
+                    gw->waiting = NULL;
+                    is_done = true;
+                }
+            }
+            if (is_done) {
+                break;
+            }
+            (void)xSemaphoreTake(gw->done_sema, pdMS_TO_TICKS(tout_ms));
+        }
+    }
+    if ((exception == MB_EX_GATEWAY_PATH_FAILED) || (exception == MB_EX_GATEWAY_TGT_FAILED)) {
+        CRITICAL_SECTION(gw->lock) {
+            gw->stats.error_count++;
+        }
+        ESP_LOGD(TAG, "%p, unit %u, function 0x%x, gateway exception 0x%x.", gw, (unsigned)uid,
+                    (unsigned)frame[0], (unsigned)exception);
+    }
+    return exception;
+}
+
+static mb_gateway_job_t *mbc_gateway_next_job(mb_gateway_t *gw)
+{
+    mb_gateway_job_t *next = NULL;
+    for (int i = 0; i < MB_GATEWAY_JOBS_MAX; i++) {
+        mb_gateway_job_t *job = &gw->jobs[i];
+        if ((job->state == MB_GATEWAY_JOB_PENDING) && (!next || ((int32_t)(job->seq - next->seq) < 0))) {
+            next = job;
+        }
+    }
+    return next;
+}
+
+// The task owns the bus and puts the jobs on it one after another
+static void mbc_gateway_task(void *param)
+{
+    mb_gateway_t *gw = (mb_gateway_t *)param;
+
+    while (!atomic_load(&gw->stop)) {
+        mb_gateway_job_t *job = NULL;
+        uint64_t start = 0;
+        CRITICAL_SECTION(gw->lock) {
+            job = mbc_gateway_next_job(gw);
+            if (job) {
+                start = esp_timer_get_time();
+                uint64_t ready = (job->create_tick > gw->done_tick) ? job->create_tick : gw->done_tick;
+                gw->stats.gap_time_us += (gw->done_tick && (start > ready)) ? (start - ready) : 0;
+                job->state = MB_GATEWAY_JOB_ACTIVE;
+                job->start_tick = start;
+            }
+        }
+        if (!job) {
+            (void)xSemaphoreTake(gw->work_sema, portMAX_DELAY);
+            continue;
+        }
+        // Only this task changes the active job
+        uint16_t response_len = 0;
+        esp_err_t err = gw->config.transfer(gw->config.transfer_arg, job->slave_addr,
+                                                job->request, job->request_len, job->response, &response_len);
+        CRITICAL_SECTION(gw->lock) {
+            uint64_t done = esp_timer_get_time();
+            if ((err != ESP_OK) || !response_len || (response_len > MB_GATEWAY_PDU_SIZE_MAX)) {
+                ESP_LOGD(TAG, "%p, slave %u, function 0x%x, transfer fail, err = 0x%x.", gw,
+                            (unsigned)job->slave_addr, (unsigned)job->request[0], (int)err);
+                job->response[0] = job->request[0] | MB_FUNC_ERROR;
+                job->response[1] = (err == ESP_ERR_TIMEOUT) ? MB_EX_GATEWAY_TGT_FAILED : MB_EX_SLAVE_DEVICE_FAILURE;
+                response_len = 2;
+            }
+            job->response_len = response_len;
+            job->state = MB_GATEWAY_JOB_DONE;
+            if (!job->is_read) {
+                // The completed reads do not answer the requests received before the write anymore
+                for (int i = 0; i < MB_GATEWAY_JOBS_MAX; i++) {
+                    gw->jobs[i].is_stale |= (gw->jobs[i].state == MB_GATEWAY_JOB_DONE);
+                }
+            }
+            if (!job->refs) {
+                job->state = MB_GATEWAY_JOB_FREE;
+            }
+            gw->done_tick = done;
+            gw->stats.transfer_count++;
+            gw->stats.busy_time_us += (done - start);
+        }
+        (void)xSemaphoreGive(gw->done_sema);
+    }
+    (void)xSemaphoreGive(gw->exit_sema);
+    vTaskDelete(NULL);
+}
+
+// Sends the request through the serial master and builds the response PDU
+static esp_err_t mbc_gateway_master_transfer(void *arg, uint8_t slave_addr, const uint8_t *request, uint16_t request_len,
+                                                uint8_t *response, uint16_t *response_len)
+{
+    uint16_t regs[MB_GATEWAY_PDU_SIZE_MAX / 2] = {0};
+    mb_param_request_t req = {
+        .slave_addr = slave_addr,
+        .command = request[0],
+        .reg_start = MB_GATEWAY_GET_U16(request, 1),
+        .reg_size = MB_GATEWAY_GET_U16(request, 3)
+    };
+    esp_err_t err = ESP_ERR_NOT_SUPPORTED;
+
+    switch (req.command) {
+        case MB_FUNC_READ_COILS:
+        case MB_FUNC_READ_DISCRETE_INPUTS:
+            err = mbc_master_send_request(arg, &req, regs);
+            if (err == ESP_OK) {
+                response[1] = (uint8_t)((req.reg_size + 7) >> 3);
+                memcpy(&response[2], regs, response[1]);
+                *response_len = 2 + response[1];
+            }
+            break;
+        case MB_FUNC_READ_HOLDING_REGISTER:
+        case MB_FUNC_READ_INPUT_REGISTER:
+            err = mbc_master_send_request(arg, &req, regs);
+            if (err == ESP_OK) {
+                response[1] = (uint8_t)(req.reg_size << 1);
+                for (int i = 0; i < req.reg_size; i++) {
+                    response[2 + (i << 1)] = (uint8_t)(regs[i] >> 8);
+                    response[3 + (i << 1)] = (uint8_t)(regs[i] & 0xFF);
+                }
+                *response_len = 2 + response[1];
+            }
+            break;
+        case MB_FUNC_WRITE_SINGLE_COIL:
+        case MB_FUNC_WRITE_REGISTER:
+            regs[0] = req.reg_size; // the value of the single write
+            req.reg_size = 1;
+            err = mbc_master_send_request(arg, &req, regs);
+            break;
+        case MB_FUNC_WRITE_MULTIPLE_COILS:
+            memcpy(regs, &request[6], request[5]);
+            err = mbc_master_send_request(arg, &req, regs);
+            break;
+        case MB_FUNC_WRITE_MULTIPLE_REGISTERS:
+            for (int i = 0; i < req.reg_size; i++) {
+                regs[i] = MB_GATEWAY_GET_U16(request, 6 + (i << 1));
+            }
+            err = mbc_master_send_request(arg, &req, regs);
+            break;
+        default:
+            break;
+    }
+    if ((err == ESP_OK) && !MB_GATEWAY_IS_READ(req.command)) {
+        // The write response repeats the address and the value or quantity of the request
+        memcpy(response, request, 5);
+        *response_len = 5;
+    }
+    response[0] = req.command;
+    return err;
+}
+
+// Restores the function handlers of the slave taken by the gateway
+static void mbc_gateway_restore_handlers(mb_gateway_t *gw, mb_base_t *mb_base)
+{
+    for (int i = 0; i < MB_GATEWAY_FUNC_COUNT; i++) {
+        if (gw->prev_handlers[i]) {
+            (void)mbs_set_handler(mb_base, mb_gateway_functions[i], gw->prev_handlers[i]);
+        } else {
+            (void)mbs_delete_handler(mb_base, mb_gateway_functions[i]);
+        }
+    }
+}
+
+static void mbc_gateway_free(mb_gateway_t *gw)
+{
+    if (gw->work_sema) {
+        vSemaphoreDelete(gw->work_sema);
+    }
+    if (gw->done_sema) {
+        vSemaphoreDelete(gw->done_sema);
+    }
+    if (gw->exit_sema) {
+        vSemaphoreDelete(gw->exit_sema);
+    }
+    CRITICAL_SECTION_CLOSE(gw->lock);
+    free(gw->routes);
+    free(gw);
+}
+
+// The request waits for the bus as long as the master waits for the response of the slave
+static uint32_t mbc_gateway_get_master_tout_ms(void *master_handle)
+{
+    uint32_t tout_ms = 0;
+    if (master_handle) {
+        mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(master_handle);
+        switch (mbm_opts->comm_opts.mode) {
+#if (CONFIG_FMB_COMM_MODE_ASCII_EN || CONFIG_FMB_COMM_MODE_RTU_EN)
+            case MB_RTU:
+            case MB_ASCII:
+                tout_ms = mbm_opts->comm_opts.ser_opts.response_tout_ms;
+                break;
+#endif
+#if (CONFIG_FMB_COMM_MODE_TCP_EN)
+            case MB_TCP:
+                tout_ms = mbm_opts->comm_opts.tcp_opts.response_tout_ms;
+                break;
+#endif
+            default:
+                break;
+        }
+    }
+    return tout_ms ? tout_ms : CONFIG_FMB_MASTER_TIMEOUT_MS_RESPOND;
+}
+
+esp_err_t mbc_gateway_create(const mb_gateway_config_t *config, void **handle)
+{
+    MB_RETURN_ON_FALSE((config && handle && config->slave_handle), ESP_ERR_INVALID_ARG, TAG,
+                        "mb gateway invalid arguments.");
+    MB_RETURN_ON_FALSE((config->routes && config->route_count), ESP_ERR_INVALID_ARG, TAG,
+                        "mb gateway routes are not defined.");
+    MB_RETURN_ON_FALSE((config->transfer || config->master_handle), ESP_ERR_INVALID_ARG, TAG,
+                        "mb gateway bus transfer is not defined.");
+    mbs_controller_iface_t *mbs_iface = MB_SLAVE_GET_IFACE(config->slave_handle);
+    MB_RETURN_ON_FALSE((mbs_iface->mb_base), ESP_ERR_INVALID_STATE, TAG,
+                        "Slave interface is not correctly initialized.");
+    MB_RETURN_ON_FALSE((!mbs_iface->opts.gateway), ESP_ERR_INVALID_STATE, TAG,
+                        "mb slave already has the gateway.");
+    esp_err_t ret = ESP_OK;
+    mb_gateway_t *gw = (mb_gateway_t *)heap_caps_calloc(1, sizeof(mb_gateway_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    MB_RETURN_ON_FALSE((gw), ESP_ERR_NO_MEM, TAG, "mb gateway memory allocation fail.");
+    CRITICAL_SECTION_INIT(gw->lock);
+    gw->config = *config;
+    if (!gw->config.response_tout_ms) {
+        gw->config.response_tout_ms = mbc_gateway_get_master_tout_ms(config->master_handle);
+    }
+    if (!gw->config.transfer) {
+        gw->config.transfer = mbc_gateway_master_transfer;
+        gw->config.transfer_arg = config->master_handle;
+    }
+    gw->routes = (mb_gateway_route_t *)calloc(config->route_count, sizeof(mb_gateway_route_t));
+    MB_GOTO_ON_FALSE((gw->routes), ESP_ERR_NO_MEM, error, TAG, "mb gateway memory allocation fail.");
+    memcpy(gw->routes, config->routes, config->route_count * sizeof(mb_gateway_route_t));
+    gw->config.routes = gw->routes;
+    gw->work_sema = xSemaphoreCreateBinary();
+    gw->done_sema = xSemaphoreCreateBinary();
+    gw->exit_sema = xSemaphoreCreateBinary();
+    MB_GOTO_ON_FALSE((gw->work_sema && gw->done_sema && gw->exit_sema), ESP_ERR_NO_MEM, error,
+                        TAG, "mb gateway semaphore creation fail.");
+    atomic_init(&gw->stop, false);
+    BaseType_t status = xTaskCreatePinnedToCore((void *)&mbc_gateway_task,
+                                                MB_GATEWAY_TASK_NAME,
+                                                MB_CONTROLLER_STACK_SIZE,
+                                                gw,
+                                                MB_CONTROLLER_PRIORITY,
+                                                &gw->task_handle,
+                                                MB_PORT_TASK_AFFINITY);
+    MB_GOTO_ON_FALSE((status == pdPASS), ESP_ERR_INVALID_STATE, error, TAG,
+                        "mb gateway task creation error, xTaskCreate() returns (0x%x).", (unsigned)status);
+
+    // The handlers find the gateway in the slave options
+    mbs_iface->opts.gateway = gw;
+    for (int i = 0; i < MB_GATEWAY_FUNC_COUNT; i++) {
+        if (mbs_get_handler(mbs_iface->mb_base, mb_gateway_functions[i], &gw->prev_handlers[i]) != MB_ENOERR) {
+            gw->prev_handlers[i] = NULL;
+        }
+        MB_GOTO_ON_FALSE((mbs_set_handler(mbs_iface->mb_base, mb_gateway_functions[i], mbc_gateway_forward) == MB_ENOERR),
+                            ESP_ERR_INVALID_STATE, restore, TAG, "mb gateway can not set the handler of function 0x%x.",
+                            (unsigned)mb_gateway_functions[i]);
+    }
+    (void)mbs_set_any_address(mbs_iface->mb_base, true);
+    *handle = gw;
+    return ESP_OK;
+
+restore:
+    mbc_gateway_restore_handlers(gw, mbs_iface->mb_base);
+    mbs_iface->opts.gateway = NULL;
+    atomic_store(&gw->stop, true);
+    (void)xSemaphoreGive(gw->work_sema);
+    (void)xSemaphoreTake(gw->exit_sema, portMAX_DELAY);
+error:
+    mbc_gateway_free(gw);
+    return ret;
+}
+
+esp_err_t mbc_gateway_delete(void *handle)
+{
+    MB_RETURN_ON_FALSE((handle), ESP_ERR_INVALID_ARG, TAG, "mb gateway invalid arguments.");
+    mb_gateway_t *gw = (mb_gateway_t *)handle;
+    mbs_controller_iface_t *mbs_iface = MB_SLAVE_GET_IFACE(gw->config.slave_handle);
+    MB_RETURN_ON_FALSE((mbs_iface->opts.gateway == gw), ESP_ERR_INVALID_ARG, TAG,
+                        "mb gateway is not attached to the slave.");
+
+    (void)mbs_set_any_address(mbs_iface->mb_base, false);
+    mbc_gateway_restore_handlers(gw, mbs_iface->mb_base);
+    mbs_iface->opts.gateway = NULL;
+    // The task completes the active transfer and exits
+    atomic_store(&gw->stop, true);
+    (void)xSemaphoreGive(gw->work_sema);
+    (void)xSemaphoreTake(gw->exit_sema, portMAX_DELAY);
+    mbc_gateway_free(gw);
+    return ESP_OK;
+}
+
+esp_err_t mbc_gateway_get_stats(void *handle, mb_gateway_stats_t *stats)
+{
+    MB_RETURN_ON_FALSE((handle && stats), ESP_ERR_INVALID_ARG, TAG, "mb gateway invalid arguments.");
+    mb_gateway_t *gw = (mb_gateway_t *)handle;
+    CRITICAL_SECTION(gw->lock) {
+        *stats = gw->stats;
+    }
+    return ESP_OK;
+}
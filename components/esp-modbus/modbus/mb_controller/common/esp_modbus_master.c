@@ -77,6 +77,43 @@ esp_err_t mbc_master_get_cid_info(void *ctx, uint16_t cid, const mb_parameter_de
     return error;
 }
 
+/**
+ * Get the cid of characteristic by its key
+ */
+esp_err_t mbc_master_get_cid_by_key(void *ctx, const char *key, uint16_t *cid)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                       "Master interface is not correctly initialized.");
+    MB_RETURN_ON_FALSE((key && cid), ESP_ERR_INVALID_ARG, TAG, "Master incorrect key or cid pointer.");
+    mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(ctx);
+    uint16_t index = mbc_master_index_get_by_key(mbm_opts, key);
+    if (index == MB_PARAM_INDEX_NONE) {
+        ESP_LOGD(TAG, "Master characteristic %s is not found.", key);
+        *cid = MB_PARAM_CID_NONE;
+        return ESP_ERR_NOT_FOUND;
+    }
+    *cid = mbm_opts->param_descriptor_table[index].cid;
+    return ESP_OK;
+}
+
+/**
+ * Get the cids of the set of characteristics by their keys
+ */
+esp_err_t mbc_master_get_cids_by_keys(void *ctx, const char **keys, uint16_t *cids, uint16_t count)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                       "Master interface is not correctly initialized.");
+    MB_RETURN_ON_FALSE((keys && cids), ESP_ERR_INVALID_ARG, TAG, "Master incorrect keys or cids pointer.");
+    esp_err_t error = ESP_OK;
+    for (uint16_t i = 0; i < count; i++) {
+        if (!keys[i] || (mbc_master_get_cid_by_key(ctx, keys[i], &cids[i]) != ESP_OK)) {
+            cids[i] = MB_PARAM_CID_NONE;
+            error = ESP_ERR_NOT_FOUND;
+        }
+    }
+    return error;
+}
+
 /**
  * Set parameter value for characteristic selected by name and cid
  */
@@ -134,6 +171,124 @@ esp_err_t mbc_master_get_parameter(void *ctx, uint16_t cid, uint8_t *value, uint
     return error;
 }
 
+// Reads the block of the plan and sets the parameters of the list which are placed in the block
+static esp_err_t mbc_master_read_block(void *ctx, uint16_t block, mb_param_poll_t *params, uint16_t count, bool *is_done)
+{
+    mbm_controller_iface_t *mbm_controller = MB_MASTER_GET_IFACE(ctx);
+    mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(ctx);
+    mb_param_request_t request = mbm_opts->read_plan.blocks[block];
+    esp_err_t error = ESP_ERR_NO_MEM;
+
+    uint8_t *data_ptr = calloc(1, (request.reg_size << 1));
+    if (data_ptr) {
+        error = mbm_controller->send_request(ctx, &request, data_ptr);
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        if (is_done[i] || (mbc_master_plan_get_block(mbm_opts, params[i].cid) != block)) {
+            continue;
+        }
+        params[i].type = mbm_opts->param_descriptor_table[mbc_master_index_get(mbm_opts, params[i].cid)].param_type;
+        params[i].error = error;
+        if (error == ESP_OK) {
+            params[i].error = mbc_master_plan_set_param(mbm_opts, params[i].cid, data_ptr, params[i].value);
+        }
+        is_done[i] = true;
+    }
+    free(data_ptr);
+    return error;
+}
+
+// Reads the parameters one by one, the parameters placed in one block of the plan are read with one request
+static esp_err_t mbc_master_read_parameters(void *ctx, mb_param_poll_t *params, uint16_t count)
+{
+    mbm_controller_iface_t *mbm_controller = MB_MASTER_GET_IFACE(ctx);
+    mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(ctx);
+    esp_err_t error = ESP_OK;
+
+    bool *is_done = calloc(count, sizeof(bool));
+    MB_RETURN_ON_FALSE((is_done), ESP_ERR_NO_MEM, TAG, "Master poll list allocation fail.");
+    for (uint16_t i = 0; i < count; i++) {
+        if (is_done[i]) {
+            continue;
+        }
+        uint16_t block = mbc_master_plan_get_block(mbm_opts, params[i].cid);
+        if ((block != MB_READ_PLAN_NO_BLOCK) && mbm_controller->send_request) {
+            if (mbc_master_cache_get(mbm_opts, params[i].cid, params[i].value) == ESP_OK) {
+                params[i].type = mbm_opts->param_descriptor_table[mbc_master_index_get(mbm_opts, params[i].cid)].param_type;
+                params[i].error = ESP_OK;
+                is_done[i] = true;
+                continue;
+            }
+            (void)mbc_master_read_block(ctx, block, &params[i], (count - i), &is_done[i]);
+        } else {
+            // The get parameter method takes the value from the cache itself
+            params[i].error = mbm_controller->get_parameter(ctx, params[i].cid, params[i].value, &params[i].type);
+            is_done[i] = true;
+        }
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        if ((error == ESP_OK) && (params[i].error != ESP_OK)) {
+            error = params[i].error;
+        }
+    }
+    free(is_done);
+    return error;
+}
+
+/**
+ * Get parameter data for the set of characteristics
+ */
+esp_err_t mbc_master_get_parameters(void *ctx, mb_param_poll_t *params, uint16_t count)
+{
+    esp_err_t error = ESP_OK;
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                       "Master interface is not correctly initialized.");
+    MB_RETURN_ON_FALSE((params && count), ESP_ERR_INVALID_ARG, TAG,
+                       "Master incorrect parameters list.");
+    mbm_controller_iface_t *mbm_controller = MB_MASTER_GET_IFACE(ctx);
+    MB_RETURN_ON_FALSE(((mbm_controller->get_parameters || mbm_controller->get_parameter) && mbm_controller->is_active),
+                       ESP_ERR_INVALID_STATE, TAG,
+                       "Master interface is not correctly configured.");
+    if (mbm_controller->get_parameters) {
+        error = mbm_controller->get_parameters(ctx, params, count);
+    } else {
+        error = mbc_master_read_parameters(ctx, params, count);
+    }
+    MB_RETURN_ON_FALSE((error == ESP_OK), error, TAG,
+                       "Master get parameters failure, error=(0x%x) (%s).",
+                       (uint16_t)error, esp_err_to_name(error));
+    return error;
+}
+
+/**
+ * Invalidate the cached value of characteristic
+ */
+esp_err_t mbc_master_invalidate_cache(void *ctx, uint16_t cid)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                       "Master interface is not correctly initialized.");
+    mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(ctx);
+    MB_RETURN_ON_FALSE(((cid == MB_CACHE_CID_ALL) || (mbc_master_index_get(mbm_opts, cid) != MB_PARAM_INDEX_NONE)),
+                       ESP_ERR_NOT_FOUND, TAG, "Master incorrect cid of characteristic.");
+    mbc_master_cache_invalidate(mbm_opts, cid);
+    return ESP_OK;
+}
+
+/**
+ * Get the counters of parameter value cache
+ */
+esp_err_t mbc_master_get_cache_stats(void *ctx, mb_cache_stats_t *stats)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                       "Master interface is not correctly initialized.");
+    MB_RETURN_ON_FALSE(stats, ESP_ERR_INVALID_ARG, TAG, "Master incorrect stats pointer.");
+    mb_master_value_cache_t *cache = &MB_MASTER_GET_OPTS(ctx)->value_cache;
+    CRITICAL_SECTION(cache->lock) {
+        *stats = cache->stats;
+    }
+    return ESP_OK;
+}
+
 /**
  * Get parameter data for corresponding characteristic
  */
@@ -178,18 +333,48 @@ esp_err_t mbc_master_send_request(void *ctx, mb_param_request_t *request, void *
 esp_err_t mbc_master_set_descriptor(void *ctx, const mb_parameter_descriptor_t *descriptor,
                                     const uint16_t num_elements)
 {
-    esp_err_t error = ESP_OK;
+    esp_err_t ret = ESP_OK;
     MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
                        "Master interface is not correctly initialized.");
     mbm_controller_iface_t *mbm_controller = MB_MASTER_GET_IFACE(ctx);
     MB_RETURN_ON_FALSE(mbm_controller->set_descriptor,
                        ESP_ERR_INVALID_STATE, TAG,
                        "Master interface is not correctly configured.");
-    error = mbm_controller->set_descriptor(ctx, descriptor, num_elements);
-    MB_RETURN_ON_FALSE((error == ESP_OK), error, TAG,
-                       "Master set descriptor failure, error=(0x%x) (%s).",
-                       (uint16_t)error, esp_err_to_name(error));
+    mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(ctx);
+    mb_master_param_index_t index = {0};
+    mb_master_read_plan_t plan = {0};
+    mb_master_cache_entry_t *cache_entries = NULL;
+    // Build everything for the new table first, so the current table is kept if the new one is rejected
+    ret = mbc_master_index_create(descriptor, num_elements, &index);
+    MB_GOTO_ON_FALSE((ret == ESP_OK), ret, error,
+                       TAG, "Master parameter index failure, error=(0x%x) (%s).",
+                       (uint16_t)ret, esp_err_to_name(ret));
+    ret = mbc_master_plan_create(descriptor, num_elements, &plan);
+    MB_GOTO_ON_FALSE((ret == ESP_OK), ret, error,
+                       TAG, "Master read plan failure, error=(0x%x) (%s).",
+                       (uint16_t)ret, esp_err_to_name(ret));
+    ret = mbc_master_cache_create(descriptor, num_elements, &cache_entries);
+    MB_GOTO_ON_FALSE((ret == ESP_OK), ret, error,
+                       TAG, "Master value cache failure, error=(0x%x) (%s).",
+                       (uint16_t)ret, esp_err_to_name(ret));
+    ret = mbm_controller->set_descriptor(ctx, descriptor, num_elements);
+    MB_GOTO_ON_FALSE((ret == ESP_OK), ret, error,
+                       TAG, "Master set descriptor failure, error=(0x%x) (%s).",
+                       (uint16_t)ret, esp_err_to_name(ret));
+    mbc_master_index_delete(mbm_opts);
+    mbm_opts->param_index = index;
+    mbc_master_plan_delete(mbm_opts);
+    mbm_opts->read_plan = plan;
+    mbc_master_cache_replace(mbm_opts, cache_entries);
     return ESP_OK;
+
+error:
+    // The cid slots of index and the data of cache entries are placed in the same allocation
+    free(index.key_slots);
+    free(plan.blocks);
+    free(plan.cid_block);
+    free(cache_entries);
+    return ret;
 }
 
 /**
@@ -0,0 +1,478 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// esp_modbus_master_pool.c
+// Pool which routes the requests to the masters of several buses and serves the buses at the same time
+
+#include <string.h>                     // for memset
+#include "esp_err.h"                    // for esp_err_t
+#include "esp_heap_caps.h"              // for heap_caps_calloc
+#include "sdkconfig.h"                  // for KConfig values
+#include "esp_modbus_common.h"          // for common defines
+#include "esp_modbus_master.h"          // for public master interface
+#include "esp_modbus_master_pool.h"     // for public pool types
+#include "mbc_master.h"                 // for private master interface types
+#include "mb_proto.h"                   // for the address limits
+#include "port_common.h"                // for the statistics of the port
+
+static const char TAG[] __attribute__((unused)) = "MB_CONTROLLER_POOL";
+
+#define MB_POOL_QUEUE_SIZE              (CONFIG_FMB_CONTROLLER_POOL_QUEUE_SIZE)
+#define MB_POOL_TASK_NAME               "mbc_pool_bus"
+#define MB_POOL_NO_BUS                  (0xFFFF)
+
+typedef enum {
+    MB_POOL_JOB_REQUEST,                // the raw request to the slave
+    MB_POOL_JOB_GET,                    // the read of the characteristic
+    MB_POOL_JOB_SET,                    // the write of the characteristic
+    MB_POOL_JOB_GET_MANY,               // the read of the part of the characteristics set
+    MB_POOL_JOB_STOP                    // the task of the bus exits
+} mb_pool_job_type_t;
+
+/**
+ * @brief Request of the pool, the job is copied to the queue of the bus,
+ * the buffers belong to the caller until the callback is called
+ */
+typedef struct {
+    mb_pool_job_type_t type;
+    mb_param_request_t request;
+    uint16_t cid;
+    uint16_t count;
+    void *data;                         // the request data, the value or the array of the characteristics
+    uint8_t *param_type;
+    mb_master_pool_done_fp done_cb;
+    void *done_arg;
+} mb_pool_job_t;
+
+typedef struct {
+    void *master_handle;
+    QueueHandle_t queue;
+    SemaphoreHandle_t exit_sema;        // the task of the bus is finished
+    TaskHandle_t task_handle;
+} mb_pool_bus_obj_t;
+
+typedef struct {
+    uint16_t bus_count;
+    mb_pool_bus_obj_t *buses;
+    mb_parameter_descriptor_t *descriptors; // the table of the pool ordered by bus, the masters refer to its parts
+    const mb_parameter_descriptor_t **prev_tables; // the tables of the masters before the pool, set back on delete
+    uint16_t *prev_sizes;
+#if MB_STATS_ENABLED
+    mb_stats_t **stats_objs;            // the statistics of the ports of the masters
+#endif
+    uint16_t routes[MB_ADDRESS_MAX + 1];
+} mb_master_pool_t;
+
+// The caller of the blocking function waits for the callback of its job
+typedef struct {
+    SemaphoreHandle_t done_sema;
+    StaticSemaphore_t done_buf;
+    esp_err_t error;
+} mb_pool_waiter_t;
+
+static void mbc_master_pool_done(void *arg, esp_err_t error)
+{
+    mb_pool_waiter_t *waiter = (mb_pool_waiter_t *)arg;
+    waiter->error = error;
+    (void)xSemaphoreGive(waiter->done_sema);
+}
+
+// The results of the set are kept in the characteristics, the caller counts the completed buses
+static void mbc_master_pool_done_many(void *arg, esp_err_t error)
+{
+    (void)error;
+    (void)xSemaphoreGive((SemaphoreHandle_t)arg);
+}
+
+static esp_err_t mbc_master_pool_run(mb_pool_bus_obj_t *bus, mb_pool_job_t *job)
+{
+    uint8_t type = 0;
+    esp_err_t err = ESP_ERR_NOT_SUPPORTED;
+    switch (job->type) {
+        case MB_POOL_JOB_REQUEST:
+            err = mbc_master_send_request(bus->master_handle, &job->request, job->data);
+            break;
+        case MB_POOL_JOB_GET:
+            err = mbc_master_get_parameter(bus->master_handle, job->cid, (uint8_t *)job->data, &type);
+            break;
+        case MB_POOL_JOB_SET:
+            err = mbc_master_set_parameter(bus->master_handle, job->cid, (uint8_t *)job->data, &type);
+            break;
+        case MB_POOL_JOB_GET_MANY:
+            err = mbc_master_get_parameters(bus->master_handle, (mb_param_poll_t *)job->data, job->count);
+            break;
+        default:
+            break;
+    }
+    if (job->param_type) {
+        *job->param_type = type;
+    }
+    return err;
+}
+
+// The task owns the master of the bus and puts the jobs of its queue on the bus one after another
+static void mbc_master_pool_task(void *param)
+{
+    mb_pool_bus_obj_t *bus = (mb_pool_bus_obj_t *)param;
+    mb_pool_job_t job;
+
+    while (xQueueReceive(bus->queue, &job, portMAX_DELAY) == pdTRUE) {
+        if (job.type == MB_POOL_JOB_STOP) {
+            break;
+        }
+        esp_err_t err = mbc_master_pool_run(bus, &job);
+        ESP_LOGD(TAG, "%p, job type %d, err = 0x%x.", bus->master_handle, (int)job.type, (int)err);
+        if (job.done_cb) {
+            job.done_cb(job.done_arg, err);
+        }
+    }
+    (void)xSemaphoreGive(bus->exit_sema);
+    vTaskDelete(NULL);
+}
+
+// Finds the bus which has the characteristic in the table of its master
+static uint16_t mbc_master_pool_find_cid(mb_master_pool_t *pool, uint16_t cid)
+{
+    for (uint16_t i = 0; i < pool->bus_count; i++) {
+        mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(pool->buses[i].master_handle);
+        if (mbm_opts->param_descriptor_table && (mbc_master_index_get(mbm_opts, cid) != MB_PARAM_INDEX_NONE)) {
+            return i;
+        }
+    }
+    return MB_POOL_NO_BUS;
+}
+
+static esp_err_t mbc_master_pool_put(mb_master_pool_t *pool, uint16_t bus_index, mb_pool_job_t *job, TickType_t wait_ticks)
+{
+    MB_RETURN_ON_FALSE((bus_index < pool->bus_count), ESP_ERR_NOT_FOUND, TAG,
+                        "mb pool, the request is not routed to the bus.");
+    MB_RETURN_ON_FALSE((xQueueSend(pool->buses[bus_index].queue, job, wait_ticks) == pdTRUE), ESP_ERR_NO_MEM, TAG,
+                        "mb pool, the queue of the bus #%u is full.", (unsigned)bus_index);
+    return ESP_OK;
+}
+
+// Puts the job to the queue of the bus and waits for its result
+static esp_err_t mbc_master_pool_call(mb_master_pool_t *pool, uint16_t bus_index, mb_pool_job_t *job)
+{
+    mb_pool_waiter_t waiter = {.error = ESP_OK};
+    waiter.done_sema = xSemaphoreCreateBinaryStatic(&waiter.done_buf);
+    job->done_cb = mbc_master_pool_done;
+    job->done_arg = &waiter;
+    esp_err_t err = mbc_master_pool_put(pool, bus_index, job, portMAX_DELAY);
+    if (err == ESP_OK) {
+        (void)xSemaphoreTake(waiter.done_sema, portMAX_DELAY);
+        err = waiter.error;
+    }
+    vSemaphoreDelete(waiter.done_sema);
+    return err;
+}
+
+static uint16_t mbc_master_pool_route(mb_master_pool_t *pool, const mb_param_request_t *request)
+{
+    return (request->slave_addr <= MB_ADDRESS_MAX) ? pool->routes[request->slave_addr] : MB_POOL_NO_BUS;
+}
+
+// Returns the master to the table it had before the pool set its part
+static void mbc_master_pool_restore(void *master_handle, const mb_parameter_descriptor_t *descriptor, uint16_t num_elements)
+{
+    mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(master_handle);
+    if (descriptor && (mbc_master_set_descriptor(master_handle, descriptor, num_elements) == ESP_OK)) {
+        return;
+    }
+    // The master had no table, it must not refer to the table of the pool which is released
+    mbc_master_cache_delete(mbm_opts);
+    mbc_master_plan_delete(mbm_opts);
+    mbc_master_index_delete(mbm_opts);
+    mbm_opts->param_descriptor_table = NULL;
+    mbm_opts->mbm_param_descriptor_size = 0;
+}
+
+static void mbc_master_pool_free(mb_master_pool_t *pool)
+{
+    for (uint16_t i = 0; pool->buses && (i < pool->bus_count); i++) {
+        mb_pool_bus_obj_t *bus = &pool->buses[i];
+        if (bus->task_handle) {
+            // The jobs in the queue are completed before the stop job
+            mb_pool_job_t job = {.type = MB_POOL_JOB_STOP};
+            (void)xQueueSend(bus->queue, &job, portMAX_DELAY);
+            (void)xSemaphoreTake(bus->exit_sema, portMAX_DELAY);
+        }
+        // The master must not refer to the table of the pool after it is released
+        if (pool->descriptors) {
+            mbc_master_pool_restore(bus->master_handle, pool->prev_tables[i], pool->prev_sizes[i]);
+        }
+        if (bus->queue) {
+            vQueueDelete(bus->queue);
+        }
+        if (bus->exit_sema) {
+            vSemaphoreDelete(bus->exit_sema);
+        }
+    }
+#if MB_STATS_ENABLED
+    free(pool->stats_objs);
+#endif
+    free(pool->descriptors);
+    free(pool->prev_tables);
+    free(pool->prev_sizes);
+    free(pool->buses);
+    free(pool);
+}
+
+esp_err_t mbc_master_pool_create(const mb_master_pool_config_t *config, void **handle)
+{
+    MB_RETURN_ON_FALSE((config && handle && config->buses && config->bus_count && (config->bus_count < MB_POOL_NO_BUS)),
+                        ESP_ERR_INVALID_ARG, TAG, "mb pool invalid arguments.");
+    esp_err_t ret = ESP_OK;
+    mb_master_pool_t *pool = (mb_master_pool_t *)heap_caps_calloc(1, sizeof(mb_master_pool_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    MB_RETURN_ON_FALSE((pool), ESP_ERR_NO_MEM, TAG, "mb pool memory allocation fail.");
+    for (int i = 0; i <= MB_ADDRESS_MAX; i++) {
+        pool->routes[i] = MB_POOL_NO_BUS;
+    }
+    pool->buses = (mb_pool_bus_obj_t *)calloc(config->bus_count, sizeof(mb_pool_bus_obj_t));
+    pool->prev_tables = (const mb_parameter_descriptor_t **)calloc(config->bus_count, sizeof(mb_parameter_descriptor_t *));
+    pool->prev_sizes = (uint16_t *)calloc(config->bus_count, sizeof(uint16_t));
+    MB_GOTO_ON_FALSE((pool->buses && pool->prev_tables && pool->prev_sizes), ESP_ERR_NO_MEM, error, TAG, "mb pool memory allocation fail.");
+#if MB_STATS_ENABLED
+    pool->stats_objs = (mb_stats_t **)calloc(config->bus_count, sizeof(mb_stats_t *));
+    MB_GOTO_ON_FALSE((pool->stats_objs), ESP_ERR_NO_MEM, error, TAG, "mb pool memory allocation fail.");
+#endif
+    pool->bus_count = config->bus_count;
+
+    for (uint16_t i = 0; i < config->bus_count; i++) {
+        const mb_master_pool_bus_t *bus_cfg = &config->buses[i];
+        MB_GOTO_ON_FALSE((bus_cfg->master_handle && (bus_cfg->slave_addrs || !bus_cfg->slave_count)),
+                            ESP_ERR_INVALID_ARG, error, TAG, "mb pool, the bus #%u is incorrect.", (unsigned)i);
+        for (uint16_t j = 0; j < bus_cfg->slave_count; j++) {
+            uint8_t addr = bus_cfg->slave_addrs[j];
+            MB_GOTO_ON_FALSE(((addr >= MB_ADDRESS_MIN) && (addr <= MB_ADDRESS_MAX) && (pool->routes[addr] == MB_POOL_NO_BUS)),
+                                ESP_ERR_INVALID_ARG, error, TAG, "mb pool, the address %u is incorrect or routed twice.",
+                                (unsigned)addr);
+            pool->routes[addr] = i;
+        }
+        mb_pool_bus_obj_t *bus = &pool->buses[i];
+        bus->master_handle = bus_cfg->master_handle;
+#if MB_STATS_ENABLED
+        mb_base_t *mb_base = MB_MASTER_GET_IFACE(bus->master_handle)->mb_base;
+        pool->stats_objs[i] = (mb_base && mb_base->port_obj) ? mb_base->port_obj->stats_obj : NULL;
+#endif
+        bus->queue = xQueueCreate(MB_POOL_QUEUE_SIZE, sizeof(mb_pool_job_t));
+        bus->exit_sema = xSemaphoreCreateBinary();
+        MB_GOTO_ON_FALSE((bus->queue && bus->exit_sema), ESP_ERR_NO_MEM, error,
+                            TAG, "mb pool queue creation fail.");
+        BaseType_t status = xTaskCreatePinnedToCore((void *)&mbc_master_pool_task,
+                                                    MB_POOL_TASK_NAME,
+                                                    MB_CONTROLLER_STACK_SIZE,
+                                                    bus,
+                                                    MB_CONTROLLER_PRIORITY,
+                                                    &bus->task_handle,
+                                                    MB_PORT_TASK_AFFINITY);
+        MB_GOTO_ON_FALSE((status == pdPASS), ESP_ERR_INVALID_STATE, error, TAG,
+                            "mb pool task creation error, xTaskCreate() returns (0x%x).", (unsigned)status);
+    }
+    *handle = pool;
+    return ESP_OK;
+
+error:
+    mbc_master_pool_free(pool);
+    return ret;
+}
+
+esp_err_t mbc_master_pool_delete(void *handle)
+{
+    MB_RETURN_ON_FALSE((handle), ESP_ERR_INVALID_ARG, TAG, "mb pool invalid arguments.");
+    mbc_master_pool_free((mb_master_pool_t *)handle);
+    return ESP_OK;
+}
+
+esp_err_t mbc_master_pool_set_descriptor(void *handle, const mb_parameter_descriptor_t *descriptor, uint16_t num_elements)
+{
+    MB_RETURN_ON_FALSE((handle && descriptor && num_elements), ESP_ERR_INVALID_ARG, TAG, "mb pool invalid arguments.");
+    mb_master_pool_t *pool = (mb_master_pool_t *)handle;
+    MB_RETURN_ON_FALSE((!pool->descriptors), ESP_ERR_INVALID_STATE, TAG, "mb pool, the table is already set.");
+    for (uint16_t i = 0; i < num_elements; i++) {
+        uint8_t addr = descriptor[i].mb_slave_addr;
+        MB_RETURN_ON_FALSE(((addr <= MB_ADDRESS_MAX) && (pool->routes[addr] != MB_POOL_NO_BUS)), ESP_ERR_NOT_FOUND, TAG,
+                            "mb pool, the slave %u of cid %u is not routed to the bus.", (unsigned)addr, (unsigned)descriptor[i].cid);
+    }
+    mb_parameter_descriptor_t *table = (mb_parameter_descriptor_t *)calloc(num_elements, sizeof(mb_parameter_descriptor_t));
+    esp_err_t ret = ESP_OK;
+    uint16_t bus_index = 0;
+    MB_GOTO_ON_FALSE((table), ESP_ERR_NO_MEM, error, TAG, "mb pool memory allocation fail.");
+    // Each bus takes its characteristics in the order of the table
+    uint16_t start = 0;
+    for (bus_index = 0; bus_index < pool->bus_count; bus_index++) {
+        mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(pool->buses[bus_index].master_handle);
+        // The tables of the masters before the pool are set back if a master rejects its part or on delete
+        pool->prev_tables[bus_index] = mbm_opts->param_descriptor_table;
+        pool->prev_sizes[bus_index] = (uint16_t)mbm_opts->mbm_param_descriptor_size;
+        uint16_t count = 0;
+        for (uint16_t i = 0; i < num_elements; i++) {
+            if (pool->routes[descriptor[i].mb_slave_addr] == bus_index) {
+                table[start + count++] = descriptor[i];
+            }
+        }
+        if (count) {
+            ret = mbc_master_set_descriptor(pool->buses[bus_index].master_handle, &table[start], count);
+            MB_GOTO_ON_FALSE((ret == ESP_OK), ret, error, TAG, "mb pool, the bus #%u rejects its table, error=(0x%x) (%s).",
+                                (unsigned)bus_index, (int)ret, esp_err_to_name(ret));
+        }
+        start += count;
+    }
+    pool->descriptors = table;
+    return ESP_OK;
+
+error:
+    // The bus which rejects its part keeps its table, the buses before it get their tables back
+    for (uint16_t i = 0; table && (i < bus_index); i++) {
+        mbc_master_pool_restore(pool->buses[i].master_handle, pool->prev_tables[i], pool->prev_sizes[i]);
+    }
+    free(table);
+    return ret;
+}
+
+esp_err_t mbc_master_pool_send_request(void *handle, mb_param_request_t *request, void *data_ptr)
+{
+    MB_RETURN_ON_FALSE((handle && request && data_ptr), ESP_ERR_INVALID_ARG, TAG, "mb pool invalid arguments.");
+    mb_master_pool_t *pool = (mb_master_pool_t *)handle;
+    mb_pool_job_t job = {.type = MB_POOL_JOB_REQUEST, .request = *request, .data = data_ptr};
+    return mbc_master_pool_call(pool, mbc_master_pool_route(pool, request), &job);
+}
+
+esp_err_t mbc_master_pool_send_request_async(void *handle, mb_param_request_t *request, void *data_ptr,
+                                                mb_master_pool_done_fp done_cb, void *done_arg)
+{
+    MB_RETURN_ON_FALSE((handle && request && data_ptr && done_cb), ESP_ERR_INVALID_ARG, TAG, "mb pool invalid arguments.");
+    mb_master_pool_t *pool = (mb_master_pool_t *)handle;
+    mb_pool_job_t job = {.type = MB_POOL_JOB_REQUEST, .request = *request, .data = data_ptr,
+                            .done_cb = done_cb, .done_arg = done_arg};
+    return mbc_master_pool_put(pool, mbc_master_pool_route(pool, request), &job, 0);
+}
+
+esp_err_t mbc_master_pool_get_parameter(void *handle, uint16_t cid, uint8_t *value, uint8_t *type)
+{
+    MB_RETURN_ON_FALSE((handle && value), ESP_ERR_INVALID_ARG, TAG, "mb pool invalid arguments.");
+    mb_master_pool_t *pool = (mb_master_pool_t *)handle;
+    mb_pool_job_t job = {.type = MB_POOL_JOB_GET, .cid = cid, .data = value, .param_type = type};
+    return mbc_master_pool_call(pool, mbc_master_pool_find_cid(pool, cid), &job);
+}
+
+esp_err_t mbc_master_pool_get_parameter_async(void *handle, uint16_t cid, uint8_t *value,
+                                                mb_master_pool_done_fp done_cb, void *done_arg)
+{
+    MB_RETURN_ON_FALSE((handle && value && done_cb), ESP_ERR_INVALID_ARG, TAG, "mb pool invalid arguments.");
+    mb_master_pool_t *pool = (mb_master_pool_t *)handle;
+    mb_pool_job_t job = {.type = MB_POOL_JOB_GET, .cid = cid, .data = value, .done_cb = done_cb, .done_arg = done_arg};
+    return mbc_master_pool_put(pool, mbc_master_pool_find_cid(pool, cid), &job, 0);
+}
+
+esp_err_t mbc_master_pool_set_parameter(void *handle, uint16_t cid, uint8_t *value, uint8_t *type)
+{
+    MB_RETURN_ON_FALSE((handle && value), ESP_ERR_INVALID_ARG, TAG, "mb pool invalid arguments.");
+    mb_master_pool_t *pool = (mb_master_pool_t *)handle;
+    mb_pool_job_t job = {.type = MB_POOL_JOB_SET, .cid = cid, .data = value, .param_type = type};
+    return mbc_master_pool_call(pool, mbc_master_pool_find_cid(pool, cid), &job);
+}
+
+esp_err_t mbc_master_pool_set_parameter_async(void *handle, uint16_t cid, uint8_t *value,
+                                                mb_master_pool_done_fp done_cb, void *done_arg)
+{
+    MB_RETURN_ON_FALSE((handle && value && done_cb), ESP_ERR_INVALID_ARG, TAG, "mb pool invalid arguments.");
+    mb_master_pool_t *pool = (mb_master_pool_t *)handle;
+    mb_pool_job_t job = {.type = MB_POOL_JOB_SET, .cid = cid, .data = value, .done_cb = done_cb, .done_arg = done_arg};
+    return mbc_master_pool_put(pool, mbc_master_pool_find_cid(pool, cid), &job, 0);
+}
+
+esp_err_t mbc_master_pool_get_parameters(void *handle, mb_param_poll_t *params, uint16_t count)
+{
+    MB_RETURN_ON_FALSE((handle && params && count), ESP_ERR_INVALID_ARG, TAG, "mb pool invalid arguments.");
+    mb_master_pool_t *pool = (mb_master_pool_t *)handle;
+    esp_err_t ret = ESP_OK;
+    StaticSemaphore_t done_buf;
+    SemaphoreHandle_t done_sema = NULL;
+    uint16_t jobs = 0;
+    // The characteristics of each bus are put together in the order of the set,
+    // the part keeps the index of the characteristic in the set
+    mb_param_poll_t *parts = (mb_param_poll_t *)calloc(count, sizeof(mb_param_poll_t));
+    uint16_t *part_index = (uint16_t *)calloc(count, sizeof(uint16_t));
+    uint16_t *bus_of = (uint16_t *)calloc(count, sizeof(uint16_t));
+    MB_GOTO_ON_FALSE((parts && part_index && bus_of), ESP_ERR_NO_MEM, error, TAG, "mb pool memory allocation fail.");
+    for (uint16_t i = 0; i < count; i++) {
+        bus_of[i] = mbc_master_pool_find_cid(pool, params[i].cid);
+        params[i].error = ESP_ERR_NOT_FOUND;
+    }
+    done_sema = xSemaphoreCreateCountingStatic(pool->bus_count, 0, &done_buf);
+    uint16_t start = 0;
+    for (uint16_t bus_index = 0; bus_index < pool->bus_count; bus_index++) {
+        uint16_t part_count = 0;
+        for (uint16_t i = 0; i < count; i++) {
+            if (bus_of[i] == bus_index) {
+                part_index[start + part_count] = i;
+                parts[start + part_count] = params[i];
+                // The master sets the result of each characteristic it reads
+                parts[start + part_count].error = ESP_ERR_INVALID_STATE;
+                part_count++;
+            }
+        }
+        if (part_count) {
+            mb_pool_job_t job = {.type = MB_POOL_JOB_GET_MANY, .count = part_count, .data = &parts[start],
+                                    .done_cb = mbc_master_pool_done_many, .done_arg = done_sema};
+            if (mbc_master_pool_put(pool, bus_index, &job, portMAX_DELAY) == ESP_OK) {
+                jobs++;
+            }
+        }
+        start += part_count;
+    }
+    for (uint16_t i = 0; i < jobs; i++) {
+        (void)xSemaphoreTake(done_sema, portMAX_DELAY);
+    }
+    for (uint16_t i = 0; i < start; i++) {
+        mb_param_poll_t *param = &params[part_index[i]];
+        param->type = parts[i].type;
+        param->error = parts[i].error;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        if (params[i].error != ESP_OK) {
+            ret = params[i].error;
+            break;
+        }
+    }
+
+error:
+    if (done_sema) {
+        vSemaphoreDelete(done_sema);
+    }
+    free(bus_of);
+    free(part_index);
+    free(parts);
+    return ret;
+}
+
+esp_err_t mbc_master_pool_get_stats(void *handle, mb_stats_group_t group, mb_stats_info_t *info,
+                                    uint16_t max_count, uint16_t *count)
+{
+    MB_RETURN_ON_FALSE((handle && count), ESP_ERR_INVALID_ARG, TAG, "mb pool invalid arguments.");
+#if MB_STATS_ENABLED
+    mb_master_pool_t *pool = (mb_master_pool_t *)handle;
+    *count = mb_stats_get_merged(pool->stats_objs, pool->bus_count, group, info, max_count);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t mbc_master_pool_reset_stats(void *handle)
+{
+    MB_RETURN_ON_FALSE((handle), ESP_ERR_INVALID_ARG, TAG, "mb pool invalid arguments.");
+#if MB_STATS_ENABLED
+    mb_master_pool_t *pool = (mb_master_pool_t *)handle;
+    for (uint16_t i = 0; i < pool->bus_count; i++) {
+        mb_stats_reset(pool->stats_objs[i]);
+    }
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
@@ -0,0 +1,962 @@
+/*
+ * SPDX-FileCopyrightText: 2016-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "esp_err.h"                // for esp_err_t
+#include "esp_timer.h"              // for esp_timer_get_time()
+#include "sdkconfig.h"              // for KConfig defines
+
+#include "mbc_slave.h"              // for slave private type definitions
+#include "esp_modbus_common.h"      // for common defines
+#include "esp_modbus_slave.h"       // for public slave defines
+
+#include "mb_utils.h"               // for stack bit setting utilities
+
+#if CONFIG_FMB_CONTROLLER_SLAVE_ID_SUPPORT
+
+#define MB_ID_BYTE0(id) ((uint8_t)(id))
+#define MB_ID_BYTE1(id) ((uint8_t)(((uint16_t)(id) >> 8) & 0xFF))
+#define MB_ID_BYTE2(id) ((uint8_t)(((uint32_t)(id) >> 16) & 0xFF))
+#define MB_ID_BYTE3(id) ((uint8_t)(((uint32_t)(id) >> 24) & 0xFF))
+
+#define MB_CONTROLLER_SLAVE_ID (CONFIG_FMB_CONTROLLER_SLAVE_ID)
+#define MB_SLAVE_ID_SHORT      (MB_ID_BYTE3(MB_CONTROLLER_SLAVE_ID))
+
+// Slave ID constant
+static uint8_t mb_slave_id[] = { MB_ID_BYTE0(MB_CONTROLLER_SLAVE_ID),
+                                MB_ID_BYTE1(MB_CONTROLLER_SLAVE_ID),
+                                MB_ID_BYTE2(MB_CONTROLLER_SLAVE_ID) };
+
+#endif
+
+static const char TAG[] __attribute__((unused)) = "MB_CONTROLLER_SLAVE";
+
+#define MB_DESCR_TABLE_MIN_SIZE (8) // The initial number of items in the table of area descriptors
+
+// Returns the position of the first area which starts after the address
+static uint32_t mbc_slave_find_area_pos(const mb_descr_table_t *table, uint32_t addr)
+{
+    uint32_t low = 0;
+    uint32_t high = table->count;
+    while (low < high) {
+        uint32_t mid = low + ((high - low) >> 1);
+        if (table->items[mid]->start_offset <= addr) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Searches the register in the area specified by type, returns descriptor if found, else NULL
+// The areas do not overlap, so only the last area started before the address can contain the registers.
+static mb_descr_entry_t *mbc_slave_find_reg_descriptor(void *ctx, mb_param_type_t type, uint16_t addr, size_t regs)
+{
+    mb_slave_options_t *mbs_opts = MB_SLAVE_GET_OPTS(ctx);
+    const mb_descr_table_t *table = &mbs_opts->area_descriptors[type];
+
+    uint32_t pos = mbc_slave_find_area_pos(table, addr);
+    if (!pos || (regs < 1)) {
+        return NULL;
+    }
+    mb_descr_entry_t *it = table->items[pos - 1];
+    uint32_t reg_size = REG_SIZE(type, it->size);
+    if ((it->p_data) && (reg_size >= 1) && ((addr + regs) <= (it->start_offset + reg_size))) {
+        return it;
+    }
+    return NULL;
+}
+
+// Inserts the area into the table keeping the order of start offset, fails if the area overlaps other area
+static esp_err_t mbc_slave_insert_descriptor(mb_descr_table_t *table, mb_descr_entry_t *descr)
+{
+    uint32_t start = descr->start_offset;
+    uint32_t reg_size = REG_SIZE(descr->type, descr->size);
+    uint32_t end = start + reg_size;
+    uint32_t pos = mbc_slave_find_area_pos(table, start);
+
+    if (pos) {
+        mb_descr_entry_t *prev = table->items[pos - 1];
+        reg_size = REG_SIZE(prev->type, prev->size);
+        MB_RETURN_ON_FALSE(((prev->start_offset + reg_size) <= start),
+                            ESP_ERR_INVALID_ARG, TAG, "mb incorrect descriptor or already defined.");
+    }
+    MB_RETURN_ON_FALSE(((pos == table->count) || (end <= table->items[pos]->start_offset)),
+                        ESP_ERR_INVALID_ARG, TAG, "mb incorrect descriptor or already defined.");
+    if (table->count == table->capacity) {
+        uint32_t capacity = table->capacity ? (table->capacity << 1) : MB_DESCR_TABLE_MIN_SIZE;
+        mb_descr_entry_t **items = (mb_descr_entry_t **)heap_caps_realloc(table->items, (capacity * sizeof(mb_descr_entry_t *)),
+                                                                            MALLOC_CAP_INTERNAL|MALLOC_CAP_8BIT);
+        MB_RETURN_ON_FALSE(items, ESP_ERR_NO_MEM, TAG, "mb can not allocate memory for descriptor.");
+        table->items = items;
+        table->capacity = capacity;
+    }
+    memmove(&table->items[pos + 1], &table->items[pos], ((table->count - pos) * sizeof(mb_descr_entry_t *)));
+    table->items[pos] = descr;
+    table->count++;
+    return ESP_OK;
+}
+
+// The buffer of the published area selected by the publish counter
+#define MB_AREA_BUFFER(it, seq) ((((seq) >> 1) & 1) ? (it)->p_shadow : (uint8_t *)(it)->p_data)
+
+// Starts the copy from the area and returns its data. The published area is read without the lock,
+// the counter is odd while the next frame is copied into the other buffer.
+static uint8_t *mbc_slave_read_begin(mb_base_t *inst, mb_descr_entry_t *it, uint32_t *seq)
+{
+    if (!it->p_shadow) {
+        CRITICAL_SECTION_LOCK(inst->lock);
+        return (uint8_t *)it->p_data;
+    }
+    *seq = atomic_load_explicit(&it->pub_seq, memory_order_acquire);
+    return MB_AREA_BUFFER(it, *seq);
+}
+
+// Completes the copy from the area, returns false if the data could be overwritten during the copy
+static bool mbc_slave_read_end(mb_base_t *inst, mb_descr_entry_t *it, uint32_t seq)
+{
+    if (!it->p_shadow) {
+        CRITICAL_SECTION_UNLOCK(inst->lock);
+        return true;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    // The buffer being read is overwritten only by the second publish after the copy is started
+    return ((atomic_load_explicit(&it->pub_seq, memory_order_relaxed) - (seq & ~1UL)) <= 2);
+}
+
+// Returns the area which starts exactly at the offset
+static mb_descr_entry_t *mbc_slave_get_area(void *ctx, mb_param_type_t type, uint16_t start_offset)
+{
+    mb_slave_options_t *mbs_opts = MB_SLAVE_GET_OPTS(ctx);
+    const mb_descr_table_t *table = &mbs_opts->area_descriptors[type];
+    uint32_t pos = mbc_slave_find_area_pos(table, start_offset);
+    if (pos && (table->items[pos - 1]->start_offset == start_offset)) {
+        return table->items[pos - 1];
+    }
+    return NULL;
+}
+
+#if CONFIG_FMB_CONTROLLER_SLAVE_CHANGE_TRACKING
+
+#define MB_DIRTY_WORD_BITS (32)
+#define MB_DIRTY_WORDS(bits) (((bits) + MB_DIRTY_WORD_BITS - 1) / MB_DIRTY_WORD_BITS)
+#define MB_DIRTY_MASK(bit, count) (((count) >= MB_DIRTY_WORD_BITS) ? UINT32_MAX : (((1UL << (count)) - 1) << (bit)))
+
+// The areas which can be written by master
+#define MB_AREA_IS_TRACKED(type) (((type) == MB_PARAM_HOLDING) || ((type) == MB_PARAM_COIL))
+
+// Marks the registers of the area written by master, called with the lock taken
+static void mbc_slave_set_dirty(mb_descr_entry_t *it, uint32_t index, uint32_t count)
+{
+    while (count) {
+        uint32_t bit = index % MB_DIRTY_WORD_BITS;
+        uint32_t bits = ((MB_DIRTY_WORD_BITS - bit) < count) ? (MB_DIRTY_WORD_BITS - bit) : count;
+        it->dirty_bits[index / MB_DIRTY_WORD_BITS] |= MB_DIRTY_MASK(bit, bits);
+        index += bits;
+        count -= bits;
+    }
+    it->dirty_time = (uint32_t)esp_timer_get_time();
+    it->is_dirty = true;
+}
+
+// Takes the first range of the changed registers of the area and clears it, returns the number of registers
+static uint32_t mbc_slave_take_dirty(mb_descr_entry_t *it, uint32_t *start)
+{
+    uint32_t words = MB_DIRTY_WORDS(REG_SIZE(it->type, it->size));
+    uint32_t word = 0;
+    uint32_t count = 0;
+
+    while ((word < words) && !it->dirty_bits[word]) {
+        word++;
+    }
+    if (word == words) {
+        it->is_dirty = false;
+        return 0;
+    }
+    uint32_t bit = __builtin_ctz(it->dirty_bits[word]);
+    *start = (word * MB_DIRTY_WORD_BITS) + bit;
+    while (word < words) {
+        uint32_t inverted = ~(it->dirty_bits[word] >> bit);
+        uint32_t bits = inverted ? __builtin_ctz(inverted) : MB_DIRTY_WORD_BITS;
+        bits = (bits < (MB_DIRTY_WORD_BITS - bit)) ? bits : (MB_DIRTY_WORD_BITS - bit);
+        it->dirty_bits[word] &= ~MB_DIRTY_MASK(bit, bits);
+        count += bits;
+        // The range continues in the next word if it reaches the end of this word
+        if ((bit + bits) < MB_DIRTY_WORD_BITS) {
+            break;
+        }
+        word++;
+        bit = 0;
+    }
+    return count;
+}
+
+#endif
+
+#if CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE
+
+// Copies the cached data of the read request, the generation of cache is returned on miss
+static bool mbc_slave_cache_get(void *ctx, mb_base_t *inst, mb_param_type_t type, uint16_t address,
+                                    uint16_t n_regs, uint8_t *reg_buffer, uint8_t **p_instance, uint32_t *generation)
+{
+    mb_resp_cache_t *cache = &MB_SLAVE_GET_OPTS(ctx)->resp_cache;
+    bool is_found = false;
+    if (!cache->entries) {
+        return false;
+    }
+    CRITICAL_SECTION(inst->lock) {
+        for (int i = 0; i < MB_RESP_CACHE_SIZE; i++) {
+            mb_resp_cache_entry_t *entry = &cache->entries[i];
+            if ((entry->count == n_regs) && (entry->start == address) && (entry->type == type)) {
+                memcpy(reg_buffer, entry->data, (n_regs << 1));
+                *p_instance = entry->p_instance;
+                is_found = true;
+                break;
+            }
+        }
+        if (is_found) {
+            cache->stats.hit_count++;
+        } else {
+            cache->stats.miss_count++;
+            *generation = cache->generation;
+        }
+    }
+    return is_found;
+}
+
+// Keeps the data of the read request if nothing is invalidated since the miss
+static void mbc_slave_cache_put(void *ctx, mb_base_t *inst, mb_param_type_t type, uint16_t address,
+                                    uint16_t n_regs, const uint8_t *reg_buffer, uint8_t *p_instance, uint32_t generation)
+{
+    mb_resp_cache_t *cache = &MB_SLAVE_GET_OPTS(ctx)->resp_cache;
+    if (!cache->entries || (n_regs > MB_RESP_CACHE_REGS_MAX)) {
+        return;
+    }
+    CRITICAL_SECTION(inst->lock) {
+        if (generation == cache->generation) {
+            mb_resp_cache_entry_t *entry = &cache->entries[cache->next];
+            cache->next = (cache->next + 1) % MB_RESP_CACHE_SIZE;
+            entry->type = type;
+            entry->start = address;
+            entry->count = n_regs;
+            entry->p_instance = p_instance;
+            memcpy(entry->data, reg_buffer, (n_regs << 1));
+        }
+    }
+}
+
+// Drops the cached requests overlapped with the registers, MB_PARAM_COUNT drops all requests.
+// The caller holds the lock of slave object.
+static void mbc_slave_cache_invalidate(void *ctx, mb_param_type_t type, uint16_t address, uint32_t n_regs)
+{
+    mb_resp_cache_t *cache = &MB_SLAVE_GET_OPTS(ctx)->resp_cache;
+    if (!cache->entries) {
+        return;
+    }
+    cache->generation++;
+    for (int i = 0; i < MB_RESP_CACHE_SIZE; i++) {
+        mb_resp_cache_entry_t *entry = &cache->entries[i];
+        if (entry->count && ((type == MB_PARAM_COUNT) || ((entry->type == type)
+                && (entry->start < (address + n_regs)) && (address < (entry->start + entry->count))))) {
+            entry->count = 0;
+        }
+    }
+}
+
+#endif
+
+static void mbc_slave_free_descriptors(void *ctx)
+{
+    mb_slave_options_t *mbs_opts = MB_SLAVE_GET_OPTS(ctx);
+
+    for (int descr_type = 0; descr_type < MB_PARAM_COUNT; descr_type++) {
+        mb_descr_table_t *table = &mbs_opts->area_descriptors[descr_type];
+        for (uint32_t i = 0; i < table->count; i++) {
+            free(table->items[i]->p_shadow);
+            free(table->items[i]);
+        }
+        free(table->items);
+        memset(table, 0, sizeof(mb_descr_table_t));
+    }
+    free(mbs_opts->resp_cache.entries);
+    memset(&mbs_opts->resp_cache, 0, sizeof(mb_resp_cache_t));
+}
+
+void mbc_slave_init_iface(void *ctx)
+{
+    mb_slave_options_t *mbs_opts = MB_SLAVE_GET_OPTS(ctx);
+
+    // Initialize the tables of register areas
+    memset(&mbs_opts->area_descriptors[0], 0, sizeof(mbs_opts->area_descriptors));
+    memset(&mbs_opts->resp_cache, 0, sizeof(mb_resp_cache_t));
+    mbs_opts->gateway = NULL;
+#if CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE
+    mbs_opts->resp_cache.entries = (mb_resp_cache_entry_t *)heap_caps_calloc(MB_RESP_CACHE_SIZE, sizeof(mb_resp_cache_entry_t),
+                                                                                MALLOC_CAP_INTERNAL|MALLOC_CAP_8BIT);
+    if (!mbs_opts->resp_cache.entries) {
+        ESP_LOGE(TAG, "mb can not allocate memory for response cache, the cache is disabled.");
+    }
+#endif
+}
+
+/**
+ * Modbus controller delete function
+ */
+esp_err_t mbc_slave_delete(void *ctx)
+{
+    esp_err_t error = ESP_OK;
+    // Is initialization done?
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                        "Slave interface is not correctly initialized.");
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    
+    // Check if interface has been initialized
+    MB_RETURN_ON_FALSE(mbs_controller->delete,
+                        ESP_ERR_INVALID_STATE, TAG,
+                        "Slave interface is not correctly configured.");
+    // Call the slave controller destroy function
+    error = mbs_controller->delete(ctx);
+    if (error != ESP_OK) {
+        ESP_LOGE(TAG, "Slave delete failure error=(0x%x).", (uint16_t)error);
+    }
+    // Destroy all opened descriptors
+    mbc_slave_free_descriptors(ctx);
+    free(mbs_controller);
+    mbs_controller = NULL;
+    return error;
+}
+
+/**
+ * Critical section lock function
+ */
+esp_err_t mbc_slave_lock(void *ctx)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                            "Slave interface is not correctly initialized.");
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    mb_base_t *mb_obj = mbs_controller->mb_base;
+    MB_RETURN_ON_FALSE((mb_obj && mb_obj->lock), ESP_ERR_INVALID_STATE, TAG,
+                            "Slave interface is not correctly initialized.");
+    CRITICAL_SECTION_LOCK(mb_obj->lock);
+    return ESP_OK;
+}
+
+/**
+ * Critical section unlock function
+ */
+esp_err_t mbc_slave_unlock(void *ctx)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                            "Slave interface is not correctly initialized.");
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    mb_base_t *mb_obj = mbs_controller->mb_base;
+    MB_RETURN_ON_FALSE((mb_obj && mb_obj->lock), ESP_ERR_INVALID_STATE, TAG,
+                            "Slave interface is not correctly initialized.");
+#if CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE
+    // Any register could be updated by the application under the lock
+    mbc_slave_cache_invalidate(ctx, MB_PARAM_COUNT, 0, 0);
+#endif
+    CRITICAL_SECTION_UNLOCK(mb_obj->lock);
+    return ESP_OK;
+}
+
+/**
+ * Switch the register area to the publish mode
+ */
+esp_err_t mbc_slave_enable_publish(void *ctx, mb_param_type_t type, uint16_t start_offset)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                            "Slave interface is not correctly initialized.");
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    mb_base_t *mb_obj = mbs_controller->mb_base;
+    MB_RETURN_ON_FALSE((mb_obj && mb_obj->lock), ESP_ERR_INVALID_STATE, TAG,
+                            "Slave interface is not correctly initialized.");
+    MB_RETURN_ON_FALSE((type < MB_PARAM_COUNT), ESP_ERR_INVALID_ARG, TAG, "mb incorrect area type.");
+    mb_descr_entry_t *it = mbc_slave_get_area(ctx, type, start_offset);
+    MB_RETURN_ON_FALSE(it, ESP_ERR_NOT_FOUND, TAG, "mb area at offset %u is not found.", (unsigned)start_offset);
+    // The master can not write the published area
+    MB_RETURN_ON_FALSE(((type == MB_PARAM_INPUT) || (type == MB_PARAM_DISCRETE) || (it->access == MB_ACCESS_RO)),
+                            ESP_ERR_INVALID_ARG, TAG, "mb area at offset %u is writable.", (unsigned)start_offset);
+    if (it->p_shadow) {
+        return ESP_OK;
+    }
+    uint8_t *p_shadow = (uint8_t *)heap_caps_malloc(it->size, MALLOC_CAP_INTERNAL|MALLOC_CAP_8BIT);
+    MB_RETURN_ON_FALSE(p_shadow, ESP_ERR_NO_MEM, TAG, "mb can not allocate memory for published area.");
+    CRITICAL_SECTION(mb_obj->lock) {
+        memcpy(p_shadow, it->p_data, it->size);
+        atomic_store(&it->pub_seq, 0);
+        it->p_shadow = p_shadow;
+    }
+    return ESP_OK;
+}
+
+/**
+ * Publish the new data of the register area
+ */
+esp_err_t mbc_slave_publish(void *ctx, mb_param_type_t type, uint16_t start_offset, const void *data, size_t size)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                            "Slave interface is not correctly initialized.");
+    MB_RETURN_ON_FALSE((data && (type < MB_PARAM_COUNT)), ESP_ERR_INVALID_ARG, TAG, "mb incorrect publish arguments.");
+    mb_descr_entry_t *it = mbc_slave_get_area(ctx, type, start_offset);
+    MB_RETURN_ON_FALSE(it, ESP_ERR_NOT_FOUND, TAG, "mb area at offset %u is not found.", (unsigned)start_offset);
+    MB_RETURN_ON_FALSE(it->p_shadow, ESP_ERR_INVALID_STATE, TAG, "mb area at offset %u is not published.", (unsigned)start_offset);
+    MB_RETURN_ON_FALSE((size == it->size), ESP_ERR_INVALID_ARG, TAG, "mb incorrect size of the published data.");
+    uint32_t seq = atomic_load_explicit(&it->pub_seq, memory_order_relaxed);
+    MB_RETURN_ON_FALSE((!(seq & 1) && atomic_compare_exchange_strong(&it->pub_seq, &seq, (seq + 1))),
+                            ESP_ERR_INVALID_STATE, TAG, "mb area at offset %u is published by other task.", (unsigned)start_offset);
+    atomic_thread_fence(memory_order_release);
+    // The readers take the other buffer until the counter is updated
+    memcpy(MB_AREA_BUFFER(it, (seq + 2)), data, size);
+    atomic_store_explicit(&it->pub_seq, (seq + 2), memory_order_release);
+#if CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE
+    mb_base_t *mb_obj = MB_SLAVE_GET_IFACE(ctx)->mb_base;
+    CRITICAL_SECTION(mb_obj->lock) {
+        mbc_slave_cache_invalidate(ctx, type, start_offset, (size >> 1));
+    }
+#endif
+    return ESP_OK;
+}
+
+#if CONFIG_FMB_CONTROLLER_SLAVE_ID_SUPPORT
+/**
+ * Set object ID for the Modbus controller
+ */
+esp_err_t mbc_set_slave_id(void *ctx, uint8_t uid, bool is_running, uint8_t const *data_ptr, uint8_t data_len)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                        "Slave interface is not correctly initialized.");
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    // The Report Slave ID functionality is useful for TCP and gateway,
+    // so the design decision is to keep this functionality for all slaves
+    // Set the slave ID if the KConfig option is selected
+    mb_err_enum_t status = mbs_set_slave_id(mbs_controller->mb_base, uid, is_running, (uint8_t *)data_ptr, data_len);
+    MB_RETURN_ON_FALSE((status == MB_ENOERR), ESP_ERR_INVALID_STATE, TAG, "mb stack set slave ID failure.");
+    return MB_ERR_TO_ESP_ERR(status);
+}
+
+/**
+ * Get object ID from the Modbus controller
+ */
+esp_err_t mbc_get_slave_id(void *ctx, uint8_t const *data_ptr, uint8_t *data_len)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                        "Slave interface is not correctly initialized.");
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    mb_err_enum_t status = mbs_get_slave_id(mbs_controller->mb_base, (uint8_t *)data_ptr, data_len);
+    MB_RETURN_ON_FALSE((status == MB_ENOERR), ESP_ERR_INVALID_STATE, TAG, "mb stack get slave ID failure.");
+    return MB_ERR_TO_ESP_ERR(status);
+}
+#endif
+
+/**
+ * Start Modbus controller start function
+ */
+esp_err_t mbc_slave_start(void *ctx)
+{
+    esp_err_t error = ESP_OK;
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                        "Slave interface is not correctly initialized.");
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    MB_RETURN_ON_FALSE(mbs_controller->start, ESP_ERR_INVALID_STATE, TAG,
+                    "Slave interface is not correctly configured.");
+    uint8_t slave_uid = mbs_controller->opts.comm_opts.common_opts.uid;
+#if CONFIG_FMB_CONTROLLER_SLAVE_ID_SUPPORT
+    // Set the default slave ID if the KConfig option is selected
+    error = mbc_set_slave_id(mbs_controller, slave_uid, true, (uint8_t *)mb_slave_id, sizeof(mb_slave_id));
+    MB_RETURN_ON_FALSE((error == ESP_OK), ESP_ERR_INVALID_STATE, TAG, "mb stack set slave ID failure.");
+#endif
+    error = mbs_controller->start(ctx);
+    MB_RETURN_ON_FALSE((error == ESP_OK), ESP_ERR_INVALID_STATE, TAG,
+                    "Slave start failure error=(0x%x).", (uint16_t)error);
+    mbs_controller->is_active = true;
+    return error;
+}
+
+/**
+ * Start Modbus controller stop function
+ */
+esp_err_t mbc_slave_stop(void *ctx)
+{
+    esp_err_t error = ESP_OK;
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                        "Slave interface is not correctly initialized.");
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    MB_RETURN_ON_FALSE(mbs_controller->stop,
+                        ESP_ERR_INVALID_STATE, TAG,
+                        "Slave interface is not correctly configured.");
+    error = mbs_controller->stop(ctx);
+    MB_RETURN_ON_FALSE((error == ESP_OK), ESP_ERR_INVALID_STATE, TAG,
+                    "Slave stop failure error=(0x%x).", (uint16_t)error);
+    mbs_controller->is_active = false;
+    return error;
+}
+
+/**
+ * Blocking function to get event on parameter group change for application task
+ */
+mb_event_group_t mbc_slave_check_event(void *ctx, mb_event_group_t group)
+{
+    MB_RETURN_ON_FALSE(ctx, MB_EVENT_NO_EVENTS, TAG,
+                        "Slave interface is not correctly initialized.");
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    MB_RETURN_ON_FALSE((mbs_controller->check_event && mbs_controller->is_active),
+                    MB_EVENT_NO_EVENTS, TAG,
+                    "Slave interface is not correctly configured.");
+    mb_event_group_t event = mbs_controller->check_event(ctx, group);
+    return event;
+}
+
+/**
+ * Function to get notification about parameter change from application task
+ */
+esp_err_t mbc_slave_get_param_info(void *ctx, mb_param_info_t *reg_info, uint32_t timeout)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                    "Slave interface is not correctly initialized.");
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    MB_RETURN_ON_FALSE((mbs_controller->get_param_info && mbs_controller->is_active),
+                    ESP_ERR_INVALID_STATE, TAG,
+                    "Slave interface is not correctly configured.");
+    return mbs_controller->get_param_info(ctx, reg_info, timeout);
+}
+
+/**
+ * Function to get the statistics of the clients connected to the TCP slave
+ */
+esp_err_t mbc_slave_get_client_stats(void *ctx, mb_tcp_client_stats_t *stats, uint16_t max_count, uint16_t *count)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                    "Slave interface is not correctly initialized.");
+    MB_RETURN_ON_FALSE((stats && count), ESP_ERR_INVALID_ARG, TAG,
+                    "Slave incorrect stats or count pointer.");
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    *count = 0;
+    MB_RETURN_ON_FALSE((mbs_controller->get_client_stats), ESP_ERR_NOT_SUPPORTED, TAG,
+                    "Slave client statistics are not supported.");
+    *count = mbs_controller->get_client_stats(ctx, stats, max_count);
+    return ESP_OK;
+}
+
+/**
+ * Function to get the counters of the response cache
+ */
+esp_err_t mbc_slave_get_cache_stats(void *ctx, mb_cache_stats_t *stats)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                    "Slave interface is not correctly initialized.");
+    MB_RETURN_ON_FALSE(stats, ESP_ERR_INVALID_ARG, TAG, "Slave incorrect stats pointer.");
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    mb_resp_cache_t *cache = &MB_SLAVE_GET_OPTS(ctx)->resp_cache;
+    MB_RETURN_ON_FALSE((mbs_controller->mb_base && mbs_controller->mb_base->lock), ESP_ERR_INVALID_STATE, TAG,
+                    "Slave interface is not correctly initialized.");
+    MB_RETURN_ON_FALSE(cache->entries, ESP_ERR_NOT_SUPPORTED, TAG,
+                    "Slave response cache is not enabled.");
+    CRITICAL_SECTION(mbs_controller->mb_base->lock) {
+        *stats = cache->stats;
+    }
+    return ESP_OK;
+}
+
+/**
+ * Function to get the ranges of registers written by master
+ */
+esp_err_t mbc_slave_get_changes(void *ctx, mb_param_info_t *changes, uint16_t max_count, uint16_t *count)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                    "Slave interface is not correctly initialized.");
+    MB_RETURN_ON_FALSE((changes && count), ESP_ERR_INVALID_ARG, TAG,
+                    "Slave incorrect changes or count pointer.");
+#if CONFIG_FMB_CONTROLLER_SLAVE_CHANGE_TRACKING
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    mb_base_t *mb_obj = mbs_controller->mb_base;
+    MB_RETURN_ON_FALSE((mb_obj && mb_obj->lock), ESP_ERR_INVALID_STATE, TAG,
+                    "Slave interface is not correctly initialized.");
+    const mb_param_type_t types[] = {MB_PARAM_HOLDING, MB_PARAM_COIL};
+    uint16_t num = 0;
+
+    CRITICAL_SECTION(mb_obj->lock) {
+        for (int t = 0; (t < (sizeof(types) / sizeof(types[0]))) && (num < max_count); t++) {
+            mb_descr_table_t *table = &mbs_controller->opts.area_descriptors[types[t]];
+            for (uint32_t i = 0; (i < table->count) && (num < max_count); i++) {
+                mb_descr_entry_t *it = table->items[i];
+                uint32_t start = 0;
+                uint32_t regs = 0;
+                while (it->is_dirty && (num < max_count) && (regs = mbc_slave_take_dirty(it, &start))) {
+                    mb_param_info_t *change = &changes[num++];
+                    change->time_stamp = it->dirty_time;
+                    change->mb_offset = (uint16_t)(it->start_offset + start);
+                    change->size = regs;
+                    if (types[t] == MB_PARAM_HOLDING) {
+                        change->type = MB_EVENT_HOLDING_REG_WR;
+                        change->address = (uint8_t *)it->p_data + (start << 1);
+                    } else {
+                        change->type = MB_EVENT_COILS_WR;
+                        change->address = (uint8_t *)it->p_data + (start >> 3);
+                    }
+                }
+            }
+        }
+    }
+    *count = num;
+    return ESP_OK;
+#else
+    *count = 0;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * Function to set area descriptors for modbus parameters
+ */
+esp_err_t mbc_slave_set_descriptor(void *ctx, mb_register_area_descriptor_t descr_data)
+{
+    MB_RETURN_ON_FALSE((ctx), ESP_ERR_INVALID_STATE, TAG,
+                    "Slave interface is not correctly initialized.");
+    esp_err_t error = ESP_OK;
+    mbs_controller_iface_t *mbs_controller = MB_SLAVE_GET_IFACE(ctx);
+    if (mbs_controller->set_descriptor) {
+        error = mbs_controller->set_descriptor(ctx, descr_data);
+        MB_RETURN_ON_FALSE((error == ESP_OK),
+                        ESP_ERR_INVALID_STATE, TAG,
+                        "Slave set descriptor failure error=(0x%x).",
+                        (uint16_t)error);
+    } else {
+        mb_slave_options_t *mbs_opts = &mbs_controller->opts;
+
+        MB_RETURN_ON_FALSE((descr_data.size < MB_INST_MAX_SIZE) && (descr_data.size >= MB_INST_MIN_SIZE), 
+                            ESP_ERR_INVALID_ARG, TAG, "mb area size is incorrect.");
+
+        size_t dirty_size = 0;
+#if CONFIG_FMB_CONTROLLER_SLAVE_CHANGE_TRACKING
+        // The bitmap of written registers is placed after the descriptor
+        if (MB_AREA_IS_TRACKED(descr_data.type)) {
+            uint32_t reg_size = REG_SIZE(descr_data.type, descr_data.size);
+            dirty_size = MB_DIRTY_WORDS(reg_size) * sizeof(uint32_t);
+        }
+#endif
+        mb_descr_entry_t *new_descr = (mb_descr_entry_t*) heap_caps_calloc(1, (sizeof(mb_descr_entry_t) + dirty_size),
+                                            MALLOC_CAP_INTERNAL|MALLOC_CAP_8BIT);
+        MB_RETURN_ON_FALSE(new_descr, ESP_ERR_NO_MEM, TAG, "mb can not allocate memory for descriptor.");
+        new_descr->dirty_bits = dirty_size ? (uint32_t *)(new_descr + 1) : NULL;
+        new_descr->start_offset = descr_data.start_offset;
+        new_descr->type = descr_data.type;
+        new_descr->p_data = descr_data.address;
+        new_descr->size = descr_data.size;
+        new_descr->access = descr_data.access;
+        // Check if the area overlaps the areas in the descriptor table
+        error = mbc_slave_insert_descriptor(&mbs_opts->area_descriptors[descr_data.type], new_descr);
+        if (error != ESP_OK) {
+            free(new_descr);
+            return error;
+        }
+        error = ESP_OK;
+    }
+    return error;
+}
+
+// The helper function to get time stamp in microseconds
+static uint64_t mbc_slave_get_time_stamp(void)
+{
+    uint64_t time_stamp = esp_timer_get_time();
+    return time_stamp;
+}
+
+// Helper function to send parameter information to application task
+static esp_err_t mbc_slave_send_param_info(void *ctx, mb_event_group_t par_type, uint16_t mb_offset,
+                                    uint8_t *par_address, uint16_t par_size)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                    "Slave interface is not correctly initialized.");
+    mb_slave_options_t *mbs_opts = MB_SLAVE_GET_OPTS(ctx);
+    esp_err_t error = ESP_FAIL;
+    mb_param_info_t par_info;
+    // Check if queue is not full the send parameter information
+    par_info.type = par_type;
+    par_info.size = par_size;
+    par_info.address = par_address;
+    par_info.time_stamp = mbc_slave_get_time_stamp();
+    par_info.mb_offset = mb_offset;
+    BaseType_t status = xQueueSend(mbs_opts->notification_queue_handle, &par_info, MB_PAR_INFO_TOUT);
+    if (pdTRUE == status) {
+        ESP_LOGD(TAG, "Queue send parameter info (type, address, size): %d, 0x%" PRIx32 ", %d",
+                        (int)par_type, (uint32_t)par_address, (int)par_size);
+        error = ESP_OK;
+    } else if (errQUEUE_FULL == status) {
+        ESP_LOGD(TAG, "Parameter queue is overflowed.");
+    }
+    return error;
+}
+
+// Helper function to send notification
+static esp_err_t mbc_slave_send_param_access_notification(void *ctx, mb_event_group_t event)
+{
+    MB_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_STATE, TAG,
+                        "Slave interface is not correctly initialized.");
+    mb_slave_options_t *mbs_opts = MB_SLAVE_GET_OPTS(ctx);
+    esp_err_t err = ESP_FAIL;
+    mb_event_group_t bits = (mb_event_group_t)xEventGroupSetBits(mbs_opts->event_group_handle, (EventBits_t)event);
+    if (bits & event) {
+        ESP_LOGD(TAG, "The MB_REG_CHANGE_EVENT = 0x%.2x is set.", (int)event);
+        err = ESP_OK;
+    }
+    return err;
+}
+
+/*
+ * Below are the common slave read/write register callback functions
+ * The concrete slave port can override them using interface function pointers
+ */
+
+// Callback function for reading of MB Input Registers
+mb_err_enum_t mbc_reg_input_slave_cb(mb_base_t *inst, uint8_t *reg_buffer, uint16_t address, uint16_t n_regs)
+{
+    void *ctx = (void *)MB_SLAVE_GET_IFACE_FROM_BASE(inst);
+    MB_RETURN_ON_FALSE(reg_buffer, MB_EINVAL, TAG, "Slave stack call failed.");
+    mb_err_enum_t status = MB_ENOERR;
+    address--; // address of register is already +1
+#if CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE
+    uint8_t *cached_start = NULL;
+    uint32_t cache_generation = 0;
+    if (mbc_slave_cache_get(ctx, inst, MB_PARAM_INPUT, address, n_regs, reg_buffer, &cached_start, &cache_generation)) {
+        (void)mbc_slave_send_param_access_notification(ctx, MB_EVENT_INPUT_REG_RD);
+        (void)mbc_slave_send_param_info(ctx, MB_EVENT_INPUT_REG_RD, address, cached_start, n_regs);
+        return MB_ENOERR;
+    }
+#endif
+    mb_descr_entry_t *it = mbc_slave_find_reg_descriptor(ctx, MB_PARAM_INPUT, address, n_regs);
+    if (it) {
+        uint16_t input_reg_start = it->start_offset; // Get Modbus start address
+        uint16_t reg_index;
+        uint32_t seq = 0;
+        // If input or configuration parameters are incorrect then return an error to stack layer
+        reg_index = (uint16_t)(address - input_reg_start);
+        reg_index <<= 1; // register Address to byte address
+        // The parameter info refers to the instance address even if the area is published
+        uint8_t *buffer_start = (uint8_t *)it->p_data + reg_index;
+        do {
+            uint8_t *input_buffer = mbc_slave_read_begin(inst, it, &seq) + reg_index; // Get instance address
+            uint8_t *data_buffer = reg_buffer;
+            uint16_t regs = n_regs;
+            while (regs > 0) {
+                _XFER_2_RD(data_buffer, input_buffer);
+                regs -= 1;
+            }
+        } while (!mbc_slave_read_end(inst, it, seq));
+#if CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE
+        mbc_slave_cache_put(ctx, inst, MB_PARAM_INPUT, address, n_regs, reg_buffer, buffer_start, cache_generation);
+#endif
+        // Send access notification
+        (void)mbc_slave_send_param_access_notification(ctx, MB_EVENT_INPUT_REG_RD);
+        // Send parameter info to application task
+        (void)mbc_slave_send_param_info(ctx, MB_EVENT_INPUT_REG_RD, address, buffer_start, n_regs);
+    } else {
+        status = MB_ENOREG;
+    }
+    return status;
+}
+
+// Callback function for reading of MB Holding Registers
+// Executed by stack when request to read/write holding registers is received
+mb_err_enum_t mbc_reg_holding_slave_cb(mb_base_t *inst, uint8_t *reg_buffer, uint16_t address, uint16_t n_regs, mb_reg_mode_enum_t mode)
+{
+    void *ctx = (void *)MB_SLAVE_GET_IFACE_FROM_BASE(inst);
+    MB_RETURN_ON_FALSE(reg_buffer, MB_EINVAL, TAG, "Slave stack call failed.");
+    mb_err_enum_t status = MB_ENOERR;
+    uint16_t reg_index;
+    address--; // address of register is already +1
+#if CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE
+    uint8_t *cached_start = NULL;
+    uint32_t cache_generation = 0;
+    if ((mode == MB_REG_READ)
+            && mbc_slave_cache_get(ctx, inst, MB_PARAM_HOLDING, address, n_regs, reg_buffer, &cached_start, &cache_generation)) {
+        (void)mbc_slave_send_param_access_notification(ctx, MB_EVENT_HOLDING_REG_RD);
+        (void)mbc_slave_send_param_info(ctx, MB_EVENT_HOLDING_REG_RD, address, cached_start, n_regs);
+        return MB_ENOERR;
+    }
+#endif
+    mb_descr_entry_t *it = mbc_slave_find_reg_descriptor(ctx, MB_PARAM_HOLDING, address, n_regs);
+    if (it) {
+        uint16_t reg_holding_start = it->start_offset; // Get Modbus start address
+        uint8_t *holding_buffer = it->p_data; // Get instance address
+        uint16_t regs = n_regs;
+        reg_index = (uint16_t) (address - reg_holding_start);
+        reg_index <<= 1; // register Address to byte address
+        holding_buffer += reg_index;
+        uint8_t *buffer_start = holding_buffer;
+        switch (mode) {
+            case MB_REG_READ:
+                if (it->access != MB_ACCESS_WO) {
+                    uint32_t seq = 0;
+                    do {
+                        holding_buffer = mbc_slave_read_begin(inst, it, &seq) + reg_index;
+                        uint8_t *data_buffer = reg_buffer;
+                        regs = n_regs;
+                        while (regs > 0) {
+                            _XFER_2_RD(data_buffer, holding_buffer);
+                            regs -= 1;
+                        };
+                    } while (!mbc_slave_read_end(inst, it, seq));
+#if CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE
+                    mbc_slave_cache_put(ctx, inst, MB_PARAM_HOLDING, address, n_regs, reg_buffer, buffer_start, cache_generation);
+#endif
+                    // Send access notification
+                    (void)mbc_slave_send_param_access_notification(ctx, MB_EVENT_HOLDING_REG_RD);
+                    // Send parameter info
+                    (void)mbc_slave_send_param_info(ctx, MB_EVENT_HOLDING_REG_RD, address, buffer_start, n_regs);
+                } else {
+                    status = MB_EINVAL;
+                }
+                break;
+            case MB_REG_WRITE:
+                if (it->access != MB_ACCESS_RO) {
+                    CRITICAL_SECTION(inst->lock)
+                    {
+                        while (regs > 0) {
+                            _XFER_2_WR(holding_buffer, reg_buffer);
+                            holding_buffer += 2;
+                            reg_index += 2;
+                            regs -= 1;
+                        };
+#if CONFIG_FMB_CONTROLLER_SLAVE_CHANGE_TRACKING
+                        mbc_slave_set_dirty(it, (address - reg_holding_start), n_regs);
+#endif
+#if CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE
+                        mbc_slave_cache_invalidate(ctx, MB_PARAM_HOLDING, address, n_regs);
+#endif
+                    }
+                    // Send access notification
+                    (void)mbc_slave_send_param_access_notification(ctx, MB_EVENT_HOLDING_REG_WR);
+#if !CONFIG_FMB_CONTROLLER_SLAVE_CHANGE_TRACKING
+                    // Send parameter info
+                    (void)mbc_slave_send_param_info(ctx, MB_EVENT_HOLDING_REG_WR, address, buffer_start, n_regs);
+#endif
+                } else {
+                    status = MB_EINVAL;
+                }
+                break;
+        }
+    } else {
+        status = MB_ENOREG;
+    }
+    return status;
+}
+
+// Callback function for reading of MB Coils Registers
+mb_err_enum_t mbc_reg_coils_slave_cb(mb_base_t *inst, uint8_t *reg_buffer, uint16_t address, uint16_t n_coils, mb_reg_mode_enum_t mode)
+{
+    void *ctx =(void *)MB_SLAVE_GET_IFACE_FROM_BASE(inst);
+    MB_RETURN_ON_FALSE(ctx, MB_EILLSTATE, TAG, "Slave stack uninitialized.");
+    MB_RETURN_ON_FALSE(reg_buffer, MB_EINVAL, TAG, "Slave stack call failed.");
+    mb_err_enum_t status = MB_ENOERR;
+    uint16_t reg_index;
+    uint16_t coils = n_coils;
+    address--; // The address is already +1
+    mb_descr_entry_t *it = mbc_slave_find_reg_descriptor(ctx, MB_PARAM_COIL, address, n_coils);
+    if (it) {
+        uint16_t reg_coils_start = it->start_offset; // MB offset of coils
+        uint8_t *reg_coils_buf = it->p_data;
+        reg_index = (uint16_t) (address - it->start_offset);
+        char *coils_data_buf = (char *)(reg_coils_buf + (reg_index >> 3));
+        switch (mode) {
+                case MB_REG_READ:
+                if (it->access != MB_ACCESS_WO) {
+                    uint32_t seq = 0;
+                    do {
+                        reg_coils_buf = mbc_slave_read_begin(inst, it, &seq);
+                        reg_index = (uint16_t)(address - reg_coils_start);
+                        coils = n_coils;
+                        while (coils > 0) {
+                            uint8_t result = mb_util_get_bits(reg_coils_buf, reg_index, 1);
+                            mb_util_set_bits(reg_buffer, reg_index - (address - reg_coils_start), 1, result);
+                            reg_index++;
+                            coils--;
+                        }
+                    } while (!mbc_slave_read_end(inst, it, seq));
+                    // Send an event to notify application task about event
+                    (void)mbc_slave_send_param_access_notification(ctx, MB_EVENT_COILS_RD);
+                    (void)mbc_slave_send_param_info(ctx, MB_EVENT_COILS_RD, address,
+                                                        (uint8_t *)(coils_data_buf), n_coils);
+                } else {
+                    status = MB_EINVAL;
+                }
+                break;
+            case MB_REG_WRITE:
+                if (it->access != MB_ACCESS_RO) {
+                    CRITICAL_SECTION(inst->lock)
+                    {
+                        while (coils > 0) {
+                            uint8_t result = mb_util_get_bits(reg_buffer,
+                                    reg_index - (address - reg_coils_start), 1);
+                            mb_util_set_bits(reg_coils_buf, reg_index, 1, result);
+                            reg_index++;
+                            coils--;
+                        }
+#if CONFIG_FMB_CONTROLLER_SLAVE_CHANGE_TRACKING
+                        mbc_slave_set_dirty(it, (address - reg_coils_start), n_coils);
+#endif
+                    }
+                    // Send an event to notify application task about event
+                    (void)mbc_slave_send_param_access_notification(ctx, MB_EVENT_COILS_WR);
+#if !CONFIG_FMB_CONTROLLER_SLAVE_CHANGE_TRACKING
+                    (void)mbc_slave_send_param_info(ctx, MB_EVENT_COILS_WR, address,
+                                                        (uint8_t *)coils_data_buf, n_coils);
+#endif
+                } else {
+                    status = MB_EINVAL;
+                }
+                break;
+        } // switch ( mode )
+    } else {
+        // If the configuration or input parameters are incorrect then return error to stack
+        status = MB_ENOREG;
+    }
+    return status;
+}
+
+// Callback function for reading of MB Discrete Input Registers
+mb_err_enum_t mbc_reg_discrete_slave_cb(mb_base_t *inst, uint8_t *reg_buffer, uint16_t address, uint16_t n_discrete)
+{
+    void *ctx = (void *)MB_SLAVE_GET_IFACE_FROM_BASE(inst);
+    MB_RETURN_ON_FALSE(reg_buffer, MB_EINVAL, TAG, "Slave stack call failed.");
+    mb_err_enum_t status = MB_ENOERR;
+    uint16_t reg_index;
+    uint16_t reg_bit_index;
+    uint16_t n_reg;
+    uint8_t *discrete_input_buf;
+    // It already plus one in modbus function method.
+    address--;
+    mb_descr_entry_t *it = mbc_slave_find_reg_descriptor(ctx, MB_PARAM_DISCRETE, address, n_discrete);
+    if (it) {
+        uint16_t reg_discrete_start = it->start_offset; // MB offset of registers
+        n_reg = (n_discrete >> 3) + 1;
+        discrete_input_buf = (uint8_t *)it->p_data; // the storage address
+        reg_index = (uint16_t) (address - reg_discrete_start) / 8; // Get register index in the buffer for bit number
+        reg_bit_index = (uint16_t)(address - reg_discrete_start) % 8; // Get bit index
+        uint8_t *temp_buf = &discrete_input_buf[reg_index];
+        uint8_t *data_buffer = NULL;
+        uint32_t seq = 0;
+        do {
+            discrete_input_buf = mbc_slave_read_begin(inst, it, &seq);
+            data_buffer = reg_buffer;
+            for (uint16_t i = 0; i < n_reg; i++) {
+                *data_buffer++ = mb_util_get_bits(&discrete_input_buf[reg_index + i], reg_bit_index, 8);
+            }
+        } while (!mbc_slave_read_end(inst, it, seq));
+        reg_buffer = data_buffer - 1;
+        // Last discrete
+        n_discrete = n_discrete % 8;
+        // Filling zero to high bit
+        *reg_buffer = *reg_buffer << (8 - n_discrete);
+        *reg_buffer = *reg_buffer >> (8 - n_discrete);
+        // Send an event to notify application task about event
+        (void)mbc_slave_send_param_access_notification(ctx, MB_EVENT_DISCRETE_RD);
+        (void)mbc_slave_send_param_info(ctx, MB_EVENT_DISCRETE_RD, address, temp_buf, n_discrete);
+    } else {
+        status = MB_ENOREG;
+    }
+    return status;
+}
@@ -198,6 +198,14 @@ typedef union
 #endif
 } mb_communication_info_t;
 
+/**
+ * @brief Statistics of the value cache of the master or the response cache of the slave
+ */
+typedef struct {
+    uint32_t hit_count;             /*!< Number of reads answered from the cache */
+    uint32_t miss_count;            /*!< Number of reads of the cached data done without the cache */
+} mb_cache_stats_t;
+
 /**
  * common interface method types
  */
@@ -267,6 +275,37 @@ esp_err_t mbc_delete_handler(void *ctx, uint8_t func_code);
 */
 esp_err_t mbc_get_handler_count(void *ctx, uint16_t *count);
 
+/**
+ * @brief The function gets the transaction statistics of the controller object.
+ *
+ * The statistics are collected by the port of the controller when CONFIG_FMB_PORT_STATS_ENABLE is set.
+ * The latency percentiles are the upper bounds of the histogram buckets which hold them.
+ *
+ * @param[in] ctx context pointer to the controller object (master or slave)
+ * @param[in] group the group of the statistics (total, per node or per function)
+ * @param[out] info the array of entries to fill, NULL to get the number of entries only
+ * @param[in] max_count the size of the array
+ * @param[out] count the pointer to the number of entries in the group, can be more than max_count
+ *
+ * @return
+ *     - esp_err_t ESP_OK - the statistics are returned
+ *     - esp_err_t ESP_ERR_NOT_SUPPORTED - the statistics are disabled in the configuration
+ *       esp_err_t ESP_ERR_INVALID_STATE - incorrect arguments or configuration
+*/
+esp_err_t mbc_get_stats(void *ctx, mb_stats_group_t group, mb_stats_info_t *info, uint16_t max_count, uint16_t *count);
+
+/**
+ * @brief The function clears the transaction statistics of the controller object.
+ *
+ * @param[in] ctx context pointer to the controller object (master or slave)
+ *
+ * @return
+ *     - esp_err_t ESP_OK - the statistics are cleared
+ *     - esp_err_t ESP_ERR_NOT_SUPPORTED - the statistics are disabled in the configuration
+ *       esp_err_t ESP_ERR_INVALID_STATE - incorrect arguments or configuration
+*/
+esp_err_t mbc_reset_stats(void *ctx);
+
 #ifdef __cplusplus
 }
 #endif
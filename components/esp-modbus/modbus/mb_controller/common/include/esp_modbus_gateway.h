@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+// Public interface header for the gateway between the TCP slave and the serial master
+#include <stdint.h>                 // for standard int types definition
+#include <stddef.h>                 // for NULL and std defines
+#include "esp_err.h"                // for error handling
+#include "esp_modbus_common.h"      // for common types
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Route of the gateway from the unit of the TCP request to the slave on the serial bus
+ */
+typedef struct {
+    uint8_t unit_id;                /*!< Unit identifier in the MBAP header of the TCP request */
+    uint8_t slave_addr;             /*!< Address of the slave on the serial bus */
+} mb_gateway_route_t;
+
+/**
+ * @brief Bus transfer function of the gateway
+ *
+ * Sends the request PDU to the slave and receives its response PDU, the response may be an exception
+ * response (function code | 0x80, exception code). The function is called from the gateway task
+ * only, so the transfers on the bus never overlap.
+ *
+ * @param[in] arg the transfer argument of the gateway configuration
+ * @param[in] slave_addr address of the slave on the bus
+ * @param[in] request the request PDU (function code and data)
+ * @param[in] request_len length of the request PDU
+ * @param[out] response the buffer of MB_GATEWAY_PDU_SIZE_MAX bytes for the response PDU
+ * @param[out] response_len length of the response PDU
+ *
+ * @return
+ *     - ESP_OK the response is received
+ *     - ESP_ERR_TIMEOUT the slave does not respond, the gateway target failed exception is returned
+ *     - other errors, the slave device failure exception is returned
+ */
+typedef esp_err_t (*mb_gateway_transfer_fp)(void *arg, uint8_t slave_addr, const uint8_t *request, uint16_t request_len,
+                                            uint8_t *response, uint16_t *response_len);
+
+#define MB_GATEWAY_PDU_SIZE_MAX     (253)   /*!< Maximum size of the request and response PDU */
+
+/**
+ * @brief Gateway configuration
+ */
+typedef struct {
+    void *slave_handle;                 /*!< TCP slave which accepts the requests of the clients */
+    void *master_handle;                /*!< Serial master which owns the bus, used by the default transfer and for the default response timeout */
+    const mb_gateway_route_t *routes;   /*!< Table of the routes, the units without the route are answered with the gateway path exception */
+    uint16_t route_count;               /*!< Number of the routes */
+    uint32_t response_tout_ms;          /*!< Maximum time the request waits for the bus (0 - the response timeout of the master or CONFIG_FMB_MASTER_TIMEOUT_MS_RESPOND) */
+    mb_gateway_transfer_fp transfer;    /*!< Bus transfer function, NULL - send the requests through the master */
+    void *transfer_arg;                 /*!< Argument of the transfer function */
+} mb_gateway_config_t;
+
+/**
+ * @brief Gateway statistics
+ */
+typedef struct {
+    uint32_t request_count;             /*!< Number of the requests received from the TCP clients */
+    uint32_t transfer_count;            /*!< Number of the transactions on the serial bus */
+    uint32_t merged_count;              /*!< Number of the requests answered by the transaction of the identical read */
+    uint32_t prefetch_count;            /*!< Number of the queued reads sent to the bus before the slave processed them */
+    uint32_t error_count;               /*!< Number of the requests answered with the gateway exception */
+    uint64_t busy_time_us;              /*!< Time the bus spent in the transactions */
+    uint64_t gap_time_us;               /*!< Time the bus was idle while the transactions waited for it */
+} mb_gateway_stats_t;
+
+/**
+ * @brief Create the gateway which forwards the requests of the TCP slave to the serial bus
+ *
+ * The gateway takes the register read and write functions (0x01 - 0x06, 0x0F, 0x10) of the TCP slave
+ * and accepts the requests of all units. The requests of the clients are put to the bus one at a time
+ * in the order of receiving. The reads waiting in the queue of the TCP slave are started on the bus
+ * ahead of time, so the bus does not wait for the slave to send the responses, and the identical reads
+ * waiting at the same time are answered by one transaction. The reads are not started ahead of the queued
+ * writes, the response to the read always reflects the writes received before it.
+ * The slave needs CONFIG_FMB_TCP_UID_ENABLED to route the requests to several units.
+ *
+ * @param[in] config the gateway configuration
+ * @param[out] handle the handle of the gateway
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_ERR_INVALID_ARG invalid argument of function
+ *     - ESP_ERR_INVALID_STATE the slave already has the gateway
+ *     - ESP_ERR_NO_MEM not enough memory
+ */
+esp_err_t mbc_gateway_create(const mb_gateway_config_t *config, void **handle);
+
+/**
+ * @brief Delete the gateway and restore the function handlers of the TCP slave
+ *
+ * The clients have to be disconnected or the slave stopped before the gateway is deleted.
+ *
+ * @param[in] handle the handle of the gateway
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_ERR_INVALID_ARG invalid argument of function
+ */
+esp_err_t mbc_gateway_delete(void *handle);
+
+/**
+ * @brief Get the statistics of the gateway
+ *
+ * @param[in] handle the handle of the gateway
+ * @param[out] stats the statistics
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_ERR_INVALID_ARG invalid argument of function
+ */
+esp_err_t mbc_gateway_get_stats(void *handle, mb_gateway_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
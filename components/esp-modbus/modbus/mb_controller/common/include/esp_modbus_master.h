@@ -161,7 +161,7 @@ typedef enum {
  * link it with Modbus parameters that reflect its data.
  */
 typedef struct {
-    uint16_t            cid;                /*!< Characteristic cid */
+    uint16_t            cid;                /*!< Characteristic cid, unique in the table (0xFFFF is reserved) */
     const char *        param_key;          /*!< The key (name) of the parameter */
     const char *        param_units;        /*!< The physical units of the parameter */
     uint8_t             mb_slave_addr;      /*!< Slave address of device in the Modbus segment */
@@ -173,6 +173,7 @@ typedef struct {
     size_t              param_size;         /*!< Number of bytes in the parameter. */
     mb_parameter_opt_t  param_opts;         /*!< Parameter options used to check limits and etc. */
     mb_param_perms_t    access;             /*!< Access permissions based on mode */
+    uint32_t            max_age_ms;         /*!< Maximum age of the cached value (ms), 0 - the value is not cached */
 } mb_parameter_descriptor_t;
 
 /**
@@ -185,6 +186,19 @@ typedef struct {
     uint16_t reg_size;              /*!< Modbus number of registers */
 } mb_param_request_t;
 
+/**
+ * @brief Modbus characteristic read by mbc_master_get_parameters()
+ */
+typedef struct {
+    uint16_t cid;                   /*!< Characteristic cid to read */
+    uint8_t *value;                 /*!< Pointer to data buffer of parameter */
+    uint8_t type;                   /*!< Parameter type returned from the parameter description table */
+    esp_err_t error;                /*!< Result of the read for this characteristic */
+} mb_param_poll_t;
+
+#define MB_CACHE_CID_ALL (0xFFFF)   /*!< Invalidate the cached values of all characteristics */
+#define MB_PARAM_CID_NONE (0xFFFF)  /*!< The cid of the characteristic which is not found */
+
 /**
  * @brief Initialize Modbus controller and stack for TCP port
  *
@@ -319,6 +333,39 @@ esp_err_t mbc_master_send_request(void *ctx, mb_param_request_t *request, void *
 */
 esp_err_t mbc_master_get_cid_info(void *ctx, uint16_t cid, const mb_parameter_descriptor_t** param_info);
 
+/**
+ * @brief Get the cid of characteristic by its key (param_key field of the parameter description table).
+ *        The controller keeps the hash index of the keys built when the table is set,
+ *        so the lookup does not depend on the table size.
+ *
+ * @param[in] ctx context pointer of the initialized modbus interface
+ * @param[in] key the key (name) of the characteristic
+ * @param[out] cid the cid of characteristic
+ *
+ * @return
+ *     - esp_err_t ESP_OK - the characteristic is found
+ *     - esp_err_t ESP_ERR_INVALID_ARG - invalid argument of function
+ *     - esp_err_t ESP_ERR_INVALID_STATE - the master interface is not initialized
+ *     - esp_err_t ESP_ERR_NOT_FOUND - the characteristic with the key is not found
+*/
+esp_err_t mbc_master_get_cid_by_key(void *ctx, const char *key, uint16_t *cid);
+
+/**
+ * @brief Get the cids of the set of characteristics by their keys.
+ *
+ * @param[in] ctx context pointer of the initialized modbus interface
+ * @param[in] keys the array of keys
+ * @param[out] cids the array of cids, MB_PARAM_CID_NONE is set for the key which is not found
+ * @param[in] count number of keys in the array
+ *
+ * @return
+ *     - esp_err_t ESP_OK - all characteristics are found
+ *     - esp_err_t ESP_ERR_INVALID_ARG - invalid argument of function
+ *     - esp_err_t ESP_ERR_INVALID_STATE - the master interface is not initialized
+ *     - esp_err_t ESP_ERR_NOT_FOUND - one or more keys are not found
+*/
+esp_err_t mbc_master_get_cids_by_keys(void *ctx, const char **keys, uint16_t *cids, uint16_t count);
+
 /**
  * @brief Read parameter from modbus slave device whose name is defined by name and has cid.
  *        The additional data for request is taken from parameter description (lookup) table.
@@ -342,6 +389,57 @@ esp_err_t mbc_master_get_cid_info(void *ctx, uint16_t cid, const mb_parameter_de
 */
 esp_err_t mbc_master_get_parameter(void *ctx, uint16_t cid, uint8_t *value, uint8_t *type);
 
+/**
+ * @brief Read the set of parameters from modbus slave devices defined in the parameter description table.
+ *        The TCP master sends the requests to the different slaves at the same time, so the time
+ *        to read the set is defined by the slowest slave instead of the sum of the response times.
+ *        The requests to the same slave are limited by CONFIG_FMB_TCP_MASTER_INFLIGHT_MAX.
+ *        The serial master reads the parameters one after another.
+ *        The parameters placed in the neighbouring registers of one slave are read with one request
+ *        planned when the table is set (see CONFIG_FMB_MASTER_READ_PLAN_ENABLE).
+ *
+ * @param[in] ctx context pointer of the initialized modbus interface
+ * @param[in,out] params array of characteristics to read, the result of each read is set in its error field
+ * @param[in] count number of items in the params array
+ *
+ * @return
+ *     - esp_err_t ESP_OK - all parameters are read successfully
+ *     - esp_err_t ESP_ERR_INVALID_ARG - invalid argument of function
+ *     - esp_err_t ESP_ERR_INVALID_STATE - the master interface is not initialized or started
+ *     - esp_err_t other - the error of the first parameter which failed, see mbc_master_get_parameter()
+*/
+esp_err_t mbc_master_get_parameters(void *ctx, mb_param_poll_t *params, uint16_t count);
+
+/**
+ * @brief Invalidate the cached value of the characteristic, the next read is sent to the slave.
+ *        The values are cached for the characteristics with non zero max_age_ms field in the
+ *        parameter description table. The value younger than max_age_ms is returned by
+ *        mbc_master_get_parameter() and mbc_master_get_parameters() without the request to slave.
+ *        The write of characteristic invalidates its value.
+ *
+ * @param[in] ctx context pointer of the initialized modbus interface
+ * @param[in] cid id of the characteristic or MB_CACHE_CID_ALL to invalidate all values
+ *
+ * @return
+ *     - esp_err_t ESP_OK - the value is invalidated
+ *     - esp_err_t ESP_ERR_INVALID_STATE - the master interface is not initialized
+ *     - esp_err_t ESP_ERR_NOT_FOUND - the characteristic is not found in the parameter description table
+*/
+esp_err_t mbc_master_invalidate_cache(void *ctx, uint16_t cid);
+
+/**
+ * @brief Get the hit and miss counters of the parameter value cache
+ *
+ * @param[in] ctx context pointer of the initialized modbus interface
+ * @param[out] stats the counters of cache
+ *
+ * @return
+ *     - esp_err_t ESP_OK - the counters are returned
+ *     - esp_err_t ESP_ERR_INVALID_ARG - invalid argument of function
+ *     - esp_err_t ESP_ERR_INVALID_STATE - the master interface is not initialized
+*/
+esp_err_t mbc_master_get_cache_stats(void *ctx, mb_cache_stats_t *stats);
+
 /**
  * @brief Read parameter from modbus slave device whose name is defined by name and has cid.
  *        The additional data for request is taken from parameter description (lookup) table.
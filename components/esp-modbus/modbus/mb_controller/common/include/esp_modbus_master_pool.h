@@ -0,0 +1,259 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+// Public interface header for the pool of the masters which serve several buses
+#include <stdint.h>                 // for standard int types definition
+#include <stddef.h>                 // for NULL and std defines
+#include "esp_err.h"                // for error handling
+#include "esp_modbus_common.h"      // for common types
+#include "esp_modbus_master.h"      // for master types
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Bus of the master pool
+ */
+typedef struct {
+    void *master_handle;                /*!< Master which owns the bus, created and started by the application */
+    const uint8_t *slave_addrs;         /*!< Addresses of the slaves on the bus, the requests to them are routed to this bus */
+    uint16_t slave_count;               /*!< Number of the addresses */
+} mb_master_pool_bus_t;
+
+/**
+ * @brief Master pool configuration
+ */
+typedef struct {
+    const mb_master_pool_bus_t *buses;  /*!< Table of the buses */
+    uint16_t bus_count;                 /*!< Number of the buses */
+} mb_master_pool_config_t;
+
+/**
+ * @brief Completion callback of the asynchronous request of the pool
+ *
+ * The callback is called from the task of the bus, it must not block and must not wait
+ * for other requests of the same bus.
+ *
+ * @param[in] arg the argument given with the request
+ * @param[in] error the result of the request, see mbc_master_send_request() and mbc_master_get_parameter()
+ */
+typedef void (*mb_master_pool_done_fp)(void *arg, esp_err_t error);
+
+/**
+ * @brief Create the pool which routes the requests to the masters of several buses
+ *
+ * Each bus has its own task which takes the requests of the bus from its queue and sends them
+ * through the master of the bus one after another, so the buses work at the same time and the
+ * requests to the slaves of the different buses do not wait for each other. The requests
+ * to the slave address are routed by the table of the buses, the requests to the characteristic
+ * are routed to the master which has the cid in its parameter description table. The pool does
+ * not own the masters, they are created, started and deleted by the application and are not
+ * used directly while the pool exists.
+ *
+ * @param[in] config the pool configuration, the address tables are copied
+ * @param[out] handle the handle of the pool
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_ERR_INVALID_ARG invalid argument of function or the address is routed to several buses
+ *     - ESP_ERR_NO_MEM not enough memory
+ *     - ESP_ERR_INVALID_STATE the task of the bus can not be created
+ */
+esp_err_t mbc_master_pool_create(const mb_master_pool_config_t *config, void **handle);
+
+/**
+ * @brief Delete the pool
+ *
+ * The requests in the queues are completed before the tasks of the buses exit.
+ * The masters stay as they are and get back the parameter description tables they had before
+ * the table of the pool was set, the master without the previous table has no table.
+ *
+ * @param[in] handle the handle of the pool
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_ERR_INVALID_ARG invalid argument of function
+ */
+esp_err_t mbc_master_pool_delete(void *handle);
+
+/**
+ * @brief Set the parameter description table of the pool
+ *
+ * The table is split by the slave address of the characteristics, each master gets the part
+ * of its bus. The table is copied, it is set before the characteristics are read
+ * and is not changed while the requests are in the queues. If a master rejects its part,
+ * the masters get back their previous tables and the table of the pool stays unset.
+ *
+ * @param[in] handle the handle of the pool
+ * @param[in] descriptor the table of the characteristics of all buses
+ * @param[in] num_elements number of the characteristics
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_ERR_INVALID_ARG invalid argument of function
+ *     - ESP_ERR_NOT_FOUND the slave address of the characteristic is not routed to the bus
+ *     - ESP_ERR_INVALID_STATE the table of the pool is already set
+ *     - ESP_ERR_NO_MEM not enough memory
+ *     - other errors of mbc_master_set_descriptor()
+ */
+esp_err_t mbc_master_pool_set_descriptor(void *handle, const mb_parameter_descriptor_t *descriptor, uint16_t num_elements);
+
+/**
+ * @brief Send the request to the slave through the master of its bus and wait for the result
+ *
+ * @param[in] handle the handle of the pool
+ * @param[in] request the request, the slave address selects the bus
+ * @param[in,out] data_ptr the data of the request, see mbc_master_send_request()
+ *
+ * @return
+ *     - ESP_ERR_NOT_FOUND the slave address is not routed to the bus
+ *     - other results of mbc_master_send_request()
+ */
+esp_err_t mbc_master_pool_send_request(void *handle, mb_param_request_t *request, void *data_ptr);
+
+/**
+ * @brief Queue the request to the slave and return without waiting for the result
+ *
+ * The request is copied, the data buffer is used until the callback is called.
+ *
+ * @param[in] handle the handle of the pool
+ * @param[in] request the request, the slave address selects the bus
+ * @param[in,out] data_ptr the data of the request, see mbc_master_send_request()
+ * @param[in] done_cb the callback called with the result
+ * @param[in] done_arg the argument of the callback
+ *
+ * @return
+ *     - ESP_OK the request is queued, the result is passed to the callback
+ *     - ESP_ERR_INVALID_ARG invalid argument of function
+ *     - ESP_ERR_NOT_FOUND the slave address is not routed to the bus
+ *     - ESP_ERR_NO_MEM the queue of the bus is full (see CONFIG_FMB_CONTROLLER_POOL_QUEUE_SIZE)
+ */
+esp_err_t mbc_master_pool_send_request_async(void *handle, mb_param_request_t *request, void *data_ptr,
+                                                mb_master_pool_done_fp done_cb, void *done_arg);
+
+/**
+ * @brief Read the characteristic through the master which has it in its table and wait for the result
+ *
+ * @param[in] handle the handle of the pool
+ * @param[in] cid id of the characteristic
+ * @param[out] value pointer to data buffer of parameter
+ * @param[out] type parameter type from the parameter description table, can be NULL
+ *
+ * @return
+ *     - ESP_ERR_NOT_FOUND the characteristic is not found in the tables of the masters
+ *     - other results of mbc_master_get_parameter()
+ */
+esp_err_t mbc_master_pool_get_parameter(void *handle, uint16_t cid, uint8_t *value, uint8_t *type);
+
+/**
+ * @brief Queue the read of the characteristic and return without waiting for the result
+ *
+ * The value buffer is used until the callback is called.
+ *
+ * @param[in] handle the handle of the pool
+ * @param[in] cid id of the characteristic
+ * @param[out] value pointer to data buffer of parameter
+ * @param[in] done_cb the callback called with the result
+ * @param[in] done_arg the argument of the callback
+ *
+ * @return
+ *     - ESP_OK the read is queued, the result is passed to the callback
+ *     - ESP_ERR_INVALID_ARG invalid argument of function
+ *     - ESP_ERR_NOT_FOUND the characteristic is not found in the tables of the masters
+ *     - ESP_ERR_NO_MEM the queue of the bus is full
+ */
+esp_err_t mbc_master_pool_get_parameter_async(void *handle, uint16_t cid, uint8_t *value,
+                                                mb_master_pool_done_fp done_cb, void *done_arg);
+
+/**
+ * @brief Write the characteristic through the master which has it in its table and wait for the result
+ *
+ * @param[in] handle the handle of the pool
+ * @param[in] cid id of the characteristic
+ * @param[in] value pointer to data buffer of parameter
+ * @param[out] type parameter type from the parameter description table, can be NULL
+ *
+ * @return
+ *     - ESP_ERR_NOT_FOUND the characteristic is not found in the tables of the masters
+ *     - other results of mbc_master_set_parameter()
+ */
+esp_err_t mbc_master_pool_set_parameter(void *handle, uint16_t cid, uint8_t *value, uint8_t *type);
+
+/**
+ * @brief Queue the write of the characteristic and return without waiting for the result
+ *
+ * The value buffer is used until the callback is called.
+ *
+ * @param[in] handle the handle of the pool
+ * @param[in] cid id of the characteristic
+ * @param[in] value pointer to data buffer of parameter
+ * @param[in] done_cb the callback called with the result
+ * @param[in] done_arg the argument of the callback
+ *
+ * @return
+ *     - ESP_OK the write is queued, the result is passed to the callback
+ *     - ESP_ERR_INVALID_ARG invalid argument of function
+ *     - ESP_ERR_NOT_FOUND the characteristic is not found in the tables of the masters
+ *     - ESP_ERR_NO_MEM the queue of the bus is full
+ */
+esp_err_t mbc_master_pool_set_parameter_async(void *handle, uint16_t cid, uint8_t *value,
+                                                mb_master_pool_done_fp done_cb, void *done_arg);
+
+/**
+ * @brief Read the set of characteristics of all buses at once
+ *
+ * The characteristics are split by the bus, each bus reads its part with mbc_master_get_parameters(),
+ * so the time to read the set is defined by the slowest bus instead of the sum of the bus times.
+ *
+ * @param[in] handle the handle of the pool
+ * @param[in,out] params array of characteristics to read, the result of each read is set in its error field
+ * @param[in] count number of items in the params array
+ *
+ * @return
+ *     - esp_err_t ESP_OK - all parameters are read successfully
+ *     - esp_err_t ESP_ERR_INVALID_ARG - invalid argument of function
+ *     - esp_err_t ESP_ERR_NO_MEM - not enough memory
+ *     - esp_err_t other - the error of the first parameter which failed, see mbc_master_get_parameter()
+ */
+esp_err_t mbc_master_pool_get_parameters(void *handle, mb_param_poll_t *params, uint16_t count);
+
+/**
+ * @brief Get the transaction statistics of all buses as one
+ *
+ * The counters and latency histograms of the masters are added up, see mbc_get_stats().
+ *
+ * @param[in] handle the handle of the pool
+ * @param[in] group the group of the statistics (total, per node or per function)
+ * @param[out] info the array of entries to fill, NULL to get the number of entries only
+ * @param[in] max_count the size of the array
+ * @param[out] count the pointer to the number of entries in the group, can be more than max_count
+ *
+ * @return
+ *     - esp_err_t ESP_OK - the statistics are returned
+ *     - esp_err_t ESP_ERR_INVALID_ARG - invalid argument of function
+ *     - esp_err_t ESP_ERR_NOT_SUPPORTED - the statistics are disabled in the configuration
+ */
+esp_err_t mbc_master_pool_get_stats(void *handle, mb_stats_group_t group, mb_stats_info_t *info,
+                                    uint16_t max_count, uint16_t *count);
+
+/**
+ * @brief Clear the transaction statistics of all buses
+ *
+ * @param[in] handle the handle of the pool
+ *
+ * @return
+ *     - esp_err_t ESP_OK - the statistics are cleared
+ *     - esp_err_t ESP_ERR_INVALID_ARG - invalid argument of function
+ *     - esp_err_t ESP_ERR_NOT_SUPPORTED - the statistics are disabled in the configuration
+ */
+esp_err_t mbc_master_pool_reset_stats(void *handle);
+
+#ifdef __cplusplus
+}
+#endif
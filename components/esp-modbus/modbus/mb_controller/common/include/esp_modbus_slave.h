@@ -133,6 +133,7 @@ esp_err_t mbc_slave_lock(void *ctx);
 
 /**
  * @brief Critical section unlock for parameter access
+ *        The cached read responses are dropped if CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE is set.
  *
  * @param[in] ctx pointer to slave handle (modbus interface)
  * @return
@@ -189,6 +190,59 @@ mb_event_group_t mbc_slave_check_event(void *ctx, mb_event_group_t group);
  */
 esp_err_t mbc_slave_get_param_info(void *ctx, mb_param_info_t *reg_info, uint32_t timeout);
 
+/**
+ * @brief Get the ranges of holding registers and coils written by master since the last call
+ *        (requires CONFIG_FMB_CONTROLLER_SLAVE_CHANGE_TRACKING). Each range of the adjacent changed
+ *        registers is returned once regardless of the number of writes. The ranges which
+ *        do not fit the array are kept until the next call.
+ *
+ * @param[in] ctx context pointer of the initialized modbus interface
+ * @param[out] changes the array of changed ranges (type is MB_EVENT_HOLDING_REG_WR or MB_EVENT_COILS_WR)
+ * @param[in] max_count number of items in the array
+ * @param[out] count number of the ranges returned
+ *
+ * @return
+ *     - ESP_OK Success, the count can be zero if nothing is changed
+ *     - ESP_ERR_INVALID_ARG invalid argument of function
+ *     - ESP_ERR_INVALID_STATE the slave interface is not initialized
+ *     - ESP_ERR_NOT_SUPPORTED the change tracking is not enabled
+ */
+esp_err_t mbc_slave_get_changes(void *ctx, mb_param_info_t *changes, uint16_t max_count, uint16_t *count);
+
+/**
+ * @brief Get the statistics of the clients connected to the TCP slave
+ *        The slave serves the queued requests of the clients in round-robin order and rejects
+ *        the requests above CONFIG_FMB_TCP_SLAVE_CLIENT_QUEUE_MAX of one client with the busy exception.
+ *
+ * @param[in] ctx context pointer of the initialized modbus interface
+ * @param[out] stats the array of client statistics
+ * @param[in] max_count number of items in the array
+ * @param[out] count number of the connected clients returned
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_ERR_INVALID_ARG invalid argument of function
+ *     - ESP_ERR_INVALID_STATE the slave interface is not initialized
+ *     - ESP_ERR_NOT_SUPPORTED the slave is not a TCP slave
+ */
+esp_err_t mbc_slave_get_client_stats(void *ctx, mb_tcp_client_stats_t *stats, uint16_t max_count, uint16_t *count);
+
+/**
+ * @brief Get the counters of the response cache of the slave
+ *        (requires CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE). The input and holding register
+ *        read requests are counted, the request is a hit if its data is taken from the cache.
+ *
+ * @param[in] ctx context pointer of the initialized modbus interface
+ * @param[out] stats the counters of cache
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_ERR_INVALID_ARG invalid argument of function
+ *     - ESP_ERR_INVALID_STATE the slave interface is not initialized
+ *     - ESP_ERR_NOT_SUPPORTED the response cache is not enabled
+ */
+esp_err_t mbc_slave_get_cache_stats(void *ctx, mb_cache_stats_t *stats);
+
 /**
  * @brief Set Modbus area descriptor
  *
@@ -201,6 +255,45 @@ esp_err_t mbc_slave_get_param_info(void *ctx, mb_param_info_t *reg_info, uint32_
  */
 esp_err_t mbc_slave_set_descriptor(void *ctx, mb_register_area_descriptor_t descr_data);
 
+/**
+ * @brief Switch the register area to the publish mode
+ *        The published area is double buffered, the requests of master read the last published data
+ *        without the lock, so the slave is not stalled by the application which updates the area.
+ *        The application must not write the registers of the published area directly after this call,
+ *        the mbc_slave_publish() is used instead. Only the areas which master can not write are published.
+ *
+ * @param[in] ctx context pointer of the initialized modbus interface
+ * @param[in] type the type of register area (input, discrete or read only holding registers and coils)
+ * @param[in] start_offset the start offset of the area set by mbc_slave_set_descriptor()
+ *
+ * @return
+ *     - ESP_OK Success, the current data of area is published
+ *     - ESP_ERR_INVALID_ARG the area is writable by master
+ *     - ESP_ERR_NOT_FOUND the area with the start offset is not found
+ *     - ESP_ERR_NO_MEM not enough memory for the second buffer
+ *     - ESP_ERR_INVALID_STATE the slave interface is not initialized
+ */
+esp_err_t mbc_slave_enable_publish(void *ctx, mb_param_type_t type, uint16_t start_offset);
+
+/**
+ * @brief Publish the new data of the register area
+ *        The data is copied into the buffer which is not read by master, the requests see either
+ *        the previous or the new data of the whole area. The area is published by one task at a time.
+ *
+ * @param[in] ctx context pointer of the initialized modbus interface
+ * @param[in] type the type of register area
+ * @param[in] start_offset the start offset of the area
+ * @param[in] data the new data of the area
+ * @param[in] size the size of data, must be equal to the size of area
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_ERR_INVALID_ARG invalid argument of function
+ *     - ESP_ERR_NOT_FOUND the area with the start offset is not found
+ *     - ESP_ERR_INVALID_STATE the area is not published or it is published by other task
+ */
+esp_err_t mbc_slave_publish(void *ctx, mb_param_type_t type, uint16_t start_offset, const void *data, size_t size);
+
 // The support of <0x11 - Report Slave ID> command is intentionally included for TCP slave as well!
 #if CONFIG_FMB_CONTROLLER_SLAVE_ID_SUPPORT
 /**
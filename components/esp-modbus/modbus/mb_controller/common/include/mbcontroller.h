@@ -17,6 +17,8 @@
 #include "esp_modbus_common.h"
 #include "esp_modbus_master.h"
 #include "esp_modbus_slave.h"
+#include "esp_modbus_gateway.h"
+#include "esp_modbus_master_pool.h"
 
 
 
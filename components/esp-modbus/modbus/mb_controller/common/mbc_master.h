@@ -0,0 +1,291 @@
+/*
+ * SPDX-FileCopyrightText: 2016-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <sys/queue.h>              // for list
+#include "freertos/FreeRTOS.h"      // for task creation and queue access
+#include "freertos/task.h"          // for task api access
+#include "freertos/event_groups.h"  // for event groups
+#include "freertos/semphr.h"        // for semaphore
+#include "freertos/queue.h"         // for queue api access
+#include "driver/uart.h"            // for UART types
+#include "errno.h"                  // for errno
+#include "esp_log.h"                // for log write
+#include "string.h"                 // for strerror()
+#include "esp_modbus_common.h"      // for common types
+#include "esp_modbus_master.h"      // for public master types
+#include "sdkconfig.h"              // for KConfig values
+
+#include "mb_common.h"              // for mb_base_t
+#include "mb_utils.h"
+#include "mb_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------- Defines ------------------------------------------*/
+
+// Set the maximum resource waiting time, the actual time of resouce release
+// will be dependent on response time set by timer + convertion time if the command is received
+#define MB_MAX_RESP_DELAY_MS (3000)
+
+#ifdef CONFIG_FMB_MASTER_READ_PLAN_GAP_MAX
+#define MB_READ_PLAN_GAP_MAX (CONFIG_FMB_MASTER_READ_PLAN_GAP_MAX)
+#else
+#define MB_READ_PLAN_GAP_MAX (0)
+#endif
+
+// The block index of the characteristic which is read with its own request
+#define MB_READ_PLAN_NO_BLOCK (0xFFFF)
+
+// The index of the characteristic which is not found in the parameter description table
+#define MB_PARAM_INDEX_NONE (0xFFFF)
+
+/**
+ * @brief Hash index of the parameter description table
+ */
+typedef struct {
+    uint32_t slot_mask;                                 /*!< Number of slots minus one, the number of slots is a power of two */
+    uint16_t *key_slots;                                /*!< Table index of the characteristic placed in the slot by key hash */
+    uint16_t *cid_slots;                                /*!< Table index placed by cid hash, NULL if the cid is equal to index */
+} mb_master_param_index_t;
+
+/**
+ * @brief Plan of the coalesced reads built for the parameter description table
+ */
+typedef struct {
+    uint16_t block_count;                               /*!< Number of the read blocks */
+    mb_param_request_t *blocks;                         /*!< Read request of each block */
+    uint16_t *cid_block;                                /*!< Block index of each characteristic or MB_READ_PLAN_NO_BLOCK */
+} mb_master_read_plan_t;
+
+/**
+ * @brief Cached value of the characteristic
+ */
+typedef struct {
+    uint8_t *data;                                      /*!< Data of characteristic as read from slave, NULL if it is not cached */
+    int64_t time_stamp;                                 /*!< Time of the response (uS) */
+    bool is_valid;                                      /*!< The data is received and not invalidated */
+} mb_master_cache_entry_t;
+
+/**
+ * @brief Parameter value cache of the master
+ */
+typedef struct {
+    _lock_t lock;                                       /*!< Cache lock */
+    mb_master_cache_entry_t *entries;                   /*!< Cache entry of each characteristic, NULL if no cid is cached */
+    mb_cache_stats_t stats;                             /*!< Hit and miss counters */
+} mb_master_value_cache_t;
+
+/**
+ * @brief Modbus controller handler structure
+ */
+typedef struct {
+    mb_port_type_t port_type;                           /*!< Modbus port type */
+    mb_communication_info_t comm_opts;                  /*!< Modbus communication info */
+    uint8_t *reg_buffer_ptr;                            /*!< Modbus data buffer pointer */
+    uint16_t reg_buffer_size;                           /*!< Modbus data buffer size */
+    TaskHandle_t task_handle;                           /*!< Modbus task handle */
+    EventGroupHandle_t event_group_handle;              /*!< Modbus controller event group */
+    SemaphoreHandle_t mbm_sema;                         /*!< Modbus controller semaphore */
+    const mb_parameter_descriptor_t *param_descriptor_table; /*!< Modbus controller parameter description table */
+    size_t mbm_param_descriptor_size;                   /*!< Modbus controller parameter description table size */
+    mb_master_param_index_t param_index;                /*!< Lookup index of the parameter description table */
+    mb_master_read_plan_t read_plan;                    /*!< Coalesced reads of the parameter description table */
+    mb_master_value_cache_t value_cache;                /*!< Cached values of the parameters */
+} mb_master_options_t;
+
+typedef esp_err_t (*iface_get_cid_info_fp)(void *, uint16_t, const mb_parameter_descriptor_t **);           /*!< Interface get_cid_info method */
+typedef esp_err_t (*iface_get_parameter_fp)(void *, uint16_t, uint8_t *, uint8_t *);                        /*!< Interface get_parameter method */
+typedef esp_err_t (*iface_get_parameter_with_fp)(void *, uint16_t, uint8_t, uint8_t *, uint8_t *);          /*!< Interface get_parameter_with method */
+typedef esp_err_t (*iface_get_parameters_fp)(void *, mb_param_poll_t *, uint16_t);                          /*!< Interface get_parameters method */
+typedef esp_err_t (*iface_send_request_fp)(void *, mb_param_request_t*, void *);                            /*!< Interface send_request method */
+typedef esp_err_t (*iface_mbm_set_descriptor_fp)(void *, const mb_parameter_descriptor_t*, const uint16_t); /*!< Interface set_descriptor method */
+typedef esp_err_t (*iface_set_parameter_fp)(void *, uint16_t, uint8_t *, uint8_t *);                        /*!< Interface set_parameter method */
+typedef esp_err_t (*iface_set_parameter_with_fp)(void *, uint16_t, uint8_t, uint8_t *, uint8_t *);          /*!< Interface set_parameter_with method */
+
+/**
+ * @brief Modbus controller interface structure
+ */
+typedef struct {
+    mb_base_t *mb_base;
+    // Master object interface options
+    mb_master_options_t opts;
+    bool is_active;                                 /*!< Interface is active */
+
+    // Public interface methods
+    iface_create_fp create;                         /*!< Interface constructor */
+    iface_method_default_fp delete;                 /*!< Interface method delete */
+    iface_method_default_fp start;                  /*!< Interface method start */
+    iface_method_default_fp stop;                   /*!< Interface method stop */
+    iface_get_cid_info_fp get_cid_info;             /*!< Interface get_cid_info method */
+    iface_get_parameter_fp get_parameter;           /*!< Interface get_parameter method */
+    iface_get_parameter_with_fp get_parameter_with; /*!< Interface get_parameter_with method */
+    iface_get_parameters_fp get_parameters;         /*!< Interface get_parameters method (optional) */
+    iface_send_request_fp send_request;             /*!< Interface send_request method */
+    iface_mbm_set_descriptor_fp set_descriptor;     /*!< Interface set_descriptor method */
+    iface_set_parameter_fp set_parameter;           /*!< Interface set_parameter method */
+    iface_set_parameter_with_fp set_parameter_with; /*!< Interface set_parameter_with method */
+} mbm_controller_iface_t;
+
+/**
+ * @brief Build the lookup index by cid and key for the parameter description table
+ *        The index is not installed, the options of master are not changed.
+ *
+ * @param[in] table the parameter description table
+ * @param[in] table_size the number of characteristics in the table
+ * @param[out] index the built index, free it with the key_slots field if it is not installed
+ *
+ * @return
+ *     - ESP_OK                 the index is built
+ *     - ESP_ERR_INVALID_ARG    the table is incorrect or the cid of characteristic is duplicated
+ *     - ESP_ERR_NO_MEM         not enough memory for the index
+ */
+esp_err_t mbc_master_index_create(const mb_parameter_descriptor_t *table, size_t table_size,
+                                    mb_master_param_index_t *index);
+
+/**
+ * @brief Free the lookup index
+ *
+ * @param[in] mbm_opts master options
+ */
+void mbc_master_index_delete(mb_master_options_t *mbm_opts);
+
+/**
+ * @brief Get the index of characteristic in the parameter description table by its cid
+ *
+ * @param[in] mbm_opts master options
+ * @param[in] cid characteristic id
+ *
+ * @return
+ *     - the index of characteristic in the table or MB_PARAM_INDEX_NONE if it is not found
+ */
+uint16_t mbc_master_index_get(mb_master_options_t *mbm_opts, uint16_t cid);
+
+/**
+ * @brief Get the index of characteristic in the parameter description table by its key
+ *
+ * @param[in] mbm_opts master options
+ * @param[in] key the param_key of characteristic
+ *
+ * @return
+ *     - the index of the first characteristic with the key or MB_PARAM_INDEX_NONE if it is not found
+ */
+uint16_t mbc_master_index_get_by_key(mb_master_options_t *mbm_opts, const char *key);
+
+/**
+ * @brief Build the plan of the coalesced reads for the parameter description table
+ *        The plan is not installed, the options of master are not changed.
+ *
+ * @param[in] table the parameter description table
+ * @param[in] size the number of characteristics in the table
+ * @param[out] plan the built plan
+ *
+ * @return
+ *     - ESP_OK                 the plan is built (empty if the option is disabled)
+ *     - ESP_ERR_NO_MEM         not enough memory for the plan
+ */
+esp_err_t mbc_master_plan_create(const mb_parameter_descriptor_t *table, size_t size, mb_master_read_plan_t *plan);
+
+/**
+ * @brief Free the plan of the coalesced reads
+ *
+ * @param[in] mbm_opts master options
+ */
+void mbc_master_plan_delete(mb_master_options_t *mbm_opts);
+
+/**
+ * @brief Get the read block of the characteristic
+ *
+ * @param[in] mbm_opts master options
+ * @param[in] cid characteristic id
+ *
+ * @return
+ *     - the block index in the plan, MB_READ_PLAN_NO_BLOCK if the characteristic is read with its own request
+ */
+uint16_t mbc_master_plan_get_block(mb_master_options_t *mbm_opts, uint16_t cid);
+
+/**
+ * @brief Set the value of characteristic from the data read with the request of its block
+ *        The data of characteristic is kept in the value cache.
+ *
+ * @param[in] mbm_opts master options
+ * @param[in] cid characteristic id
+ * @param[in] block_data the data of block returned by the send request method
+ * @param[out] value the value of characteristic, can be NULL
+ *
+ * @return
+ *     - ESP_OK                 the value is set
+ *     - ESP_ERR_INVALID_ARG    the characteristic is not in the plan
+ *     - ESP_ERR_NOT_SUPPORTED  the type of characteristic is not supported
+ */
+esp_err_t mbc_master_plan_set_param(mb_master_options_t *mbm_opts, uint16_t cid, uint8_t *block_data, uint8_t *value);
+
+/**
+ * @brief Allocate the cache entries for the characteristics with non zero max age in the parameter description table
+ *        The entries are not installed, the options of master are not changed.
+ *
+ * @param[in] table the parameter description table
+ * @param[in] table_size the number of characteristics in the table
+ * @param[out] entries the allocated entries, NULL if no characteristic is cached
+ *
+ * @return
+ *     - ESP_OK                 the entries are created
+ *     - ESP_ERR_NO_MEM         not enough memory for the cache
+ */
+esp_err_t mbc_master_cache_create(const mb_parameter_descriptor_t *table, size_t table_size,
+                                    mb_master_cache_entry_t **entries);
+
+/**
+ * @brief Install the cache entries and free the previous ones, the statistics of cache is reset
+ *
+ * @param[in] mbm_opts master options
+ * @param[in] entries the entries created for the parameter description table of the master, can be NULL
+ */
+void mbc_master_cache_replace(mb_master_options_t *mbm_opts, mb_master_cache_entry_t *entries);
+
+/**
+ * @brief Free the value cache
+ *
+ * @param[in] mbm_opts master options
+ */
+void mbc_master_cache_delete(mb_master_options_t *mbm_opts);
+
+/**
+ * @brief Get the value of characteristic from the cache if it is not older than the max age of characteristic
+ *
+ * @param[in] mbm_opts master options
+ * @param[in] cid characteristic id
+ * @param[out] value the value of characteristic, can be NULL
+ *
+ * @return
+ *     - ESP_OK                 the value is returned from the cache
+ *     - ESP_ERR_NOT_FOUND      the characteristic is not cached or the value is expired
+ */
+esp_err_t mbc_master_cache_get(mb_master_options_t *mbm_opts, uint16_t cid, uint8_t *value);
+
+/**
+ * @brief Keep the data of characteristic read from slave in the cache
+ *
+ * @param[in] mbm_opts master options
+ * @param[in] cid characteristic id
+ * @param[in] data the data of characteristic returned by the send request method
+ */
+void mbc_master_cache_set(mb_master_options_t *mbm_opts, uint16_t cid, const uint8_t *data);
+
+/**
+ * @brief Invalidate the cached value of characteristic
+ *
+ * @param[in] mbm_opts master options
+ * @param[in] cid characteristic id or MB_CACHE_CID_ALL
+ */
+void mbc_master_cache_invalidate(mb_master_options_t *mbm_opts, uint16_t cid);
+
+#ifdef __cplusplus
+}
+#endif
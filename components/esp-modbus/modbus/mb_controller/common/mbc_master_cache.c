@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// mbc_master_cache.c
+// Parameter value cache of the Modbus master controller
+
+#include "esp_err.h"                // for esp_err_t
+#include "esp_timer.h"              // for esp_timer_get_time
+#include "mbc_master.h"             // for master interface define
+#include "esp_modbus_master.h"      // for public interface defines
+#include "port_common.h"            // for critical section
+
+static const char TAG[] __attribute__((unused)) = "MB_CONTROLLER_CACHE";
+
+// The characteristic is cached if it has the max age and can be read from the slave
+#define MB_CACHE_IS_USED(descr) (((descr)->max_age_ms > 0) && ((descr)->mb_slave_addr != MB_SLAVE_ADDR_PLACEHOLDER))
+
+void mbc_master_cache_replace(mb_master_options_t *mbm_opts, mb_master_cache_entry_t *entries)
+{
+    mb_master_value_cache_t *cache = &mbm_opts->value_cache;
+    mb_master_cache_entry_t *old_entries = NULL;
+    CRITICAL_SECTION(cache->lock) {
+        old_entries = cache->entries;
+        cache->entries = entries;
+        cache->stats.hit_count = 0;
+        cache->stats.miss_count = 0;
+    }
+    // The data of entries is placed in the same allocation
+    free(old_entries);
+}
+
+void mbc_master_cache_delete(mb_master_options_t *mbm_opts)
+{
+    mbc_master_cache_replace(mbm_opts, NULL);
+}
+
+esp_err_t mbc_master_cache_create(const mb_parameter_descriptor_t *table, size_t table_size,
+                                    mb_master_cache_entry_t **entries)
+{
+    size_t data_size = 0;
+
+    MB_RETURN_ON_FALSE((entries), ESP_ERR_INVALID_ARG, TAG, "mb incorrect cache pointer.");
+    *entries = NULL;
+    for (size_t idx = 0; table && (idx < table_size); idx++) {
+        if (MB_CACHE_IS_USED(&table[idx])) {
+            data_size += (table[idx].mb_size << 1);
+        }
+    }
+    if (!data_size) {
+        return ESP_OK;
+    }
+    size_t entries_size = table_size * sizeof(mb_master_cache_entry_t);
+    mb_master_cache_entry_t *new_entries = calloc(1, (entries_size + data_size));
+    MB_RETURN_ON_FALSE((new_entries), ESP_ERR_NO_MEM, TAG, "mb value cache allocation fail.");
+    uint8_t *data_ptr = (uint8_t *)new_entries + entries_size;
+    for (size_t idx = 0; idx < table_size; idx++) {
+        if (MB_CACHE_IS_USED(&table[idx])) {
+            new_entries[idx].data = data_ptr;
+            data_ptr += (table[idx].mb_size << 1);
+        }
+    }
+    *entries = new_entries;
+    ESP_LOGD(TAG, "mb value cache: %u bytes of data.", (unsigned)data_size);
+    return ESP_OK;
+}
+
+esp_err_t mbc_master_cache_get(mb_master_options_t *mbm_opts, uint16_t cid, uint8_t *value)
+{
+    mb_master_value_cache_t *cache = &mbm_opts->value_cache;
+    uint16_t index = cache->entries ? mbc_master_index_get(mbm_opts, cid) : MB_PARAM_INDEX_NONE;
+    if ((index == MB_PARAM_INDEX_NONE) || !cache->entries[index].data) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    const mb_parameter_descriptor_t *descr = &mbm_opts->param_descriptor_table[index];
+    mb_master_cache_entry_t *entry = &cache->entries[index];
+    esp_err_t error = ESP_ERR_NOT_FOUND;
+    int64_t time_now = esp_timer_get_time();
+
+    CRITICAL_SECTION(cache->lock) {
+        if (entry->is_valid && ((time_now - entry->time_stamp) <= ((int64_t)descr->max_age_ms * 1000))) {
+            error = value ? mbc_master_set_param_data((void *)value, (void *)entry->data,
+                                                        descr->param_type, descr->param_size) : ESP_OK;
+        }
+        if (error == ESP_OK) {
+            cache->stats.hit_count++;
+        } else {
+            cache->stats.miss_count++;
+        }
+    }
+    return (error == ESP_OK) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+void mbc_master_cache_set(mb_master_options_t *mbm_opts, uint16_t cid, const uint8_t *data)
+{
+    mb_master_value_cache_t *cache = &mbm_opts->value_cache;
+    uint16_t index = cache->entries ? mbc_master_index_get(mbm_opts, cid) : MB_PARAM_INDEX_NONE;
+    if (!data || (index == MB_PARAM_INDEX_NONE) || !cache->entries[index].data) {
+        return;
+    }
+    mb_master_cache_entry_t *entry = &cache->entries[index];
+    CRITICAL_SECTION(cache->lock) {
+        memcpy(entry->data, data, (mbm_opts->param_descriptor_table[index].mb_size << 1));
+        entry->time_stamp = esp_timer_get_time();
+        entry->is_valid = true;
+    }
+}
+
+void mbc_master_cache_invalidate(mb_master_options_t *mbm_opts, uint16_t cid)
+{
+    mb_master_value_cache_t *cache = &mbm_opts->value_cache;
+    uint16_t index = (cache->entries && (cid != MB_CACHE_CID_ALL)) ? mbc_master_index_get(mbm_opts, cid) : MB_PARAM_INDEX_NONE;
+    if (!cache->entries || ((cid != MB_CACHE_CID_ALL) && (index == MB_PARAM_INDEX_NONE))) {
+        return;
+    }
+    CRITICAL_SECTION(cache->lock) {
+        if (cid != MB_CACHE_CID_ALL) {
+            cache->entries[index].is_valid = false;
+        } else {
+            for (size_t i = 0; i < mbm_opts->mbm_param_descriptor_size; i++) {
+                cache->entries[i].is_valid = false;
+            }
+        }
+    }
+}
@@ -0,0 +1,138 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// mbc_master_index.c
+// Lookup of the characteristics by cid and key in the parameter description table
+
+#include "esp_err.h"                // for esp_err_t
+#include "mbc_master.h"             // for master interface define
+#include "esp_modbus_master.h"      // for public interface defines
+
+static const char TAG[] __attribute__((unused)) = "MB_CONTROLLER_INDEX";
+
+// FNV-1a hash of the characteristic key
+static uint32_t mbc_master_index_hash_key(const char *key)
+{
+    uint32_t hash = 2166136261UL;
+    while (*key) {
+        hash ^= (uint8_t)*key++;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+// Fibonacci hash of the cid, the upper bits are well mixed
+static uint32_t mbc_master_index_hash_cid(uint16_t cid)
+{
+    return ((uint32_t)cid * 2654435769UL) >> 16;
+}
+
+void mbc_master_index_delete(mb_master_options_t *mbm_opts)
+{
+    // The cid slots are placed in the same allocation
+    free(mbm_opts->param_index.key_slots);
+    mbm_opts->param_index.key_slots = NULL;
+    mbm_opts->param_index.cid_slots = NULL;
+    mbm_opts->param_index.slot_mask = 0;
+}
+
+// The open addressing tables keep the index of characteristic in the table and have at least
+// twice more slots than characteristics, so the lookup takes one or two probes in average.
+// The cid table is not used if the cid of each characteristic is equal to its index.
+esp_err_t mbc_master_index_create(const mb_parameter_descriptor_t *table, size_t table_size,
+                                    mb_master_param_index_t *index)
+{
+    bool is_dense = true;
+    uint32_t slot_count = 4;
+    esp_err_t ret = ESP_OK;
+
+    MB_RETURN_ON_FALSE((index), ESP_ERR_INVALID_ARG, TAG, "mb incorrect index pointer.");
+    MB_RETURN_ON_FALSE((table && table_size && (table_size < MB_PARAM_INDEX_NONE)), ESP_ERR_INVALID_ARG,
+                            TAG, "mb incorrect descriptor table.");
+    for (size_t idx = 0; idx < table_size; idx++) {
+        is_dense &= (table[idx].cid == idx);
+    }
+    while (slot_count < (table_size << 1)) {
+        slot_count <<= 1;
+    }
+    uint16_t *key_slots = malloc(slot_count * sizeof(uint16_t) * (is_dense ? 1 : 2));
+    MB_RETURN_ON_FALSE((key_slots), ESP_ERR_NO_MEM, TAG, "mb parameter index allocation fail.");
+    uint16_t *cid_slots = is_dense ? NULL : &key_slots[slot_count];
+    memset(key_slots, 0xFF, slot_count * sizeof(uint16_t) * (is_dense ? 1 : 2));
+    uint32_t mask = slot_count - 1;
+
+    for (uint16_t idx = 0; idx < table_size; idx++) {
+        const mb_parameter_descriptor_t *descr = &table[idx];
+        MB_GOTO_ON_FALSE((descr->param_key), ESP_ERR_INVALID_ARG, error, TAG,
+                            "mb descriptor param key of cid #%u is incorrect.", (unsigned)descr->cid);
+        if (cid_slots) {
+            MB_GOTO_ON_FALSE((descr->cid != MB_PARAM_CID_NONE), ESP_ERR_INVALID_ARG, error, TAG,
+                                "mb descriptor cid #%u is reserved.", (unsigned)descr->cid);
+            uint32_t slot = mbc_master_index_hash_cid(descr->cid) & mask;
+            while ((cid_slots[slot] != MB_PARAM_INDEX_NONE) && (table[cid_slots[slot]].cid != descr->cid)) {
+                slot = (slot + 1) & mask;
+            }
+            MB_GOTO_ON_FALSE((cid_slots[slot] == MB_PARAM_INDEX_NONE), ESP_ERR_INVALID_ARG, error, TAG,
+                                "mb descriptor cid #%u is duplicated.", (unsigned)descr->cid);
+            cid_slots[slot] = idx;
+        }
+        uint32_t slot = mbc_master_index_hash_key(descr->param_key) & mask;
+        while ((key_slots[slot] != MB_PARAM_INDEX_NONE) && strcmp(table[key_slots[slot]].param_key, descr->param_key)) {
+            slot = (slot + 1) & mask;
+        }
+        if (key_slots[slot] == MB_PARAM_INDEX_NONE) {
+            key_slots[slot] = idx;
+        } else {
+            // The lookup by key returns the first characteristic with the key
+            ESP_LOGW(TAG, "mb descriptor key %s of cid #%u is duplicated.", descr->param_key, (unsigned)descr->cid);
+        }
+    }
+    index->key_slots = key_slots;
+    index->cid_slots = cid_slots;
+    index->slot_mask = mask;
+    ESP_LOGD(TAG, "mb parameter index: %u characteristics, %u slots, %s cid.", (unsigned)table_size,
+                (unsigned)slot_count, is_dense ? "dense" : "sparse");
+    return ESP_OK;
+
+error:
+    free(key_slots);
+    return ret;
+}
+
+uint16_t mbc_master_index_get(mb_master_options_t *mbm_opts, uint16_t cid)
+{
+    const mb_master_param_index_t *index = &mbm_opts->param_index;
+    if (!index->key_slots) {
+        return MB_PARAM_INDEX_NONE;
+    }
+    if (!index->cid_slots) {
+        return (cid < mbm_opts->mbm_param_descriptor_size) ? cid : MB_PARAM_INDEX_NONE;
+    }
+    uint32_t slot = mbc_master_index_hash_cid(cid) & index->slot_mask;
+    while (index->cid_slots[slot] != MB_PARAM_INDEX_NONE) {
+        if (mbm_opts->param_descriptor_table[index->cid_slots[slot]].cid == cid) {
+            return index->cid_slots[slot];
+        }
+        slot = (slot + 1) & index->slot_mask;
+    }
+    return MB_PARAM_INDEX_NONE;
+}
+
+uint16_t mbc_master_index_get_by_key(mb_master_options_t *mbm_opts, const char *key)
+{
+    const mb_master_param_index_t *index = &mbm_opts->param_index;
+    if (!index->key_slots || !key) {
+        return MB_PARAM_INDEX_NONE;
+    }
+    uint32_t slot = mbc_master_index_hash_key(key) & index->slot_mask;
+    while (index->key_slots[slot] != MB_PARAM_INDEX_NONE) {
+        if (!strcmp(mbm_opts->param_descriptor_table[index->key_slots[slot]].param_key, key)) {
+            return index->key_slots[slot];
+        }
+        slot = (slot + 1) & index->slot_mask;
+    }
+    return MB_PARAM_INDEX_NONE;
+}
@@ -0,0 +1,194 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// mbc_master_plan.c
+// Coalescing of the parameter reads of the Modbus master controller
+
+#include <stdlib.h>                 // for qsort
+#include "esp_err.h"                // for esp_err_t
+#include "mbc_master.h"             // for master interface define
+#include "esp_modbus_master.h"      // for public interface defines
+#include "mb_proto.h"               // for the function codes
+
+static const char TAG[] __attribute__((unused)) = "MB_CONTROLLER_PLAN";
+
+// The maximum quantity of registers and coils in one read request
+#define MB_READ_PLAN_REGS_MAX (0x007D)
+#define MB_READ_PLAN_BITS_MAX (0x07D0)
+
+#define MB_READ_PLAN_IS_BITS(command) (((command) == MB_FUNC_READ_COILS) || ((command) == MB_FUNC_READ_DISCRETE_INPUTS))
+
+// The readable characteristic placed in the order of the slave address, command and register offset
+typedef struct {
+    uint16_t index;                 // the index of characteristic in the table
+    uint8_t slave_addr;
+    uint8_t command;
+    uint32_t reg_start;
+    uint32_t reg_end;               // the register next to the last register of characteristic
+} mb_read_plan_item_t;
+
+static int mbc_master_plan_compare(const void *left, const void *right)
+{
+    const mb_read_plan_item_t *l = (const mb_read_plan_item_t *)left;
+    const mb_read_plan_item_t *r = (const mb_read_plan_item_t *)right;
+    if (l->slave_addr != r->slave_addr) {
+        return (l->slave_addr < r->slave_addr) ? -1 : 1;
+    }
+    if (l->command != r->command) {
+        return (l->command < r->command) ? -1 : 1;
+    }
+    if (l->reg_start != r->reg_start) {
+        return (l->reg_start < r->reg_start) ? -1 : 1;
+    }
+    return (l->index < r->index) ? -1 : ((l->index > r->index) ? 1 : 0);
+}
+
+// Returns the read command of characteristic if it can be read as a part of block, otherwise 0
+static uint8_t mbc_master_plan_get_command(const mb_parameter_descriptor_t *descr)
+{
+    if (descr->mb_slave_addr == MB_SLAVE_ADDR_PLACEHOLDER) {
+        return 0;
+    }
+    uint8_t command = mbc_master_get_command(descr, MB_PARAM_READ);
+    switch (command) {
+        case MB_FUNC_READ_COILS:
+        case MB_FUNC_READ_DISCRETE_INPUTS:
+            return (descr->mb_size <= MB_READ_PLAN_BITS_MAX) ? command : 0;
+        case MB_FUNC_READ_HOLDING_REGISTER:
+        case MB_FUNC_READ_INPUT_REGISTER:
+            return (descr->mb_size <= MB_READ_PLAN_REGS_MAX) ? command : 0;
+        default:
+            return 0;
+    }
+}
+
+void mbc_master_plan_delete(mb_master_options_t *mbm_opts)
+{
+    free(mbm_opts->read_plan.blocks);
+    free(mbm_opts->read_plan.cid_block);
+    mbm_opts->read_plan.blocks = NULL;
+    mbm_opts->read_plan.cid_block = NULL;
+    mbm_opts->read_plan.block_count = 0;
+}
+
+// The table is sorted by the slave, command and register offset, then the neighbouring characteristics
+// are merged into the block while the request does not exceed the maximum quantity of registers.
+esp_err_t mbc_master_plan_create(const mb_parameter_descriptor_t *table, size_t size, mb_master_read_plan_t *plan)
+{
+    MB_RETURN_ON_FALSE((plan), ESP_ERR_INVALID_ARG, TAG, "mb incorrect plan pointer.");
+    memset(plan, 0, sizeof(mb_master_read_plan_t));
+#if CONFIG_FMB_MASTER_READ_PLAN_ENABLE
+    uint16_t table_size = (uint16_t)size;
+    if (!table || !table_size) {
+        return ESP_OK;
+    }
+    mb_read_plan_item_t *items = calloc(table_size, sizeof(mb_read_plan_item_t));
+    uint16_t *cid_block = malloc(table_size * sizeof(uint16_t));
+    mb_param_request_t *blocks = NULL;
+    esp_err_t ret = ESP_OK;
+    uint16_t item_count = 0;
+    uint16_t block_count = 0;
+    MB_GOTO_ON_FALSE((items && cid_block), ESP_ERR_NO_MEM, error, TAG, "mb read plan allocation fail.");
+
+    for (uint16_t idx = 0; idx < table_size; idx++) {
+        const mb_parameter_descriptor_t *descr = &table[idx];
+        cid_block[idx] = MB_READ_PLAN_NO_BLOCK;
+        uint8_t command = mbc_master_plan_get_command(descr);
+        if (command) {
+            items[item_count].index = idx;
+            items[item_count].slave_addr = descr->mb_slave_addr;
+            items[item_count].command = command;
+            items[item_count].reg_start = descr->mb_reg_start;
+            items[item_count].reg_end = (uint32_t)descr->mb_reg_start + descr->mb_size;
+            item_count++;
+        }
+    }
+    if (!item_count) {
+        free(items);
+        free(cid_block);
+        return ESP_OK;
+    }
+    qsort(items, item_count, sizeof(mb_read_plan_item_t), mbc_master_plan_compare);
+
+    blocks = calloc(item_count, sizeof(mb_param_request_t));
+    MB_GOTO_ON_FALSE((blocks), ESP_ERR_NO_MEM, error, TAG, "mb read plan allocation fail.");
+    mb_param_request_t *block = NULL;
+    uint32_t block_end = 0;
+    for (uint16_t i = 0; i < item_count; i++) {
+        mb_read_plan_item_t *item = &items[i];
+        uint32_t reg_max = MB_READ_PLAN_IS_BITS(item->command) ? MB_READ_PLAN_BITS_MAX : MB_READ_PLAN_REGS_MAX;
+        uint32_t reg_end = (item->reg_end > block_end) ? item->reg_end : block_end;
+        if (!block || (block->slave_addr != item->slave_addr) || (block->command != item->command)
+                || (item->reg_start > (block_end + MB_READ_PLAN_GAP_MAX))
+                || ((reg_end - block->reg_start) > reg_max)) {
+            block = &blocks[block_count++];
+            block->slave_addr = item->slave_addr;
+            block->command = item->command;
+            block->reg_start = (uint16_t)item->reg_start;
+            reg_end = item->reg_end;
+        }
+        block_end = reg_end;
+        block->reg_size = (uint16_t)(block_end - block->reg_start);
+        cid_block[item->index] = (block_count - 1);
+    }
+    free(items);
+    plan->blocks = blocks;
+    plan->cid_block = cid_block;
+    plan->block_count = block_count;
+    ESP_LOGD(TAG, "mb read plan: %u characteristics in %u requests.", (unsigned)item_count, (unsigned)block_count);
+    return ESP_OK;
+
+error:
+    free(items);
+    free(cid_block);
+    free(blocks);
+    return ret;
+#else
+    return ESP_OK;
+#endif
+}
+
+uint16_t mbc_master_plan_get_block(mb_master_options_t *mbm_opts, uint16_t cid)
+{
+    uint16_t index = mbc_master_index_get(mbm_opts, cid);
+    if (!mbm_opts->read_plan.cid_block || (index == MB_PARAM_INDEX_NONE)) {
+        return MB_READ_PLAN_NO_BLOCK;
+    }
+    return mbm_opts->read_plan.cid_block[index];
+}
+
+esp_err_t mbc_master_plan_set_param(mb_master_options_t *mbm_opts, uint16_t cid, uint8_t *block_data, uint8_t *value)
+{
+    uint16_t index = mbc_master_plan_get_block(mbm_opts, cid);
+    MB_RETURN_ON_FALSE((index != MB_READ_PLAN_NO_BLOCK), ESP_ERR_INVALID_ARG, TAG,
+                            "mb cid #%u is not in the read plan.", (unsigned)cid);
+    MB_RETURN_ON_FALSE((block_data), ESP_ERR_INVALID_ARG, TAG, "incorrect data pointer.");
+    const mb_param_request_t *block = &mbm_opts->read_plan.blocks[index];
+    const mb_parameter_descriptor_t *descr = &mbm_opts->param_descriptor_table[mbc_master_index_get(mbm_opts, cid)];
+    uint16_t offset = descr->mb_reg_start - block->reg_start;
+    esp_err_t error = ESP_OK;
+
+    if (MB_READ_PLAN_IS_BITS(block->command)) {
+        // Shift the bits of characteristic to the start of buffer as if they are read with own request
+        uint8_t *data_ptr = calloc(1, (descr->mb_size << 1));
+        MB_RETURN_ON_FALSE((data_ptr), ESP_ERR_NO_MEM, TAG, "mb data allocation fail.");
+        for (uint16_t bit = 0; bit < descr->mb_size; bit++) {
+            mb_util_set_bits(data_ptr, bit, 1, mb_util_get_bits(block_data, (offset + bit), 1));
+        }
+        mbc_master_cache_set(mbm_opts, cid, data_ptr);
+        if (value) {
+            error = mbc_master_set_param_data((void *)value, (void *)data_ptr, descr->param_type, descr->param_size);
+        }
+        free(data_ptr);
+    } else {
+        mbc_master_cache_set(mbm_opts, cid, &block_data[offset << 1]);
+        if (value) {
+            error = mbc_master_set_param_data((void *)value, (void *)&block_data[offset << 1],
+                                                descr->param_type, descr->param_size);
+        }
+    }
+    return error;
+}
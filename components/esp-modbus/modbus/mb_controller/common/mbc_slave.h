@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <stdatomic.h>
 #include "driver/uart.h"            // for uart defines
 #include "errno.h"                  // for errno
 #include "sys/queue.h"              // for list
@@ -27,6 +28,13 @@ extern "C" {
 #define MB_CONTROLLER_NOTIFY_QUEUE_SIZE     (CONFIG_FMB_CONTROLLER_NOTIFY_QUEUE_SIZE) // Number of messages in parameter notification queue
 #define MB_CONTROLLER_NOTIFY_TIMEOUT        (pdMS_TO_TICKS(CONFIG_FMB_CONTROLLER_NOTIFY_TIMEOUT)) // notification timeout
 
+#ifdef CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE_SIZE
+#define MB_RESP_CACHE_SIZE                  (CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE_SIZE) // Number of cached read requests
+#else
+#define MB_RESP_CACHE_SIZE                  (0)
+#endif
+#define MB_RESP_CACHE_REGS_MAX              (125) // The maximum number of registers in one read request
+
 /**
  * @brief Modbus area descriptor list item
  */
@@ -36,9 +44,43 @@ typedef struct mb_descr_entry_s {
     mb_param_access_t access;               /*!< Area access type */
     void *p_data;                           /*!< Instance address for storage area descriptor */
     size_t size;                            /*!< Instance size for area descriptor (bytes) */
-    LIST_ENTRY(mb_descr_entry_s) entries;   /*!< The Modbus area descriptor entry */
+    uint32_t *dirty_bits;                   /*!< Bitmap of the registers written by master, NULL if not tracked */
+    uint32_t dirty_time;                    /*!< Time stamp of the last write to the area (uS) */
+    bool is_dirty;                          /*!< The area has the changes not taken by application */
+    uint8_t *p_shadow;                      /*!< Second buffer of the published area, NULL if the area is not published */
+    _Atomic(uint32_t) pub_seq;              /*!< Publish counter, bit 1 selects the buffer, odd while the data is copied */
 } mb_descr_entry_t;
 
+/**
+ * @brief Modbus area descriptors of one type sorted by the start address
+ */
+typedef struct {
+    mb_descr_entry_t **items;               /*!< The area descriptors in the order of start offset */
+    uint32_t count;                         /*!< Number of the area descriptors */
+    uint32_t capacity;                      /*!< Number of the allocated items */
+} mb_descr_table_t;
+
+/**
+ * @brief Encoded data of the register read request kept in the response cache
+ */
+typedef struct {
+    mb_param_type_t type;                   /*!< Type of the registers */
+    uint16_t start;                         /*!< Start address of the request */
+    uint16_t count;                         /*!< Number of registers, zero if the entry is free */
+    uint8_t *p_instance;                    /*!< Instance address of the first register */
+    uint8_t data[MB_RESP_CACHE_REGS_MAX * 2]; /*!< Registers in the order of the response */
+} mb_resp_cache_entry_t;
+
+/**
+ * @brief Response cache of the slave, protected by the lock of slave object
+ */
+typedef struct {
+    mb_resp_cache_entry_t *entries;         /*!< Cache entries, NULL if the cache is disabled */
+    uint32_t generation;                    /*!< Incremented when the cached data is invalidated */
+    uint16_t next;                          /*!< Entry replaced by the next request */
+    mb_cache_stats_t stats;                 /*!< Hit and miss counters */
+} mb_resp_cache_t;
+
 /**
  * @brief Modbus controller handler structure
  */
@@ -48,12 +90,18 @@ typedef struct {
     TaskHandle_t task_handle;                           /*!< task handle */
     EventGroupHandle_t event_group_handle;              /*!< controller event group */
     QueueHandle_t notification_queue_handle;            /*!< controller notification queue */
-    LIST_HEAD(mbs_area_descriptors_, mb_descr_entry_s) area_descriptors[MB_PARAM_COUNT]; /*!< register area descriptors */
+    mb_descr_table_t area_descriptors[MB_PARAM_COUNT];  /*!< register area descriptors */
+    mb_resp_cache_t resp_cache;                         /*!< cache of the read responses */
+    void *gateway;                                      /*!< gateway which forwards the requests, NULL if not used */
 } mb_slave_options_t;
 
 typedef mb_event_group_t (*iface_check_event_fp)(void *, mb_event_group_t);          /*!< Interface method check_event */
 typedef esp_err_t (*iface_get_param_info_fp)(void *, mb_param_info_t*, uint32_t);    /*!< Interface method get_param_info */
 typedef esp_err_t (*iface_mbs_set_descriptor_fp)(void *, mb_register_area_descriptor_t); /*!< Interface method set_descriptor */
+typedef uint16_t (*iface_get_client_stats_fp)(void *, mb_tcp_client_stats_t *, uint16_t); /*!< Interface method get_client_stats */
+typedef bool (*iface_request_visitor_fp)(void *, uint8_t, uint64_t, const uint8_t *, uint16_t); /*!< Visitor of the queued requests (arg, uid, tick, pdu, length) */
+typedef bool (*iface_get_request_info_fp)(void *, uint8_t *, uint64_t *);            /*!< Interface method get_request_info */
+typedef uint16_t (*iface_foreach_request_fp)(void *, iface_request_visitor_fp, void *); /*!< Interface method foreach_request */
 
 /**
  * @brief Request mode for parameter to use in data dictionary
@@ -72,6 +120,9 @@ typedef struct
     iface_check_event_fp check_event;           /*!< Interface method check_event */
     iface_get_param_info_fp get_param_info;     /*!< Interface method get_param_info */
     iface_mbs_set_descriptor_fp set_descriptor;     /*!< Interface method set_descriptor */
+    iface_get_client_stats_fp get_client_stats;     /*!< Interface method get_client_stats (optional) */
+    iface_get_request_info_fp get_request_info;     /*!< Interface method get_request_info (optional) */
+    iface_foreach_request_fp foreach_request;       /*!< Interface method foreach_request (optional) */
 } mbs_controller_iface_t;
 
 #ifdef __cplusplus
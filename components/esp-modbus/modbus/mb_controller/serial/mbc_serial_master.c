@@ -126,6 +126,10 @@ static esp_err_t mbc_serial_master_delete(void *ctx)
     MB_RETURN_ON_FALSE((mb_error == MB_ENOERR), ESP_ERR_INVALID_STATE, TAG,
                        "mb stack delete failure, returned (0x%x).", (int)mb_error);
     mbm_iface->mb_base = NULL;
+    mbc_master_plan_delete(mbm_opts);
+    mbc_master_index_delete(mbm_opts);
+    mbc_master_cache_delete(mbm_opts);
+    CRITICAL_SECTION_CLOSE(mbm_opts->value_cache.lock);
     free(mbm_iface); // free the memory allocated
     return ESP_OK;
 }
@@ -141,8 +145,7 @@ static esp_err_t mbc_serial_master_set_descriptor(void *ctx, const mb_parameter_
     for (uint16_t counter = 0; counter < (num_elements); counter++, reg_ptr++)
     {
         // Below is the code to check consistency of the table format and required fields.
-        MB_RETURN_ON_FALSE((reg_ptr->cid == counter),
-                           ESP_ERR_INVALID_ARG, TAG, "mb descriptor cid field is incorrect.");
+        // The cid uniqueness is checked by the index of the table.
         MB_RETURN_ON_FALSE((reg_ptr->param_key),
                            ESP_ERR_INVALID_ARG, TAG, "mb descriptor param key is incorrect.");
         MB_RETURN_ON_FALSE((reg_ptr->mb_size > 0),
@@ -279,11 +282,12 @@ static esp_err_t mbc_serial_master_get_cid_info(void *ctx, uint16_t cid, const m
                        ESP_ERR_INVALID_ARG, TAG, "mb incorrect data buffer pointer.");
     MB_RETURN_ON_FALSE((mbm_opts->param_descriptor_table),
                        ESP_ERR_INVALID_ARG, TAG, "mb incorrect descriptor table or not set.");
-    MB_RETURN_ON_FALSE((cid < mbm_opts->mbm_param_descriptor_size),
+    uint16_t index = mbc_master_index_get(mbm_opts, cid);
+    MB_RETURN_ON_FALSE((index != MB_PARAM_INDEX_NONE),
                        ESP_ERR_NOT_FOUND, TAG, "mb incorrect cid of characteristic.");
 
-    // It is assumed that characteristics cid increased in the table
-    const mb_parameter_descriptor_t *reg_info = &mbm_opts->param_descriptor_table[cid];
+    // The characteristic is found by the index of the table built on set descriptor
+    const mb_parameter_descriptor_t *reg_info = &mbm_opts->param_descriptor_table[index];
 
     MB_RETURN_ON_FALSE((reg_info->param_key),
                        ESP_ERR_INVALID_ARG, TAG, "mb incorrect characteristic key.");
@@ -301,10 +305,11 @@ static esp_err_t mbc_serial_master_set_request(void *ctx, uint16_t cid, mb_param
     esp_err_t error = ESP_ERR_NOT_FOUND;
     MB_RETURN_ON_FALSE((request), ESP_ERR_INVALID_ARG, TAG, "mb incorrect request parameter.");
     MB_RETURN_ON_FALSE((mode <= MB_PARAM_WRITE), ESP_ERR_INVALID_ARG, TAG, "mb incorrect mode.");
-    MB_RETURN_ON_FALSE((cid < mbm_opts->mbm_param_descriptor_size), ESP_ERR_INVALID_ARG, TAG, "mb incorrect cid parameter.");
     MB_RETURN_ON_FALSE((mbm_opts->param_descriptor_table), ESP_ERR_INVALID_ARG, TAG, "mb data dictionary is incorrect.");
+    uint16_t index = mbc_master_index_get(mbm_opts, cid);
+    MB_RETURN_ON_FALSE((index != MB_PARAM_INDEX_NONE), ESP_ERR_INVALID_ARG, TAG, "mb incorrect cid parameter.");
     const mb_parameter_descriptor_t *reg_ptr = mbm_opts->param_descriptor_table;
-    reg_ptr += cid;
+    reg_ptr += index;
     if (reg_ptr->cid == cid)
     {
         request->slave_addr = reg_ptr->mb_slave_addr;
@@ -333,6 +338,11 @@ static esp_err_t mbc_serial_master_get_parameter(void *ctx, uint16_t cid, uint8_
 
     error = mbc_serial_master_set_request(ctx, cid, MB_PARAM_READ, &request, &reg_info);
     if ((error == ESP_OK) && (cid == reg_info.cid) && (request.slave_addr != MB_SLAVE_ADDR_PLACEHOLDER)) {
+        // The value is taken from the cache while it is not older than the max age of characteristic
+        *type = reg_info.param_type;
+        if (mbc_master_cache_get(MB_MASTER_GET_OPTS(ctx), cid, value) == ESP_OK) {
+            return ESP_OK;
+        }
         MB_MASTER_ASSERT(xPortGetFreeHeapSize() > (reg_info.mb_size << 1));
         // alloc buffer to store parameter data
         data_ptr = calloc(1, (reg_info.mb_size << 1));
@@ -341,6 +351,7 @@ static esp_err_t mbc_serial_master_get_parameter(void *ctx, uint16_t cid, uint8_
         }
         error = mbc_serial_master_send_request(ctx, &request, data_ptr);
         if (error == ESP_OK) {
+            mbc_master_cache_set(MB_MASTER_GET_OPTS(ctx), cid, data_ptr);
             // If data pointer is NULL then we don't need to set value (it is still in the cache of cid)
             if (value) {
                 error = mbc_master_set_param_data((void *)value, (void *)data_ptr,
@@ -456,6 +467,8 @@ static esp_err_t mbc_serial_master_set_parameter(void *ctx, uint16_t cid, uint8_
         // Send request to write characteristic data
         error = mbc_serial_master_send_request(ctx, &request, data_ptr);
         if (error == ESP_OK) {
+            // The cached value is outdated by the write
+            mbc_master_cache_invalidate(MB_MASTER_GET_OPTS(ctx), cid);
             ESP_LOGD(TAG, "%s: Good response for set cid(%u) = %s",
                                     __FUNCTION__, (unsigned)reg_info.cid, (char *)esp_err_to_name(error));
         } else {
@@ -509,6 +522,8 @@ static esp_err_t mbc_serial_master_set_parameter_with(void *ctx, uint16_t cid, u
         error = mbc_serial_master_send_request(ctx, &request, value_ptr);
         if (error == ESP_OK)
         {
+            // The cached value is outdated by the write
+            mbc_master_cache_invalidate(MB_MASTER_GET_OPTS(ctx), cid);
             ESP_LOGD(TAG, "%s: Good response for set cid(%u) = %s",
                      __FUNCTION__, (unsigned)reg_info.cid, (char *)esp_err_to_name(error));
         }
@@ -565,6 +580,12 @@ static esp_err_t mbc_serial_master_controller_create(void **ctx)
     // Initialize interface properties
     mb_master_options_t *mbm_opts = &mbm_controller_iface->opts;
     mbm_opts->task_handle = NULL;
+    mbm_opts->param_descriptor_table = NULL;
+    mbm_opts->mbm_param_descriptor_size = 0;
+    memset(&mbm_opts->param_index, 0, sizeof(mbm_opts->param_index));
+    memset(&mbm_opts->read_plan, 0, sizeof(mbm_opts->read_plan));
+    memset(&mbm_opts->value_cache, 0, sizeof(mbm_opts->value_cache));
+    CRITICAL_SECTION_INIT(mbm_opts->value_cache.lock);
 
     // Initialization of active context of the modbus controller
     mbm_opts->event_group_handle = xEventGroupCreate();
@@ -593,6 +614,7 @@ static esp_err_t mbc_serial_master_controller_create(void **ctx)
     mbm_controller_iface->get_cid_info = mbc_serial_master_get_cid_info;
     mbm_controller_iface->get_parameter = mbc_serial_master_get_parameter;
     mbm_controller_iface->get_parameter_with = mbc_serial_master_get_parameter_with;
+    mbm_controller_iface->get_parameters = NULL;
     mbm_controller_iface->send_request = mbc_serial_master_send_request;
     mbm_controller_iface->set_descriptor = mbc_serial_master_set_descriptor;
     mbm_controller_iface->set_parameter = mbc_serial_master_set_parameter;
@@ -211,6 +211,9 @@ static esp_err_t mbc_serial_slave_controller_create(void **ctx)
     mbs_controller_iface->check_event = mbc_serial_slave_check_event;
     mbs_controller_iface->get_param_info = mbc_serial_slave_get_param_info;
     mbs_controller_iface->set_descriptor = NULL; // Use common set descriptor function
+    mbs_controller_iface->get_client_stats = NULL; // No client connections in serial mode
+    mbs_controller_iface->get_request_info = NULL; // The requests are not queued in serial mode
+    mbs_controller_iface->foreach_request = NULL;
     mbs_controller_iface->start = mbc_serial_slave_start;
     mbs_controller_iface->stop = mbc_serial_slave_stop;
     mbs_controller_iface->mb_base = NULL;
@@ -137,8 +137,7 @@ static esp_err_t mbc_tcp_master_set_descriptor(void *ctx, const mb_parameter_des
 
     // Go through all items in the table to check all Modbus registers
     for (int idx = 0; idx < (num_elements); idx++, reg_ptr++) {
-        // Check consistency of the table format and required fields.
-        MB_RETURN_ON_FALSE((reg_ptr->cid == idx), ESP_ERR_INVALID_ARG, TAG, "mb descriptor cid field is incorrect.");
+        // Check consistency of the table format and required fields, the cid uniqueness is checked by the index.
         MB_RETURN_ON_FALSE((reg_ptr->param_key), ESP_ERR_INVALID_ARG, TAG, "mb descriptor param key is incorrect.");
         MB_RETURN_ON_FALSE((reg_ptr->mb_size > 0), ESP_ERR_INVALID_ARG, TAG, "mb descriptor param size is incorrect.");
         
@@ -157,113 +156,247 @@ static esp_err_t mbc_tcp_master_set_descriptor(void *ctx, const mb_parameter_des
     return ESP_OK;
 }
 
-// Send custom Modbus request defined as mb_param_request_t structure
-static esp_err_t mbc_tcp_master_send_request(void *ctx, mb_param_request_t *request, void *data_ptr)
+// Builds the request PDU for the standard function, returns MB_ENOREG for other functions
+static mb_err_enum_t mbc_tcp_master_pack_request(const mb_param_request_t *request, const void *data_ptr,
+                                                    uint8_t *pdu_ptr, uint16_t *pdu_len)
 {
-    mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(ctx);
-    mbm_controller_iface_t *mbm_controller_iface = MB_MASTER_GET_IFACE(ctx);
-    MB_RETURN_ON_FALSE((request), ESP_ERR_INVALID_ARG, TAG, "mb request structure.");
-    MB_RETURN_ON_FALSE((data_ptr), ESP_ERR_INVALID_ARG, TAG, "mb incorrect data pointer.");
-
-    mb_err_enum_t mb_error = MB_EBUSY;
+    uint16_t reg_size = request->reg_size;
+    uint16_t byte_cnt = 0;
+    uint16_t len = 0;
+    const uint16_t *reg_ptr = (const uint16_t *)data_ptr;
 
-    if (xSemaphoreTake(mbm_opts->mbm_sema, pdMS_TO_TICKS(MB_MAX_RESP_DELAY_MS)) == pdTRUE) {
-        uint8_t mb_slave_addr = request->slave_addr;
-        uint8_t mb_command = request->command;
-        uint16_t mb_offset = request->reg_start;
-        uint16_t mb_size = request->reg_size;
-
-        // Set the buffer for callback function processing of received data
-        mbm_opts->reg_buffer_ptr = (uint8_t *)data_ptr;
-        mbm_opts->reg_buffer_size = mb_size;
+    if (request->slave_addr > MB_ADDRESS_MAX) {
+        return MB_EINVAL;
+    }
+    pdu_ptr[MB_PDU_FUNC_OFF] = request->command;
+    pdu_ptr[MB_PDU_DATA_OFF] = request->reg_start >> 8;
+    pdu_ptr[MB_PDU_DATA_OFF + 1] = request->reg_start;
 
-        // Calls appropriate request function to send request and waits response
-        switch(mb_command) {
+    switch(request->command) {
 #if MB_FUNC_READ_COILS_ENABLED
-            case MB_FUNC_READ_COILS:
-                mb_error = mbm_rq_read_coils(mbm_controller_iface->mb_base, mb_slave_addr, 
-                                                mb_offset, mb_size , pdMS_TO_TICKS(MB_MAX_RESP_DELAY_MS));
-                break;
+        case MB_FUNC_READ_COILS:
 #endif
-
-#if MB_FUNC_WRITE_COIL_ENABLED
-            case MB_FUNC_WRITE_SINGLE_COIL:
-                mb_error = mbm_rq_write_coil(mbm_controller_iface->mb_base, mb_slave_addr, mb_offset,
-                                                    *(uint16_t *)data_ptr, 
-                                                    pdMS_TO_TICKS(MB_MAX_RESP_DELAY_MS));
-                break;
+#if MB_FUNC_READ_DISCRETE_INPUTS_ENABLED
+        case MB_FUNC_READ_DISCRETE_INPUTS:
 #endif
-
-#if MB_FUNC_WRITE_MULTIPLE_COILS_ENABLED
-            case MB_FUNC_WRITE_MULTIPLE_COILS:
-                mb_error = mbm_rq_write_multi_coils(mbm_controller_iface->mb_base, mb_slave_addr, mb_offset,
-                                                                mb_size, (uint8_t *)data_ptr, 
-                                                                pdMS_TO_TICKS(MB_MAX_RESP_DELAY_MS));
-                break;
+#if MB_FUNC_READ_HOLDING_ENABLED
+        case MB_FUNC_READ_HOLDING_REGISTER:
 #endif
-
-#if MB_FUNC_READ_DISCRETE_INPUTS_ENABLED
-            case MB_FUNC_READ_DISCRETE_INPUTS:
-                mb_error = mbm_rq_read_discrete_inputs(mbm_controller_iface->mb_base, mb_slave_addr, mb_offset,
-                                                        mb_size, pdMS_TO_TICKS(MB_MAX_RESP_DELAY_MS));
-                break;
+#if MB_FUNC_READ_INPUT_ENABLED
+        case MB_FUNC_READ_INPUT_REGISTER:
+#endif
+#if (MB_FUNC_READ_COILS_ENABLED || MB_FUNC_READ_DISCRETE_INPUTS_ENABLED || MB_FUNC_READ_HOLDING_ENABLED || MB_FUNC_READ_INPUT_ENABLED)
+            pdu_ptr[MB_PDU_DATA_OFF + 2] = reg_size >> 8;
+            pdu_ptr[MB_PDU_DATA_OFF + 3] = reg_size;
+            len = MB_PDU_DATA_OFF + 4;
+            break;
 #endif
 
-#if MB_FUNC_READ_HOLDING_ENABLED
-            case MB_FUNC_READ_HOLDING_REGISTER:
-                mb_error = mbm_rq_read_holding_reg(mbm_controller_iface->mb_base, mb_slave_addr, mb_offset,
-                                                                mb_size, pdMS_TO_TICKS(MB_MAX_RESP_DELAY_MS));
-                break;
+#if MB_FUNC_WRITE_COIL_ENABLED
+        case MB_FUNC_WRITE_SINGLE_COIL:
+            if ((*reg_ptr != 0xFF00) && (*reg_ptr != 0x0000)) {
+                return MB_EINVAL;
+            }
+            pdu_ptr[MB_PDU_DATA_OFF + 2] = *reg_ptr >> 8;
+            pdu_ptr[MB_PDU_DATA_OFF + 3] = *reg_ptr;
+            len = MB_PDU_DATA_OFF + 4;
+            break;
 #endif
 
 #if MB_FUNC_WRITE_HOLDING_ENABLED
-            case MB_FUNC_WRITE_REGISTER:
-                mb_error = mbm_rq_write_holding_reg(mbm_controller_iface->mb_base, mb_slave_addr, mb_offset,
-                                                                *(uint16_t *)data_ptr, 
-                                                                pdMS_TO_TICKS(MB_MAX_RESP_DELAY_MS));
-                break;
+        case MB_FUNC_WRITE_REGISTER:
+            pdu_ptr[MB_PDU_DATA_OFF + 2] = *reg_ptr >> 8;
+            pdu_ptr[MB_PDU_DATA_OFF + 3] = *reg_ptr;
+            len = MB_PDU_DATA_OFF + 4;
+            break;
+#endif
+
+#if MB_FUNC_WRITE_MULTIPLE_COILS_ENABLED
+        case MB_FUNC_WRITE_MULTIPLE_COILS:
+            byte_cnt = (reg_size + 7) >> 3;
+            pdu_ptr[MB_PDU_DATA_OFF + 2] = reg_size >> 8;
+            pdu_ptr[MB_PDU_DATA_OFF + 3] = reg_size;
+            pdu_ptr[MB_PDU_DATA_OFF + 4] = byte_cnt;
+            len = MB_PDU_DATA_OFF + 5 + byte_cnt;
+            if (len > MB_PDU_SIZE_MAX) {
+                return MB_EINVAL;
+            }
+            memcpy(&pdu_ptr[MB_PDU_DATA_OFF + 5], data_ptr, byte_cnt);
+            break;
 #endif
 
 #if MB_FUNC_WRITE_MULTIPLE_HOLDING_ENABLED
-            case MB_FUNC_WRITE_MULTIPLE_REGISTERS:
-                mb_error = mbm_rq_write_multi_holding_reg(mbm_controller_iface->mb_base, mb_slave_addr,
-                                                            mb_offset, mb_size, (uint16_t *)data_ptr, pdMS_TO_TICKS(MB_MAX_RESP_DELAY_MS));
-                break;
+        case MB_FUNC_WRITE_MULTIPLE_REGISTERS:
+            byte_cnt = reg_size << 1;
+            pdu_ptr[MB_PDU_DATA_OFF + 2] = reg_size >> 8;
+            pdu_ptr[MB_PDU_DATA_OFF + 3] = reg_size;
+            pdu_ptr[MB_PDU_DATA_OFF + 4] = byte_cnt;
+            len = MB_PDU_DATA_OFF + 5 + byte_cnt;
+            if (len > MB_PDU_SIZE_MAX) {
+                return MB_EINVAL;
+            }
+            for (uint16_t idx = 0; idx < reg_size; idx++) {
+                pdu_ptr[MB_PDU_DATA_OFF + 5 + (idx << 1)] = reg_ptr[idx] >> 8;
+                pdu_ptr[MB_PDU_DATA_OFF + 6 + (idx << 1)] = reg_ptr[idx];
+            }
+            break;
 #endif
 
 #if MB_FUNC_READWRITE_HOLDING_ENABLED
-            case MB_FUNC_READWRITE_MULTIPLE_REGISTERS:
-                mb_error = mbm_rq_rw_multi_holding_reg(mbm_controller_iface->mb_base, mb_slave_addr, mb_offset,
-                                                            mb_size, (uint16_t *)data_ptr, mb_offset, mb_size, pdMS_TO_TICKS(MB_MAX_RESP_DELAY_MS));
-                break;
+        case MB_FUNC_READWRITE_MULTIPLE_REGISTERS:
+            // The same registers are written and then read back
+            byte_cnt = reg_size << 1;
+            pdu_ptr[MB_PDU_DATA_OFF + 2] = reg_size >> 8;
+            pdu_ptr[MB_PDU_DATA_OFF + 3] = reg_size;
+            pdu_ptr[MB_PDU_DATA_OFF + 4] = request->reg_start >> 8;
+            pdu_ptr[MB_PDU_DATA_OFF + 5] = request->reg_start;
+            pdu_ptr[MB_PDU_DATA_OFF + 6] = reg_size >> 8;
+            pdu_ptr[MB_PDU_DATA_OFF + 7] = reg_size;
+            pdu_ptr[MB_PDU_DATA_OFF + 8] = byte_cnt;
+            len = MB_PDU_DATA_OFF + 9 + byte_cnt;
+            if (len > MB_PDU_SIZE_MAX) {
+                return MB_EINVAL;
+            }
+            for (uint16_t idx = 0; idx < reg_size; idx++) {
+                pdu_ptr[MB_PDU_DATA_OFF + 9 + (idx << 1)] = reg_ptr[idx] >> 8;
+                pdu_ptr[MB_PDU_DATA_OFF + 10 + (idx << 1)] = reg_ptr[idx];
+            }
+            break;
 #endif
+        default:
+            return MB_ENOREG;
+    }
+    *pdu_len = len;
+    return MB_ENOERR;
+}
 
-#if MB_FUNC_READ_INPUT_ENABLED
-            case MB_FUNC_READ_INPUT_REGISTER:
-                mb_error = mbm_rq_read_inp_reg(mbm_controller_iface->mb_base, mb_slave_addr, mb_offset,
-                                                            mb_size, pdMS_TO_TICKS(MB_MAX_RESP_DELAY_MS));
-                break;
+// Checks the response PDU to the standard function and copies the read data into the buffer
+static mb_err_enum_t mbc_tcp_master_unpack_response(const mb_param_request_t *request, const uint8_t *pdu_ptr,
+                                                        uint16_t pdu_len, void *data_ptr)
+{
+    uint16_t reg_size = request->reg_size;
+    uint8_t *dst_ptr = (uint8_t *)data_ptr;
+    const uint8_t *src_ptr = &pdu_ptr[MB_PDU_DATA_OFF + 1];
+    uint16_t byte_cnt = 0;
+    uint8_t mask = 0;
+
+    if ((pdu_len < MB_PDU_SIZE_MIN) || ((pdu_ptr[MB_PDU_FUNC_OFF] & ~MB_FUNC_ERROR) != request->command)) {
+        return MB_ERECVDATA;
+    }
+    if (pdu_ptr[MB_PDU_FUNC_OFF] & MB_FUNC_ERROR) {
+        ESP_LOGD(TAG, "%s: exception (0x%x) in response to function (0x%x).",
+                    __func__, (int)pdu_ptr[MB_PDU_DATA_OFF], (int)request->command);
+        return MB_EILLFUNC;
+    }
+
+    switch(request->command) {
+        case MB_FUNC_READ_COILS:
+        case MB_FUNC_READ_DISCRETE_INPUTS:
+            byte_cnt = (reg_size + 7) >> 3;
+            if (!reg_size || (pdu_len < (MB_PDU_DATA_OFF + 1 + byte_cnt)) || (pdu_ptr[MB_PDU_DATA_OFF] != byte_cnt)) {
+                return MB_EILLFUNC;
+            }
+            memcpy(dst_ptr, src_ptr, byte_cnt - 1);
+            // Keep the bits of the last byte which are out of the requested range
+            mask = (uint8_t)(0xFF >> ((8 - (reg_size & 0x07)) & 0x07));
+            dst_ptr[byte_cnt - 1] = (dst_ptr[byte_cnt - 1] & ~mask) | (src_ptr[byte_cnt - 1] & mask);
+            break;
+
+        case MB_FUNC_READ_HOLDING_REGISTER:
+        case MB_FUNC_READ_INPUT_REGISTER:
+        case MB_FUNC_READWRITE_MULTIPLE_REGISTERS:
+            byte_cnt = reg_size << 1;
+            if (!reg_size || (pdu_len < (MB_PDU_DATA_OFF + 1 + byte_cnt)) || (pdu_ptr[MB_PDU_DATA_OFF] != byte_cnt)) {
+                return MB_EILLFUNC;
+            }
+            for (uint16_t idx = 0; idx < reg_size; idx++) {
+                _XFER_2_WR(dst_ptr, src_ptr);
+                dst_ptr += 2;
+            }
+            break;
+
+        default:
+            // The write functions echo the address and value or quantity
+            if (pdu_len != (MB_PDU_DATA_OFF + 4)) {
+                return MB_EILLFUNC;
+            }
+            break;
+    }
+    return MB_ENOERR;
+}
+
+// Checks the response frame with MBAP header and copies the read data into the buffer
+static mb_err_enum_t mbc_tcp_master_check_response(const mb_param_request_t *request, const uint8_t *frame_ptr,
+                                                    uint16_t frame_len, void *data_ptr)
+{
+#if MB_TCP_UID_ENABLED
+    if ((frame_ptr[MB_TCP_UID] != request->slave_addr) && (frame_ptr[MB_TCP_UID] != MB_TCP_PSEUDO_ADDRESS)) {
+        return MB_ERECVDATA;
+    }
 #endif
-            default:
-                mb_fn_handler_fp handler = NULL;
-                // check registered function handler
-                mb_error = mbm_get_handler(mbm_controller_iface->mb_base, mb_command, &handler);
-                if (mb_error == MB_ENOERR) {
-                    // send the request for custom command
-                    mb_error = mbm_rq_custom(mbm_controller_iface->mb_base, mb_slave_addr, mb_command,
-                                                data_ptr, (uint16_t)(mb_size << 1),
-                                                pdMS_TO_TICKS(MB_MAX_RESP_DELAY_MS));
-                    ESP_LOGD(TAG, "%s: Send custom request (%u)", __FUNCTION__, mb_command);
-                } else {
-                    ESP_LOGE(TAG, "%s: Incorrect or unsupported function in request (%u), error = (0x%x) ", __FUNCTION__, mb_command, (int)mb_error);
-                    mb_error = MB_ENOREG;
-                }
-                break;
+    return mbc_tcp_master_unpack_response(request, &frame_ptr[MB_TCP_FUNC], (frame_len - MB_TCP_FUNC), data_ptr);
+}
+
+// Sends the request for custom function through the master object, one request at a time
+static mb_err_enum_t mbc_tcp_master_send_custom(void *ctx, mb_param_request_t *request, void *data_ptr)
+{
+    mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(ctx);
+    mbm_controller_iface_t *mbm_controller_iface = MB_MASTER_GET_IFACE(ctx);
+    mb_err_enum_t mb_error = MB_EBUSY;
+
+    if (xSemaphoreTake(mbm_opts->mbm_sema, pdMS_TO_TICKS(MB_MAX_RESP_DELAY_MS)) == pdTRUE) {
+        uint8_t mb_command = request->command;
+        mb_fn_handler_fp handler = NULL;
+        // Set the buffer for callback function processing of received data
+        mbm_opts->reg_buffer_ptr = (uint8_t *)data_ptr;
+        mbm_opts->reg_buffer_size = request->reg_size;
+        // check registered function handler
+        mb_error = mbm_get_handler(mbm_controller_iface->mb_base, mb_command, &handler);
+        if (mb_error == MB_ENOERR) {
+            // send the request for custom command
+            mb_error = mbm_rq_custom(mbm_controller_iface->mb_base, request->slave_addr, mb_command,
+                                        data_ptr, (uint16_t)(request->reg_size << 1),
+                                        pdMS_TO_TICKS(MB_MAX_RESP_DELAY_MS));
+            ESP_LOGD(TAG, "%s: Send custom request (%u)", __FUNCTION__, mb_command);
+        } else {
+            ESP_LOGE(TAG, "%s: Incorrect or unsupported function in request (%u), error = (0x%x) ", __FUNCTION__, mb_command, (int)mb_error);
+            mb_error = MB_ENOREG;
         }
+        (void)xSemaphoreGive(mbm_opts->mbm_sema);
     } else {
         ESP_LOGD(TAG, "%s:MBC semaphore take fail.", __func__);
     }
-    (void)xSemaphoreGive(mbm_opts->mbm_sema);
+    return mb_error;
+}
+
+// Send custom Modbus request defined as mb_param_request_t structure
+// The standard functions are sent directly to the port and can be issued from several tasks
+// concurrently, the responses are matched by TID.
+static esp_err_t mbc_tcp_master_send_request(void *ctx, mb_param_request_t *request, void *data_ptr)
+{
+    mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(ctx);
+    mbm_controller_iface_t *mbm_controller_iface = MB_MASTER_GET_IFACE(ctx);
+    MB_RETURN_ON_FALSE((request), ESP_ERR_INVALID_ARG, TAG, "mb request structure.");
+    MB_RETURN_ON_FALSE((data_ptr), ESP_ERR_INVALID_ARG, TAG, "mb incorrect data pointer.");
+
+    mb_err_enum_t mb_error = MB_EBUSY;
+    uint16_t pdu_len = 0;
+    uint8_t *frame_ptr = mb_port_frame_alloc(MB_TCP_BUFF_MAX_SIZE);
+    MB_RETURN_ON_FALSE((frame_ptr), ESP_ERR_NO_MEM, TAG, "mb frame allocation fail.");
+
+    mb_error = mbc_tcp_master_pack_request(request, data_ptr, &frame_ptr[MB_TCP_FUNC], &pdu_len);
+    if (mb_error == MB_ENOERR) {
+        uint16_t frame_len = MB_TCP_BUFF_MAX_SIZE;
+        mb_error = mbm_port_tcp_transfer(mbm_controller_iface->mb_base->port_obj, request->slave_addr,
+                                            frame_ptr, (MB_TCP_FUNC + pdu_len), &frame_len,
+                                            mbm_opts->comm_opts.tcp_opts.response_tout_ms);
+        if (mb_error == MB_ENOERR) {
+            mb_error = mbc_tcp_master_check_response(request, frame_ptr, frame_len, data_ptr);
+        }
+    } else if (mb_error == MB_ENOREG) {
+        mb_error = mbc_tcp_master_send_custom(ctx, request, data_ptr);
+    }
+    mb_port_frame_free(frame_ptr);
 
     // Propagate the Modbus errors to higher level
     return MB_ERR_TO_ESP_ERR(mb_error);
@@ -277,11 +410,12 @@ static esp_err_t mbc_tcp_master_get_cid_info(void *ctx, uint16_t cid, const mb_p
                         ESP_ERR_INVALID_ARG, TAG, "mb incorrect data buffer pointer.");
     MB_RETURN_ON_FALSE((mbm_opts->param_descriptor_table),
                         ESP_ERR_INVALID_ARG, TAG, "mb incorrect descriptor table or not set.");
-    MB_RETURN_ON_FALSE((cid < mbm_opts->mbm_param_descriptor_size),
+    uint16_t index = mbc_master_index_get(mbm_opts, cid);
+    MB_RETURN_ON_FALSE((index != MB_PARAM_INDEX_NONE),
                         ESP_ERR_NOT_FOUND, TAG, "mb incorrect cid of characteristic.");
 
-    // It is assumed that characteristics cid increased in the table
-    const mb_parameter_descriptor_t *reg_info = &mbm_opts->param_descriptor_table[cid];
+    // The characteristic is found by the index of the table built on set descriptor
+    const mb_parameter_descriptor_t *reg_info = &mbm_opts->param_descriptor_table[index];
 
     MB_RETURN_ON_FALSE((reg_info->param_key),
                         ESP_ERR_INVALID_ARG, TAG, "mb incorrect characteristic key.");
@@ -297,10 +431,11 @@ static esp_err_t mbc_tcp_master_set_request(void *ctx, uint16_t cid, mb_param_mo
     esp_err_t error = ESP_ERR_NOT_FOUND;
     MB_RETURN_ON_FALSE((request), ESP_ERR_INVALID_ARG, TAG, "mb incorrect request parameter.");
     MB_RETURN_ON_FALSE((mode <= MB_PARAM_WRITE), ESP_ERR_INVALID_ARG, TAG, "mb incorrect mode.");
-    MB_RETURN_ON_FALSE((cid < mbm_opts->mbm_param_descriptor_size), ESP_ERR_INVALID_ARG, TAG, "mb incorrect cid parameter.");
     MB_RETURN_ON_FALSE((mbm_opts->param_descriptor_table), ESP_ERR_INVALID_ARG, TAG, "mb data dictionary is incorrect.");
+    uint16_t index = mbc_master_index_get(mbm_opts, cid);
+    MB_RETURN_ON_FALSE((index != MB_PARAM_INDEX_NONE), ESP_ERR_INVALID_ARG, TAG, "mb incorrect cid parameter.");
     const mb_parameter_descriptor_t *reg_ptr = mbm_opts->param_descriptor_table;
-    reg_ptr += cid;
+    reg_ptr += index;
     if (reg_ptr->cid == cid) {
         request->slave_addr = reg_ptr->mb_slave_addr;
         request->reg_start = reg_ptr->mb_reg_start;
@@ -328,6 +463,11 @@ static esp_err_t mbc_tcp_master_get_parameter(void *ctx, uint16_t cid, uint8_t *
 
     error = mbc_tcp_master_set_request(ctx, cid, MB_PARAM_READ, &request, &reg_info);
     if ((error == ESP_OK) && (cid == reg_info.cid) && (request.slave_addr != MB_SLAVE_ADDR_PLACEHOLDER)) {
+        // The value is taken from the cache while it is not older than the max age of characteristic
+        *type = reg_info.param_type;
+        if (mbc_master_cache_get(MB_MASTER_GET_OPTS(ctx), cid, value) == ESP_OK) {
+            return ESP_OK;
+        }
         mb_uid_info_t *addr_info = mbm_port_tcp_get_slave_info(mbm_controller_iface->mb_base->port_obj,
                                                                         request.slave_addr, MB_SOCK_STATE_CONNECTED);
         if (!addr_info) {
@@ -342,6 +482,7 @@ static esp_err_t mbc_tcp_master_get_parameter(void *ctx, uint16_t cid, uint8_t *
         }
         error = mbc_tcp_master_send_request(ctx, &request, data_ptr);
         if (error == ESP_OK) {
+            mbc_master_cache_set(MB_MASTER_GET_OPTS(ctx), cid, data_ptr);
             // If data pointer is NULL then we don't need to set value (it is still in the cache of cid)
             if (value) {
                 error = mbc_master_set_param_data((void *)value, (void *)data_ptr,
@@ -429,6 +570,199 @@ static esp_err_t mbc_tcp_master_get_parameter_with(void *ctx, uint16_t cid, uint
     return error;
 }
 
+// The state of one request sent by mbc_tcp_master_get_parameters(), the request reads one characteristic
+// or the block of the read plan shared by several characteristics
+typedef struct {
+    mb_param_request_t request;
+    uint16_t block;
+    uint8_t *frame_ptr;
+    uint8_t *data_ptr;
+    uint16_t frame_len;
+    bool is_started;
+    bool is_done;
+    esp_err_t error;
+    mbm_tcp_pending_t pending;
+} mbc_tcp_poll_item_t;
+
+#define MBC_TCP_POLL_NO_ITEM (0xFFFF)
+
+// Reads the response to the started request into the data buffer of the item
+static esp_err_t mbc_tcp_master_poll_complete(void *ctx, mbc_tcp_poll_item_t *item)
+{
+    mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(ctx);
+    mbm_controller_iface_t *mbm_controller_iface = MB_MASTER_GET_IFACE(ctx);
+    uint16_t frame_len = 0;
+
+    mb_err_enum_t mb_error = mbm_port_tcp_transfer_wait(mbm_controller_iface->mb_base->port_obj, &item->pending,
+                                                        &frame_len, mbm_opts->comm_opts.tcp_opts.response_tout_ms);
+    if (mb_error == MB_ENOERR) {
+        item->data_ptr = calloc(1, (item->request.reg_size << 1));
+        if (!item->data_ptr) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        mb_error = mbc_tcp_master_check_response(&item->request, item->frame_ptr, frame_len, item->data_ptr);
+    }
+    ESP_LOGD(TAG, "%s: Response to request of uid(%u), reg(%u) = %s", __FUNCTION__,
+                (unsigned)item->request.slave_addr, (unsigned)item->request.reg_start,
+                (char *)esp_err_to_name(MB_ERR_TO_ESP_ERR(mb_error)));
+    return MB_ERR_TO_ESP_ERR(mb_error);
+}
+
+// Sets the parameter value from the data read by the request of item
+static esp_err_t mbc_tcp_master_poll_set_param(void *ctx, mbc_tcp_poll_item_t *item, mb_param_poll_t *param)
+{
+    mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(ctx);
+    esp_err_t error = item->error;
+    if (error != ESP_OK) {
+        return error;
+    }
+    if (item->block != MB_READ_PLAN_NO_BLOCK) {
+        // The plan updates the cache even if the value is not requested
+        error = mbc_master_plan_set_param(mbm_opts, param->cid, item->data_ptr, param->value);
+    } else {
+        mbc_master_cache_set(mbm_opts, param->cid, item->data_ptr);
+        // If data pointer is NULL then we don't need to set value
+        if (param->value) {
+            const mb_parameter_descriptor_t *reg_info = &mbm_opts->param_descriptor_table[mbc_master_index_get(mbm_opts, param->cid)];
+            error = mbc_master_set_param_data((void *)param->value, (void *)item->data_ptr,
+                                                reg_info->param_type, reg_info->param_size);
+        }
+    }
+    if (error != ESP_OK) {
+        ESP_LOGE(TAG, "fail to set parameter data.");
+        error = ESP_ERR_INVALID_STATE;
+    }
+    return error;
+}
+
+// Get parameter data for the set of characteristics
+// The request to each slave is started before waiting for the responses, so the slaves are polled
+// at the same time. The requests above the in-flight window of the slave are sent in the next round.
+// The characteristics placed in one block of the read plan are read with one request.
+static esp_err_t mbc_tcp_master_get_parameters(void *ctx, mb_param_poll_t *params, uint16_t count)
+{
+    mbm_controller_iface_t *mbm_controller_iface = MB_MASTER_GET_IFACE(ctx);
+    mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(ctx);
+    mb_port_base_t *port_obj = mbm_controller_iface->mb_base->port_obj;
+    esp_err_t error = ESP_OK;
+    uint16_t item_count = 0;
+    uint16_t left = 0;
+
+    mbc_tcp_poll_item_t *items = calloc(count, sizeof(mbc_tcp_poll_item_t));
+    uint16_t *param_item = calloc(count, sizeof(uint16_t));
+    if (!items || !param_item) {
+        free(items);
+        free(param_item);
+        ESP_LOGE(TAG, "mb poll list allocation fail.");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        mb_param_request_t request;
+        mb_parameter_descriptor_t reg_info = { 0 };
+        param_item[i] = MBC_TCP_POLL_NO_ITEM;
+        params[i].error = mbc_tcp_master_set_request(ctx, params[i].cid, MB_PARAM_READ, &request, &reg_info);
+        if ((params[i].error != ESP_OK) || (request.slave_addr == MB_SLAVE_ADDR_PLACEHOLDER)) {
+            ESP_LOGE(TAG, "%s: The cid(%u) not found in the data dictionary.", __FUNCTION__, (unsigned)params[i].cid);
+            params[i].error = ESP_ERR_INVALID_ARG;
+            continue;
+        }
+        params[i].type = reg_info.param_type;
+        if (mbc_master_cache_get(mbm_opts, params[i].cid, params[i].value) == ESP_OK) {
+            continue;
+        }
+        uint16_t block = mbc_master_plan_get_block(mbm_opts, params[i].cid);
+        if (block != MB_READ_PLAN_NO_BLOCK) {
+            // Share the request of block already in the list
+            for (uint16_t j = 0; j < item_count; j++) {
+                if (items[j].block == block) {
+                    param_item[i] = j;
+                    break;
+                }
+            }
+            if (param_item[i] != MBC_TCP_POLL_NO_ITEM) {
+                continue;
+            }
+            request = mbm_opts->read_plan.blocks[block];
+        }
+        mbc_tcp_poll_item_t *item = &items[item_count];
+        item->frame_ptr = mb_port_frame_alloc(MB_TCP_BUFF_MAX_SIZE);
+        if (!item->frame_ptr) {
+            params[i].error = ESP_ERR_INVALID_STATE;
+            continue;
+        }
+        uint16_t pdu_len = 0;
+        mb_err_enum_t mb_error = mbc_tcp_master_pack_request(&request, NULL, &item->frame_ptr[MB_TCP_FUNC], &pdu_len);
+        if (mb_error != MB_ENOERR) {
+            mb_port_frame_free(item->frame_ptr);
+            item->frame_ptr = NULL;
+            if (mb_error == MB_ENOREG) {
+                // The function is not supported by the port, read the parameter through the master object
+                params[i].error = mbc_tcp_master_get_parameter(ctx, params[i].cid, params[i].value, &params[i].type);
+            } else {
+                params[i].error = MB_ERR_TO_ESP_ERR(mb_error);
+            }
+            continue;
+        }
+        item->request = request;
+        item->block = block;
+        item->frame_len = MB_TCP_FUNC + pdu_len;
+        param_item[i] = item_count++;
+        left++;
+    }
+
+    while (left) {
+        // Start the requests while the slaves have the free place in the in-flight window, the
+        // disconnected slaves fail at once. Wait for the window only if no request can be started.
+        uint16_t started = 0;
+        for (int pass = 0; (pass < 2) && !started; pass++) {
+            for (uint16_t i = 0; i < item_count; i++) {
+                mbc_tcp_poll_item_t *item = &items[i];
+                if (item->is_done || item->is_started) {
+                    continue;
+                }
+                uint32_t wait_ms = (pass && !started) ? MB_TCP_MASTER_WINDOW_TOUT_MS : 0;
+                mb_err_enum_t mb_error = mbm_port_tcp_transfer_start(port_obj, item->request.slave_addr,
+                                                                        item->frame_ptr, item->frame_len, MB_TCP_BUFF_MAX_SIZE,
+                                                                        &item->pending, wait_ms);
+                if (mb_error == MB_ENOERR) {
+                    item->is_started = true;
+                    started++;
+                } else if ((mb_error != MB_EBUSY) || wait_ms) {
+                    item->error = MB_ERR_TO_ESP_ERR(mb_error);
+                    item->is_done = true;
+                    left--;
+                }
+            }
+        }
+        // Collect the responses, the timeout of each request is counted from its send time
+        for (uint16_t i = 0; i < item_count; i++) {
+            mbc_tcp_poll_item_t *item = &items[i];
+            if (item->is_started && !item->is_done) {
+                item->error = mbc_tcp_master_poll_complete(ctx, item);
+                item->is_done = true;
+                left--;
+            }
+        }
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        if (param_item[i] != MBC_TCP_POLL_NO_ITEM) {
+            params[i].error = mbc_tcp_master_poll_set_param(ctx, &items[param_item[i]], &params[i]);
+        }
+        if ((error == ESP_OK) && (params[i].error != ESP_OK)) {
+            error = params[i].error;
+        }
+    }
+    for (uint16_t i = 0; i < item_count; i++) {
+        mb_port_frame_free(items[i].frame_ptr);
+        free(items[i].data_ptr);
+    }
+    free(param_item);
+    free(items);
+    return error;
+}
+
 // Set parameter value for characteristic selected by name and cid
 static esp_err_t mbc_tcp_master_set_parameter(void *ctx, uint16_t cid, uint8_t *value, uint8_t *type)
 {
@@ -464,6 +798,8 @@ static esp_err_t mbc_tcp_master_set_parameter(void *ctx, uint16_t cid, uint8_t *
         // Send request to write characteristic data
         error = mbc_tcp_master_send_request(ctx, &request, data_ptr);
         if (error == ESP_OK) {
+            // The cached value is outdated by the write
+            mbc_master_cache_invalidate(MB_MASTER_GET_OPTS(ctx), cid);
             ESP_LOGD(TAG, "%s: Good response for set cid(%u) = %s",
                                     __FUNCTION__, (unsigned)reg_info.cid, (char *)esp_err_to_name(error));
         } else {
@@ -523,6 +859,8 @@ static esp_err_t mbc_tcp_master_set_parameter_with(void *ctx, uint16_t cid, uint
         // Send request to write characteristic data
         error = mbc_tcp_master_send_request(ctx, &request, data_ptr);
         if (error == ESP_OK) {
+            // The cached value is outdated by the write
+            mbc_master_cache_invalidate(MB_MASTER_GET_OPTS(ctx), cid);
             ESP_LOGD(TAG, "%s: Good response for set cid(%u) = %s",
                                     __FUNCTION__, (unsigned)reg_info.cid, (char *)esp_err_to_name(error));
         } else {
@@ -568,6 +906,10 @@ static esp_err_t mbc_tcp_master_delete(void *ctx)
     mb_error = mbm_iface->mb_base->delete(mbm_iface->mb_base);
     MB_RETURN_ON_FALSE((mb_error == MB_ENOERR), ESP_ERR_INVALID_STATE, TAG,
                         "mb stack delete failure, returned (0x%x).", (unsigned)mb_error);
+    mbc_master_plan_delete(mbm_opts);
+    mbc_master_index_delete(mbm_opts);
+    mbc_master_cache_delete(mbm_opts);
+    CRITICAL_SECTION_CLOSE(mbm_opts->value_cache.lock);
     free(mbm_iface); // free the memory allocated
     ctx = NULL;
     return ESP_OK;
@@ -587,6 +929,12 @@ esp_err_t mbc_tcp_master_controller_create(void ** ctx)
     // Initialize interface properties
     mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(mbm_controller_iface);
     mbm_opts->task_handle = NULL;
+    mbm_opts->param_descriptor_table = NULL;
+    mbm_opts->mbm_param_descriptor_size = 0;
+    memset(&mbm_opts->param_index, 0, sizeof(mbm_opts->param_index));
+    memset(&mbm_opts->read_plan, 0, sizeof(mbm_opts->read_plan));
+    memset(&mbm_opts->value_cache, 0, sizeof(mbm_opts->value_cache));
+    CRITICAL_SECTION_INIT(mbm_opts->value_cache.lock);
 
     // Initialization of active context of the modbus controller
     BaseType_t status = 0;
@@ -617,6 +965,7 @@ esp_err_t mbc_tcp_master_controller_create(void ** ctx)
     mbm_controller_iface->get_cid_info = mbc_tcp_master_get_cid_info;
     mbm_controller_iface->get_parameter = mbc_tcp_master_get_parameter;
     mbm_controller_iface->get_parameter_with = mbc_tcp_master_get_parameter_with;
+    mbm_controller_iface->get_parameters = mbc_tcp_master_get_parameters;
     mbm_controller_iface->send_request = mbc_tcp_master_send_request;
     mbm_controller_iface->set_descriptor = mbc_tcp_master_set_descriptor;
     mbm_controller_iface->set_parameter = mbc_tcp_master_set_parameter;
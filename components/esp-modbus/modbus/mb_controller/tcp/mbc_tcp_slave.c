@@ -108,6 +108,33 @@ static esp_err_t mbc_tcp_slave_get_param_info(void *ctx, mb_param_info_t *reg_in
     return err;
 }
 
+// Function to get the statistics of the connected clients
+static uint16_t mbc_tcp_slave_get_client_stats(void *ctx, mb_tcp_client_stats_t *stats, uint16_t max_count)
+{
+    mbs_controller_iface_t *mbs_iface = MB_SLAVE_GET_IFACE(ctx);
+    MB_RETURN_ON_FALSE((mbs_iface->mb_base && mbs_iface->mb_base->port_obj), 0, TAG,
+                        "mb stack is not initialized.");
+    return mbs_port_tcp_get_client_stats(mbs_iface->mb_base->port_obj, stats, max_count);
+}
+
+// Function to get the unit identifier and the receive time of the request processed by the slave
+static bool mbc_tcp_slave_get_request_info(void *ctx, uint8_t *uid, uint64_t *tick)
+{
+    mbs_controller_iface_t *mbs_iface = MB_SLAVE_GET_IFACE(ctx);
+    MB_RETURN_ON_FALSE((mbs_iface->mb_base && mbs_iface->mb_base->port_obj && uid && tick), false, TAG,
+                        "mb stack is not initialized.");
+    return mbs_port_tcp_get_request_info(mbs_iface->mb_base->port_obj, uid, tick);
+}
+
+// Function to visit the requests waiting in the queue of the slave
+static uint16_t mbc_tcp_slave_foreach_request(void *ctx, iface_request_visitor_fp visitor, void *arg)
+{
+    mbs_controller_iface_t *mbs_iface = MB_SLAVE_GET_IFACE(ctx);
+    MB_RETURN_ON_FALSE((mbs_iface->mb_base && mbs_iface->mb_base->port_obj), 0, TAG,
+                        "mb stack is not initialized.");
+    return mbs_port_tcp_foreach_queued(mbs_iface->mb_base->port_obj, visitor, arg);
+}
+
 // Modbus controller delete function
 static esp_err_t mbc_tcp_slave_delete(void *ctx)
 {
@@ -186,6 +213,9 @@ esp_err_t mbc_tcp_slave_controller_create(void ** ctx)
     mbs_controller_iface->check_event = mbc_tcp_slave_check_event;
     mbs_controller_iface->get_param_info = mbc_tcp_slave_get_param_info;
     mbs_controller_iface->set_descriptor = NULL; // Use common descriptor setter
+    mbs_controller_iface->get_client_stats = mbc_tcp_slave_get_client_stats;
+    mbs_controller_iface->get_request_info = mbc_tcp_slave_get_request_info;
+    mbs_controller_iface->foreach_request = mbc_tcp_slave_foreach_request;
     mbs_controller_iface->start = mbc_tcp_slave_start;
     mbs_controller_iface->stop = mbc_tcp_slave_stop;
     *ctx = mbs_controller_iface;
@@ -119,6 +119,21 @@ typedef struct uid_info_s {
     void *inst;                     /*!< pointer to linked instance */
 } mb_uid_info_t;
 
+#define MB_CLIENT_ADDR_STR_MAX_LEN  (46)   /*!< Maximum length of the client IP address string */
+
+/**
+ * @brief Statistics of the client connection of the TCP slave
+ */
+typedef struct {
+    uint16_t index;                                 /*!< index of the client connection */
+    char ip_addr_str[MB_CLIENT_ADDR_STR_MAX_LEN];   /*!< IP address of the client */
+    uint16_t queue_depth;                           /*!< number of the client requests in the slave queue */
+    uint32_t request_count;                         /*!< number of the client requests served */
+    uint32_t reject_count;                          /*!< number of the requests rejected because the client queue is full */
+    uint32_t latency_avg_us;                        /*!< average time from the request receiving to the response send (uS) */
+    uint32_t latency_max_us;                        /*!< maximum time from the request receiving to the response send (uS) */
+} mb_tcp_client_stats_t;
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
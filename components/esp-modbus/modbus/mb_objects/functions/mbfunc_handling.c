@@ -0,0 +1,91 @@
+/*
+ * SPDX-FileCopyrightText: 2021-2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "mb_common.h"
+#include "mb_proto.h"
+
+/* ----------------------- Defines ------------------------------------------*/
+#define MB_IS_VALID_FUNC_CODE(fc)   ((fc) >= MB_FUNC_CODE_MIN && (fc) <= MB_FUNC_CODE_MAX)
+static const char TAG[] __attribute__((unused)) = "MB_FUNC_HANDLING";
+
+// The set and delete functions are called under the semaphore of descriptor,
+// the handler is replaced with one store and can be read concurrently without the lock.
+mb_err_enum_t mb_set_handler(handler_descriptor_t *descriptor, uint8_t func_code, mb_fn_handler_fp handler)
+{
+    MB_RETURN_ON_FALSE((descriptor && handler && descriptor->instance), MB_EINVAL, TAG, "invalid arguments.");
+    MB_RETURN_ON_FALSE(MB_IS_VALID_FUNC_CODE(func_code), MB_EINVAL, TAG,
+                        "invalid function code (0x%x)", (int)func_code);
+
+    if (atomic_load_explicit(&descriptor->handlers[func_code], memory_order_relaxed)) {
+        // The handler for the function already exists, rewrite it.
+        atomic_store_explicit(&descriptor->handlers[func_code], handler, memory_order_release);
+        ESP_LOGD(TAG, "Inst: %p, set handler: 0x%x, %p", descriptor->instance, (int)func_code, handler);
+        return MB_ENOERR;
+    }
+
+    if (descriptor->count >= MB_FUNC_HANDLERS_MAX) {
+        return MB_ENORES;
+    }
+    descriptor->count += 1;
+    atomic_store_explicit(&descriptor->handlers[func_code], handler, memory_order_release);
+    ESP_LOGD(TAG, "Inst: %p, add handler: 0x%x, %p", descriptor->instance, (int)func_code, handler);
+
+    return MB_ENOERR;
+}
+
+mb_err_enum_t mb_get_handler(handler_descriptor_t *descriptor, uint8_t func_code, mb_fn_handler_fp *handler)
+{
+    MB_RETURN_ON_FALSE((descriptor && handler && descriptor->instance), MB_EINVAL, TAG, "invalid arguments.");
+    MB_RETURN_ON_FALSE(MB_IS_VALID_FUNC_CODE(func_code), MB_EINVAL, TAG,
+                        "invalid function code (0x%x)", (int)func_code);
+
+    mb_fn_handler_fp item = atomic_load_explicit(&descriptor->handlers[func_code], memory_order_acquire);
+    if (item) {
+        *handler = item;
+        ESP_LOGD(TAG, "Inst: %p, get handler: 0x%x, %p", descriptor->instance, (int)func_code, item);
+        return MB_ENOERR;
+    }
+    return MB_ENORES;
+}
+
+// Helper function to delete handler
+mb_err_enum_t mb_delete_handler(handler_descriptor_t *descriptor, uint8_t func_code)
+{
+    MB_RETURN_ON_FALSE((descriptor && descriptor->instance), MB_EINVAL, TAG, "invalid arguments.");
+    MB_RETURN_ON_FALSE(MB_IS_VALID_FUNC_CODE(func_code), MB_EINVAL, TAG,
+                        "invalid function code (0x%x)", (int)func_code);
+
+    if (!descriptor->count) {
+        return MB_EINVAL;
+    }
+
+    mb_fn_handler_fp item = atomic_exchange_explicit(&descriptor->handlers[func_code], NULL, memory_order_acq_rel);
+    if (item) {
+        ESP_LOGD(TAG, "Inst: %p, remove handler: 0x%x, %p", descriptor->instance, (int)func_code, item);
+        descriptor->count--;
+        return MB_ENOERR;
+    }
+
+    return MB_ENORES;
+}
+
+// Helper function to close all registered handlers in the table
+mb_err_enum_t mb_delete_command_handlers(handler_descriptor_t *descriptor)
+{
+    MB_RETURN_ON_FALSE((descriptor), MB_EINVAL, TAG, "invalid arguments.");
+
+    if (!descriptor->count) {
+        return MB_EINVAL;
+    }
+
+    for (int func_code = MB_FUNC_CODE_MIN; func_code <= MB_FUNC_CODE_MAX; func_code++) {
+        mb_fn_handler_fp item = atomic_exchange_explicit(&descriptor->handlers[func_code], NULL, memory_order_acq_rel);
+        if (item) {
+            ESP_LOGD(TAG, "Inst: %p, close handler: 0x%x, %p", descriptor->instance, func_code, item);
+        }
+    }
+    descriptor->count = 0;
+    return MB_ENOERR;
+}
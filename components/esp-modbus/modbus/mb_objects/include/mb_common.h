@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdatomic.h>
 #include <sys/queue.h>
 
 #include "mb_config.h"
@@ -106,22 +107,18 @@ extern "C" {
 }                                               \
 ))
 
+// The number of handler slots indexed by function code (0x01 - 0x7F)
+#define MB_FUNC_HANDLER_SLOTS (0x80)
+
 /**
- * @brief Modbus function handlers entry
+ * @brief Modbus function handlers table
+ *        The handler is read without the semaphore, the semaphore serializes the registration only.
  */
-typedef struct mb_command_entry_s {
-    uint8_t func_code;                          /*!< function code */
-    mb_fn_handler_fp handler;                   /*!< handler function pointer */
-    LIST_ENTRY(mb_command_entry_s) entries;     /*!< command handler entry */
-} mb_command_entry_t;
-
-typedef LIST_HEAD(handler_head, mb_command_entry_s) handler_head_t;
-
 typedef struct mb_handler_descriptor_s {
-    SemaphoreHandle_t sema;
-    void* instance;
-    handler_head_t head;
-    uint16_t count;
+    SemaphoreHandle_t sema;                                     /*!< registration semaphore */
+    void* instance;                                             /*!< parent instance */
+    _Atomic(mb_fn_handler_fp) handlers[MB_FUNC_HANDLER_SLOTS];  /*!< handler of each function code, NULL if not set */
+    uint16_t count;                                             /*!< number of registered handlers */
 } handler_descriptor_t;
 
 typedef struct mb_base_t mb_base_t;
@@ -24,6 +24,9 @@ mb_err_enum_t mbs_get_handler(mb_base_t *inst, uint8_t func_code, mb_fn_handler_
 // The helper function to delete custom function handler for slave
 mb_err_enum_t mbs_delete_handler(mb_base_t *inst, uint8_t func_code);
 
+// The helper function to accept the frames addressed to any unit, the gateway serves all units
+mb_err_enum_t mbs_set_any_address(mb_base_t *inst, bool enable);
+
 // The helper function to get count of handlers for slave
 mb_err_enum_t mbs_get_handler_count(mb_base_t *inst, uint16_t *count);
 
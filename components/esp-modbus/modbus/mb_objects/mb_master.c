@@ -39,6 +39,7 @@ typedef struct
     mb_exception_t exception;
     uint8_t master_dst_addr;
     uint64_t curr_trans_id;
+    bool is_not_sent;           // The current request is not sent, so the slave timeout is not updated
     handler_descriptor_t handler_descriptor;
 } mbm_object_t;
 
@@ -71,9 +72,8 @@ mb_err_enum_t mbm_get_handler(mb_base_t *inst, uint8_t func_code, mb_fn_handler_
     mbm_object_t *mbm_obj = MB_GET_OBJ_CTX(inst, mbm_object_t, base);
     mb_err_enum_t status = MB_EILLSTATE;
     if (handler) {
-        SEMA_SECTION(mbm_obj->handler_descriptor.sema, MB_HANDLER_UNLOCK_TICKS) {
-            status = mb_get_handler(&mbm_obj->handler_descriptor, func_code, handler);
-        }
+        // The handler table is read without the semaphore
+        status = mb_get_handler(&mbm_obj->handler_descriptor, func_code, handler);
     }
     return status;
 }
@@ -109,12 +109,10 @@ static mb_exception_t mbm_check_invoke_handler(mb_base_t *inst, uint8_t func_cod
         exception = (mb_exception_t)buf[MB_PDU_DATA_OFF];
         return exception;
     }
-    SEMA_SECTION(mbm_obj->handler_descriptor.sema, MB_HANDLER_UNLOCK_TICKS) {
-        mb_fn_handler_fp handler = NULL;
-        mb_err_enum_t status = mb_get_handler(&mbm_obj->handler_descriptor, func_code, &handler);
-        if ((status == MB_ENOERR) && handler) {
-            exception = handler(inst, buf, len);
-        }
+    mb_fn_handler_fp handler = NULL;
+    mb_err_enum_t status = mb_get_handler(&mbm_obj->handler_descriptor, func_code, &handler);
+    if ((status == MB_ENOERR) && handler) {
+        exception = handler(inst, buf, len);
     }
     return exception;
 }
@@ -123,7 +121,6 @@ static mb_err_enum_t mbm_register_default_handlers(mb_base_t *inst)
 {
     mbm_object_t *mbm_obj = MB_GET_OBJ_CTX(inst, mbm_object_t, base);
     mb_err_enum_t err = MB_EILLSTATE;
-    LIST_INIT(&mbm_obj->handler_descriptor.head);
     mbm_obj->handler_descriptor.sema = xSemaphoreCreateBinary();
     (void)xSemaphoreGive(mbm_obj->handler_descriptor.sema);
     mbm_obj->handler_descriptor.instance = inst->descr.parent;
@@ -434,7 +431,7 @@ mb_err_enum_t mbm_disable(mb_base_t *inst)
 {
     mb_err_enum_t status = MB_ENOERR;
     mbm_object_t *mbm_obj = MB_GET_OBJ_CTX(inst, mbm_object_t, base);
-    // Wait for function handler to be unlocked before disable the object
+    // Wait for the handler registration to be completed before disable the object
     (void)xSemaphoreTake(mbm_obj->handler_descriptor.sema, MB_HANDLER_UNLOCK_TICKS);
     (void)xSemaphoreGive(mbm_obj->handler_descriptor.sema);
     CRITICAL_SECTION(inst->lock)
@@ -519,6 +516,82 @@ void mbm_error_cb_request_success(mb_base_t *inst, uint8_t dest_address, const u
     ESP_LOG_BUFFER_HEX_LEVEL(__func__, (void *)pdu_data, pdu_length, ESP_LOG_DEBUG);
 }
 
+// Counts the finished transaction in the port statistics
+static void mbm_update_stats(mb_base_t *inst, mb_err_event_t error_type, uint64_t time_div_us)
+{
+    mbm_object_t *mbm_obj = MB_GET_OBJ_CTX(inst, mbm_object_t, base);
+    mb_stats_t *stats = MB_BASE2PORT(inst)->stats_obj;
+    uint8_t func = mbm_obj->snd_frame ? mbm_obj->snd_frame[MB_PDU_FUNC_OFF] : MB_STATS_NO_FUNC;
+    uint32_t latency_us = (time_div_us < UINT32_MAX) ? (uint32_t)time_div_us : UINT32_MAX;
+    switch (error_type) {
+        case EV_ERROR_RESPOND_TIMEOUT:
+            mb_stats_record(stats, mbm_obj->master_dst_addr, func, MB_STATS_RESULT_TIMEOUT,
+                                0, mbm_obj->pdu_snd_len, latency_us);
+            break;
+        case EV_ERROR_RECEIVE_DATA:
+            mb_stats_record(stats, mbm_obj->master_dst_addr, func, MB_STATS_RESULT_FRAME_ERROR,
+                                0, mbm_obj->pdu_snd_len, latency_us);
+            break;
+        case EV_ERROR_EXECUTE_FUNCTION:
+            mb_stats_record(stats, mbm_obj->master_dst_addr, func, MB_STATS_RESULT_EXCEPTION,
+                                mbm_obj->pdu_rcv_len, mbm_obj->pdu_snd_len, latency_us);
+            break;
+        case EV_ERROR_OK:
+            mb_stats_record(stats, mbm_obj->master_dst_addr, func, MB_STATS_RESULT_OK,
+                                mbm_obj->pdu_rcv_len, mbm_obj->pdu_snd_len, latency_us);
+            break;
+        default:
+            break;
+    }
+}
+
+// Gets the response timeout of the slave, returns false if the request must not be sent
+static bool mbm_rto_request(mb_base_t *inst, uint64_t now_us)
+{
+    mbm_object_t *mbm_obj = MB_GET_OBJ_CTX(inst, mbm_object_t, base);
+    mb_port_base_t *port_obj = MB_BASE2PORT(inst);
+    uint32_t tout_ms = 0;
+    // The serial broadcast request is not answered, it waits for the conversion delay
+    if ((mbm_obj->master_dst_addr == MB_ADDRESS_BROADCAST) && (mbm_obj->cur_mode != MB_TCP)) {
+        mb_port_timer_set_request_time(port_obj, 0);
+        return true;
+    }
+    if (!mb_rto_request(port_obj->rto_obj, mbm_obj->master_dst_addr,
+                            mb_port_timer_get_response_time_ms(port_obj), now_us, &tout_ms)) {
+        return false;
+    }
+    mb_port_timer_set_request_time(port_obj, port_obj->rto_obj ? tout_ms : 0);
+    return true;
+}
+
+// Updates the response timeout of the slave with the outcome of the transaction
+static void mbm_rto_response(mb_base_t *inst, mb_err_event_t error_type, uint64_t time_div_us, uint64_t now_us)
+{
+    mbm_object_t *mbm_obj = MB_GET_OBJ_CTX(inst, mbm_object_t, base);
+    mb_rto_t *rto = MB_BASE2PORT(inst)->rto_obj;
+    uint32_t rtt_us = (time_div_us < UINT32_MAX) ? (uint32_t)time_div_us : UINT32_MAX;
+    // The address, function and CRC (LRC) fields of the serial request and response frames
+    uint16_t frame_bytes = mbm_obj->pdu_snd_len + mbm_obj->pdu_rcv_len + (2 * (MB_SER_PDU_PDU_OFF + MB_SER_PDU_SIZE_CRC));
+    if (mbm_obj->is_not_sent || !rto
+            || ((mbm_obj->master_dst_addr == MB_ADDRESS_BROADCAST) && (mbm_obj->cur_mode != MB_TCP))) {
+        return;
+    }
+    switch (error_type) {
+        case EV_ERROR_RESPOND_TIMEOUT:
+            mb_rto_response(rto, mbm_obj->master_dst_addr, MB_RTO_RESULT_TIMEOUT, rtt_us, 0, now_us);
+            break;
+        case EV_ERROR_RECEIVE_DATA:
+            mb_rto_response(rto, mbm_obj->master_dst_addr, MB_RTO_RESULT_FRAME_ERROR, rtt_us, 0, now_us);
+            break;
+        case EV_ERROR_EXECUTE_FUNCTION:
+        case EV_ERROR_OK:
+            mb_rto_response(rto, mbm_obj->master_dst_addr, MB_RTO_RESULT_RESPONSE, rtt_us, frame_bytes, now_us);
+            break;
+        default:
+            break;
+    }
+}
+
 mb_err_enum_t mbm_poll(mb_base_t *inst)
 {
     mbm_object_t *mbm_obj = MB_GET_OBJ_CTX(inst, mbm_object_t, base);;
@@ -547,8 +620,18 @@ mb_err_enum_t mbm_poll(mb_base_t *inst)
                 mbm_get_pdu_send_buf(inst, &mbm_obj->snd_frame);
                 MB_PRT_BUF(inst->descr.parent_name, ":MB_TRANSMIT",
                                 mbm_obj->snd_frame, mbm_obj->pdu_snd_len, ESP_LOG_DEBUG);
+                if (!mbm_rto_request(inst, event.get_ts)) {
+                    // The slave did not respond several times, fail the request without sending it
+                    mb_port_event_set_err_type(MB_OBJ(inst->port_obj), EV_ERROR_RESPOND_TIMEOUT);
+                    (void)mb_port_event_post(MB_OBJ(inst->port_obj), EVENT(EV_ERROR_PROCESS));
+                    ESP_LOGD(TAG, MB_OBJ_FMT", slave #%u is quarantined.", MB_OBJ_PARENT(inst), (unsigned)mbm_obj->master_dst_addr);
+                    mbm_obj->is_not_sent = true;
+                    mbm_obj->curr_trans_id = event.trans_id;
+                    break;
+                }
                 status = MB_OBJ(inst->transp_obj)->frm_send(inst->transp_obj, mbm_obj->master_dst_addr, 
                                                                 mbm_obj->snd_frame, mbm_obj->pdu_snd_len);
+                mbm_obj->is_not_sent = (status != MB_ENOERR);
                 if (status != MB_ENOERR) {
                     mb_port_event_set_err_type(MB_OBJ(inst->port_obj), EV_ERROR_RESPOND_TIMEOUT);
                     (void)mb_port_event_post(MB_OBJ(inst->port_obj), EVENT(EV_ERROR_PROCESS));
@@ -674,6 +757,9 @@ mb_err_enum_t mbm_poll(mb_base_t *inst)
                 mb_port_event_set_err_type(MB_OBJ(inst->port_obj), EV_ERROR_INIT);
                 uint64_t time_div_us = mbm_obj->curr_trans_id ? (event.get_ts - mbm_obj->curr_trans_id) : 0;
                 mbm_obj->curr_trans_id = 0;
+                mbm_update_stats(inst, error_type, time_div_us);
+                mbm_rto_response(inst, error_type, time_div_us, event.get_ts);
+                mbm_obj->is_not_sent = false;
                 ESP_LOGD(TAG, MB_OBJ_FMT", transaction processing time(us) = %" PRId64, MB_OBJ_PARENT(inst), time_div_us);
                 mb_port_event_res_release(MB_OBJ(inst->port_obj));
                 break;
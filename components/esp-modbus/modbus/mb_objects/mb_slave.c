@@ -35,6 +35,9 @@ typedef struct
     uint16_t length;
     uint8_t func_code;
     uint8_t rcv_addr;
+    uint16_t rcv_length;
+    mb_exception_t exception;
+    bool any_address;
     uint64_t curr_trans_id;
     volatile uint16_t *pdu_snd_len;
     handler_descriptor_t handler_descriptor;
@@ -62,9 +65,8 @@ mb_err_enum_t mbs_get_handler(mb_base_t *inst, uint8_t func_code, mb_fn_handler_
     mbs_object_t *mbs_obj = MB_GET_OBJ_CTX(inst, mbs_object_t, base);
     mb_err_enum_t status = MB_EINVAL;
     if (handler) {
-        SEMA_SECTION(mbs_obj->handler_descriptor.sema, MB_HANDLER_UNLOCK_TICKS) {
-            status = mb_get_handler(&mbs_obj->handler_descriptor, func_code, handler);
-        }
+        // The handler table is read without the semaphore
+        status = mb_get_handler(&mbs_obj->handler_descriptor, func_code, handler);
     }
     return status;
 }
@@ -89,6 +91,15 @@ mb_err_enum_t mbs_get_handler_count(mb_base_t *inst, uint16_t *count)
     return MB_ENOERR;
 }
 
+// The helper function to accept the frames addressed to any unit
+mb_err_enum_t mbs_set_any_address(mb_base_t *inst, bool enable)
+{
+    MB_RETURN_ON_FALSE(inst, MB_EINVAL, TAG, "set any address wrong arguments");
+    mbs_object_t *mbs_obj = MB_GET_OBJ_CTX(inst, mbs_object_t, base);
+    mbs_obj->any_address = enable;
+    return MB_ENOERR;
+}
+
 static mb_exception_t mbs_check_invoke_handler(mb_base_t *inst, uint8_t func_code, uint8_t *buf, uint16_t *len)
 {
     mbs_object_t *mbs_obj = MB_GET_OBJ_CTX(inst, mbs_object_t, base);
@@ -96,13 +107,11 @@ static mb_exception_t mbs_check_invoke_handler(mb_base_t *inst, uint8_t func_cod
     if (!func_code || (func_code & MB_FUNC_ERROR)) {
         return MB_EX_ILLEGAL_FUNCTION;
     }
-    SEMA_SECTION(mbs_obj->handler_descriptor.sema, MB_HANDLER_UNLOCK_TICKS) {
-        mb_fn_handler_fp handler = NULL;
-        mb_err_enum_t status = mb_get_handler(&mbs_obj->handler_descriptor, func_code, &handler);
-        if ((status == MB_ENOERR) && handler) {
-            exception = handler(inst, buf, len);
-            ESP_LOGD(TAG, MB_OBJ_FMT": function (0x%x), invoke handler %p.", MB_OBJ_PARENT(inst), (int)func_code, handler);
-        }
+    mb_fn_handler_fp handler = NULL;
+    mb_err_enum_t status = mb_get_handler(&mbs_obj->handler_descriptor, func_code, &handler);
+    if ((status == MB_ENOERR) && handler) {
+        exception = handler(inst, buf, len);
+        ESP_LOGD(TAG, MB_OBJ_FMT": function (0x%x), invoke handler %p.", MB_OBJ_PARENT(inst), (int)func_code, handler);
     }
     return exception;
 }
@@ -111,7 +120,6 @@ static mb_err_enum_t mbs_register_default_handlers(mb_base_t *inst)
 {
     mbs_object_t *mbs_obj = MB_GET_OBJ_CTX(inst, mbs_object_t, base);
     mb_err_enum_t err = MB_EILLSTATE;
-    LIST_INIT(&mbs_obj->handler_descriptor.head);
     mbs_obj->handler_descriptor.sema = xSemaphoreCreateBinary();
     (void)xSemaphoreGive(mbs_obj->handler_descriptor.sema);
     mbs_obj->handler_descriptor.instance = inst->descr.parent;
@@ -447,6 +455,33 @@ void mbs_error_cb_request_success(mb_base_t *inst, uint8_t dest_address, const u
     ESP_LOG_BUFFER_HEX_LEVEL(__func__, (void *)pdu_data, pdu_length, ESP_LOG_DEBUG);
 }
 
+// Counts the finished transaction in the port statistics
+static void mbs_update_stats(mb_base_t *inst, mb_err_event_t error_type, uint64_t time_div_us)
+{
+    mbs_object_t *mbs_obj = MB_GET_OBJ_CTX(inst, mbs_object_t, base);
+    mb_stats_t *stats = MB_BASE2PORT(inst)->stats_obj;
+    uint32_t latency_us = (time_div_us < UINT32_MAX) ? (uint32_t)time_div_us : UINT32_MAX;
+    switch (error_type) {
+        case EV_ERROR_RECEIVE_DATA:
+            // The address and function of the broken frame are unknown
+            mb_stats_record(stats, MB_STATS_NO_NODE, MB_STATS_NO_FUNC, MB_STATS_RESULT_FRAME_ERROR, 0, 0, 0);
+            break;
+        case EV_ERROR_RESPOND_TIMEOUT:
+            mb_stats_record(stats, mbs_obj->rcv_addr, mbs_obj->func_code, MB_STATS_RESULT_TIMEOUT,
+                                mbs_obj->rcv_length, 0, latency_us);
+            break;
+        case EV_ERROR_EXECUTE_FUNCTION:
+        case EV_ERROR_OK:
+            mb_stats_record(stats, mbs_obj->rcv_addr, mbs_obj->func_code,
+                                ((mbs_obj->exception != MB_EX_NONE) || (error_type == EV_ERROR_EXECUTE_FUNCTION))
+                                    ? MB_STATS_RESULT_EXCEPTION : MB_STATS_RESULT_OK,
+                                mbs_obj->rcv_length, mbs_obj->length, latency_us);
+            break;
+        default:
+            break;
+    }
+}
+
 mb_err_enum_t mbs_poll(mb_base_t *inst)
 {
     mbs_object_t *mbs_obj = MB_GET_OBJ_CTX(inst, mbs_object_t, base);;
@@ -478,7 +513,7 @@ mb_err_enum_t mbs_poll(mb_base_t *inst)
                 if (status == MB_ENOERR) {
                     // Check if the frame is for us. If not ignore the frame.
                     if((mbs_obj->rcv_addr == mbs_obj->mb_address) || (mbs_obj->rcv_addr == MB_ADDRESS_BROADCAST)
-                            || (mbs_obj->rcv_addr == MB_TCP_PSEUDO_ADDRESS)) {
+                            || (mbs_obj->rcv_addr == MB_TCP_PSEUDO_ADDRESS) || mbs_obj->any_address) {
                         mbs_obj->curr_trans_id = event.get_ts;
                         (void)mb_port_event_post(MB_OBJ(inst->port_obj), EVENT(EV_EXECUTE | EV_TRANS_START));
                         MB_PRT_BUF(inst->descr.parent_name, ":MB_RECV",
@@ -497,7 +532,9 @@ mb_err_enum_t mbs_poll(mb_base_t *inst)
                 MB_RETURN_ON_FALSE(mbs_obj->frame, MB_EILLSTATE, TAG, "receive buffer fail.");
                 ESP_LOGD(TAG, MB_OBJ_FMT":EV_EXECUTE", MB_OBJ_PARENT(inst));
                 mbs_obj->func_code = mbs_obj->frame[MB_PDU_FUNC_OFF];
+                mbs_obj->rcv_length = mbs_obj->length;
                 exception = mbs_check_invoke_handler(inst, mbs_obj->func_code, mbs_obj->frame, &mbs_obj->length);
+                mbs_obj->exception = exception;
                 // If the request was not sent to the broadcast address, return a reply.
                 if ((mbs_obj->rcv_addr != MB_ADDRESS_BROADCAST) || (mbs_obj->cur_mode == MB_TCP)) {
                     if (exception != MB_EX_NONE) {
@@ -568,6 +605,7 @@ mb_err_enum_t mbs_poll(mb_base_t *inst)
                 mb_port_event_set_err_type(MB_OBJ(inst->port_obj), EV_ERROR_INIT);
                 time_div_us = mbs_obj->curr_trans_id ? (event.get_ts - mbs_obj->curr_trans_id) : 0;
                 mbs_obj->curr_trans_id = 0;
+                mbs_update_stats(inst, error_type, time_div_us);
                 ESP_LOGD(TAG, MB_OBJ_FMT", transaction processing time(us) = %" PRId64, MB_OBJ_PARENT(inst), time_div_us);
                 mb_port_event_res_release(MB_OBJ(inst->port_obj));
                 break;
@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+#include "port_common.h"
+#include "mb_pool.h"
+
+static const char *TAG = "mb_pool";
+
+#define MB_POOL_MEMORY_CAPS (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+
+// The static pool object is zero initialized, so the lock is initialized on first use
+// and the free list is linked under the lock when the first block is requested.
+static void mb_pool_link_blocks(mb_pool_t *pool)
+{
+    pool->free_list = NULL;
+    for (size_t i = pool->block_count; i > 0; i--) {
+        mb_pool_block_t *block = (mb_pool_block_t *)(pool->storage + ((i - 1) * pool->block_size));
+        block->next = pool->free_list;
+        pool->free_list = block;
+    }
+    pool->stats.block_size = pool->block_size;
+    pool->stats.block_count = pool->block_count;
+    pool->is_ready = true;
+}
+
+bool mb_pool_is_owner(mb_pool_t *pool, const void *buf)
+{
+    const uint8_t *ptr = (const uint8_t *)buf;
+    return (pool && pool->storage && (ptr >= pool->storage)
+                && (ptr < (pool->storage + (pool->block_count * pool->block_size))));
+}
+
+void *mb_pool_alloc(mb_pool_t *pool, size_t size)
+{
+    mb_pool_block_t *block = NULL;
+    if (!pool || !size) {
+        return NULL;
+    }
+    CRITICAL_SECTION(pool->lock) {
+        if (!pool->is_ready) {
+            mb_pool_link_blocks(pool);
+        }
+        if (pool->free_list && (size <= pool->block_size)) {
+            block = pool->free_list;
+            pool->free_list = block->next;
+            pool->stats.used++;
+            if (pool->stats.used > pool->stats.high_water) {
+                pool->stats.high_water = pool->stats.used;
+            }
+        }
+    }
+    if (block) {
+        return (void *)block;
+    }
+    void *buf = heap_caps_malloc(size, MB_POOL_MEMORY_CAPS);
+    if (!buf) {
+        ESP_LOGE(TAG, "%s, could not allocate %u bytes.", pool->name, (unsigned)size);
+        return NULL;
+    }
+    CRITICAL_SECTION(pool->lock) {
+        pool->stats.heap_used++;
+        pool->stats.heap_allocs++;
+    }
+    ESP_LOGD(TAG, "%s, heap fallback for %u bytes, used %" PRIu32 " of %" PRIu32 " blocks.",
+                pool->name, (unsigned)size, pool->stats.used, pool->stats.block_count);
+    return buf;
+}
+
+void mb_pool_free(mb_pool_t *pool, void *buf)
+{
+    if (!pool || !buf) {
+        return;
+    }
+    if (mb_pool_is_owner(pool, buf)) {
+        mb_pool_block_t *block = (mb_pool_block_t *)buf;
+        CRITICAL_SECTION(pool->lock) {
+            block->next = pool->free_list;
+            pool->free_list = block;
+            pool->stats.used--;
+        }
+        return;
+    }
+    free(buf);
+    CRITICAL_SECTION(pool->lock) {
+        if (pool->stats.heap_used) {
+            pool->stats.heap_used--;
+        }
+    }
+}
+
+void mb_pool_get_stats(mb_pool_t *pool, mb_pool_stats_t *stats)
+{
+    if (!pool || !stats) {
+        return;
+    }
+    CRITICAL_SECTION(pool->lock) {
+        if (!pool->is_ready) {
+            mb_pool_link_blocks(pool);
+        }
+        *stats = pool->stats;
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "sys/lock.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MB_POOL_ALIGN(size) (((size) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+#if CONFIG_FMB_PORT_POOL_ENABLE
+
+/**
+ * @brief Defines the storage and the pool object for the fixed block pool in static memory
+ */
+#define MB_POOL_DEFINE_STATIC(pool_name, blk_size, blk_count)                                \
+    static uint8_t pool_name##_storage[(blk_count) * MB_POOL_ALIGN(blk_size)]                 \
+                                                    __attribute__((aligned(sizeof(void *))));  \
+    static mb_pool_t pool_name = {                                                             \
+        .name = #pool_name,                                                                    \
+        .storage = pool_name##_storage,                                                        \
+        .block_size = MB_POOL_ALIGN(blk_size),                                                 \
+        .block_count = (blk_count),                                                            \
+    }
+
+#else
+
+// The pool without storage just forwards all allocations to heap
+#define MB_POOL_DEFINE_STATIC(pool_name, blk_size, blk_count)                                \
+    static mb_pool_t pool_name = {                                                             \
+        .name = #pool_name,                                                                    \
+        .storage = NULL,                                                                       \
+        .block_size = MB_POOL_ALIGN(blk_size),                                                 \
+        .block_count = 0,                                                                      \
+    }
+
+#endif
+
+/**
+ * @brief Pool usage statistic
+ */
+typedef struct mb_pool_stats_s {
+    uint32_t block_size;        /*!< The size of one block in the pool */
+    uint32_t block_count;       /*!< The number of blocks in the pool */
+    uint32_t used;              /*!< The number of currently allocated blocks */
+    uint32_t high_water;        /*!< The maximum number of blocks allocated at the same time */
+    uint32_t heap_used;         /*!< The number of currently allocated heap fallback buffers */
+    uint32_t heap_allocs;       /*!< The total number of heap fallback allocations */
+} mb_pool_stats_t;
+
+typedef struct mb_pool_block_s {
+    struct mb_pool_block_s *next;
+} mb_pool_block_t;
+
+/**
+ * @brief Fixed block pool object, the free blocks are linked into the list on first use
+ */
+typedef struct mb_pool_s {
+    const char *name;
+    _lock_t lock;
+    uint8_t *storage;
+    size_t block_size;
+    size_t block_count;
+    bool is_ready;
+    mb_pool_block_t *free_list;
+    mb_pool_stats_t stats;
+} mb_pool_t;
+
+/**
+ * @brief Allocates the block from the pool
+ *
+ * The buffer is allocated from heap when the pool is exhausted or the size exceeds the block size.
+ *
+ * @param pool the pool object
+ * @param size the size of buffer to allocate
+ * @return pointer to the buffer or NULL if the memory is exhausted
+ */
+void *mb_pool_alloc(mb_pool_t *pool, size_t size);
+
+/**
+ * @brief Returns the buffer allocated by mb_pool_alloc() back to the pool or heap
+ *
+ * @param pool the pool object
+ * @param buf pointer to buffer, NULL is ignored
+ */
+void mb_pool_free(mb_pool_t *pool, void *buf);
+
+/**
+ * @brief Checks if the buffer belongs to the pool storage
+ */
+bool mb_pool_is_owner(mb_pool_t *pool, const void *buf);
+
+/**
+ * @brief Gets the usage statistic of the pool
+ */
+void mb_pool_get_stats(mb_pool_t *pool, mb_pool_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
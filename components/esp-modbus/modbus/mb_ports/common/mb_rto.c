@@ -0,0 +1,158 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include "port_common.h"
+#include "mb_rto.h"
+
+#if MB_RTO_ENABLED
+
+#define MB_RTO_FLOOR_MS             (CONFIG_FMB_MASTER_TIMEOUT_MS_FLOOR)
+#define MB_RTO_QUARANTINE_FAILS     (CONFIG_FMB_MASTER_QUARANTINE_FAILS)
+#define MB_RTO_QUARANTINE_MS        (CONFIG_FMB_MASTER_QUARANTINE_MS)
+#define MB_RTO_QUARANTINE_MAX_MS    (CONFIG_FMB_MASTER_QUARANTINE_MAX_MS)
+#define MB_RTO_GRANULARITY_US       (1000)      // the timeout resolution
+#define MB_RTO_SHIFT_MAX            (16)        // limits the back-off shifts, the result is clamped anyway
+
+void mb_rto_init(mb_rto_t *rto, uint32_t byte_time_us, uint16_t frame_max)
+{
+    if (rto) {
+        CRITICAL_SECTION(rto->lock) {
+            rto->byte_time_us = byte_time_us;
+            rto->frame_time_us = byte_time_us * frame_max;
+            memset(rto->nodes, 0, sizeof(rto->nodes));
+        }
+    }
+}
+
+// Finds the entry of the node, the new node takes the free or the least recently used entry
+static mb_rto_node_t *mb_rto_get_node(mb_rto_t *rto, uint8_t node, bool can_take)
+{
+    uint16_t key = (uint16_t)node + 1;
+    mb_rto_node_t *lru = NULL;
+    for (int i = 0; i < MB_RTO_NODES; i++) {
+        if (rto->nodes[i].key == key) {
+            return &rto->nodes[i];
+        }
+        if (!lru || (lru->key && (!rto->nodes[i].key || (rto->nodes[i].last_use_us < lru->last_use_us)))) {
+            lru = &rto->nodes[i];
+        }
+    }
+    if (!can_take) {
+        return NULL;
+    }
+    memset(lru, 0, sizeof(mb_rto_node_t));
+    lru->key = key;
+    return lru;
+}
+
+static uint32_t mb_rto_get_timeout(mb_rto_t *rto, mb_rto_node_t *entry, uint32_t ceiling_ms)
+{
+    uint32_t floor_ms = (MB_RTO_FLOOR_MS < ceiling_ms) ? MB_RTO_FLOOR_MS : ceiling_ms;
+    if (!entry->samples) {
+        return ceiling_ms;
+    }
+    // The variation of the steady slave decays to zero, so its term is kept above the half of the time
+    // to tolerate the occasional slow response without the timeout
+    uint64_t var_us = (uint64_t)entry->rttvar_us * 4;
+    uint64_t min_var_us = entry->srtt_us / 2;
+    if (min_var_us < MB_RTO_GRANULARITY_US) {
+        min_var_us = MB_RTO_GRANULARITY_US;
+    }
+    uint64_t rto_us = (uint64_t)entry->srtt_us + ((var_us > min_var_us) ? var_us : min_var_us) + rto->frame_time_us;
+    uint64_t tout_ms = ((rto_us + 999) / 1000) << ((entry->fails < MB_RTO_SHIFT_MAX) ? entry->fails : MB_RTO_SHIFT_MAX);
+    if (tout_ms < floor_ms) {
+        tout_ms = floor_ms;
+    }
+    return (tout_ms < ceiling_ms) ? (uint32_t)tout_ms : ceiling_ms;
+}
+
+bool mb_rto_request(mb_rto_t *rto, uint8_t node, uint32_t ceiling_ms, uint64_t now_us, uint32_t *timeout_ms)
+{
+    bool is_allowed = true;
+    uint32_t tout_ms = ceiling_ms;
+    if (rto) {
+        CRITICAL_SECTION(rto->lock) {
+            mb_rto_node_t *entry = mb_rto_get_node(rto, node, true);
+            entry->last_use_us = now_us;
+            if (entry->quarantine_until_us > now_us) {
+                is_allowed = false;
+            } else {
+                tout_ms = mb_rto_get_timeout(rto, entry, ceiling_ms);
+                if (entry->fails >= MB_RTO_QUARANTINE_FAILS) {
+                    // This is the probe request, other requests to the node wait for its outcome
+                    entry->quarantine_until_us = now_us + ((uint64_t)tout_ms * 1000);
+                }
+            }
+        }
+    }
+    *timeout_ms = tout_ms;
+    return is_allowed;
+}
+
+void mb_rto_response(mb_rto_t *rto, uint8_t node, mb_rto_result_t result, uint32_t rtt_us,
+                        uint16_t frame_bytes, uint64_t now_us)
+{
+    if (!rto) {
+        return;
+    }
+    CRITICAL_SECTION(rto->lock) {
+        // The entry can be taken by other node while the request is in flight
+        mb_rto_node_t *entry = mb_rto_get_node(rto, node, false);
+        if (entry && (result == MB_RTO_RESULT_TIMEOUT)) {
+            entry->fails++;
+            if (entry->fails >= MB_RTO_QUARANTINE_FAILS) {
+                uint32_t shift = entry->fails - MB_RTO_QUARANTINE_FAILS;
+                uint64_t quarantine_ms = (uint64_t)MB_RTO_QUARANTINE_MS << ((shift < MB_RTO_SHIFT_MAX) ? shift : MB_RTO_SHIFT_MAX);
+                if (quarantine_ms > MB_RTO_QUARANTINE_MAX_MS) {
+                    quarantine_ms = MB_RTO_QUARANTINE_MAX_MS;
+                }
+                entry->quarantine_until_us = now_us + (quarantine_ms * 1000);
+            }
+        } else if (entry) {
+            entry->fails = 0;
+            entry->quarantine_until_us = 0;
+        }
+        if (entry && (result == MB_RTO_RESULT_RESPONSE)) {
+            // RFC 6298: the variation is updated with the previous smoothed time
+            uint32_t wire_us = rto->byte_time_us * frame_bytes;
+            uint32_t sample_us = (rtt_us > wire_us) ? (rtt_us - wire_us) : 0;
+            if (!entry->samples) {
+                entry->srtt_us = sample_us;
+                entry->rttvar_us = sample_us / 2;
+            } else {
+                uint32_t delta_us = (entry->srtt_us > sample_us) ? (entry->srtt_us - sample_us) : (sample_us - entry->srtt_us);
+                entry->rttvar_us = (uint32_t)((3ULL * entry->rttvar_us + delta_us) / 4);
+                entry->srtt_us = (uint32_t)((7ULL * entry->srtt_us + sample_us) / 8);
+            }
+            entry->samples++;
+        }
+    }
+}
+
+bool mb_rto_get(mb_rto_t *rto, uint8_t node, uint32_t ceiling_ms, uint64_t now_us, mb_rto_info_t *info)
+{
+    bool is_found = false;
+    if (!rto || !info) {
+        return false;
+    }
+    CRITICAL_SECTION(rto->lock) {
+        mb_rto_node_t *entry = mb_rto_get_node(rto, node, false);
+        if (entry) {
+            info->node = node;
+            info->samples = entry->samples;
+            info->srtt_us = entry->srtt_us;
+            info->rttvar_us = entry->rttvar_us;
+            info->timeout_ms = mb_rto_get_timeout(rto, entry, ceiling_ms);
+            info->fails = entry->fails;
+            info->quarantine_ms = (entry->quarantine_until_us > now_us)
+                                    ? (uint32_t)((entry->quarantine_until_us - now_us + 999) / 1000) : 0;
+            is_found = true;
+        }
+    }
+    return is_found;
+}
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "sys/lock.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MB_RTO_ENABLED              (CONFIG_FMB_MASTER_ADAPTIVE_TIMEOUT_ENABLE)
+
+/**
+ * @brief The outcome of the request used to update the timeout of the node
+ */
+typedef enum {
+    MB_RTO_RESULT_RESPONSE,         /*!< The normal or exception response is received */
+    MB_RTO_RESULT_FRAME_ERROR,      /*!< The broken or unexpected frame is received, the node is alive */
+    MB_RTO_RESULT_TIMEOUT,          /*!< No response is received */
+} mb_rto_result_t;
+
+/**
+ * @brief The snapshot of the timeout state of the node
+ */
+typedef struct {
+    uint8_t node;                   /*!< The unit address of the node */
+    uint32_t samples;               /*!< The number of the round trip samples */
+    uint32_t srtt_us;               /*!< The smoothed round trip time without the wire time of the frames (uS) */
+    uint32_t rttvar_us;             /*!< The round trip time variation (uS) */
+    uint32_t timeout_ms;            /*!< The response timeout of the next request */
+    uint32_t fails;                 /*!< The number of consecutive timeouts */
+    uint32_t quarantine_ms;         /*!< The time left until the node is polled again, zero if it is not quarantined */
+} mb_rto_info_t;
+
+#if MB_RTO_ENABLED
+
+#define MB_RTO_NODES                (CONFIG_FMB_MASTER_ADAPTIVE_NODES)
+
+typedef struct {
+    uint16_t key;                   /*!< unit address + 1, zero if the entry is free */
+    uint32_t samples;
+    uint32_t srtt_us;
+    uint32_t rttvar_us;
+    uint32_t fails;
+    uint64_t quarantine_until_us;
+    uint64_t last_use_us;
+} mb_rto_node_t;
+
+/**
+ * @brief The response timeouts of the nodes of the master port
+ *
+ * The zero initialized object is empty, the lock is initialized on first use.
+ * The node entry is taken by the first request to the node, the least recently used entry
+ * is replaced when the table is full.
+ */
+typedef struct mb_rto_s {
+    _lock_t lock;
+    uint32_t byte_time_us;          /*!< The wire time of one byte */
+    uint32_t frame_time_us;         /*!< The wire time of the longest response frame */
+    mb_rto_node_t nodes[MB_RTO_NODES];
+} mb_rto_t;
+
+/**
+ * @brief Sets the wire time of the port, zero for TCP
+ *
+ * @param rto the timeout object
+ * @param byte_time_us the time to transfer one byte of the frame
+ * @param frame_max the maximum length of the response frame in bytes
+ */
+void mb_rto_init(mb_rto_t *rto, uint32_t byte_time_us, uint16_t frame_max);
+
+/**
+ * @brief Gets the response timeout for the request to the node
+ *
+ * The timeout is derived from the smoothed round trip time and its variation as the TCP
+ * retransmission timeout (RFC 6298) plus the wire time of the longest response, the variation term
+ * is at least the half of the smoothed time. The timeout is kept within
+ * CONFIG_FMB_MASTER_TIMEOUT_MS_FLOOR and the ceiling, the ceiling is used until the first response
+ * is received and the timeout is doubled after each consecutive timeout. The node is quarantined
+ * after CONFIG_FMB_MASTER_QUARANTINE_FAILS consecutive timeouts, the requests to it fail until
+ * the quarantine is over, then one probe request is sent.
+ *
+ * @param rto the timeout object, NULL to use the ceiling
+ * @param node the unit address
+ * @param ceiling_ms the response timeout of the port
+ * @param now_us the current time
+ * @param timeout_ms returns the response timeout
+ * @return false if the node is quarantined and the request must not be sent
+ */
+bool mb_rto_request(mb_rto_t *rto, uint8_t node, uint32_t ceiling_ms, uint64_t now_us, uint32_t *timeout_ms);
+
+/**
+ * @brief Updates the timeout of the node with the outcome of the sent request
+ *
+ * @param rto the timeout object, NULL is ignored
+ * @param node the unit address
+ * @param result the outcome of the request
+ * @param rtt_us the time from the request to the response
+ * @param frame_bytes the length of the request and response frames, their wire time is excluded from the sample
+ * @param now_us the current time
+ */
+void mb_rto_response(mb_rto_t *rto, uint8_t node, mb_rto_result_t result, uint32_t rtt_us,
+                        uint16_t frame_bytes, uint64_t now_us);
+
+/**
+ * @brief Gets the timeout state of the node
+ *
+ * @return false if the node is not tracked
+ */
+bool mb_rto_get(mb_rto_t *rto, uint8_t node, uint32_t ceiling_ms, uint64_t now_us, mb_rto_info_t *info);
+
+#else
+
+typedef struct mb_rto_s mb_rto_t;
+
+static inline bool mb_rto_request(mb_rto_t *rto, uint8_t node, uint32_t ceiling_ms, uint64_t now_us, uint32_t *timeout_ms)
+{
+    (void)rto; (void)node; (void)now_us;
+    *timeout_ms = ceiling_ms;
+    return true;
+}
+
+static inline void mb_rto_response(mb_rto_t *rto, uint8_t node, mb_rto_result_t result, uint32_t rtt_us,
+                                    uint16_t frame_bytes, uint64_t now_us)
+{
+    (void)rto; (void)node; (void)result; (void)rtt_us; (void)frame_bytes; (void)now_us;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
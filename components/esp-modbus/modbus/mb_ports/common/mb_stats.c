@@ -0,0 +1,292 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include "mb_stats.h"
+
+#if MB_STATS_ENABLED
+
+#define MB_STATS_HIST_SUB_MASK ((1U << MB_STATS_HIST_SUB_BITS) - 1)
+
+// The function codes implemented by the stack, the last entry counts all other functions
+static const uint8_t mb_stats_func_codes[MB_STATS_FUNCS - 1] = {
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x0F, 0x10, 0x11, 0x17
+};
+
+static uint32_t mb_stats_hist_index(uint32_t latency_us)
+{
+    uint32_t value = latency_us >> MB_STATS_HIST_UNIT_SHIFT;
+    if (value < (1U << MB_STATS_HIST_SUB_BITS)) {
+        return value;
+    }
+    uint32_t msb = 31 - __builtin_clz(value);
+    uint32_t index = ((msb - MB_STATS_HIST_SUB_BITS + 1) << MB_STATS_HIST_SUB_BITS)
+                        | ((value >> (msb - MB_STATS_HIST_SUB_BITS)) & MB_STATS_HIST_SUB_MASK);
+    return (index < MB_STATS_HIST_BUCKETS) ? index : (MB_STATS_HIST_BUCKETS - 1);
+}
+
+// Returns the lowest latency of the bucket, so the bucket covers the latencies below the start of the next one
+static uint32_t mb_stats_hist_start(uint32_t index)
+{
+    if (index < (1U << MB_STATS_HIST_SUB_BITS)) {
+        return index << MB_STATS_HIST_UNIT_SHIFT;
+    }
+    uint32_t msb = (index >> MB_STATS_HIST_SUB_BITS) + MB_STATS_HIST_SUB_BITS - 1;
+    uint32_t value = ((1U << MB_STATS_HIST_SUB_BITS) | (index & MB_STATS_HIST_SUB_MASK)) << (msb - MB_STATS_HIST_SUB_BITS);
+    return value << MB_STATS_HIST_UNIT_SHIFT;
+}
+
+static mb_stats_counters_t *mb_stats_get_func(mb_stats_t *stats, uint8_t func)
+{
+    uint8_t code = func & 0x7F;
+    for (int i = 0; i < (MB_STATS_FUNCS - 1); i++) {
+        if (mb_stats_func_codes[i] == code) {
+            return &stats->funcs[i];
+        }
+    }
+    return &stats->funcs[MB_STATS_FUNCS - 1];
+}
+
+// Finds the entry of the node or takes the free one, the entry is never released
+static mb_stats_counters_t *mb_stats_get_node(mb_stats_t *stats, uint16_t node)
+{
+    unsigned key = (unsigned)node + 1;
+    for (int i = 0; i < MB_STATS_NODES; i++) {
+        unsigned cur_key = atomic_load_explicit(&stats->nodes[i].key, memory_order_relaxed);
+        if (!cur_key) {
+            // The concurrent task can take the same entry for other node, check the key again
+            if (atomic_compare_exchange_strong(&stats->nodes[i].key, &cur_key, key)) {
+                return &stats->nodes[i].counters;
+            }
+        }
+        if (cur_key == key) {
+            return &stats->nodes[i].counters;
+        }
+    }
+    return NULL;
+}
+
+static void mb_stats_add(mb_stats_counters_t *counters, bool has_func, mb_stats_result_t result,
+                            uint16_t bytes_in, uint16_t bytes_out, uint32_t latency_us)
+{
+    if (has_func) {
+        atomic_fetch_add_explicit(&counters->requests, 1, memory_order_relaxed);
+    }
+    switch (result) {
+        case MB_STATS_RESULT_EXCEPTION:
+            atomic_fetch_add_explicit(&counters->exceptions, 1, memory_order_relaxed);
+            break;
+        case MB_STATS_RESULT_TIMEOUT:
+            atomic_fetch_add_explicit(&counters->timeouts, 1, memory_order_relaxed);
+            break;
+        case MB_STATS_RESULT_FRAME_ERROR:
+            atomic_fetch_add_explicit(&counters->frame_errors, 1, memory_order_relaxed);
+            break;
+        default:
+            break;
+    }
+    atomic_fetch_add_explicit(&counters->bytes_in, bytes_in, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counters->bytes_out, bytes_out, memory_order_relaxed);
+    if ((result == MB_STATS_RESULT_OK) || (result == MB_STATS_RESULT_EXCEPTION)) {
+        atomic_fetch_add_explicit(&counters->hist[mb_stats_hist_index(latency_us)], 1, memory_order_relaxed);
+        unsigned max_us = atomic_load_explicit(&counters->latency_max_us, memory_order_relaxed);
+        while ((latency_us > max_us)
+                && !atomic_compare_exchange_weak_explicit(&counters->latency_max_us, &max_us, latency_us,
+                                                            memory_order_relaxed, memory_order_relaxed)) {
+        }
+    }
+}
+
+void mb_stats_record(mb_stats_t *stats, uint16_t node, uint8_t func, mb_stats_result_t result,
+                        uint16_t bytes_in, uint16_t bytes_out, uint32_t latency_us)
+{
+    if (!stats) {
+        return;
+    }
+    bool has_func = (func != MB_STATS_NO_FUNC);
+    mb_stats_add(&stats->total, has_func, result, bytes_in, bytes_out, latency_us);
+    if (has_func) {
+        mb_stats_add(mb_stats_get_func(stats, func), true, result, bytes_in, bytes_out, latency_us);
+    }
+    if (node != MB_STATS_NO_NODE) {
+        mb_stats_counters_t *counters = mb_stats_get_node(stats, node);
+        if (counters) {
+            mb_stats_add(counters, has_func, result, bytes_in, bytes_out, latency_us);
+        }
+    }
+}
+
+// The percentile is the end of the bucket which holds it, limited by the maximum latency
+static uint32_t mb_stats_percentile(const uint32_t *hist, uint32_t count, uint32_t max_us, uint32_t percent)
+{
+    uint32_t rank = (uint32_t)(((uint64_t)count * percent + 99) / 100);
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < MB_STATS_HIST_BUCKETS; i++) {
+        sum += hist[i];
+        if (rank && (sum >= rank)) {
+            uint32_t end_us = (i < (MB_STATS_HIST_BUCKETS - 1)) ? mb_stats_hist_start(i + 1) : max_us;
+            return (end_us < max_us) ? end_us : max_us;
+        }
+    }
+    return 0;
+}
+
+// The snapshot of the counters, the counters of several ports are added up before the percentiles are taken
+typedef struct {
+    mb_stats_info_t info;
+    uint32_t hist[MB_STATS_HIST_BUCKETS];
+} mb_stats_sum_t;
+
+static void mb_stats_add_up(mb_stats_counters_t *counters, mb_stats_sum_t *sum)
+{
+    sum->info.requests += atomic_load_explicit(&counters->requests, memory_order_relaxed);
+    sum->info.exceptions += atomic_load_explicit(&counters->exceptions, memory_order_relaxed);
+    sum->info.timeouts += atomic_load_explicit(&counters->timeouts, memory_order_relaxed);
+    sum->info.frame_errors += atomic_load_explicit(&counters->frame_errors, memory_order_relaxed);
+    sum->info.bytes_in += atomic_load_explicit(&counters->bytes_in, memory_order_relaxed);
+    sum->info.bytes_out += atomic_load_explicit(&counters->bytes_out, memory_order_relaxed);
+    uint32_t max_us = atomic_load_explicit(&counters->latency_max_us, memory_order_relaxed);
+    sum->info.latency_max_us = (max_us > sum->info.latency_max_us) ? max_us : sum->info.latency_max_us;
+    for (int i = 0; i < MB_STATS_HIST_BUCKETS; i++) {
+        uint32_t value = atomic_load_explicit(&counters->hist[i], memory_order_relaxed);
+        sum->hist[i] += value;
+        sum->info.latency_count += value;
+    }
+}
+
+static bool mb_stats_read(mb_stats_sum_t *sum, uint16_t key, mb_stats_info_t *info)
+{
+    *info = sum->info;
+    info->key = key;
+    info->latency_p50_us = mb_stats_percentile(sum->hist, info->latency_count, info->latency_max_us, 50);
+    info->latency_p95_us = mb_stats_percentile(sum->hist, info->latency_count, info->latency_max_us, 95);
+    info->latency_p99_us = mb_stats_percentile(sum->hist, info->latency_count, info->latency_max_us, 99);
+    return (info->requests || info->frame_errors);
+}
+
+// Checks if the node is already counted with the entry of the previous object
+static bool mb_stats_node_is_seen(mb_stats_t *const *stats, uint16_t stats_index, unsigned key)
+{
+    for (uint16_t j = 0; j < stats_index; j++) {
+        for (int i = 0; stats[j] && (i < MB_STATS_NODES); i++) {
+            if (atomic_load_explicit(&stats[j]->nodes[i].key, memory_order_relaxed) == key) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void mb_stats_add_up_node(mb_stats_t *const *stats, uint16_t stats_count, unsigned key, mb_stats_sum_t *sum)
+{
+    for (uint16_t j = 0; j < stats_count; j++) {
+        for (int i = 0; stats[j] && (i < MB_STATS_NODES); i++) {
+            if (atomic_load_explicit(&stats[j]->nodes[i].key, memory_order_relaxed) == key) {
+                mb_stats_add_up(&stats[j]->nodes[i].counters, sum);
+                break;
+            }
+        }
+    }
+}
+
+static void mb_stats_put(mb_stats_info_t *info, uint16_t max_count, uint16_t *count, const mb_stats_info_t *entry)
+{
+    if (info && (*count < max_count)) {
+        info[*count] = *entry;
+    }
+    (*count)++;
+}
+
+uint16_t mb_stats_get(mb_stats_t *stats, mb_stats_group_t group, mb_stats_info_t *info, uint16_t max_count)
+{
+    return stats ? mb_stats_get_merged(&stats, 1, group, info, max_count) : 0;
+}
+
+uint16_t mb_stats_get_merged(mb_stats_t *const *stats, uint16_t stats_count, mb_stats_group_t group,
+                                mb_stats_info_t *info, uint16_t max_count)
+{
+    mb_stats_sum_t sum;
+    mb_stats_info_t entry;
+    uint16_t count = 0;
+    if (!stats || !stats_count) {
+        return 0;
+    }
+    switch (group) {
+        case MB_STATS_TOTAL:
+            memset(&sum, 0, sizeof(sum));
+            for (uint16_t j = 0; j < stats_count; j++) {
+                if (stats[j]) {
+                    mb_stats_add_up(&stats[j]->total, &sum);
+                }
+            }
+            (void)mb_stats_read(&sum, 0, &entry);
+            mb_stats_put(info, max_count, &count, &entry);
+            break;
+        case MB_STATS_NODE:
+            // The node is reported once, with the counters of all objects which know it
+            for (uint16_t j = 0; j < stats_count; j++) {
+                for (int i = 0; stats[j] && (i < MB_STATS_NODES); i++) {
+                    unsigned key = atomic_load_explicit(&stats[j]->nodes[i].key, memory_order_relaxed);
+                    if (!key || mb_stats_node_is_seen(stats, j, key)) {
+                        continue;
+                    }
+                    memset(&sum, 0, sizeof(sum));
+                    mb_stats_add_up_node(&stats[j], stats_count - j, key, &sum);
+                    if (mb_stats_read(&sum, (uint16_t)(key - 1), &entry)) {
+                        mb_stats_put(info, max_count, &count, &entry);
+                    }
+                }
+            }
+            break;
+        case MB_STATS_FUNC:
+            for (int i = 0; i < MB_STATS_FUNCS; i++) {
+                uint16_t key = (i < (MB_STATS_FUNCS - 1)) ? mb_stats_func_codes[i] : MB_STATS_NO_FUNC;
+                memset(&sum, 0, sizeof(sum));
+                for (uint16_t j = 0; j < stats_count; j++) {
+                    if (stats[j]) {
+                        mb_stats_add_up(&stats[j]->funcs[i], &sum);
+                    }
+                }
+                if (mb_stats_read(&sum, key, &entry)) {
+                    mb_stats_put(info, max_count, &count, &entry);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    return count;
+}
+
+static void mb_stats_clear(mb_stats_counters_t *counters)
+{
+    atomic_store_explicit(&counters->requests, 0, memory_order_relaxed);
+    atomic_store_explicit(&counters->exceptions, 0, memory_order_relaxed);
+    atomic_store_explicit(&counters->timeouts, 0, memory_order_relaxed);
+    atomic_store_explicit(&counters->frame_errors, 0, memory_order_relaxed);
+    atomic_store_explicit(&counters->bytes_in, 0, memory_order_relaxed);
+    atomic_store_explicit(&counters->bytes_out, 0, memory_order_relaxed);
+    atomic_store_explicit(&counters->latency_max_us, 0, memory_order_relaxed);
+    for (int i = 0; i < MB_STATS_HIST_BUCKETS; i++) {
+        atomic_store_explicit(&counters->hist[i], 0, memory_order_relaxed);
+    }
+}
+
+void mb_stats_reset(mb_stats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    mb_stats_clear(&stats->total);
+    for (int i = 0; i < MB_STATS_FUNCS; i++) {
+        mb_stats_clear(&stats->funcs[i]);
+    }
+    // The node entries stay taken, so the updates in progress do not take the second entry of the node
+    for (int i = 0; i < MB_STATS_NODES; i++) {
+        mb_stats_clear(&stats->nodes[i].counters);
+    }
+}
+
+#endif
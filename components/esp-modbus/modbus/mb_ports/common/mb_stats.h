@@ -0,0 +1,167 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MB_STATS_ENABLED            (CONFIG_FMB_PORT_STATS_ENABLE)
+
+#define MB_STATS_NO_NODE            (0xFFFF)    // the address of the frame is unknown
+#define MB_STATS_NO_FUNC            (0)         // the function of the frame is unknown
+
+// The latency histogram is log-linear: the latencies below 128 uS are counted in 32 uS steps,
+// every next power of two is split into 4 buckets, the last bucket counts all latencies from 7.3 S
+#define MB_STATS_HIST_UNIT_SHIFT    (5)
+#define MB_STATS_HIST_SUB_BITS      (2)
+#define MB_STATS_HIST_BUCKETS       (68)
+
+/**
+ * @brief The outcome of the transaction
+ */
+typedef enum {
+    MB_STATS_RESULT_OK,             /*!< The normal response is sent or received */
+    MB_STATS_RESULT_EXCEPTION,      /*!< The exception response is sent or received */
+    MB_STATS_RESULT_TIMEOUT,        /*!< No response is received or the response is not sent */
+    MB_STATS_RESULT_FRAME_ERROR,    /*!< The frame is dropped because of CRC, LRC, length or address */
+} mb_stats_result_t;
+
+/**
+ * @brief The group of the statistics to read
+ */
+typedef enum {
+    MB_STATS_TOTAL,                 /*!< One entry for all transactions */
+    MB_STATS_NODE,                  /*!< One entry per node, the key is the unit address */
+    MB_STATS_FUNC,                  /*!< One entry per function code, the key is the function code, 0 for all others */
+} mb_stats_group_t;
+
+/**
+ * @brief The snapshot of the statistics of the node or function
+ */
+typedef struct {
+    uint16_t key;                   /*!< The unit address of the node or the function code */
+    uint32_t requests;              /*!< The number of transactions with the known function */
+    uint32_t exceptions;            /*!< The number of exception responses */
+    uint32_t timeouts;              /*!< The number of transactions without response */
+    uint32_t frame_errors;          /*!< The number of dropped frames (CRC, LRC, length or address errors) */
+    uint32_t bytes_in;              /*!< The number of received PDU bytes */
+    uint32_t bytes_out;             /*!< The number of sent PDU bytes */
+    uint32_t latency_count;         /*!< The number of the responses in the latency histogram */
+    uint32_t latency_p50_us;        /*!< The median latency, the upper bound of the histogram bucket (uS) */
+    uint32_t latency_p95_us;        /*!< The 95th percentile of the latency (uS) */
+    uint32_t latency_p99_us;        /*!< The 99th percentile of the latency (uS) */
+    uint32_t latency_max_us;        /*!< The maximum latency (uS) */
+} mb_stats_info_t;
+
+#if MB_STATS_ENABLED
+
+#define MB_STATS_NODES              (CONFIG_FMB_PORT_STATS_NODES)
+#define MB_STATS_FUNCS              (11)        // the standard functions of the stack and one for all others
+
+/**
+ * @brief The counters of one entry, all fields are updated with atomic operations
+ */
+typedef struct {
+    atomic_uint requests;
+    atomic_uint exceptions;
+    atomic_uint timeouts;
+    atomic_uint frame_errors;
+    atomic_uint bytes_in;
+    atomic_uint bytes_out;
+    atomic_uint latency_max_us;
+    atomic_uint hist[MB_STATS_HIST_BUCKETS];
+} mb_stats_counters_t;
+
+typedef struct {
+    atomic_uint key;                /*!< unit address + 1, zero if the entry is free */
+    mb_stats_counters_t counters;
+} mb_stats_node_t;
+
+/**
+ * @brief The statistics of the port
+ *
+ * The object is updated from several tasks without the lock, the zero initialized object is empty.
+ * The node entry is taken by the first transaction of the node and is kept until the object is deleted,
+ * the nodes above MB_STATS_NODES are counted in the total and function entries only.
+ */
+typedef struct mb_stats_s {
+    mb_stats_counters_t total;
+    mb_stats_counters_t funcs[MB_STATS_FUNCS];
+    mb_stats_node_t nodes[MB_STATS_NODES];
+} mb_stats_t;
+
+/**
+ * @brief Counts the transaction
+ *
+ * The frames without known function (MB_STATS_NO_FUNC) are counted in the total entry only and
+ * do not increase the number of requests. The latency is added to the histograms if the response
+ * is sent or received (MB_STATS_RESULT_OK or MB_STATS_RESULT_EXCEPTION).
+ *
+ * @param stats the statistics object, NULL is ignored
+ * @param node the unit address or MB_STATS_NO_NODE
+ * @param func the function code of the request or MB_STATS_NO_FUNC
+ * @param result the outcome of the transaction
+ * @param bytes_in the length of the received PDU
+ * @param bytes_out the length of the sent PDU
+ * @param latency_us the time from the request to the response
+ */
+void mb_stats_record(mb_stats_t *stats, uint16_t node, uint8_t func, mb_stats_result_t result,
+                        uint16_t bytes_in, uint16_t bytes_out, uint32_t latency_us);
+
+/**
+ * @brief Gets the snapshot of the statistics group
+ *
+ * @param stats the statistics object
+ * @param group the group to read
+ * @param info the array of entries to fill, NULL to get the number of entries only
+ * @param max_count the size of the array
+ * @return the number of the entries in the group, can be more than max_count
+ */
+uint16_t mb_stats_get(mb_stats_t *stats, mb_stats_group_t group, mb_stats_info_t *info, uint16_t max_count);
+
+/**
+ * @brief Gets the snapshot of the statistics group of several objects as one
+ *
+ * The counters and latency histograms of the objects are added up before the percentiles are taken,
+ * the node known to several objects is reported once.
+ *
+ * @param stats the array of the statistics objects, NULL entries are skipped
+ * @param stats_count the number of the objects
+ * @param group the group to read
+ * @param info the array of entries to fill, NULL to get the number of entries only
+ * @param max_count the size of the array
+ * @return the number of the entries in the group, can be more than max_count
+ */
+uint16_t mb_stats_get_merged(mb_stats_t *const *stats, uint16_t stats_count, mb_stats_group_t group,
+                                mb_stats_info_t *info, uint16_t max_count);
+
+/**
+ * @brief Clears the counters, the concurrent updates can be counted before or after the clear
+ */
+void mb_stats_reset(mb_stats_t *stats);
+
+#else
+
+typedef struct mb_stats_s mb_stats_t;
+
+static inline void mb_stats_record(mb_stats_t *stats, uint16_t node, uint8_t func, mb_stats_result_t result,
+                                    uint16_t bytes_in, uint16_t bytes_out, uint32_t latency_us)
+{
+    (void)stats; (void)node; (void)func; (void)result; (void)bytes_in; (void)bytes_out; (void)latency_us;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
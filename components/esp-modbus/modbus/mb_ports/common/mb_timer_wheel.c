@@ -0,0 +1,188 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include "mb_timer_wheel.h"
+
+#define MB_TIMER_WHEEL_LEVEL_SHIFT(level) ((level) * MB_TIMER_WHEEL_SLOT_BITS)
+#define MB_TIMER_WHEEL_SLOT_BIT(slot) (1ULL << (slot))
+
+// Links the timer to the slot according to its distance from the current tick,
+// the timer which is already due goes to the slot of the current tick
+static void mb_timer_wheel_link(mb_timer_wheel_t *wheel, mb_timer_node_t *timer)
+{
+    if (timer->expire < wheel->tick) {
+        timer->expire = wheel->tick;
+    }
+    uint64_t delta = timer->expire - wheel->tick;
+    if (delta > MB_TIMER_WHEEL_MAX_TICKS) {
+        delta = MB_TIMER_WHEEL_MAX_TICKS;
+        timer->expire = wheel->tick + delta;
+    }
+    uint8_t level = 0;
+    while ((level < (MB_TIMER_WHEEL_LEVELS - 1)) && (delta >> MB_TIMER_WHEEL_LEVEL_SHIFT(level + 1))) {
+        level++;
+    }
+    uint8_t slot = (uint8_t)((timer->expire >> MB_TIMER_WHEEL_LEVEL_SHIFT(level)) & MB_TIMER_WHEEL_SLOT_MASK);
+    timer->level = level;
+    timer->slot = slot;
+    LIST_INSERT_HEAD(&wheel->slots[level][slot], timer, entries);
+    wheel->occupied[level] |= MB_TIMER_WHEEL_SLOT_BIT(slot);
+}
+
+static void mb_timer_wheel_unlink(mb_timer_wheel_t *wheel, mb_timer_node_t *timer)
+{
+    LIST_REMOVE(timer, entries);
+    if (LIST_EMPTY(&wheel->slots[timer->level][timer->slot])) {
+        wheel->occupied[timer->level] &= ~MB_TIMER_WHEEL_SLOT_BIT(timer->slot);
+    }
+}
+
+// Moves all timers of the slot to the list, the slot becomes empty
+static void mb_timer_wheel_take_slot(mb_timer_wheel_t *wheel, uint8_t level, uint8_t slot, struct mb_timer_list_s *list)
+{
+    struct mb_timer_list_s *head = &wheel->slots[level][slot];
+    LIST_INIT(list);
+    LIST_FIRST(list) = LIST_FIRST(head);
+    if (LIST_FIRST(list)) {
+        LIST_FIRST(list)->entries.le_prev = &LIST_FIRST(list);
+    }
+    LIST_INIT(head);
+    wheel->occupied[level] &= ~MB_TIMER_WHEEL_SLOT_BIT(slot);
+}
+
+// Moves the timers of the upper level slots down when the lower level wraps to the slot 0
+static void mb_timer_wheel_cascade(mb_timer_wheel_t *wheel)
+{
+    struct mb_timer_list_s list;
+    mb_timer_node_t *timer = NULL;
+    for (uint8_t level = 1; level < MB_TIMER_WHEEL_LEVELS; level++) {
+        uint8_t slot = (uint8_t)((wheel->tick >> MB_TIMER_WHEEL_LEVEL_SHIFT(level)) & MB_TIMER_WHEEL_SLOT_MASK);
+        mb_timer_wheel_take_slot(wheel, level, slot, &list);
+        while ((timer = LIST_FIRST(&list))) {
+            LIST_REMOVE(timer, entries);
+            mb_timer_wheel_link(wheel, timer);
+        }
+        if (slot) {
+            break;
+        }
+    }
+}
+
+void mb_timer_wheel_init(mb_timer_wheel_t *wheel, uint64_t now_us)
+{
+    for (int level = 0; level < MB_TIMER_WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < MB_TIMER_WHEEL_SLOTS; slot++) {
+            LIST_INIT(&wheel->slots[level][slot]);
+        }
+        wheel->occupied[level] = 0;
+    }
+    wheel->count = 0;
+    wheel->tick = now_us / MB_TIMER_WHEEL_TICK_US;
+}
+
+void mb_timer_node_init(mb_timer_node_t *timer, mb_timer_cb_fp cb, void *arg)
+{
+    timer->cb = cb;
+    timer->arg = arg;
+    timer->expire = 0;
+    timer->level = 0;
+    timer->slot = 0;
+    timer->is_armed = false;
+}
+
+void mb_timer_wheel_arm(mb_timer_wheel_t *wheel, mb_timer_node_t *timer, uint64_t expire_us)
+{
+    if (timer->is_armed) {
+        mb_timer_wheel_unlink(wheel, timer);
+    } else {
+        wheel->count++;
+    }
+    // Round up, so the timer does not expire before the time
+    timer->expire = (expire_us + MB_TIMER_WHEEL_TICK_US - 1) / MB_TIMER_WHEEL_TICK_US;
+    timer->is_armed = true;
+    mb_timer_wheel_link(wheel, timer);
+}
+
+void mb_timer_wheel_disarm(mb_timer_wheel_t *wheel, mb_timer_node_t *timer)
+{
+    if (timer->is_armed) {
+        mb_timer_wheel_unlink(wheel, timer);
+        timer->is_armed = false;
+        wheel->count--;
+    }
+}
+
+uint32_t mb_timer_wheel_advance(mb_timer_wheel_t *wheel, uint64_t now_us)
+{
+    uint64_t now_tick = now_us / MB_TIMER_WHEEL_TICK_US;
+    uint32_t expired_count = 0;
+    struct mb_timer_list_s expired;
+    mb_timer_node_t *timer = NULL;
+
+    while (wheel->tick <= now_tick) {
+        if (!wheel->count) {
+            // Nothing to cascade, just jump to the current time
+            wheel->tick = now_tick + 1;
+            break;
+        }
+        uint8_t index = (uint8_t)(wheel->tick & MB_TIMER_WHEEL_SLOT_MASK);
+        if (!index) {
+            mb_timer_wheel_cascade(wheel);
+        }
+        uint64_t pending = wheel->occupied[0] >> index;
+        if (!pending) {
+            // Skip the empty slots up to the next cascade
+            uint64_t next_tick = (wheel->tick | MB_TIMER_WHEEL_SLOT_MASK) + 1;
+            wheel->tick = (next_tick <= now_tick) ? next_tick : (now_tick + 1);
+            continue;
+        }
+        uint8_t skip = (uint8_t)__builtin_ctzll(pending);
+        if ((wheel->tick + skip) > now_tick) {
+            wheel->tick = now_tick + 1;
+            break;
+        }
+        index += skip;
+        // The tick is counted as processed before the callbacks,
+        // so the timer armed again from its callback goes to the next slots
+        wheel->tick += skip + 1;
+        mb_timer_wheel_take_slot(wheel, 0, index, &expired);
+        while ((timer = LIST_FIRST(&expired))) {
+            LIST_REMOVE(timer, entries);
+            timer->is_armed = false;
+            wheel->count--;
+            expired_count++;
+            if (timer->cb) {
+                timer->cb(timer, timer->arg);
+            }
+        }
+    }
+    return expired_count;
+}
+
+uint32_t mb_timer_wheel_next_ms(const mb_timer_wheel_t *wheel, uint64_t now_us, uint32_t max_ms)
+{
+    if (!wheel->count) {
+        return max_ms;
+    }
+    uint8_t index = (uint8_t)(wheel->tick & MB_TIMER_WHEEL_SLOT_MASK);
+    uint64_t pending = wheel->occupied[0] >> index;
+    uint64_t upper = 0;
+    for (int level = 1; level < MB_TIMER_WHEEL_LEVELS; level++) {
+        upper |= wheel->occupied[level];
+    }
+    // The lower slots hold the timers of the next round, so without the pending slot
+    // the wheel waits for the next cascade
+    uint64_t next_tick = (wheel->tick | MB_TIMER_WHEEL_SLOT_MASK) + 1;
+    if (!index && upper) {
+        next_tick = wheel->tick;
+    } else if (pending) {
+        next_tick = wheel->tick + __builtin_ctzll(pending);
+    }
+    uint64_t next_us = next_tick * MB_TIMER_WHEEL_TICK_US;
+    uint64_t wait_ms = (next_us > now_us) ? ((next_us - now_us + 999) / 1000) : 0;
+    return (wait_ms < max_ms) ? (uint32_t)wait_ms : max_ms;
+}
@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "sys/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MB_TIMER_WHEEL_TICK_US      (10000)     // resolution of the wheel
+#define MB_TIMER_WHEEL_LEVELS       (4)
+#define MB_TIMER_WHEEL_SLOT_BITS    (6)
+#define MB_TIMER_WHEEL_SLOTS        (1 << MB_TIMER_WHEEL_SLOT_BITS)
+#define MB_TIMER_WHEEL_SLOT_MASK    (MB_TIMER_WHEEL_SLOTS - 1)
+
+// The longest timeout of the wheel in ticks (about 46 hours), the longer ones are clamped
+#define MB_TIMER_WHEEL_MAX_TICKS    ((1ULL << (MB_TIMER_WHEEL_SLOT_BITS * MB_TIMER_WHEEL_LEVELS)) - 1)
+
+typedef struct mb_timer_node_s mb_timer_node_t;
+
+/**
+ * @brief Expiration callback of the timer, the timer is already disarmed and can be armed again
+ */
+typedef void (*mb_timer_cb_fp)(mb_timer_node_t *timer, void *arg);
+
+/**
+ * @brief Timer embedded into the object which expires it, the wheel does not allocate memory
+ */
+struct mb_timer_node_s {
+    LIST_ENTRY(mb_timer_node_s) entries;
+    uint64_t expire;                        /*!< expiration tick */
+    mb_timer_cb_fp cb;                      /*!< expiration callback */
+    void *arg;                              /*!< argument of the callback */
+    uint8_t level;                          /*!< level of the wheel the timer is linked to */
+    uint8_t slot;                           /*!< slot of the level the timer is linked to */
+    bool is_armed;                          /*!< the timer is linked to the wheel */
+};
+
+LIST_HEAD(mb_timer_list_s, mb_timer_node_s);
+
+/**
+ * @brief Hierarchical timer wheel
+ *
+ * The level 0 has the slot for each tick, every slot of the next level covers all slots
+ * of the previous one. The timers of the upper level slot are moved down when the lower level
+ * wraps to it, so arming, disarming and expiring the timer takes constant time.
+ * The wheel has no lock, the owner serializes all calls.
+ */
+typedef struct mb_timer_wheel_s {
+    uint64_t tick;                          /*!< next tick to process */
+    uint32_t count;                         /*!< number of armed timers */
+    uint64_t occupied[MB_TIMER_WHEEL_LEVELS];   /*!< non empty slots of each level */
+    struct mb_timer_list_s slots[MB_TIMER_WHEEL_LEVELS][MB_TIMER_WHEEL_SLOTS];
+} mb_timer_wheel_t;
+
+/**
+ * @brief Initializes the empty wheel starting from the current time
+ */
+void mb_timer_wheel_init(mb_timer_wheel_t *wheel, uint64_t now_us);
+
+/**
+ * @brief Initializes the disarmed timer with the expiration callback
+ */
+void mb_timer_node_init(mb_timer_node_t *timer, mb_timer_cb_fp cb, void *arg);
+
+/**
+ * @brief Arms the timer to expire at the absolute time, the armed timer is moved to the new time
+ *
+ * The timer never expires earlier than the time and expires not later than one tick after it
+ * if the wheel is advanced in time.
+ */
+void mb_timer_wheel_arm(mb_timer_wheel_t *wheel, mb_timer_node_t *timer, uint64_t expire_us);
+
+/**
+ * @brief Disarms the timer, does nothing if the timer is not armed
+ */
+void mb_timer_wheel_disarm(mb_timer_wheel_t *wheel, mb_timer_node_t *timer);
+
+static inline bool mb_timer_node_is_armed(const mb_timer_node_t *timer)
+{
+    return timer->is_armed;
+}
+
+/**
+ * @brief Calls the callbacks of the timers expired up to the current time
+ *
+ * @return the number of expired timers
+ */
+uint32_t mb_timer_wheel_advance(mb_timer_wheel_t *wheel, uint64_t now_us);
+
+/**
+ * @brief Returns the time to wait before the next advance of the wheel
+ *
+ * The returned time is not longer than the time to the next expiration, but can be shorter
+ * when the timers of the upper level are moved down.
+ *
+ * @return the time in milliseconds limited by max_ms
+ */
+uint32_t mb_timer_wheel_next_ms(const mb_timer_wheel_t *wheel, uint64_t now_us, uint32_t max_ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,544 @@
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "sys/queue.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "mb_transaction.h"
+
+static const char *TAG = "mb_transaction";
+
+// Initial and maximum number of TID hash buckets (must be a power of two)
+#define TRANSACTION_HASH_BUCKETS_MIN    (16)
+#define TRANSACTION_HASH_BUCKETS_MAX    (1024)
+// The table is grown when the average chain length exceeds this value
+#define TRANSACTION_HASH_LOAD_FACTOR    (2)
+// Initial number of the per node item counters, grown to fit the node id
+#define TRANSACTION_NODE_COUNTS_MIN     (8)
+#define TRANSACTION_STATE_COUNT         (EXPIRED + 1)
+
+#define TRANSACTION_HASH(transaction, msg_id) ((msg_id) & ((transaction)->bucket_count - 1))
+#define TRANSACTION_STATE_IS_VALID(state) (((int)(state) >= INIT) && ((int)(state) < TRANSACTION_STATE_COUNT))
+
+/**
+ * @brief transaction list item
+ *
+ * Every item is linked into three lists at once: the insertion ordered list,
+ * the hash chain of its TID and the list of items in its current state.
+ */
+typedef struct transaction_item {
+    uint8_t *buffer;
+    uint16_t len;
+    int node_id;
+    uint16_t msg_id;
+    void *pnode;
+    transaction_tick_t tick;
+    _Atomic(int) state;
+    transaction_handle_t owner;
+    mb_timer_node_t timer;
+    TAILQ_ENTRY(transaction_item) next;
+    TAILQ_ENTRY(transaction_item) hash_next;
+    TAILQ_ENTRY(transaction_item) state_next;
+} transaction_item_t;
+
+TAILQ_HEAD(transaction_list_t, transaction_item);
+
+MB_POOL_DEFINE_STATIC(transaction_item_pool, sizeof(transaction_item_t), CONFIG_FMB_QUEUE_LENGTH);
+
+struct transaction_t {
+    _lock_t lock;
+    uint64_t size;
+    uint32_t count;
+    uint32_t bucket_count;
+    uint32_t *node_counts;
+    uint32_t node_counts_size;
+    struct transaction_list_t list;
+    struct transaction_list_t *buckets;
+    struct transaction_list_t states[TRANSACTION_STATE_COUNT];
+    mb_timer_wheel_t *wheel;
+    transaction_tick_t timeout;
+};
+
+static void transaction_link_item(transaction_handle_t transaction, transaction_item_handle_t item)
+{
+    TAILQ_INSERT_TAIL(&transaction->list, item, next);
+    TAILQ_INSERT_TAIL(&transaction->buckets[TRANSACTION_HASH(transaction, item->msg_id)], item, hash_next);
+    TAILQ_INSERT_TAIL(&transaction->states[atomic_load(&item->state)], item, state_next);
+    transaction->size += item->len;
+    transaction->count++;
+    if (item->node_id >= 0) {
+        transaction->node_counts[item->node_id]++;
+    }
+}
+
+static void transaction_unlink_item(transaction_handle_t transaction, transaction_item_handle_t item)
+{
+    TAILQ_REMOVE(&transaction->list, item, next);
+    TAILQ_REMOVE(&transaction->buckets[TRANSACTION_HASH(transaction, item->msg_id)], item, hash_next);
+    TAILQ_REMOVE(&transaction->states[atomic_load(&item->state)], item, state_next);
+    if (transaction->wheel) {
+        mb_timer_wheel_disarm(transaction->wheel, &item->timer);
+    }
+    transaction->size -= item->len;
+    transaction->count--;
+    if (item->node_id >= 0) {
+        transaction->node_counts[item->node_id]--;
+    }
+    item->owner = NULL;
+}
+
+static void transaction_free_item(transaction_item_handle_t item)
+{
+    mb_port_frame_free(item->buffer);
+    mb_pool_free(&transaction_item_pool, item);
+}
+
+// Doubles the number of hash buckets, the chains keep the insertion order of items.
+// The table just stays at the current size if the allocation fails.
+static void transaction_grow_buckets(transaction_handle_t transaction)
+{
+    uint32_t new_count = transaction->bucket_count << 1;
+    if (new_count > TRANSACTION_HASH_BUCKETS_MAX) {
+        return;
+    }
+    struct transaction_list_t *new_buckets = calloc(new_count, sizeof(struct transaction_list_t));
+    if (!new_buckets) {
+        ESP_LOGD(TAG, "could not grow TID index to %" PRIu32 " buckets.", new_count);
+        return;
+    }
+    for (uint32_t i = 0; i < new_count; i++) {
+        TAILQ_INIT(&new_buckets[i]);
+    }
+    free(transaction->buckets);
+    transaction->buckets = new_buckets;
+    transaction->bucket_count = new_count;
+    transaction_item_handle_t item;
+    TAILQ_FOREACH(item, &transaction->list, next) {
+        TAILQ_INSERT_TAIL(&new_buckets[TRANSACTION_HASH(transaction, item->msg_id)], item, hash_next);
+    }
+}
+
+// Makes the node counters fit the node id, the negative ids are not counted
+static bool transaction_fit_node_counts(transaction_handle_t transaction, int node_id)
+{
+    if ((node_id < 0) || ((uint32_t)node_id < transaction->node_counts_size)) {
+        return true;
+    }
+    uint32_t new_size = transaction->node_counts_size ? transaction->node_counts_size : TRANSACTION_NODE_COUNTS_MIN;
+    while (new_size <= (uint32_t)node_id) {
+        new_size <<= 1;
+    }
+    uint32_t *new_counts = realloc(transaction->node_counts, new_size * sizeof(uint32_t));
+    if (!new_counts) {
+        ESP_LOGE(TAG, "could not grow node counters to %" PRIu32 " nodes.", new_size);
+        return false;
+    }
+    memset(&new_counts[transaction->node_counts_size], 0, (new_size - transaction->node_counts_size) * sizeof(uint32_t));
+    transaction->node_counts = new_counts;
+    transaction->node_counts_size = new_size;
+    return true;
+}
+
+// Deletes the item expired on the timer wheel, the advance is serialized with the other calls
+static void transaction_item_expired(mb_timer_node_t *timer, void *arg)
+{
+    transaction_item_handle_t item = (transaction_item_handle_t)arg;
+    transaction_handle_t transaction = item->owner;
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    transaction_unlink_item(transaction, item);
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    ESP_LOGD(TAG, "EXPIRED msgid=%x, remain size=%"PRIu64, item->msg_id, transaction_get_size(transaction));
+    transaction_free_item(item);
+}
+
+static transaction_item_handle_t transaction_find_item(transaction_handle_t transaction, uint16_t msg_id)
+{
+    transaction_item_handle_t item;
+    TAILQ_FOREACH(item, &transaction->buckets[TRANSACTION_HASH(transaction, msg_id)], hash_next) {
+        if (item->msg_id == msg_id) {
+            return item;
+        }
+    }
+    return NULL;
+}
+
+transaction_handle_t transaction_init(void)
+{
+    transaction_handle_t transaction = calloc(1, sizeof(struct transaction_t));
+    ESP_MEM_CHECK(TAG, transaction, return NULL);
+    transaction->buckets = calloc(TRANSACTION_HASH_BUCKETS_MIN, sizeof(struct transaction_list_t));
+    ESP_MEM_CHECK(TAG, transaction->buckets, {free(transaction); return NULL;});
+    transaction->bucket_count = TRANSACTION_HASH_BUCKETS_MIN;
+    for (uint32_t i = 0; i < transaction->bucket_count; i++) {
+        TAILQ_INIT(&transaction->buckets[i]);
+    }
+    for (int i = 0; i < TRANSACTION_STATE_COUNT; i++) {
+        TAILQ_INIT(&transaction->states[i]);
+    }
+    transaction->size = 0;
+    transaction->count = 0;
+    CRITICAL_SECTION_INIT(transaction->lock);
+    TAILQ_INIT(&transaction->list);
+    return transaction;
+}
+
+transaction_item_handle_t transaction_enqueue(transaction_handle_t transaction, transaction_message_handle_t message, transaction_tick_t tick)
+{
+    ESP_MEM_CHECK(TAG, (message && message->buffer && message->len), {
+        return NULL;
+    });
+    transaction_item_handle_t item = mb_pool_alloc(&transaction_item_pool, sizeof(transaction_item_t));
+    ESP_MEM_CHECK(TAG, (item), {
+        return NULL;
+    });
+    memset(item, 0, sizeof(transaction_item_t));
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    if (!transaction_fit_node_counts(transaction, message->node_id)) {
+        CRITICAL_SECTION_UNLOCK(transaction->lock);
+        mb_pool_free(&transaction_item_pool, item);
+        return NULL;
+    }
+    item->tick = tick;
+    item->node_id = message->node_id;
+    item->pnode = message->pnode;
+    item->msg_id = message->msg_id;
+    item->len =  message->len;
+    item->owner = transaction;
+    atomic_init(&item->state, QUEUED);
+    item->buffer = message->buffer;
+    mb_timer_node_init(&item->timer, transaction_item_expired, item);
+    if (transaction->count >= (transaction->bucket_count * TRANSACTION_HASH_LOAD_FACTOR)) {
+        transaction_grow_buckets(transaction);
+    }
+    transaction_link_item(transaction, item);
+    if (transaction->wheel) {
+        mb_timer_wheel_arm(transaction->wheel, &item->timer, tick + transaction->timeout);
+    }
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    ESP_LOGD(TAG, "ENQUEUE msgid=%x, len=%d, size=%"PRIu64, message->msg_id, message->len, transaction_get_size(transaction));
+    return item;
+}
+
+uint32_t transaction_foreach(transaction_handle_t transaction, pending_state_t state, transaction_visitor_fp visitor, void *arg)
+{
+    uint32_t count = 0;
+    transaction_item_handle_t item;
+    if (!TRANSACTION_STATE_IS_VALID(state) || !visitor) {
+        return 0;
+    }
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    TAILQ_FOREACH(item, &transaction->states[state], state_next) {
+        count++;
+        if (!visitor(item, arg)) {
+            break;
+        }
+    }
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    return count;
+}
+
+transaction_item_handle_t transaction_get(transaction_handle_t transaction, uint16_t msg_id)
+{
+    transaction_item_handle_t item;
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    item = transaction_find_item(transaction, msg_id);
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    return item;
+}
+
+transaction_item_handle_t transaction_get_first(transaction_handle_t transaction)
+{
+    transaction_item_handle_t item;
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    item = TAILQ_FIRST(&transaction->list);
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    return item;
+}
+
+// Returns the item which entered the requested state first
+transaction_item_handle_t transaction_dequeue(transaction_handle_t transaction, pending_state_t state, transaction_tick_t *tick)
+{
+    transaction_item_handle_t item = NULL;
+    if (!TRANSACTION_STATE_IS_VALID(state)) {
+        return NULL;
+    }
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    item = TAILQ_FIRST(&transaction->states[state]);
+    if (item && tick) {
+        *tick = item->tick;
+    }
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    return item;
+}
+
+// The state list keeps the order of entering the state, so the first item of each node is its oldest one
+transaction_item_handle_t transaction_dequeue_next_node(transaction_handle_t transaction, pending_state_t state, int last_node_id)
+{
+    transaction_item_handle_t item = NULL;
+    transaction_item_handle_t next = NULL;
+    if (!TRANSACTION_STATE_IS_VALID(state)) {
+        return NULL;
+    }
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    TAILQ_FOREACH(item, &transaction->states[state], state_next) {
+        if (!next) {
+            next = item;
+        } else if ((item->node_id > last_node_id) != (next->node_id > last_node_id)) {
+            // The nodes after the last served one go first
+            next = (item->node_id > last_node_id) ? item : next;
+        } else if (item->node_id < next->node_id) {
+            next = item;
+        }
+        if (next->node_id == (last_node_id + 1)) {
+            break;
+        }
+    }
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    return next;
+}
+
+// The owner is cleared on unlink, so the handle of the deleted or expired item and the item
+// of other transaction are rejected without the walk over the list.
+esp_err_t transaction_delete_item(transaction_handle_t transaction, transaction_item_handle_t item_to_delete)
+{
+    transaction_item_handle_t item = NULL;
+    if (!transaction || !item_to_delete) {
+        return ESP_FAIL;
+    }
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    if (item_to_delete->owner == transaction) {
+        item = item_to_delete;
+        transaction_unlink_item(transaction, item);
+    }
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    if (!item) {
+        return ESP_FAIL;
+    }
+    transaction_free_item(item);
+    return ESP_OK;
+}
+
+uint16_t transaction_item_get_id(transaction_item_handle_t item)
+{
+    if (item) {
+        return item->msg_id;
+    }
+    return 0xFFFF;
+}
+
+uint8_t *transaction_item_get_data(transaction_item_handle_t item,  size_t *len, uint16_t *msg_id, int *node_id)
+{
+    if (item) {
+        if (len) {
+            *len = item->len;
+        }
+        if (msg_id) {
+            *msg_id = item->msg_id;
+        }
+        if (node_id) {
+            *node_id = item->node_id;
+        }
+        return item->buffer;
+    }
+    return NULL;
+}
+
+uint8_t *transaction_item_take_data(transaction_item_handle_t item, size_t *len)
+{
+    uint8_t *buf = NULL;
+    if (item && item->owner) {
+        CRITICAL_SECTION(item->owner->lock) {
+            buf = item->buffer;
+            item->buffer = NULL;
+            if (len) {
+                *len = item->len;
+            }
+        }
+    }
+    return buf;
+}
+
+esp_err_t transaction_delete(transaction_handle_t transaction, uint16_t msg_id)
+{
+    transaction_item_handle_t item;
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    item = transaction_find_item(transaction, msg_id);
+    if (item) {
+        transaction_unlink_item(transaction, item);
+    }
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    if (!item) {
+        return ESP_FAIL;
+    }
+    transaction_free_item(item);
+    ESP_LOGD(TAG, "DELETED msgid=%x, remain size=%"PRIu64, msg_id, transaction_get_size(transaction));
+    return ESP_OK;
+}
+
+esp_err_t transaction_set_state(transaction_handle_t transaction, uint16_t msg_id, pending_state_t state)
+{
+    transaction_item_handle_t item = transaction_get(transaction, msg_id);
+    return transaction_item_set_state(item, state);
+}
+
+pending_state_t transaction_item_get_state(transaction_item_handle_t item)
+{
+    if (item) {
+        return atomic_load(&(item->state));
+    }
+    return INIT;
+}
+
+esp_err_t transaction_item_set_state(transaction_item_handle_t item, pending_state_t state)
+{
+    if (!item || !item->owner || !TRANSACTION_STATE_IS_VALID(state)) {
+        return ESP_FAIL;
+    }
+    transaction_handle_t transaction = item->owner;
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    pending_state_t prev_state = atomic_load(&(item->state));
+    if (prev_state != state) {
+        TAILQ_REMOVE(&transaction->states[prev_state], item, state_next);
+        TAILQ_INSERT_TAIL(&transaction->states[state], item, state_next);
+        atomic_store(&(item->state), state);
+    }
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    return ESP_OK;
+}
+
+transaction_tick_t transaction_item_get_tick(transaction_item_handle_t item)
+{
+    if (item) {
+        return item->tick;
+    }
+    return 0;
+}
+
+esp_err_t transaction_set_tick(transaction_handle_t transaction, uint16_t msg_id, transaction_tick_t tick)
+{
+    transaction_item_handle_t item = transaction_get(transaction, msg_id);
+    if (item) {
+        item->tick = tick;
+        if (transaction->wheel) {
+            mb_timer_wheel_arm(transaction->wheel, &item->timer, tick + transaction->timeout);
+        }
+        return ESP_OK;
+    }
+    return ESP_FAIL;
+}
+
+uint16_t transaction_delete_single_expired(transaction_handle_t transaction, transaction_tick_t current_tick, transaction_tick_t timeout)
+{
+    uint16_t msg_id = 0xFFFF;
+    transaction_item_handle_t item;
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    TAILQ_FOREACH(item, &transaction->list, next) {
+        if (current_tick - item->tick > timeout) {
+            transaction_unlink_item(transaction, item);
+            msg_id = item->msg_id;
+            break;
+        }
+    }
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    if (item) {
+        transaction_free_item(item);
+    }
+    return msg_id;
+}
+
+int transaction_delete_by_node_id(transaction_handle_t transaction, int node_id)
+{
+    int deleted_items = 0;
+    transaction_item_handle_t item, tmp;
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    TAILQ_FOREACH_SAFE(item, &transaction->list, next, tmp) {
+        if (item->node_id == node_id) {
+            transaction_unlink_item(transaction, item);
+            transaction_free_item(item);
+            deleted_items ++;
+        }
+    }
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    return deleted_items;
+}
+
+uint32_t transaction_get_node_count(transaction_handle_t transaction, int node_id)
+{
+    uint32_t count = 0;
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    if ((node_id >= 0) && ((uint32_t)node_id < transaction->node_counts_size)) {
+        count = transaction->node_counts[node_id];
+    }
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    return count;
+}
+
+int transaction_delete_expired(transaction_handle_t transaction, transaction_tick_t current_tick, transaction_tick_t timeout)
+{
+    int deleted_items = 0;
+    transaction_item_handle_t item, tmp;
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    TAILQ_FOREACH_SAFE(item, &transaction->list, next, tmp) {
+        if (current_tick - item->tick > timeout) {
+            transaction_unlink_item(transaction, item);
+            transaction_free_item(item);
+            deleted_items ++;
+        }
+    }
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+    return deleted_items;
+}
+
+void transaction_set_timer_wheel(transaction_handle_t transaction, mb_timer_wheel_t *wheel, transaction_tick_t timeout)
+{
+    transaction_item_handle_t item;
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    TAILQ_FOREACH(item, &transaction->list, next) {
+        if (transaction->wheel) {
+            mb_timer_wheel_disarm(transaction->wheel, &item->timer);
+        }
+        if (wheel) {
+            mb_timer_wheel_arm(wheel, &item->timer, item->tick + timeout);
+        }
+    }
+    transaction->wheel = wheel;
+    transaction->timeout = timeout;
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+}
+
+uint64_t transaction_get_size(transaction_handle_t transaction)
+{
+    return transaction->size;
+}
+
+uint32_t transaction_get_count(transaction_handle_t transaction)
+{
+    return transaction->count;
+}
+
+void transaction_get_pool_stats(mb_pool_stats_t *stats)
+{
+    mb_pool_get_stats(&transaction_item_pool, stats);
+}
+
+void transaction_delete_all_items(transaction_handle_t transaction)
+{
+    transaction_item_handle_t item, tmp;
+    CRITICAL_SECTION_LOCK(transaction->lock);
+    TAILQ_FOREACH_SAFE(item, &transaction->list, next, tmp) {
+        transaction_unlink_item(transaction, item);
+        transaction_free_item(item);
+    }
+    CRITICAL_SECTION_UNLOCK(transaction->lock);
+}
+
+void transaction_destroy(transaction_handle_t transaction)
+{
+    transaction_delete_all_items(transaction);
+    CRITICAL_SECTION_CLOSE(transaction->lock);
+    free(transaction->buckets);
+    free(transaction->node_counts);
+    free(transaction);
+}
@@ -7,6 +7,7 @@
 
 #include "esp_err.h"
 #include "port_common.h"
+#include "mb_timer_wheel.h"
 
 #ifdef  __cplusplus
 extern "C" {
@@ -34,6 +35,7 @@ typedef struct transaction_message {
 
 typedef struct transaction_message *transaction_message_handle_t;
 typedef uint64_t transaction_tick_t;
+typedef bool (*transaction_visitor_fp)(transaction_item_handle_t item, void *arg);
 
 typedef enum pending_state {
     INIT,
@@ -48,16 +50,65 @@ typedef enum pending_state {
 
 transaction_handle_t transaction_init(void);
 transaction_item_handle_t transaction_enqueue(transaction_handle_t transaction, transaction_message_handle_t message, transaction_tick_t tick);
+
+/**
+ * @brief Returns the item which entered the pending state first, the item stays in the transaction
+ */
 transaction_item_handle_t transaction_dequeue(transaction_handle_t transaction, pending_state_t pending, transaction_tick_t *tick);
+
+/**
+ * @brief Returns the item which entered the pending state first among the items of the next node
+ *
+ * The nodes are taken in the round-robin order of node id: the items of the nodes with the id
+ * greater than last_node_id go first, then the nodes from the lowest id up to last_node_id.
+ * The item stays in the transaction.
+ */
+transaction_item_handle_t transaction_dequeue_next_node(transaction_handle_t transaction, pending_state_t pending, int last_node_id);
+
+/**
+ * @brief Calls the visitor for the items in the pending state in the order they entered it
+ *
+ * The iteration stops when the visitor returns false. The visitor is called under the lock
+ * of the transaction and must not change the transaction.
+ *
+ * @return the number of visited items
+ */
+uint32_t transaction_foreach(transaction_handle_t transaction, pending_state_t pending, transaction_visitor_fp visitor, void *arg);
 transaction_item_handle_t transaction_get(transaction_handle_t transaction, uint16_t msg_id);
 transaction_item_handle_t transaction_get_first(transaction_handle_t transaction);
 uint16_t transaction_item_get_id(transaction_item_handle_t item);
 uint8_t *transaction_item_get_data(transaction_item_handle_t item,  size_t *len, uint16_t *msg_id, int *node_id);
+
+/**
+ * @brief Detaches the data buffer from the item and passes its ownership to the caller
+ *
+ * The item stays in the transaction but does not free the buffer anymore.
+ * The caller must release the buffer with mb_port_frame_free().
+ *
+ * @return pointer to the buffer or NULL if the buffer is already taken
+ */
+uint8_t *transaction_item_take_data(transaction_item_handle_t item, size_t *len);
 esp_err_t transaction_delete(transaction_handle_t transaction, uint16_t msg_id);
 esp_err_t transaction_delete_item(transaction_handle_t transaction, transaction_item_handle_t item);
 int transaction_delete_by_node_id(transaction_handle_t transaction, int node_id);
+
+/**
+ * @brief Returns the number of items of the node currently held in the transaction
+ *
+ * The counter of the node is updated on enqueue and delete, the negative node ids are not counted.
+ */
+uint32_t transaction_get_node_count(transaction_handle_t transaction, int node_id);
 int transaction_delete_expired(transaction_handle_t transaction, transaction_tick_t current_tick, transaction_tick_t timeout);
 
+/**
+ * @brief Expires the items on the timer wheel, the item is deleted when its tick is older than the timeout
+ *
+ * The items queued before the call are armed as well, the NULL wheel disarms all items.
+ * The calls of the transaction which add and delete the items must be serialized
+ * with the advance of the wheel, the expired item is deleted from the advance.
+ */
+void transaction_set_timer_wheel(transaction_handle_t transaction, mb_timer_wheel_t *wheel, transaction_tick_t timeout);
+
 /**
  * @brief Deletes single expired message returning it's message id
  *
@@ -70,6 +121,16 @@ esp_err_t transaction_item_set_state(transaction_item_handle_t item, pending_sta
 esp_err_t transaction_set_tick(transaction_handle_t transaction, uint16_t msg_id, transaction_tick_t tick);
 transaction_tick_t transaction_item_get_tick(transaction_item_handle_t item);
 uint64_t transaction_get_size(transaction_handle_t transaction);
+
+/**
+ * @brief Returns the number of items currently held in the transaction
+ */
+uint32_t transaction_get_count(transaction_handle_t transaction);
+
+/**
+ * @brief Gets the usage statistic of the transaction item pool shared by all transaction objects
+ */
+void transaction_get_pool_stats(mb_pool_stats_t *stats);
 void transaction_destroy(transaction_handle_t transaction);
 void transaction_delete_all_items(transaction_handle_t transaction);
 
@@ -17,6 +17,9 @@
 #include "freertos/portmacro.h"
 
 #include "mb_port_types.h"
+#include "mb_pool.h"
+#include "mb_stats.h"
+#include "mb_rto.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -135,6 +138,20 @@ typedef struct
 } mb_port_cb_t;
 
 typedef struct mb_port_event_t mb_port_event_t;
+
+#define MB_EVENT_LATENCY_BUCKETS (16)
+
+/**
+ * @brief Statistics of the port events, the latency is the time from the post to the get of the event
+ */
+typedef struct mb_port_event_stats_s {
+    uint32_t posted;            /*!< The number of posted events */
+    uint32_t received;          /*!< The number of events taken by the consumer */
+    uint32_t overflows;         /*!< The number of posts which waited for the free slot */
+    uint32_t dropped;           /*!< The number of events not posted because the queue stayed full */
+    uint32_t max_latency_us;    /*!< The maximum latency of the event */
+    uint32_t latency_hist[MB_EVENT_LATENCY_BUCKETS]; /*!< Bucket n counts the latencies below 2^n us, the last one all others */
+} mb_port_event_stats_t;
 typedef struct mb_port_timer_t mb_port_timer_t;
 typedef struct obj_descr_s obj_descr_t;
 
@@ -157,6 +174,8 @@ struct mb_port_base_t
 
     mb_port_event_t *event_obj;
     mb_port_timer_t *timer_obj;
+    mb_stats_t *stats_obj; //!< Transaction statistics, NULL if disabled.
+    mb_rto_t *rto_obj;     //!< Adaptive response timeouts of the master, NULL if disabled.
 };
 
 // Port event functions
@@ -171,6 +190,7 @@ mb_err_event_t mb_port_event_get_err_type(mb_port_base_t *inst);
 void mb_port_event_delete(mb_port_base_t *inst);
 mb_err_enum_t mb_port_event_wait_req_finish(mb_port_base_t *inst);
 uint64_t mb_port_get_trans_id(mb_port_base_t *inst);
+void mb_port_event_get_stats(mb_port_base_t *inst, mb_port_event_stats_t *stats);
 
 // Port timer functions
 mb_err_enum_t mb_port_timer_create(mb_port_base_t *inst, uint16_t t35_timer_ticks);
@@ -182,6 +202,7 @@ void mb_port_set_cur_timer_mode(mb_port_base_t *inst, mb_timer_mode_enum_t tmr_m
 mb_timer_mode_enum_t mb_port_get_cur_timer_mode(mb_port_base_t *inst);
 void mb_port_timer_set_response_time(mb_port_base_t *inst, uint32_t resp_time_ms);
 uint32_t mb_port_timer_get_response_time_ms(mb_port_base_t *inst);
+void mb_port_timer_set_request_time(mb_port_base_t *inst, uint32_t req_time_ms);
 void mb_port_timer_delay(mb_port_base_t *inst, uint16_t timeout_ms);
 void mb_port_timer_delete(mb_port_base_t *inst);
 
@@ -191,6 +212,11 @@ uint32_t mb_port_get_inst_counter();
 uint32_t mb_port_get_inst_counter_inc();
 uint32_t mb_port_get_inst_counter_dec();
 
+// Common frame buffer functions, the buffers are allocated from the frame pool if it is enabled
+void *mb_port_frame_alloc(size_t len);
+void mb_port_frame_free(void *buf);
+void mb_port_frame_get_stats(mb_pool_stats_t *stats);
+
 // Common queue functions
 QueueHandle_t queue_create(int queue_size);
 void queue_delete(QueueHandle_t queue);
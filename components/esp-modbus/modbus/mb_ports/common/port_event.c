@@ -16,15 +16,109 @@
 
 static const char *TAG = "mb_port.event";
 
+// The error events are delivered ahead of the transport events
+#define MB_EVENT_LANE_ERROR     (0)
+#define MB_EVENT_LANE_TRANSPORT (1)
+#define MB_EVENT_LANE_COUNT     (2)
+
+typedef struct
+{
+    _Atomic(uint32_t) seq;      // the position the slot is ready for (write: pos, read: pos + 1)
+    mb_event_t event;
+} mb_event_slot_t;
+
+// Bounded ring with the sequence number in each slot, many producers and the single consumer
+typedef struct
+{
+    _Atomic(uint32_t) head;     // the next position to write, shared by the producers
+    uint32_t tail;              // the next position to read, owned by the consumer
+    uint32_t mask;
+    mb_event_slot_t *slots;
+} mb_event_ring_t;
+
 struct mb_port_event_t
 {
     _Atomic(int) curr_err_type;
     SemaphoreHandle_t resource_hdl;
     EventGroupHandle_t event_group_hdl;
-    QueueHandle_t event_hdl;
+    SemaphoreHandle_t ready_hdl;        // wakes the consumer up on the posted event
+    SemaphoreHandle_t space_hdl;        // wakes the producers up on the free slot
+    mb_event_ring_t lanes[MB_EVENT_LANE_COUNT];
+    _Atomic(uint32_t) space_waiters;
     _Atomic(uint64_t) curr_trans_id;
+    _Atomic(uint32_t) posted;
+    _Atomic(uint32_t) overflows;
+    _Atomic(uint32_t) dropped;
+    uint32_t received;                  // the consumer side statistics
+    uint32_t max_latency_us;
+    uint32_t latency_hist[MB_EVENT_LATENCY_BUCKETS];
 };
 
+static bool mb_event_ring_init(mb_event_ring_t *ring, uint32_t min_size)
+{
+    uint32_t size = 1;
+    while (size < min_size) {
+        size <<= 1;
+    }
+    ring->slots = (mb_event_slot_t *)calloc(size, sizeof(mb_event_slot_t));
+    if (!ring->slots) {
+        return false;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        atomic_init(&ring->slots[i].seq, i);
+    }
+    atomic_init(&ring->head, 0);
+    ring->tail = 0;
+    ring->mask = size - 1;
+    return true;
+}
+
+static bool IRAM_ATTR mb_event_ring_push(mb_event_ring_t *ring, const mb_event_t *event)
+{
+    uint32_t pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    for (;;) {
+        mb_event_slot_t *slot = &ring->slots[pos & ring->mask];
+        int32_t diff = (int32_t)(atomic_load_explicit(&slot->seq, memory_order_acquire) - pos);
+        if (diff == 0) {
+            // The slot is free, take the position
+            if (atomic_compare_exchange_weak_explicit(&ring->head, &pos, pos + 1,
+                                                        memory_order_relaxed, memory_order_relaxed)) {
+                slot->event = *event;
+                atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            // The consumer did not read the slot yet, the ring is full
+            return false;
+        } else {
+            pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        }
+    }
+}
+
+static bool mb_event_ring_pop(mb_event_ring_t *ring, mb_event_t *event)
+{
+    mb_event_slot_t *slot = &ring->slots[ring->tail & ring->mask];
+    if (atomic_load_explicit(&slot->seq, memory_order_acquire) != (ring->tail + 1)) {
+        // Empty or the producer still writes the slot
+        return false;
+    }
+    *event = slot->event;
+    atomic_store_explicit(&slot->seq, ring->tail + ring->mask + 1, memory_order_release);
+    ring->tail++;
+    return true;
+}
+
+static void mb_event_add_latency(mb_port_event_t *event_obj, uint64_t latency_us)
+{
+    uint32_t latency = (latency_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)latency_us;
+    uint32_t index = latency ? (32 - __builtin_clz(latency)) : 0;
+    index = (index < MB_EVENT_LATENCY_BUCKETS) ? index : (MB_EVENT_LATENCY_BUCKETS - 1);
+    event_obj->latency_hist[index]++;
+    event_obj->max_latency_us = (latency > event_obj->max_latency_us) ? latency : event_obj->max_latency_us;
+    event_obj->received++;
+}
+
 mb_err_enum_t mb_port_event_create(mb_port_base_t *inst)
 {
     mb_port_event_t *event_obj = NULL;
@@ -39,18 +133,28 @@ mb_err_enum_t mb_port_event_create(mb_port_base_t *inst)
     event_obj->event_group_hdl = xEventGroupCreate();
     MB_GOTO_ON_FALSE((event_obj->event_group_hdl), MB_EILLSTATE, error, TAG,
                         "%s, event group create error.", inst->descr.parent_name);
-    event_obj->event_hdl = xQueueCreate(MB_EVENT_QUEUE_SIZE, sizeof(mb_event_t));
-    MB_GOTO_ON_FALSE((event_obj->event_hdl), MB_EILLSTATE, error,  TAG, "%s, event queue create error.", inst->descr.parent_name);
-    vQueueAddToRegistry(event_obj->event_hdl, TAG);
+    event_obj->ready_hdl = xSemaphoreCreateBinary();
+    event_obj->space_hdl = xSemaphoreCreateBinary();
+    MB_GOTO_ON_FALSE((event_obj->ready_hdl && event_obj->space_hdl), MB_EILLSTATE, error,
+                        TAG, "%s, event semaphore create error.", inst->descr.parent_name);
+    for (int i = 0; i < MB_EVENT_LANE_COUNT; i++) {
+        MB_GOTO_ON_FALSE((mb_event_ring_init(&event_obj->lanes[i], MB_EVENT_QUEUE_SIZE)), MB_EILLSTATE, error,
+                            TAG, "%s, event queue create error.", inst->descr.parent_name);
+    }
     inst->event_obj = event_obj;
     atomic_init(&event_obj->curr_err_type, EV_ERROR_INIT);
     ESP_LOGD(TAG, "initialized object @%p", event_obj);
     return MB_ENOERR;
 
 error:
-    if(event_obj->event_hdl) {
-        vQueueDelete(event_obj->event_hdl);
-        event_obj->event_hdl = NULL;
+    for (int i = 0; i < MB_EVENT_LANE_COUNT; i++) {
+        free(event_obj->lanes[i].slots);
+    }
+    if (event_obj->ready_hdl) {
+        vSemaphoreDelete(event_obj->ready_hdl);
+    }
+    if (event_obj->space_hdl) {
+        vSemaphoreDelete(event_obj->space_hdl);
     }
     if (event_obj->event_group_hdl) {
         vEventGroupDelete(event_obj->event_group_hdl);
@@ -86,28 +190,31 @@ uint64_t mb_port_get_trans_id(mb_port_base_t *inst)
 bool mb_port_event_post(mb_port_base_t *inst, mb_event_t event)
 {
     MB_RETURN_ON_FALSE((inst), false, TAG, "incorrect object handle for transaction %" PRIu64, event.trans_id);
-    MB_RETURN_ON_FALSE((inst->event_obj && inst->event_obj->event_hdl), false, TAG, 
+    MB_RETURN_ON_FALSE((inst->event_obj && inst->event_obj->ready_hdl), false, TAG, 
                             "Wrong event handle for transaction: %" PRIu64" %d, %p, %s.", 
                             event.trans_id, (int)(event.event), inst, inst->descr.parent_name);
-    BaseType_t result = pdFALSE;
+    mb_port_event_t *event_obj = inst->event_obj;
     mb_event_t temp_event;
     temp_event = event;
     temp_event.post_ts = esp_timer_get_time();
 
     if (event.event & EV_TRANS_START) {
-        atomic_store(&(inst->event_obj->curr_trans_id), temp_event.post_ts);
+        atomic_store(&(event_obj->curr_trans_id), temp_event.post_ts);
     }
     temp_event.event = (event.event & ~EV_TRANS_START);
+    mb_event_ring_t *ring = &event_obj->lanes[(temp_event.event == EV_ERROR_PROCESS)
+                                                ? MB_EVENT_LANE_ERROR : MB_EVENT_LANE_TRANSPORT];
 
     if (xPortInIsrContext()) {
         BaseType_t high_prio_task_woken = pdFALSE;
-        result = xQueueSendFromISR(inst->event_obj->event_hdl, 
-                                    (const void*)&temp_event, &high_prio_task_woken);
-        // Was the message posted successfully?
-        if (result != pdPASS) {
+        // The ISR can not wait for the consumer
+        if (!mb_event_ring_push(ring, &temp_event)) {
+            atomic_fetch_add(&event_obj->dropped, 1);
             ESP_EARLY_LOGV(TAG, "%s, post message %x failure .", inst->descr.parent_name, temp_event.event);
             return false;
-        }    
+        }
+        atomic_fetch_add(&event_obj->posted, 1);
+        (void)xSemaphoreGiveFromISR(event_obj->ready_hdl, &high_prio_task_woken);
         // If high_prio_task_woken is now set to pdTRUE
         // then a context switch should be requested.
         if (high_prio_task_woken) {
@@ -115,29 +222,73 @@ bool mb_port_event_post(mb_port_base_t *inst, mb_event_t event)
         }
         return true;
     }
-    result = xQueueSend(inst->event_obj->event_hdl, (const void*)&temp_event, MB_EVENT_QUEUE_TIMEOUT_MAX);
-    if (result != pdTRUE) {
-        xQueueReset(inst->event_obj->event_hdl);
-        ESP_LOGE(TAG, "%s, post message failure.", inst->descr.parent_name);
-        return false;
+    if (!mb_event_ring_push(ring, &temp_event)) {
+        // The ring is full, wait for the consumer instead of dropping the queued events
+        bool is_posted = false;
+        TickType_t start_time = xTaskGetTickCount();
+        atomic_fetch_add(&event_obj->overflows, 1);
+        atomic_fetch_add(&event_obj->space_waiters, 1);
+        for (;;) {
+            if (mb_event_ring_push(ring, &temp_event)) {
+                is_posted = true;
+                break;
+            }
+            TickType_t elapsed = xTaskGetTickCount() - start_time;
+            if (elapsed >= MB_EVENT_QUEUE_TIMEOUT_MAX) {
+                break;
+            }
+            (void)xSemaphoreTake(event_obj->space_hdl, MB_EVENT_QUEUE_TIMEOUT_MAX - elapsed);
+        }
+        atomic_fetch_sub(&event_obj->space_waiters, 1);
+        if (!is_posted) {
+            atomic_fetch_add(&event_obj->dropped, 1);
+            ESP_LOGE(TAG, "%s, post message failure.", inst->descr.parent_name);
+            return false;
+        }
     }
+    atomic_fetch_add(&event_obj->posted, 1);
+    (void)xSemaphoreGive(event_obj->ready_hdl);
     return true;
 }
 
 bool mb_port_event_get(mb_port_base_t *inst, mb_event_t *event)
 {
-    MB_RETURN_ON_FALSE((inst && event && inst->event_obj && inst->event_obj->event_hdl), false, TAG, 
+    MB_RETURN_ON_FALSE((inst && event && inst->event_obj && inst->event_obj->ready_hdl), false, TAG, 
                             "incorrect object handle.");
-    bool event_happened = false;
+    mb_port_event_t *event_obj = inst->event_obj;
+    TickType_t start_time = xTaskGetTickCount();
 
-    if (xQueueReceive(inst->event_obj->event_hdl, event, MB_EVENT_QUEUE_TIMEOUT_MAX) == pdTRUE) {
-        event->trans_id = atomic_load(&inst->event_obj->curr_trans_id);
-        event->get_ts = esp_timer_get_time();
-        event_happened = true;
-    } else {
-        ESP_LOGD(TAG, "%s, get event timeout.", inst->descr.parent_name);
+    for (;;) {
+        if (mb_event_ring_pop(&event_obj->lanes[MB_EVENT_LANE_ERROR], event)
+                || mb_event_ring_pop(&event_obj->lanes[MB_EVENT_LANE_TRANSPORT], event)) {
+            break;
+        }
+        TickType_t elapsed = xTaskGetTickCount() - start_time;
+        if ((elapsed >= MB_EVENT_QUEUE_TIMEOUT_MAX)
+                || !xSemaphoreTake(event_obj->ready_hdl, MB_EVENT_QUEUE_TIMEOUT_MAX - elapsed)) {
+            ESP_LOGD(TAG, "%s, get event timeout.", inst->descr.parent_name);
+            return false;
+        }
+    }
+    if (atomic_load(&event_obj->space_waiters)) {
+        (void)xSemaphoreGive(event_obj->space_hdl);
     }
-    return event_happened;
+    event->trans_id = atomic_load(&event_obj->curr_trans_id);
+    event->get_ts = esp_timer_get_time();
+    mb_event_add_latency(event_obj, (event->get_ts > event->post_ts) ? (event->get_ts - event->post_ts) : 0);
+    return true;
+}
+
+void mb_port_event_get_stats(mb_port_base_t *inst, mb_port_event_stats_t *stats)
+{
+    MB_RETURN_ON_FALSE((inst && inst->event_obj && stats), ;, TAG, "incorrect object handle.");
+    mb_port_event_t *event_obj = inst->event_obj;
+    stats->posted = atomic_load(&event_obj->posted);
+    stats->received = event_obj->received;
+    stats->overflows = atomic_load(&event_obj->overflows);
+    stats->dropped = atomic_load(&event_obj->dropped);
+    stats->max_latency_us = event_obj->max_latency_us;
+    memcpy(stats->latency_hist, event_obj->latency_hist, sizeof(stats->latency_hist));
 }
 
 bool mb_port_event_res_take(mb_port_base_t *inst, uint32_t timeout)
@@ -229,9 +380,14 @@ void mb_port_event_delete(mb_port_base_t *inst)
     if (inst->event_obj->event_group_hdl) {
         vEventGroupDelete(inst->event_obj->event_group_hdl);
     }
-    if(inst->event_obj->event_hdl) {
-        vQueueDelete(inst->event_obj->event_hdl);
-        inst->event_obj->event_hdl = NULL;
+    if (inst->event_obj->ready_hdl) {
+        vSemaphoreDelete(inst->event_obj->ready_hdl);
+    }
+    if (inst->event_obj->space_hdl) {
+        vSemaphoreDelete(inst->event_obj->space_hdl);
+    }
+    for (int i = 0; i < MB_EVENT_LANE_COUNT; i++) {
+        free(inst->event_obj->lanes[i].slots);
     }
     free(inst->event_obj);
     inst->event_obj = NULL;
@@ -9,10 +9,13 @@
 #include "sys/lock.h"
 
 #include "port_common.h"
+#include "mb_pool.h"
 
 /* ----------------------- Variables ----------------------------------------*/
 static _Atomic(uint32_t) inst_counter = 0;
 
+MB_POOL_DEFINE_STATIC(frame_pool, CONFIG_FMB_BUFFER_SIZE, CONFIG_FMB_QUEUE_LENGTH);
+
 /* ----------------------- Start implementation -----------------------------*/
 int lock_obj(_lock_t *lock_ptr)
 {
@@ -47,6 +50,21 @@ uint32_t mb_port_get_inst_counter_dec()
     return atomic_fetch_sub(&inst_counter, 1);
 }
 
+void *mb_port_frame_alloc(size_t len)
+{
+    return mb_pool_alloc(&frame_pool, len);
+}
+
+void mb_port_frame_free(void *buf)
+{
+    mb_pool_free(&frame_pool, buf);
+}
+
+void mb_port_frame_get_stats(mb_pool_stats_t *stats)
+{
+    mb_pool_get_stats(&frame_pool, stats);
+}
+
 QueueHandle_t queue_create(int queue_size)
 {
     return xQueueCreate(queue_size, sizeof(frame_entry_t));
@@ -76,7 +94,7 @@ esp_err_t queue_push(QueueHandle_t queue, void *buf, size_t len, frame_entry_t *
 
     if (buf && (len > 0)) {
         if (!frame_info.buf) {
-            frame_info.buf = calloc(1, len);
+            frame_info.buf = mb_port_frame_alloc(len);
         }
         if (!frame_info.buf) {
             return ESP_ERR_NO_MEM;
@@ -110,7 +128,7 @@ ssize_t queue_pop(QueueHandle_t queue, void *buf, size_t len, frame_entry_t *fra
         if (frame_info.buf && buf) {
             memcpy(buf, frame_info.buf, len);
             if (!frame) {
-                free(frame_info.buf); // must free the buffer manually!
+                mb_port_frame_free(frame_info.buf); // must free the buffer manually!
             }
         }
     } else {
@@ -131,7 +149,7 @@ void queue_flush(QueueHandle_t queue)
     frame_entry_t frame_info;
     while (xQueueReceive(queue, &frame_info, 0) == pdTRUE) {
         if ((frame_info.len > 0) && frame_info.buf) {
-            free(frame_info.buf);
+            mb_port_frame_free(frame_info.buf);
         }
     }
 }
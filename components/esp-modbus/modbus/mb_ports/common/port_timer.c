@@ -30,6 +30,7 @@ struct mb_port_timer_t
     esp_timer_handle_t timer_handle;
     uint16_t t35_ticks;
     _Atomic(uint32_t) response_time_ms;
+    _Atomic(uint32_t) request_time_ms;      // The response timeout of the current request, zero to use the response time
     _Atomic(bool) timer_state;
     _Atomic(uint16_t) timer_mode;
 };
@@ -64,6 +65,7 @@ mb_err_enum_t mb_port_timer_create(mb_port_base_t *inst, uint16_t t35_timer_tick
     atomic_init(&(inst->timer_obj->timer_state), false);
     // Set default response time according to kconfig
     atomic_init(&(inst->timer_obj->response_time_ms), MB_MASTER_TIMEOUT_MS_RESPOND);
+    atomic_init(&(inst->timer_obj->request_time_ms), 0);
     // Save timer reload value for Modbus T35 period
     inst->timer_obj->t35_ticks = t35_timer_ticks;
     esp_timer_create_args_t timer_conf = {
@@ -151,11 +153,15 @@ void mb_port_timer_convert_delay_enable(mb_port_base_t *inst)
 
 void mb_port_timer_respond_timeout_enable(mb_port_base_t *inst)
 {
-    uint64_t tout_us = (inst->timer_obj->response_time_ms * 1000);
+    uint32_t tout_ms = atomic_load(&(inst->timer_obj->request_time_ms));
+    if (!tout_ms) {
+        tout_ms = mb_port_timer_get_response_time_ms(inst);
+    }
+    uint64_t tout_us = ((uint64_t)tout_ms * 1000);
 
     mb_port_set_cur_timer_mode(inst, MB_TMODE_RESPOND_TIMEOUT);
     ESP_LOGD(TAG, "%s, respond enable timeout (%u).", 
-                inst->descr.parent_name, (unsigned)mb_port_timer_get_response_time_ms(inst));
+                inst->descr.parent_name, (unsigned)tout_ms);
     mb_port_timer_us(inst, tout_us);
 }
 
@@ -187,3 +193,9 @@ uint32_t mb_port_timer_get_response_time_ms(mb_port_base_t *inst)
 {
     return atomic_load(&(inst->timer_obj->response_time_ms));
 }
+
+// Sets the response timeout of the next request, zero to use the response time of the port
+void mb_port_timer_set_request_time(mb_port_base_t *inst, uint32_t req_time_ms)
+{
+    atomic_store(&(inst->timer_obj->request_time_ms), req_time_ms);
+}
@@ -9,6 +9,7 @@
 #include "port_common.h"
 #include "mb_config.h"
 #include "port_serial_common.h"
+#include "mbcrc.h"
 
 /* ----------------------- Defines ------------------------------------------*/
 #define MB_SERIAL_RX_SEMA_TOUT_MS   (1000)
@@ -20,6 +21,11 @@
 #define MB_SERIAL_TASK_STACK_SIZE   (CONFIG_FMB_PORT_TASK_STACK_SIZE)
 #define MB_SERIAL_RX_TOUT_TICKS     (pdMS_TO_TICKS(100))
 
+#define MB_SERIAL_BYTE_BITS         (11)
+
+#define MB_SERIAL_RX_SLOTS          (2)
+#define MB_SERIAL_RX_SLOT_NONE      (-1)
+
 #define MB_SERIAL_MIN_PATTERN_INTERVAL  (9)
 #define MB_SERIAL_MIN_POST_IDLE         (0)
 #define MB_SERIAL_MIN_PRE_IDLE          (0)
@@ -33,7 +39,6 @@ typedef struct
     mb_serial_opts_t ser_opts;
     bool rx_state_en;
     bool tx_state_en;
-    uint16_t recv_length;
     uint64_t send_time_stamp;
     uint64_t recv_time_stamp;
     uint32_t flags;
@@ -41,6 +46,24 @@ typedef struct
     QueueHandle_t uart_queue;           // A queue to handle UART event.
     TaskHandle_t  task_handle;          // UART task to handle UART event.
     SemaphoreHandle_t bus_sema_handle;   // Rx blocking semaphore handle
+    // The port task moves the bytes from the UART ring buffer into the slot as they arrive,
+    // the frame is parsed by the transport in place and the slot is kept until the next frame is taken
+    uint8_t rx_slots[MB_SERIAL_RX_SLOTS][MB_BUFFER_SIZE];
+    uint16_t rx_slot_len[MB_SERIAL_RX_SLOTS];
+    uint16_t rx_slot_crc[MB_SERIAL_RX_SLOTS]; // The CRC16 of the RTU frame, zero if the frame is valid
+    int rx_fill;                        // The slot of the frame being received
+    int rx_ready;                       // The received frame which is not taken by the stack yet
+    int rx_held;                        // The frame used by the stack
+    uint16_t rx_pos;                    // The number of bytes of the frame being received
+    uint16_t rx_crc;                    // The CRC16 of the received bytes of the RTU frame
+    bool rx_skip;                       // The rest of the frame is skipped up to the RX timeout
+    uint32_t rx_gen;                    // Changed on flush to drop the bytes read before it
+#if MB_STATS_ENABLED
+    mb_stats_t stats;                   // Transaction statistics of the port
+#endif
+#if MB_RTO_ENABLED
+    mb_rto_t rto;                       // Adaptive response timeouts of the slaves
+#endif
 } mb_ser_port_t;
 
 /* ----------------------- Static variables & functions ----------------------*/
@@ -98,6 +121,15 @@ static void mb_port_ser_rx_flush(mb_port_base_t *inst)
     size_t size = 1;
     esp_err_t err = ESP_OK;
     mb_ser_port_t *port_obj = __containerof(inst, mb_ser_port_t, base);
+    // The frame used by the stack is kept, the partial and not taken frames are dropped
+    CRITICAL_SECTION (port_obj->base.lock) {
+        port_obj->rx_gen++;
+        port_obj->rx_fill = MB_SERIAL_RX_SLOT_NONE;
+        port_obj->rx_ready = MB_SERIAL_RX_SLOT_NONE;
+        port_obj->rx_pos = 0;
+        port_obj->rx_crc = MB_CRC16_INIT;
+        port_obj->rx_skip = false;
+    }
     for (int cnt = 0; (cnt < MB_SERIAL_RX_FLUSH_RETRY) && size; cnt++) {
         err = uart_get_buffered_data_len(port_obj->ser_opts.port, &size);
         MB_RETURN_ON_FALSE((err == ESP_OK), ; , TAG, 
@@ -133,6 +165,113 @@ void mb_port_ser_disable(mb_port_base_t *inst)
     }
 }
 
+// Returns the slot for the next frame, the frame which is not taken by the stack yet is replaced by the newer one
+static int mb_port_ser_rx_get_slot(mb_ser_port_t *port_obj)
+{
+    for (int slot = 0; slot < MB_SERIAL_RX_SLOTS; slot++) {
+        if ((slot != port_obj->rx_ready) && (slot != port_obj->rx_held)) {
+            return slot;
+        }
+    }
+    int slot = port_obj->rx_ready;
+    port_obj->rx_ready = MB_SERIAL_RX_SLOT_NONE;
+    return slot;
+}
+
+// Moves the received bytes from the UART ring buffer to the slot of the frame,
+// so only the tail of the frame is left to read when the RX timeout ends the frame
+static void mb_port_ser_rx_fetch(mb_ser_port_t *port_obj)
+{
+    size_t size = 0;
+    int slot = MB_SERIAL_RX_SLOT_NONE;
+    uint16_t pos = 0;
+    uint16_t crc = MB_CRC16_INIT;
+    uint32_t gen = 0;
+    bool is_skip = false;
+    bool is_dropped = false;
+
+    if ((uart_get_buffered_data_len(port_obj->ser_opts.port, &size) != ESP_OK) || !size) {
+        return;
+    }
+    CRITICAL_SECTION (port_obj->base.lock) {
+        if ((port_obj->rx_fill == MB_SERIAL_RX_SLOT_NONE) && !port_obj->rx_skip) {
+            port_obj->rx_fill = mb_port_ser_rx_get_slot(port_obj);
+        }
+        slot = port_obj->rx_fill;
+        pos = port_obj->rx_pos;
+        crc = port_obj->rx_crc;
+        gen = port_obj->rx_gen;
+        if ((pos + size) > MB_BUFFER_SIZE) {
+            port_obj->rx_fill = MB_SERIAL_RX_SLOT_NONE;
+            port_obj->rx_pos = 0;
+            port_obj->rx_crc = MB_CRC16_INIT;
+            is_dropped = !port_obj->rx_skip;
+            port_obj->rx_skip = true;
+        }
+        is_skip = port_obj->rx_skip;
+    }
+    if (is_skip) {
+        if (is_dropped) {
+            ESP_LOGD(TAG, "%s, drop the frame longer than %d bytes.", port_obj->base.descr.parent_name, MB_BUFFER_SIZE);
+            mb_stats_record(port_obj->base.stats_obj, MB_STATS_NO_NODE, MB_STATS_NO_FUNC,
+                                MB_STATS_RESULT_FRAME_ERROR, 0, 0, 0);
+        }
+        (void)uart_flush_input(port_obj->ser_opts.port);
+        return;
+    }
+    int count = uart_read_bytes(port_obj->ser_opts.port, &port_obj->rx_slots[slot][pos], size, 0);
+    // The CRC is updated while the rest of the frame is received, so it is ready when the frame ends
+    if ((count > 0) && (port_obj->ser_opts.mode == MB_RTU)) {
+        crc = mb_crc16_update(crc, &port_obj->rx_slots[slot][pos], (uint16_t)count);
+    }
+    CRITICAL_SECTION (port_obj->base.lock) {
+        // The flush from other task drops the bytes read before it
+        if ((count > 0) && (gen == port_obj->rx_gen)) {
+            port_obj->rx_pos = pos + count;
+            port_obj->rx_crc = crc;
+        }
+    }
+}
+
+// Ends the frame on the RX timeout and passes it to the stack
+static void mb_port_ser_rx_complete(mb_ser_port_t *port_obj)
+{
+    int slot = MB_SERIAL_RX_SLOT_NONE;
+    uint16_t length = 0;
+    uint16_t crc = MB_CRC16_INIT;
+
+    CRITICAL_SECTION (port_obj->base.lock) {
+        slot = port_obj->rx_fill;
+        length = port_obj->rx_pos;
+        crc = port_obj->rx_crc;
+        port_obj->rx_fill = MB_SERIAL_RX_SLOT_NONE;
+        port_obj->rx_pos = 0;
+        port_obj->rx_crc = MB_CRC16_INIT;
+        port_obj->rx_skip = false;
+    }
+    if (slot == MB_SERIAL_RX_SLOT_NONE) {
+        return;
+    }
+    // If bus is busy or fragmented data is received, then drop the frame
+    if (mb_port_ser_bus_sema_is_busy(&port_obj->base) && port_obj->base.descr.is_master) {
+        ESP_LOGD(TAG, "%s, drop %d byte(s) received while bus is busy.", port_obj->base.descr.parent_name, (int)length);
+        return;
+    }
+    if (length <= MB_SER_PDU_SIZE_MIN) {
+        ESP_LOGD(TAG, "%s, drop short packet %d byte(s)", port_obj->base.descr.parent_name, (int)length);
+        return;
+    }
+    CRITICAL_SECTION (port_obj->base.lock) {
+        port_obj->rx_slot_len[slot] = length;
+        port_obj->rx_slot_crc[slot] = crc;
+        port_obj->rx_ready = slot;
+    }
+    port_obj->recv_time_stamp = esp_timer_get_time();
+    // New frame is received, send an event to main FSM to take it from the slot
+    mb_port_event_post(&port_obj->base, EVENT(EV_FRAME_RECEIVED, length, NULL, 0));
+    ESP_LOGD(TAG, "%s, frame %d bytes is ready.", port_obj->base.descr.parent_name, (int)length);
+}
+
 // UART receive event task
 static void mb_port_ser_task(void *p_args)
 {
@@ -151,24 +290,11 @@ static void mb_port_ser_task(void *p_args)
             switch(event.type) {
                 case UART_DATA:
                     ESP_LOGD(TAG, "%s, data event, len: %d.", port_obj->base.descr.parent_name, (int)event.size);
+                    mb_port_ser_rx_fetch(port_obj);
                     // This flag set in the event means that no more
                     // data received during configured timeout and UART TOUT feature is triggered
                     if (event.timeout_flag) {
-                        // If bus is busy or fragmented data is received, then flush buffer
-                        if (mb_port_ser_bus_sema_is_busy(&port_obj->base) && port_obj->base.descr.is_master) {
-                            mb_port_ser_rx_flush(&port_obj->base);
-                            break;
-                        }
-                        uart_get_buffered_data_len(port_obj->ser_opts.port, (unsigned int*)&event.size);
-                        port_obj->recv_length = (event.size < MB_BUFFER_SIZE) ? event.size : MB_BUFFER_SIZE;
-                        if (event.size <= MB_SER_PDU_SIZE_MIN) {
-                            ESP_LOGD(TAG, "%s, drop short packet %d byte(s)", port_obj->base.descr.parent_name, (int)event.size);
-                            (void)mb_port_ser_rx_flush(&port_obj->base);
-                            break;
-                        }
-                        // New frame is received, send an event to main FSM to read it into receiver buffer
-                        mb_port_event_post(&port_obj->base, EVENT(EV_FRAME_RECEIVED, port_obj->recv_length, NULL, 0));
-                        ESP_LOGD(TAG, "%s, frame %d bytes is ready.", port_obj->base.descr.parent_name, (int)port_obj->recv_length);
+                        mb_port_ser_rx_complete(port_obj);
                     }
                     break;
                 //Event of HW FIFO overflow detected
@@ -180,6 +306,9 @@ static void mb_port_ser_task(void *p_args)
                 case UART_BUFFER_FULL:
                     ESP_LOGD(TAG, "%s, ring buffer full.", port_obj->base.descr.parent_name);
                     (void)mb_port_ser_rx_flush(&port_obj->base);
+                    // The dropped frame never reaches the stack, so it is counted here
+                    mb_stats_record(port_obj->base.stats_obj, MB_STATS_NO_NODE, MB_STATS_NO_FUNC,
+                                        MB_STATS_RESULT_FRAME_ERROR, 0, 0, 0);
                     break;
                 //Event of UART RX break detected
                 case UART_BREAK:
@@ -189,11 +318,15 @@ static void mb_port_ser_task(void *p_args)
                 case UART_PARITY_ERR:
                     ESP_LOGD(TAG, "%s, uart parity error.", port_obj->base.descr.parent_name);
                     (void)mb_port_ser_rx_flush(&port_obj->base);
+                    mb_stats_record(port_obj->base.stats_obj, MB_STATS_NO_NODE, MB_STATS_NO_FUNC,
+                                        MB_STATS_RESULT_FRAME_ERROR, 0, 0, 0);
                     break;
                 //Event of UART frame error
                 case UART_FRAME_ERR:
                     ESP_LOGD(TAG, "%s, uart frame error.", port_obj->base.descr.parent_name);
                     (void)mb_port_ser_rx_flush(&port_obj->base);
+                    mb_stats_record(port_obj->base.stats_obj, MB_STATS_NO_NODE, MB_STATS_NO_FUNC,
+                                        MB_STATS_RESULT_FRAME_ERROR, 0, 0, 0);
                     break;
                 default:
                     ESP_LOGD(TAG, "%s, uart event type: %d.", port_obj->base.descr.parent_name, (int)event.type);
@@ -214,6 +347,22 @@ mb_err_enum_t mb_port_ser_create(mb_serial_opts_t *ser_opts, mb_port_base_t **in
 
     CRITICAL_SECTION_INIT(ser_port->base.lock);
     ser_port->base.descr = (*in_out_obj)->descr;
+    ser_port->rx_fill = MB_SERIAL_RX_SLOT_NONE;
+    ser_port->rx_ready = MB_SERIAL_RX_SLOT_NONE;
+    ser_port->rx_held = MB_SERIAL_RX_SLOT_NONE;
+    ser_port->rx_crc = MB_CRC16_INIT;
+#if MB_STATS_ENABLED
+    ser_port->base.stats_obj = &ser_port->stats;
+#endif
+#if MB_RTO_ENABLED
+    if (ser_port->base.descr.is_master && ser_opts->baudrate) {
+        // One byte takes 11 bits with parity, the ASCII frame sends two characters per byte
+        uint32_t byte_time_us = (MB_SERIAL_BYTE_BITS * 1000000UL) / ser_opts->baudrate;
+        mb_rto_init(&ser_port->rto, (ser_opts->mode == MB_ASCII) ? (byte_time_us * 2) : byte_time_us,
+                        MB_SER_PDU_SIZE_MAX);
+        ser_port->base.rto_obj = &ser_port->rto;
+    }
+#endif
     ser_opts->data_bits = ((ser_opts->data_bits > UART_DATA_5_BITS) 
                                 && (ser_opts->data_bits < UART_DATA_BITS_MAX)) 
                                 ? ser_opts->data_bits : UART_DATA_8_BITS;
@@ -291,31 +440,49 @@ bool mb_port_ser_recv_data(mb_port_base_t *inst, uint8_t **ser_frame, uint16_t *
 {
     MB_RETURN_ON_FALSE((ser_frame && p_ser_length), false, TAG, "mb serial get buffer failure.");
     mb_ser_port_t *port_obj = __containerof(inst, mb_ser_port_t, base);
-    uint16_t counter = *p_ser_length ? *p_ser_length : port_obj->recv_length;
+    int slot = MB_SERIAL_RX_SLOT_NONE;
+    uint16_t counter = 0;
     bool status = false;
 
     status = mb_port_ser_bus_sema_take(inst, pdMS_TO_TICKS(mb_port_timer_get_response_time_ms(inst)));
-    if (status && counter && *ser_frame && atomic_load(&(port_obj->enabled))) {
-        // Read frame data from the ringbuffer of receiver
-        counter = uart_read_bytes(port_obj->ser_opts.port, *ser_frame, counter, MB_SERIAL_RX_TOUT_TICKS);
-        // Store the timestamp of received frame
-        port_obj->recv_time_stamp = esp_timer_get_time();
+    if (status && atomic_load(&(port_obj->enabled))) {
+        // The previous frame is released, the stack takes the received one without copy
+        CRITICAL_SECTION (port_obj->base.lock) {
+            slot = port_obj->rx_ready;
+            port_obj->rx_held = slot;
+            port_obj->rx_ready = MB_SERIAL_RX_SLOT_NONE;
+            counter = (slot != MB_SERIAL_RX_SLOT_NONE) ? port_obj->rx_slot_len[slot] : 0;
+        }
+    }
+    if (counter) {
+        *ser_frame = port_obj->rx_slots[slot];
         ESP_LOGD(TAG, "%s, received data: %d bytes.", inst->descr.parent_name, (int)counter);
         MB_PRT_BUF(inst->descr.parent_name, ":PORT_RECV", *ser_frame, counter, ESP_LOG_DEBUG);
         int64_t time_delta = (port_obj->recv_time_stamp > port_obj->send_time_stamp) ? 
                                 (port_obj->recv_time_stamp - port_obj->send_time_stamp) :
                                 (port_obj->send_time_stamp - port_obj->recv_time_stamp);
         ESP_LOGD(TAG, "%s, serial processing time[us] = %" PRId64, inst->descr.parent_name, time_delta);
-        status = true;
-        *p_ser_length = counter;
     } else {
-        ESP_LOGE(TAG, "%s: junk data (%d bytes) received. ", inst->descr.parent_name, (int)counter);
+        ESP_LOGE(TAG, "%s: junk data (%d bytes) received. ", inst->descr.parent_name, (int)*p_ser_length);
+        status = false;
     }
     *p_ser_length = counter;
     mb_port_ser_bus_sema_release(inst);
     return status;
 }
 
+bool mb_port_ser_check_crc16(mb_port_base_t *inst, uint8_t *ser_frame, uint16_t ser_length)
+{
+    mb_ser_port_t *port_obj = __containerof(inst, mb_ser_port_t, base);
+    int slot = port_obj->rx_held;
+    // The CRC of the RTU frame taken from the slot is calculated on reception
+    if ((port_obj->ser_opts.mode == MB_RTU) && (slot != MB_SERIAL_RX_SLOT_NONE)
+            && (ser_frame == port_obj->rx_slots[slot]) && (ser_length == port_obj->rx_slot_len[slot])) {
+        return (port_obj->rx_slot_crc[slot] == 0);
+    }
+    return (mb_crc16(ser_frame, ser_length) == 0);
+}
+
 bool mb_port_ser_send_data(mb_port_base_t *inst, uint8_t *p_ser_frame, uint16_t ser_length)
 {
     bool res = false;
@@ -26,6 +26,7 @@ typedef struct mb_port_base_t mb_port_base_t;
 mb_err_enum_t mb_port_ser_create(mb_serial_opts_t *ser_opts, mb_port_base_t **in_out_obj);
 bool mb_port_ser_recv_data(mb_port_base_t *inst, uint8_t **ser_frame, uint16_t *p_ser_length);
 bool mb_port_ser_send_data(mb_port_base_t *inst, uint8_t *p_ser_frame, uint16_t ser_length);
+bool mb_port_ser_check_crc16(mb_port_base_t *inst, uint8_t *ser_frame, uint16_t ser_length);
 void mb_port_ser_enable(mb_port_base_t *inst);
 void mb_port_ser_disable(mb_port_base_t *inst);
 void mb_port_ser_delete(mb_port_base_t *inst);
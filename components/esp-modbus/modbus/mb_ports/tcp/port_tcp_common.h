@@ -19,6 +19,9 @@ extern "C" {
 
 #define MB_TCP_PORT_MAX_CONN            (CONFIG_FMB_TCP_PORT_MAX_CONN)
 #define MB_TCP_DEFAULT_PORT             (CONFIG_FMB_TCP_PORT_DEFAULT)
+#define MB_TCP_MASTER_INFLIGHT_MAX      (CONFIG_FMB_TCP_MASTER_INFLIGHT_MAX)
+#define MB_TCP_SLAVE_CLIENT_QUEUE_MAX   (CONFIG_FMB_TCP_SLAVE_CLIENT_QUEUE_MAX)
+#define MB_TCP_MASTER_WINDOW_TOUT_MS    (3000) // wait for the free place in the in-flight window
 #define MB_FRAME_QUEUE_SZ               (20)
 #define MB_TCP_CHECK_ALIVE_TOUT_MS      (20) // check alive timeout in mS
 #define MB_RECONNECT_TIME_MS            (CONFIG_FMB_TCP_CONNECTION_TOUT_SEC * 1000UL)
@@ -46,8 +49,52 @@ void mbs_port_tcp_delete(mb_port_base_t *inst);
 void mbs_port_tcp_enable(mb_port_base_t *inst);
 void mbs_port_tcp_disable(mb_port_base_t *inst);
 bool mbs_port_tcp_send_data(mb_port_base_t *inst, uint8_t *frame, uint16_t length);
+
+/**
+ * @brief Gets the acknowledged frame received from socket
+ *
+ * The buffer read from socket is returned without copy and the caller takes its ownership.
+ * The buffer has MB_TCP_BUFF_MAX_SIZE bytes to build the response in place and must be
+ * released with mb_port_frame_free().
+ */
 bool mbs_port_tcp_recv_data(mb_port_base_t *inst, uint8_t **frame, uint16_t *length);
 
+/**
+ * @brief Gets the statistics of the connected clients of the TCP slave
+ *
+ * @param inst the port object of the TCP slave
+ * @param stats the array of statistics to fill
+ * @param max_count the number of items in the array
+ *
+ * @return the number of the client statistics returned
+ */
+uint16_t mbs_port_tcp_get_client_stats(mb_port_base_t *inst, mb_tcp_client_stats_t *stats, uint16_t max_count);
+
+/**
+ * @brief The visitor of the requests queued in the TCP slave
+ *
+ * Gets the unit identifier, the time of receiving (us) and the PDU of the request.
+ * Returns false to stop the iteration.
+ */
+typedef bool (*mbs_port_tcp_visitor_fp)(void *arg, uint8_t uid, uint64_t tick, const uint8_t *pdu, uint16_t length);
+
+/**
+ * @brief Gets the unit identifier and the time of receiving of the request processed by the slave
+ *
+ * @return true if the slave processes a request
+ */
+bool mbs_port_tcp_get_request_info(mb_port_base_t *inst, uint8_t *uid, uint64_t *tick);
+
+/**
+ * @brief Calls the visitor for the requests waiting in the queue of the TCP slave
+ *
+ * The requests are visited in the order of receiving. The visitor is called under the lock
+ * of the port, so it has to copy the data it needs and return quickly.
+ *
+ * @return the number of visited requests
+ */
+uint16_t mbs_port_tcp_foreach_queued(mb_port_base_t *inst, mbs_port_tcp_visitor_fp visitor, void *arg);
+
 #endif
 
 #ifdef __cplusplus
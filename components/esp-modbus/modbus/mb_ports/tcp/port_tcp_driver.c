@@ -281,6 +281,34 @@ mb_status_flags_t mb_drv_wait_status_flag(void *ctx, mb_status_flags_t mask, Tic
                                             ticks);
 }
 
+// Remove the node from the nodes to check, the caller holds the driver lock
+static void mb_drv_alive_del_locked(port_driver_t *drv_obj, int index)
+{
+    for (int i = 0; i < drv_obj->alive_count; i++) {
+        if (drv_obj->alive_nodes[i] == index) {
+            drv_obj->alive_nodes[i] = drv_obj->alive_nodes[--drv_obj->alive_count];
+            break;
+        }
+    }
+}
+
+// Keep alive timer of the node, the check is postponed while the node receives data
+static void mb_drv_alive_timer_cb(mb_timer_node_t *timer, void *arg)
+{
+    port_driver_t *drv_obj = (port_driver_t *)arg;
+    mb_node_info_t *node_ptr = __containerof(timer, mb_node_info_t, alive_timer);
+    uint64_t alive_time = (uint64_t)node_ptr->recv_time + MB_KEEP_ALIVE_TIME_US;
+    uint64_t time_now = esp_timer_get_time();
+    if (alive_time > time_now) {
+        mb_timer_wheel_arm(drv_obj->timer_wheel, timer, alive_time);
+    } else {
+        // The event is sent by the driver task after the wheel is advanced and the lock is released
+        mb_drv_alive_del_locked(drv_obj, node_ptr->index);
+        drv_obj->alive_nodes[drv_obj->alive_count++] = node_ptr->index;
+        mb_timer_wheel_arm(drv_obj->timer_wheel, timer, time_now + MB_KEEP_ALIVE_TIME_US);
+    }
+}
+
 int mb_drv_open(void *ctx, mb_uid_info_t addr_info, int flags)
 {
     int fd = UNDEF_FD;
@@ -319,6 +347,10 @@ int mb_drv_open(void *ctx, mb_uid_info_t addr_info, int flags)
             node_ptr->tid_counter = 0;
             node_ptr->send_counter = 0;
             node_ptr->recv_counter = 0;
+            node_ptr->recv_copy_bytes = 0;
+            node_ptr->recv_time_us = 0;
+            node_ptr->rx_buf = NULL;
+            node_ptr->rx_len = 0;
             node_ptr->is_blocking = ((flags & O_NONBLOCK) == 0);
             drv_obj->mb_nodes[fd] = node_ptr;
             // mark opened node in the open set
@@ -400,11 +432,91 @@ ssize_t mb_drv_read(void *ctx, int fd, void *data, size_t size)
     ssize_t actual_size = -1;
     if ((actual_size = queue_pop(node_ptr->rx_queue, data, size, NULL)) < 0) {
         errno = EAGAIN;
+    } else {
+        node_ptr->recv_copy_bytes += actual_size;
     }
 
     return actual_size;
 }
 
+// Add the node socket into the connection set, the caller holds the driver lock
+static bool mb_drv_conn_add_locked(port_driver_t *drv_obj, mb_node_info_t *node_ptr)
+{
+    if (node_ptr->sock_id < 0) {
+        return false;
+    }
+    if (FD_ISSET(node_ptr->sock_id, &drv_obj->conn_set)) {
+        return true;
+    }
+    if (drv_obj->node_conn_count >= MB_MAX_FDS) {
+        return false;
+    }
+    FD_SET(node_ptr->sock_id, &drv_obj->conn_set);
+    drv_obj->conn_max_fd = (node_ptr->sock_id > drv_obj->conn_max_fd) ? node_ptr->sock_id : drv_obj->conn_max_fd;
+    drv_obj->conn_nodes[drv_obj->node_conn_count++] = node_ptr->index;
+    // The master checks the connections with its own requests
+    if (!drv_obj->is_master) {
+        // The timer is not armed while the node is not connected
+        mb_timer_node_init(&node_ptr->alive_timer, mb_drv_alive_timer_cb, drv_obj);
+        mb_timer_wheel_arm(drv_obj->timer_wheel, &node_ptr->alive_timer,
+                            (uint64_t)node_ptr->recv_time + MB_KEEP_ALIVE_TIME_US);
+    }
+    return true;
+}
+
+// Remove the node socket from the connection set, the caller holds the driver lock
+static bool mb_drv_conn_del_locked(port_driver_t *drv_obj, mb_node_info_t *node_ptr)
+{
+    if ((node_ptr->sock_id < 0) || !FD_ISSET(node_ptr->sock_id, &drv_obj->conn_set)) {
+        return false;
+    }
+    FD_CLR(node_ptr->sock_id, &drv_obj->conn_set);
+    mb_timer_wheel_disarm(drv_obj->timer_wheel, &node_ptr->alive_timer);
+    mb_drv_alive_del_locked(drv_obj, node_ptr->index);
+    // Swap the removed entry with the last one and update the maximum descriptor in one pass
+    int max_fd = UNDEF_FD;
+    int i = 0;
+    while (i < drv_obj->node_conn_count) {
+        if (drv_obj->conn_nodes[i] == node_ptr->index) {
+            drv_obj->conn_nodes[i] = drv_obj->conn_nodes[--drv_obj->node_conn_count];
+            continue;
+        }
+        mb_node_info_t *pnode = drv_obj->mb_nodes[drv_obj->conn_nodes[i]];
+        if (pnode && (pnode->sock_id > max_fd)) {
+            max_fd = pnode->sock_id;
+        }
+        i++;
+    }
+    drv_obj->conn_max_fd = max_fd;
+    return true;
+}
+
+bool mb_drv_conn_add(void *ctx, mb_node_info_t *node_ptr)
+{
+    port_driver_t *drv_obj = MB_GET_DRV_PTR(ctx);
+    bool is_added = false;
+    if (!node_ptr) {
+        return false;
+    }
+    CRITICAL_SECTION(drv_obj->lock) {
+        is_added = mb_drv_conn_add_locked(drv_obj, node_ptr);
+    }
+    return is_added;
+}
+
+bool mb_drv_conn_del(void *ctx, mb_node_info_t *node_ptr)
+{
+    port_driver_t *drv_obj = MB_GET_DRV_PTR(ctx);
+    bool is_removed = false;
+    if (!node_ptr) {
+        return false;
+    }
+    CRITICAL_SECTION(drv_obj->lock) {
+        is_removed = mb_drv_conn_del_locked(drv_obj, node_ptr);
+    }
+    return is_removed;
+}
+
 int mb_drv_close(void *ctx, int fd)
 {
     port_driver_t *drv_obj = MB_GET_DRV_PTR(ctx);
@@ -419,19 +531,15 @@ int mb_drv_close(void *ctx, int fd)
     // stop socket
     if (MB_GET_NODE_STATE(node_ptr) != MB_SOCK_STATE_CLOSED) {
         // Do we need to close connection, if the close event is not run
-        if ((node_ptr->sock_id > 0) && (FD_ISSET(node_ptr->sock_id, &drv_obj->conn_set)))
-        {
-            FD_CLR(node_ptr->sock_id, &drv_obj->conn_set);
-            if (drv_obj->node_conn_count)
-            {
-                drv_obj->node_conn_count--;
-            }
-        }
+        (void)mb_drv_conn_del_locked(drv_obj, node_ptr);
         port_close_connection(node_ptr);
     }
     MB_SET_NODE_STATE(node_ptr, MB_SOCK_STATE_CLOSED);
     FD_CLR(fd, &drv_obj->open_set);
+    mb_timer_wheel_disarm(drv_obj->timer_wheel, &node_ptr->alive_timer);
+    mb_drv_alive_del_locked(drv_obj, fd);
     delete_queues(node_ptr);
+    port_reset_rx_buffer(node_ptr);
     if (drv_obj->mb_node_open_count) {
         drv_obj->mb_node_open_count--;
     }
@@ -468,6 +576,26 @@ mb_node_info_t *mb_drv_get_next_node_from_set(void *ctx, int *fd_ptr, fd_set *fd
     return NULL;
 }
 
+mb_node_info_t *mb_drv_get_next_ready_node(void *ctx, int *pos_ptr, fd_set *fdset)
+{
+    port_driver_t *drv_obj = MB_GET_DRV_PTR(ctx);
+    if (!fdset || !pos_ptr) {
+        return NULL;
+    }
+    mb_node_info_t *node_ptr = NULL;
+    // Only the connected nodes are checked, so the cost does not depend on the MB_MAX_FDS
+    for (int pos = *pos_ptr; pos < drv_obj->node_conn_count; pos++) {
+        node_ptr = drv_obj->mb_nodes[drv_obj->conn_nodes[pos]];
+        if (node_ptr && (node_ptr->sock_id > 0)
+            && (MB_GET_NODE_STATE(node_ptr) >= MB_SOCK_STATE_CONNECTED)
+            && FD_ISSET(node_ptr->sock_id, fdset)) {
+            *pos_ptr = pos;
+            return node_ptr;
+        }
+    }
+    return NULL;
+}
+
 mb_node_info_t *mb_drv_get_node_info_from_addr(void *ctx, uint8_t uid)
 {
     port_driver_t *drv_obj = MB_GET_DRV_PTR(ctx);
@@ -483,17 +611,13 @@ mb_node_info_t *mb_drv_get_node_info_from_addr(void *ctx, uint8_t uid)
 
 static int mb_drv_register_fds(void *ctx, fd_set *fdset)
 {
-    mb_node_info_t *node_ptr = NULL;
     port_driver_t *drv_obj = MB_GET_DRV_PTR(ctx);
-    // Setup select waiting for eventfd && socket events
-    FD_ZERO(fdset);
     int max_fd = UNDEF_FD;
-    // Add to the set all connected slaves
-    for (int i = 0; i < MB_MAX_FDS; i++) {
-        node_ptr = drv_obj->mb_nodes[i];
-        if (node_ptr && node_ptr->sock_id && (MB_GET_NODE_STATE(node_ptr) >= MB_SOCK_STATE_CONNECTED)) {
-            MB_ADD_FD(node_ptr->sock_id, max_fd, fdset);
-        }
+    // The connection set is kept up to date when the nodes are connected or closed,
+    // so just take its copy instead of the check of each node
+    CRITICAL_SECTION(drv_obj->lock) {
+        *fdset = drv_obj->conn_set;
+        max_fd = drv_obj->conn_max_fd;
     }
     // Add event fd events to the set to handle them in one select
     MB_ADD_FD(drv_obj->event_fd, max_fd, fdset);
@@ -601,10 +725,25 @@ void mb_drv_tcp_task(void *ctx)
     ESP_LOGD(TAG, "Start of driver task.");
     while (1) {
         fd_set readset, errorset;
+        int alive_nodes[MB_MAX_FDS];
         FD_ZERO(&readset);
         FD_ZERO(&errorset);
+        // Expire the timers and wait for the events not longer than the next expiration
+        mb_drv_lock(ctx);
+        (void)mb_timer_wheel_advance(drv_obj->timer_wheel, esp_timer_get_time());
+        uint32_t wait_ms = mb_timer_wheel_next_ms(drv_obj->timer_wheel, esp_timer_get_time(), MB_SELECT_WAIT_MS);
+        // Only the expired nodes are taken, the posting of event can block so it is done without the lock
+        int alive_count = drv_obj->alive_count;
+        if (alive_count) {
+            memcpy(alive_nodes, drv_obj->alive_nodes, alive_count * sizeof(int));
+            drv_obj->alive_count = 0;
+        }
+        mb_drv_unlock(ctx);
+        for (int i = 0; i < alive_count; i++) {
+            DRIVER_SEND_EVENT(ctx, MB_EVENT_TIMEOUT, alive_nodes[i]);
+        }
         // check all active socket and fd events
-        int ret = mb_drv_wait_fd_events(ctx, &readset, &errorset, MB_SELECT_WAIT_MS);
+        int ret = mb_drv_wait_fd_events(ctx, &readset, &errorset, wait_ms);
         if (ret == ERR_TIMEOUT) {
             // timeout occured waiting for the vfds
             DRIVER_SEND_EVENT(ctx, MB_EVENT_TIMEOUT, UNDEF_FD);
@@ -655,43 +794,49 @@ void mb_drv_tcp_task(void *ctx)
             } else {
                 // socket event is ready, process each socket event
                 mb_drv_check_suspend_shutdown(ctx);
-                int curr_fd = 0;
                 mb_node_info_t *node_ptr = NULL;
                 ESP_LOGD(TAG, "%p, socket event active: %" PRIx64, ctx, *(uint64_t *)&readset);
-                while(((node_ptr = mb_drv_get_next_node_from_set(ctx, &curr_fd, &readset))
-                           && (curr_fd < MB_MAX_FDS))) {
-                    if (FD_ISSET(node_ptr->sock_id, &drv_obj->conn_set)) {
-                        // The data is ready in the socket, read frame and queue
-                        FD_CLR(node_ptr->sock_id, &readset);
-                        int ret = port_read_packet(node_ptr);
-                        if (ret > 0) {
-                            ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", frame received."), ctx, (int)node_ptr->fd,
-                                        (int)node_ptr->sock_id, node_ptr->addr_info.ip_addr_str);
-                            mb_drv_lock(ctx);
-                            node_ptr->recv_time = esp_timer_get_time();
-                            mb_drv_unlock(ctx);
+                // Check only the connected nodes and stop when all ready sockets are handled
+                int ready_cnt = ret;
+                int curr_pos = 0;
+                while ((ready_cnt > 0) && (node_ptr = mb_drv_get_next_ready_node(ctx, &curr_pos, &readset))) {
+                    ready_cnt--;
+                    // The data is ready in the socket, read frame and queue
+                    FD_CLR(node_ptr->sock_id, &readset);
+                    int ret = port_read_packet(node_ptr);
+                    if (ret > 0) {
+                        ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", %d frame(s) received."), ctx, (int)node_ptr->fd,
+                                    (int)node_ptr->sock_id, node_ptr->addr_info.ip_addr_str, ret);
+                        mb_drv_lock(ctx);
+                        node_ptr->recv_time = esp_timer_get_time();
+                        mb_drv_unlock(ctx);
+                        // Each event handles one frame from the queue
+                        for (int i = 0; i < ret; i++) {
                             DRIVER_SEND_EVENT(ctx, MB_EVENT_RECV_DATA, node_ptr->index);
-                        } else if (ret == ERR_TIMEOUT) {
-                            ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", frame read timeout or closed connection."), ctx, (int)node_ptr->fd,
-                                        (int)node_ptr->sock_id, node_ptr->addr_info.ip_addr_str);
-                        } else if (ret == ERR_BUF) {
-                            // After retries a response with incorrect TID received, process failure.
-                            drv_obj->event_cbs.mb_sync_event_cb(drv_obj->event_cbs.port_arg, MB_SYNC_EVENT_RECV_FAIL);
-                            ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", frame error."), ctx, (int)node_ptr->fd,
+                        }
+                    } else if (ret == ERR_INPROGRESS) {
+                        ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", frame is received partially."), ctx, (int)node_ptr->fd,
+                                    (int)node_ptr->sock_id, node_ptr->addr_info.ip_addr_str);
+                    } else if (ret == ERR_TIMEOUT) {
+                        ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", frame read timeout or closed connection."), ctx, (int)node_ptr->fd,
+                                    (int)node_ptr->sock_id, node_ptr->addr_info.ip_addr_str);
+                    } else if (ret == ERR_BUF) {
+                        // After retries a response with incorrect TID received, process failure.
+                        drv_obj->event_cbs.mb_sync_event_cb(drv_obj->event_cbs.port_arg, MB_SYNC_EVENT_RECV_FAIL);
+                        ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", frame error."), ctx, (int)node_ptr->fd,
+                                    (int)node_ptr->sock_id, node_ptr->addr_info.ip_addr_str);
+                    } else {
+                        if (ret == ERR_CONN) {
+                            ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", connection lost."), ctx, (int)node_ptr->fd,
                                         (int)node_ptr->sock_id, node_ptr->addr_info.ip_addr_str);
+                            DRIVER_SEND_EVENT(ctx, MB_EVENT_ERROR, node_ptr->index);
                         } else {
-                            if (ret == ERR_CONN) {
-                                ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", connection lost."), ctx, (int)node_ptr->fd,
-                                            (int)node_ptr->sock_id, node_ptr->addr_info.ip_addr_str);
-                                DRIVER_SEND_EVENT(ctx, MB_EVENT_ERROR, node_ptr->index);
-                            } else {
-                                ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", critical read error=%d, errno=%u."), ctx, (int)node_ptr->fd,
-                                        (int)node_ptr->sock_id, node_ptr->addr_info.ip_addr_str, (int)ret, (unsigned)errno);
-                                DRIVER_SEND_EVENT(ctx, MB_EVENT_ERROR, node_ptr->index);
-                            }
+                            ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", critical read error=%d, errno=%u."), ctx, (int)node_ptr->fd,
+                                    (int)node_ptr->sock_id, node_ptr->addr_info.ip_addr_str, (int)ret, (unsigned)errno);
+                            DRIVER_SEND_EVENT(ctx, MB_EVENT_ERROR, node_ptr->index);
                         }
                     }
-                    curr_fd++;
+                    curr_pos++;
                     mb_drv_check_suspend_shutdown(ctx);
                 }
             }
@@ -718,6 +863,14 @@ esp_err_t mb_drv_register(port_driver_t **ctx)
     for (i = 0; i < MB_MAX_FDS; i++) {
         pctx->mb_nodes[i] = NULL;
     }
+    pctx->conn_nodes = calloc(MB_MAX_FDS, sizeof(int));
+    MB_GOTO_ON_FALSE((pctx->conn_nodes), ESP_ERR_NO_MEM, error, TAG, "%p, node index allocation fail.", pctx);
+    pctx->timer_wheel = calloc(1, sizeof(mb_timer_wheel_t));
+    MB_GOTO_ON_FALSE((pctx->timer_wheel), ESP_ERR_NO_MEM, error, TAG, "%p, timer wheel allocation fail.", pctx);
+    mb_timer_wheel_init(pctx->timer_wheel, esp_timer_get_time());
+    pctx->alive_nodes = calloc(MB_MAX_FDS, sizeof(int));
+    MB_GOTO_ON_FALSE((pctx->alive_nodes), ESP_ERR_NO_MEM, error, TAG, "%p, node index allocation fail.", pctx);
+    pctx->alive_count = 0;
     // initialization of event handlers
     for (i = 0; i < MB_EVENT_COUNT; i++) {
         pctx->event_handler[i] = NULL;
@@ -775,6 +928,9 @@ error:
             pctx->close_done_sema = NULL;
         }
         free(pctx->mb_nodes);
+        free(pctx->conn_nodes);
+        free(pctx->alive_nodes);
+        free(pctx->timer_wheel);
     }
     free(pctx);
     return ret;
@@ -823,6 +979,13 @@ esp_err_t mb_drv_unregister(void *ctx)
 
     free(drv_obj->mb_nodes); // free the node info address array
     drv_obj->mb_nodes = NULL;
+    free(drv_obj->conn_nodes);
+    drv_obj->conn_nodes = NULL;
+    free(drv_obj->alive_nodes);
+    drv_obj->alive_nodes = NULL;
+    drv_obj->alive_count = 0;
+    free(drv_obj->timer_wheel); // all timers are disarmed when the nodes are closed
+    drv_obj->timer_wheel = NULL;
 
     vEventGroupDelete(drv_obj->status_flags_hdl);
 
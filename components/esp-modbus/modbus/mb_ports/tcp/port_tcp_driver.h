@@ -23,6 +23,7 @@
 
 #include "port_tcp_utils.h"
 #include "mb_port_types.h"
+#include "mb_timer_wheel.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -49,6 +50,7 @@ typedef void (*mb_event_handler_fp)(void *ctx, esp_event_base_t base, int32_t id
 #define MB_EVENT_QUEUE_SZ           (CONFIG_FMB_QUEUE_LENGTH * MB_TCP_PORT_MAX_CONN)
 
 #define MB_DROP_TRANSACTION_TIME_US    (1000UL * (CONFIG_FMB_TCP_KEEP_ALIVE_TOUT_SEC * 2000UL)) // drop after twice keep alive timeout is reasonable
+#define MB_KEEP_ALIVE_TIME_US          (1000ULL * MB_TCP_KEEP_ALIVE_TOUT_MS)
 
 #define MB_WAIT_DONE_MS             (5000)
 #define MB_SELECT_WAIT_MS           (200)
@@ -69,7 +71,12 @@ typedef void (*mb_event_handler_fp)(void *ctx, esp_event_base_t base, int32_t id
     .mb_node_curr = NULL,                       \
     .close_done_sema = NULL,                    \
     .node_conn_count = 0,                       \
+    .conn_nodes = NULL,                         \
+    .conn_max_fd = UNDEF_FD,                    \
     .event_fd = UNDEF_FD,                       \
+    .timer_wheel = NULL,                        \
+    .alive_nodes = NULL,                        \
+    .alive_count = 0,                           \
 }
 
 #define MB_EVENTFD_CONFIG() (esp_vfs_eventfd_config_t) {    \
@@ -97,7 +104,7 @@ typedef struct _port_driver port_driver_t;
 ))
 
 #define MB_ADD_FD(fd, max_fd, fdset) do {       \
-    if (fd) {                                   \
+    if ((fd) > 0) {                             \
         (max_fd = (fd > max_fd) ? fd : max_fd); \
         FD_SET(fd, fdset);                      \
     }                                           \
@@ -192,7 +199,12 @@ typedef struct mb_node_info_s {
     uint16_t tid_counter;               /*!< transaction identifier (TID) for slave */
     uint16_t send_counter;              /*!< number of packets sent to slave during one session */
     uint16_t recv_counter;              /*!< number of packets received from slave during one session */
+    uint32_t recv_copy_bytes;           /*!< number of received frame bytes copied on the way to the handler */
+    uint64_t recv_time_us;              /*!< time spent to read and queue the received frames */
+    uint8_t *rx_buf;                    /*!< frame buffer being reassembled from the socket stream */
+    uint16_t rx_len;                    /*!< number of bytes received into the rx_buf */
     bool is_blocking;                   /*!< slave blocking bit state saved */
+    mb_timer_node_t alive_timer;        /*!< keep alive check timer of the connection */
 } mb_node_info_t;
 
 typedef enum _mb_sync_event {
@@ -243,8 +255,13 @@ typedef struct _port_driver {
     mb_node_info_t *mb_node_curr;               /*!< current slave information */
     uint16_t curr_node_index;                   /*!< current processing slave index */
     fd_set open_set;                            /*!< file descriptor set for opened nodes */
-    fd_set conn_set;                            /*!< file descriptor set for associated nodes */
+    fd_set conn_set;                            /*!< file descriptor set for associated nodes (select interest set) */
+    int *conn_nodes;                            /*!< indexes of associated nodes, node_conn_count entries are valid */
+    int conn_max_fd;                            /*!< maximum socket descriptor in the conn_set */
     int event_fd;                               /*!< eventfd descriptor for modbus event tracking */
+    mb_timer_wheel_t *timer_wheel;              /*!< timer wheel of the driver task, used under the driver lock */
+    int *alive_nodes;                           /*!< indexes of nodes to check the connection state, set by the keep alive timers */
+    uint16_t alive_count;                       /*!< number of nodes to check, alive_count entries are valid */
     SemaphoreHandle_t close_done_sema;          /*!< close and done semaphore */
     EventGroupHandle_t status_flags_hdl;        /*!< status bits to control nodes states */
     TaskHandle_t mb_tcp_task_handle;            /*!< TCP/UDP handling task handle */
@@ -340,6 +357,44 @@ void mb_drv_unlock(void *ctx);
 
 mb_node_info_t *mb_drv_get_next_node_from_set(void *ctx, int *fd_ptr, fd_set *fdset);
 
+/**
+ * @brief Get next connected node which socket is ready in the set
+ *
+ * @param ctx - pointer to driver interface structure
+ * @param pos_ptr - pointer to the position in the list of connected nodes to start from, updated with the position of found node
+ * @param fdset - the set of ready socket descriptors returned by select
+ * @return mb_node_info_t
+ *          - Address of node info structure on success
+ *          - NULL, if no more ready nodes
+ */
+mb_node_info_t *mb_drv_get_next_ready_node(void *ctx, int *pos_ptr, fd_set *fdset);
+
+/**
+ * @brief Add the socket of connected node into the interest set of the driver
+ *
+ * The set is updated incrementally, so the driver task does not rebuild it before each select.
+ * The slave arms the keep alive timer of the node, the timer sends the MB_EVENT_TIMEOUT
+ * with the node index when the node does not receive data during the keep alive timeout.
+ *
+ * @param ctx - pointer to driver interface structure
+ * @param node_ptr - pointer to the node information structure with valid socket
+ * @return
+ *          - true, if the node is added or already connected
+ *          - false, if the socket is not valid or the maximum connection count is reached
+ */
+bool mb_drv_conn_add(void *ctx, mb_node_info_t *node_ptr);
+
+/**
+ * @brief Remove the socket of the node from the interest set of the driver
+ *
+ * @param ctx - pointer to driver interface structure
+ * @param node_ptr - pointer to the node information structure
+ * @return
+ *          - true, if the node was connected and is removed from the set
+ *          - false, if the node is not in the set
+ */
+bool mb_drv_conn_del(void *ctx, mb_node_info_t *node_ptr);
+
 mb_status_flags_t mb_drv_set_status_flag(void *ctx, mb_status_flags_t mask);
 
 mb_status_flags_t mb_drv_clear_status_flag(void *ctx, mb_status_flags_t mask);
@@ -5,6 +5,7 @@
  */ 
 #include <stdbool.h>
 #include <string.h>
+#include <sys/queue.h>
 
 #include "port_tcp_common.h"
 #include "port_tcp_driver.h"
@@ -20,6 +21,18 @@ typedef struct
     mb_tcp_opts_t tcp_opts;
     uint8_t ptemp_buf[MB_TCP_BUFF_MAX_SIZE];
     port_driver_t *drv_obj;
+    // The transaction of the master object (one at a time)
+    uint16_t trans_tid;
+    int trans_node;
+    // The in-flight window and the list of pending requests for each node
+    SemaphoreHandle_t window_sema[MB_TCP_PORT_MAX_CONN];
+    LIST_HEAD(mbm_pending_head, mbm_tcp_pending_s) pending_list[MB_TCP_PORT_MAX_CONN];
+#if MB_STATS_ENABLED
+    mb_stats_t stats;
+#endif
+#if MB_RTO_ENABLED
+    mb_rto_t rto;
+#endif
 } mbm_tcp_port_t;
 
 /* ----------------------- Static variables & functions ----------------------*/
@@ -99,6 +112,115 @@ static esp_err_t mbm_port_tcp_unregister_handlers(void *ctx)
     return ESP_OK;
 }
 
+static void mbm_port_tcp_delete_windows(mbm_tcp_port_t *port_obj)
+{
+    for (int fd = 0; fd < MB_TCP_PORT_MAX_CONN; fd++) {
+        if (port_obj->window_sema[fd]) {
+            vSemaphoreDelete(port_obj->window_sema[fd]);
+            port_obj->window_sema[fd] = NULL;
+        }
+    }
+}
+
+// Allocates the TID for the next request to the node, the driver lock must be held by caller
+static uint16_t mbm_port_tcp_alloc_tid(mb_node_info_t *info_ptr)
+{
+    uint16_t tid = info_ptr->tid_counter;
+    if (info_ptr->tid_counter < (USHRT_MAX - 1)) {
+        info_ptr->tid_counter++;
+    } else {
+        info_ptr->tid_counter = (uint16_t)(info_ptr->index << 8U);
+    }
+    return tid;
+}
+
+// Passes the response to the request pending with the same TID, returns false if there is no such request
+static bool mbm_port_tcp_complete_pending(mbm_tcp_port_t *port_obj, mb_node_info_t *node_ptr, uint8_t *frame, size_t len)
+{
+    uint16_t tid = MB_TCP_MBAP_GET_FIELD(frame, MB_TCP_TID);
+    mbm_tcp_pending_t *pending = NULL;
+    bool is_found = false;
+    mb_drv_lock(port_obj->drv_obj);
+    LIST_FOREACH(pending, &port_obj->pending_list[node_ptr->index], entries) {
+        if (pending->tid == tid) {
+            LIST_REMOVE(pending, entries);
+            pending->is_active = false;
+            if (len <= pending->size) {
+                memcpy(pending->frame, frame, len);
+                pending->length = len;
+                pending->status = MB_ENOERR;
+            } else {
+                pending->status = MB_ERECVDATA;
+            }
+            node_ptr->recv_time = esp_timer_get_time();
+            pending->latency_us = (uint32_t)(node_ptr->recv_time - pending->send_time_us);
+            // The waiting task can not release the request while the lock is held
+            (void)xSemaphoreGive(pending->done);
+            is_found = true;
+            break;
+        }
+    }
+    mb_drv_unlock(port_obj->drv_obj);
+    return is_found;
+}
+
+// Counts the finished request in the port statistics, the lengths are the lengths of PDU
+static void mbm_port_tcp_update_stats(mbm_tcp_port_t *port_obj, mbm_tcp_pending_t *pending)
+{
+    uint16_t req_len = pending->req_length - MB_TCP_FUNC;
+    switch (pending->status) {
+        case MB_ENOERR:
+            mb_stats_record(port_obj->base.stats_obj, pending->uid, pending->func,
+                            (pending->frame[MB_TCP_FUNC] & MB_FUNC_ERROR) ? MB_STATS_RESULT_EXCEPTION : MB_STATS_RESULT_OK,
+                            (pending->length > MB_TCP_FUNC) ? (pending->length - MB_TCP_FUNC) : 0,
+                            req_len, pending->latency_us);
+            break;
+        case MB_ERECVDATA:
+            mb_stats_record(port_obj->base.stats_obj, pending->uid, pending->func,
+                            MB_STATS_RESULT_FRAME_ERROR, 0, req_len, 0);
+            break;
+        default:
+            mb_stats_record(port_obj->base.stats_obj, pending->uid, pending->func,
+                            MB_STATS_RESULT_TIMEOUT, 0, req_len, 0);
+            break;
+    }
+}
+
+// Updates the response timeout of the node, the closed connection does not change it
+static void mbm_port_tcp_update_rto(mbm_tcp_port_t *port_obj, mbm_tcp_pending_t *pending)
+{
+    switch (pending->status) {
+        case MB_ENOERR:
+            mb_rto_response(port_obj->base.rto_obj, pending->uid, MB_RTO_RESULT_RESPONSE,
+                            pending->latency_us, 0, esp_timer_get_time());
+            break;
+        case MB_ERECVDATA:
+            mb_rto_response(port_obj->base.rto_obj, pending->uid, MB_RTO_RESULT_FRAME_ERROR,
+                            0, 0, esp_timer_get_time());
+            break;
+        case MB_ETIMEDOUT:
+            mb_rto_response(port_obj->base.rto_obj, pending->uid, MB_RTO_RESULT_TIMEOUT,
+                            0, 0, esp_timer_get_time());
+            break;
+        default:
+            break;
+    }
+}
+
+// Fails all requests pending for the node, used when its connection is closed
+static void mbm_port_tcp_cancel_pending(mbm_tcp_port_t *port_obj, int fd)
+{
+    mbm_tcp_pending_t *pending = NULL;
+    mb_drv_lock(port_obj->drv_obj);
+    while ((pending = LIST_FIRST(&port_obj->pending_list[fd]))) {
+        LIST_REMOVE(pending, entries);
+        pending->is_active = false;
+        pending->status = MB_ENOCONN;
+        (void)xSemaphoreGive(pending->done);
+    }
+    mb_drv_unlock(port_obj->drv_obj);
+}
+
 mb_err_enum_t mbm_port_tcp_create(mb_tcp_opts_t *tcp_opts, mb_port_base_t **port_obj)
 {
     MB_RETURN_ON_FALSE((port_obj && tcp_opts), MB_EINVAL, TAG, "mb tcp port invalid arguments.");
@@ -109,8 +231,20 @@ mb_err_enum_t mbm_port_tcp_create(mb_tcp_opts_t *tcp_opts, mb_port_base_t **port
     ptcp = (mbm_tcp_port_t*)calloc(1, sizeof(mbm_tcp_port_t));
     MB_GOTO_ON_FALSE(ptcp, MB_EILLSTATE, error, TAG, "mb tcp port creation error.");
     ptcp->drv_obj = NULL;
+    ptcp->trans_node = UNDEF_FD;
+    for (int fd = 0; fd < MB_TCP_PORT_MAX_CONN; fd++) {
+        LIST_INIT(&ptcp->pending_list[fd]);
+    }
     CRITICAL_SECTION_INIT(ptcp->base.lock);
     ptcp->base.descr = (*port_obj)->descr;
+#if MB_STATS_ENABLED
+    ptcp->base.stats_obj = &ptcp->stats;
+#endif
+#if MB_RTO_ENABLED
+    // The wire time of the TCP frames is not counted
+    mb_rto_init(&ptcp->rto, 0, 0);
+    ptcp->base.rto_obj = &ptcp->rto;
+#endif
 
     err = mb_drv_register(&ptcp->drv_obj);
     MB_GOTO_ON_FALSE(((err == ESP_OK) && ptcp->drv_obj), MB_EILLSTATE, error, 
@@ -153,6 +287,9 @@ mb_err_enum_t mbm_port_tcp_create(mb_tcp_opts_t *tcp_opts, mb_port_base_t **port
             } else {
                 ESP_LOGD(TAG, "%p, open slave: %d, %s:%d", 
                                     ptcp->drv_obj, fd, slave_address_info.ip_addr_str, slave_address_info.port);
+                ptcp->window_sema[fd] = xSemaphoreCreateCounting(MB_TCP_MASTER_INFLIGHT_MAX, MB_TCP_MASTER_INFLIGHT_MAX);
+                MB_GOTO_ON_FALSE((ptcp->window_sema[fd]), MB_EILLSTATE, error,
+                                    TAG, "mb tcp port window creation failed.");
             }
         } else {
             ESP_LOGE(TAG, "%p, unable to open slave: %s, check configuration.", ptcp->drv_obj, (char *)*paddr_table);
@@ -180,6 +317,9 @@ error:
         CRITICAL_SECTION_CLOSE(ptcp->base.lock);
         // if the MDNS resolving is enabled, then free it
     }
+    if (ptcp) {
+        mbm_port_tcp_delete_windows(ptcp);
+    }
     free(ptcp);
     return ret;
 }
@@ -197,6 +337,7 @@ void mbm_port_tcp_delete(mb_port_base_t *inst)
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "driver unregister fail, returns (0x%d).", (uint16_t)err);
     }
+    mbm_port_tcp_delete_windows(port_obj);
     CRITICAL_SECTION_CLOSE(inst->lock);
     free(port_obj);
 }
@@ -228,12 +369,12 @@ bool mbm_port_tcp_recv_data(mb_port_base_t *inst, uint8_t **frame, uint16_t *len
     size_t sz = mb_drv_read(port_obj->drv_obj, info_ptr->fd, port_obj->ptemp_buf, MB_BUFFER_SIZE);
     if (sz > MB_TCP_FUNC) {
         uint16_t tid_counter = MB_TCP_MBAP_GET_FIELD(port_obj->ptemp_buf, MB_TCP_TID);
-        if (tid_counter == (info_ptr->tid_counter - 1)) {
+        if (tid_counter == port_obj->trans_tid) {
             *frame = port_obj->ptemp_buf;
             *length = sz;
             ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", get packet TID: 0x%04" PRIx16 ":0x%04" PRIx16 ", %p."),
                             port_obj->drv_obj, info_ptr->index, info_ptr->sock_id, info_ptr->addr_info.ip_addr_str, 
-                            (unsigned)tid_counter, (unsigned)info_ptr->tid_counter, *frame);
+                            (unsigned)tid_counter, (unsigned)port_obj->trans_tid, *frame);
             uint64_t time = 0;
             time = port_get_timestamp() - info_ptr->send_time;
             ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", processing time[us] = %ju."), port_obj->drv_obj, info_ptr->index,
@@ -242,7 +383,7 @@ bool mbm_port_tcp_recv_data(mb_port_base_t *inst, uint8_t **frame, uint16_t *len
         } else {
             ESP_LOGE(TAG, "%p, "MB_NODE_FMT(", drop packet TID: 0x%04" PRIx16 ":0x%04" PRIx16 ", %p."),
                             port_obj->drv_obj, info_ptr->index, info_ptr->sock_id,
-                            info_ptr->addr_info.ip_addr_str, (unsigned)tid_counter, (unsigned)info_ptr->tid_counter, *frame);
+                            info_ptr->addr_info.ip_addr_str, (unsigned)tid_counter, (unsigned)port_obj->trans_tid, *frame);
         }
     }
     return status;
@@ -263,7 +404,11 @@ bool mbm_port_tcp_send_data(mb_port_base_t *inst, uint8_t address, uint8_t *fram
 
     if (info_ptr && frame) {
         // Apply TID field to the frame before send
-        MB_TCP_MBAP_SET_FIELD(frame, MB_TCP_TID, info_ptr->tid_counter);
+        mb_drv_lock(port_obj->drv_obj);
+        port_obj->trans_tid = mbm_port_tcp_alloc_tid(info_ptr);
+        port_obj->trans_node = info_ptr->index;
+        mb_drv_unlock(port_obj->drv_obj);
+        MB_TCP_MBAP_SET_FIELD(frame, MB_TCP_TID, port_obj->trans_tid);
         frame[MB_TCP_UID] = (uint8_t)(info_ptr->addr_info.uid);
     }
 
@@ -282,6 +427,130 @@ bool mbm_port_tcp_send_data(mb_port_base_t *inst, uint8_t address, uint8_t *fram
     return frame_sent;
 }
 
+mb_err_enum_t mbm_port_tcp_transfer_start(mb_port_base_t *inst, uint8_t address, uint8_t *frame, uint16_t length,
+                                            uint16_t size, mbm_tcp_pending_t *pending, uint32_t wait_ms)
+{
+    mbm_tcp_port_t *port_obj = __containerof(inst, mbm_tcp_port_t, base);
+    MB_RETURN_ON_FALSE((frame && pending && (length > MB_TCP_FUNC) && (length <= size)),
+                        MB_EINVAL, TAG, "incorrect transfer arguments.");
+
+    mb_node_info_t *info_ptr = mb_drv_get_node_info_from_addr(port_obj->drv_obj, address);
+    MB_RETURN_ON_FALSE((info_ptr && MB_CHECK_FD_RANGE(info_ptr->index) && port_obj->window_sema[info_ptr->index]),
+                        MB_EINVAL, TAG, "The node UID #%d, is not configured.", address);
+    // The connected node is polled independently of the state of other nodes
+    if (wait_ms && (MB_GET_NODE_STATE(info_ptr) < MB_SOCK_STATE_CONNECTED)) {
+        (void)mb_drv_wait_status_flag(port_obj->drv_obj, MB_FLAG_CONNECTED, pdMS_TO_TICKS(MB_RECONNECT_TIME_MS));
+    }
+    MB_RETURN_ON_FALSE((MB_GET_NODE_STATE(info_ptr) >= MB_SOCK_STATE_CONNECTED),
+                        MB_ENOCONN, TAG, "The node UID #%d, is not connected.", address);
+
+    // The node which did not respond several times is not polled until its quarantine is over
+    uint32_t rto_ms = 0;
+    if (!mb_rto_request(inst->rto_obj, address, mb_port_timer_get_response_time_ms(inst),
+                            esp_timer_get_time(), &rto_ms)) {
+        ESP_LOGD(TAG, "%p, node UID #%d, is quarantined.", port_obj->drv_obj, address);
+        return MB_ETIMEDOUT;
+    }
+
+    // Wait for the free place in the in-flight window of the node
+    int fd = info_ptr->index;
+    if (xSemaphoreTake(port_obj->window_sema[fd], pdMS_TO_TICKS(wait_ms)) != pdTRUE) {
+        ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", in-flight window is full."),
+                    port_obj->drv_obj, fd, (int)info_ptr->sock_id, info_ptr->addr_info.ip_addr_str);
+        return MB_EBUSY;
+    }
+
+    // The request is owned by the caller until mbm_port_tcp_transfer_wait() returns
+    pending->fd = fd;
+    pending->is_active = true;
+    pending->is_sent = false;
+    pending->frame = frame;
+    pending->size = size;
+    pending->length = 0;
+    pending->req_length = length;
+    pending->uid = address;
+    pending->func = frame[MB_TCP_FUNC];
+    pending->latency_us = 0;
+    pending->status = MB_ETIMEDOUT;
+    pending->done = xSemaphoreCreateBinaryStatic(&pending->done_buf);
+
+    mb_drv_lock(port_obj->drv_obj);
+    // The slave serves the requests in turn, so the learned timeout is used only if no other
+    // request to the node is in flight, the queued request waits with the response timeout of the port
+    pending->rto_ms = (inst->rto_obj && LIST_EMPTY(&port_obj->pending_list[fd])) ? rto_ms : 0;
+    pending->tid = mbm_port_tcp_alloc_tid(info_ptr);
+    LIST_INSERT_HEAD(&port_obj->pending_list[fd], pending, entries);
+    mb_drv_unlock(port_obj->drv_obj);
+
+    MB_TCP_MBAP_SET_FIELD(frame, MB_TCP_TID, pending->tid);
+    MB_TCP_MBAP_SET_FIELD(frame, MB_TCP_PID, MB_TCP_PROTOCOL_ID);
+    MB_TCP_MBAP_SET_FIELD(frame, MB_TCP_LEN, (length - MB_TCP_UID));
+    frame[MB_TCP_UID] = (uint8_t)(info_ptr->addr_info.uid);
+
+    ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", send request TID: 0x%04" PRIx16 ", len: %u."),
+                port_obj->drv_obj, fd, (int)info_ptr->sock_id, info_ptr->addr_info.ip_addr_str,
+                pending->tid, (unsigned)length);
+
+    // The frame is copied to the send queue, so its buffer can receive the response
+    pending->send_tick = xTaskGetTickCount();
+    pending->send_time_us = esp_timer_get_time();
+    pending->is_sent = (mb_drv_write(port_obj->drv_obj, fd, frame, length) > 0);
+    return MB_ENOERR;
+}
+
+mb_err_enum_t mbm_port_tcp_transfer_wait(mb_port_base_t *inst, mbm_tcp_pending_t *pending,
+                                            uint16_t *rsp_len, uint32_t tout_ms)
+{
+    mbm_tcp_port_t *port_obj = __containerof(inst, mbm_tcp_port_t, base);
+    MB_RETURN_ON_FALSE((pending && pending->done && rsp_len), MB_EINVAL, TAG, "incorrect transfer arguments.");
+
+    if (pending->is_sent) {
+        // The timeout is counted from the moment the request is sent
+        TickType_t elapsed = xTaskGetTickCount() - pending->send_tick;
+        TickType_t timeout = pdMS_TO_TICKS((pending->rto_ms && (pending->rto_ms < tout_ms)) ? pending->rto_ms : tout_ms);
+        (void)xSemaphoreTake(pending->done, (elapsed < timeout) ? (timeout - elapsed) : 0);
+    }
+
+    mb_drv_lock(port_obj->drv_obj);
+    if (pending->is_active) {
+        // Expired or not sent, the late response will be dropped
+        LIST_REMOVE(pending, entries);
+        pending->is_active = false;
+        pending->status = pending->is_sent ? MB_ETIMEDOUT : MB_EIO;
+    }
+    mb_drv_unlock(port_obj->drv_obj);
+
+    vSemaphoreDelete(pending->done);
+    pending->done = NULL;
+    (void)xSemaphoreGive(port_obj->window_sema[pending->fd]);
+
+    if (pending->is_sent) {
+        mbm_port_tcp_update_stats(port_obj, pending);
+        mbm_port_tcp_update_rto(port_obj, pending);
+    }
+
+    if (pending->status == MB_ENOERR) {
+        *rsp_len = pending->length;
+    } else {
+        ESP_LOGD(TAG, "%p, node #%d, request TID: 0x%04" PRIx16 " failed, err = %d.",
+                    port_obj->drv_obj, pending->fd, pending->tid, (int)pending->status);
+    }
+    return pending->status;
+}
+
+mb_err_enum_t mbm_port_tcp_transfer(mb_port_base_t *inst, uint8_t address, uint8_t *frame,
+                                    uint16_t length, uint16_t *rsp_len, uint32_t tout_ms)
+{
+    mbm_tcp_pending_t pending;
+    MB_RETURN_ON_FALSE((rsp_len), MB_EINVAL, TAG, "incorrect transfer arguments.");
+    mb_err_enum_t status = mbm_port_tcp_transfer_start(inst, address, frame, length, *rsp_len,
+                                                        &pending, MB_TCP_MASTER_WINDOW_TOUT_MS);
+    if (status == MB_ENOERR) {
+        status = mbm_port_tcp_transfer_wait(inst, &pending, rsp_len, tout_ms);
+    }
+    return status;
+}
+
 void mbm_port_tcp_set_conn_cb(mb_port_base_t *inst, void *conn_fp, void *arg)
 {
     mbm_tcp_port_t *port_obj = __containerof(inst, mbm_tcp_port_t, base);
@@ -440,9 +709,8 @@ MB_EVENT_HANDLER(mbm_on_connect)
             err = port_connect(ctx, node_ptr);
             switch (err) {
                 case ERR_OK:
-                    FD_SET(node_ptr->sock_id, &drv_obj->conn_set);
+                    (void)mb_drv_conn_add(drv_obj, node_ptr);
                     mb_drv_lock(ctx);
-                    drv_obj->node_conn_count++;
                     // Update time stamp for connected slaves
                     node_ptr->send_time = esp_timer_get_time();
                     node_ptr->recv_time = esp_timer_get_time();
@@ -464,16 +732,10 @@ MB_EVENT_HANDLER(mbm_on_connect)
                     }
                     break;
                 case ERR_INPROGRESS:
-                    if (FD_ISSET(node_ptr->sock_id, &drv_obj->conn_set)) {
-                        FD_CLR(node_ptr->sock_id, &drv_obj->conn_set);
+                    if (mb_drv_conn_del(drv_obj, node_ptr)) {
                         ESP_LOGD(TAG, "%p, slave: #%d, sock:%d, IP:%s, connect fail error = %d.",
                                 ctx, (int)event_info->opt_fd, (int)node_ptr->sock_id,
                                 node_ptr->addr_info.ip_addr_str, (int)err);
-                        mb_drv_lock(ctx);
-                        if (drv_obj->node_conn_count) {
-                            drv_obj->node_conn_count--;
-                        }
-                        mb_drv_unlock(ctx);
                         DRIVER_SEND_EVENT(ctx, MB_EVENT_CLOSE, event_info->opt_fd);
                         port_close_connection(node_ptr);
                     } else {
@@ -533,13 +795,9 @@ MB_EVENT_HANDLER(mbm_on_error)
             ESP_LOGW(TAG, "%p, "MB_NODE_FMT(", error handling."), ctx, (int)node_ptr->fd,
                                             (int)node_ptr->sock_id, node_ptr->addr_info.ip_addr_str);
             ESP_LOGE(TAG, "Node: %d, try to repair lost connection, err= %d", (int)event_info->opt_fd, ret);
-            FD_CLR(node_ptr->sock_id, &drv_obj->conn_set);
-            mb_drv_lock(ctx);
-            if (drv_obj->node_conn_count) {
-                drv_obj->node_conn_count--;
-            }
-            mb_drv_unlock(ctx);
+            (void)mb_drv_conn_del(drv_obj, node_ptr);
             port_close_connection(node_ptr);
+            mbm_port_tcp_cancel_pending((mbm_tcp_port_t *)drv_obj->parent, node_ptr->index);
             DRIVER_SEND_EVENT(ctx, MB_EVENT_RESOLVE, node_ptr->index);
         }
     } else if (event_info->opt_fd < 0) {
@@ -583,15 +841,9 @@ MB_EVENT_HANDLER(mbm_on_send_data)
             info_ptr->error = ret;
         } else {
             ESP_LOGD(TAG, "%p, "MB_NODE_FMT(", send data successful: TID:0x%04x, %d (bytes), errno %d"),
-                        ctx, (int)info_ptr->index, (int)info_ptr->sock_id, 
-                        info_ptr->addr_info.ip_addr_str, (unsigned)info_ptr->tid_counter, (int)ret, (unsigned)errno);
+                        ctx, (int)info_ptr->index, (int)info_ptr->sock_id, info_ptr->addr_info.ip_addr_str,
+                        (unsigned)MB_TCP_MBAP_GET_FIELD(tx_buffer, MB_TCP_TID), (int)ret, (unsigned)errno);
             info_ptr->error = 0;
-            // Every successful write increase TID counter
-            if (info_ptr->tid_counter < (USHRT_MAX - 1)) {
-                info_ptr->tid_counter++;
-            } else {
-                info_ptr->tid_counter = (uint16_t)(info_ptr->index << 8U);
-            }
         }
         mb_drv_lock(ctx);
         drv_obj->mb_node_curr = info_ptr;
@@ -607,9 +859,9 @@ MB_EVENT_HANDLER(mbm_on_send_data)
 MB_EVENT_HANDLER(mbm_on_recv_data)
 {
     port_driver_t *drv_obj = MB_GET_DRV_PTR(ctx);
+    mbm_tcp_port_t *port_obj = (mbm_tcp_port_t *)drv_obj->parent;
     mb_event_info_t *event_info = (mb_event_info_t *)data;
     ESP_LOGD(TAG, "%s  %s: fd: %d", (char *)base, __func__, (int)event_info->opt_fd);
-    size_t sz = 0;
     uint8_t buf[MB_TCP_BUFF_MAX_SIZE] = {0};
     mb_drv_check_suspend_shutdown(ctx);
     // Get frame from queue, check for correctness, push back correct frame and generate receive condition.
@@ -618,20 +870,28 @@ MB_EVENT_HANDLER(mbm_on_recv_data)
     if (node_ptr) {
         ESP_LOGD(TAG, "%p, slave #%d(%d) [%s], receive data ready.", ctx, (int)event_info->opt_fd,
                     (int)node_ptr->sock_id, node_ptr->addr_info.ip_addr_str);
-        while ((sz <= 0) && !queue_is_empty(node_ptr->rx_queue)) {
+        while (!queue_is_empty(node_ptr->rx_queue)) {
             size_t sz = queue_pop(node_ptr->rx_queue, buf, MB_TCP_BUFF_MAX_SIZE, NULL);
             if ((sz > MB_TCP_FUNC) && (sz < sizeof(buf))) {
                 uint16_t tid = MB_TCP_MBAP_GET_FIELD(buf, MB_TCP_TID);
                 ESP_LOGD(TAG, "%p, packet TID: 0x%04" PRIx16 " received.", ctx, tid);
-                if (tid == (node_ptr->tid_counter - 1)) {
-                    queue_push(node_ptr->rx_queue, buf, sz, NULL);
-                    mb_drv_lock(ctx);
+                // The responses to pipelined requests are matched by TID in any order
+                if (mbm_port_tcp_complete_pending(port_obj, node_ptr, buf, sz)) {
+                    break;
+                }
+                mb_drv_lock(ctx);
+                bool is_trans = ((node_ptr->index == port_obj->trans_node) && (tid == port_obj->trans_tid));
+                if (is_trans) {
                     node_ptr->recv_time = esp_timer_get_time();
-                    mb_drv_unlock(ctx);
+                }
+                mb_drv_unlock(ctx);
+                if (is_trans) {
+                    queue_push(node_ptr->rx_queue, buf, sz, NULL);
                     // send receive event to modbus object
                     drv_obj->event_cbs.mb_sync_event_cb(drv_obj->event_cbs.port_arg, MB_SYNC_EVENT_RECV_OK);
                     break;
                 }
+                ESP_LOGD(TAG, "%p, drop packet TID: 0x%04" PRIx16 ", no request is pending.", ctx, tid);
             }
             mb_drv_check_suspend_shutdown(ctx);
         }
@@ -652,10 +912,10 @@ MB_EVENT_HANDLER(mbm_on_close)
             mb_node_info_t *pnode = mb_drv_get_node(drv_obj, fd);
             if (pnode && (MB_GET_NODE_STATE(pnode) >= MB_SOCK_STATE_OPENED)
                     && FD_ISSET(pnode->index, &drv_obj->open_set)) {
-                // Close node immediately
-                mb_drv_close(drv_obj, fd);
-                MB_SET_NODE_STATE(pnode, MB_SOCK_STATE_READY);
                 ESP_LOGD(TAG, "%p, Close node %d, sock #%d.", ctx, fd, pnode->sock_id);
+                // Close node immediately, the node is released by the driver
+                mb_drv_close(drv_obj, fd);
+                mbm_port_tcp_cancel_pending((mbm_tcp_port_t *)drv_obj->parent, fd);
             }
         }
         (void)mb_drv_set_status_flag(drv_obj, MB_FLAG_DISCONNECTED);
@@ -667,6 +927,7 @@ MB_EVENT_HANDLER(mbm_on_close)
             if ((pnode->sock_id < 0) && FD_ISSET(pnode->sock_id, &drv_obj->open_set)) {
                 mb_drv_close(drv_obj, event_info->opt_fd);
             }
+            mbm_port_tcp_cancel_pending((mbm_tcp_port_t *)drv_obj->parent, event_info->opt_fd);
         }
         mb_drv_check_suspend_shutdown(ctx);
     }
@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: 2021-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "esp_event.h"          // for esp event loop
+#include <sys/queue.h>              // for list
+
+#include "mb_common.h"
+#include "mb_frame.h"
+
+#include "port_tcp_driver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (CONFIG_FMB_COMM_MODE_TCP_EN)
+
+typedef enum mb_sock_state_enum mb_sock_state_t;
+typedef struct uid_info_s mb_uid_info_t;
+
+/**
+ * @brief The request of the TCP master which waits for the response with its TID
+ *
+ * The structure is filled by mbm_port_tcp_transfer_start() and must not be changed or released
+ * by the caller until mbm_port_tcp_transfer_wait() returns.
+ */
+typedef struct mbm_tcp_pending_s
+{
+    uint16_t tid;                           /*!< The transaction identifier of the request */
+    int fd;                                 /*!< The index of the node */
+    bool is_active;                         /*!< The request is waiting for the response */
+    bool is_sent;                           /*!< The request is placed into the send queue */
+    uint8_t *frame;                         /*!< The request frame buffer, receives the response */
+    uint16_t size;                          /*!< The size of the frame buffer */
+    uint16_t length;                        /*!< The length of the response frame */
+    uint16_t req_length;                    /*!< The length of the request frame */
+    uint8_t uid;                            /*!< The unit identifier of the request */
+    uint8_t func;                           /*!< The function code of the request */
+    mb_err_enum_t status;                   /*!< The result of the request */
+    TickType_t send_tick;                   /*!< The tick count when the request is sent */
+    int64_t send_time_us;                   /*!< The time when the request is sent (uS) */
+    uint32_t latency_us;                    /*!< The time from the request to the response (uS) */
+    uint32_t rto_ms;                        /*!< The adaptive response timeout of the node, zero to use tout_ms */
+    SemaphoreHandle_t done;                 /*!< Given when the request is complete */
+    StaticSemaphore_t done_buf;             /*!< The storage of the done semaphore */
+    LIST_ENTRY(mbm_tcp_pending_s) entries;
+} mbm_tcp_pending_t;
+
+void mbm_port_tcp_set_conn_cb(mb_port_base_t *inst, void *conn_fp, void *arg);
+mb_uid_info_t *mbm_port_tcp_get_slave_info(mb_port_base_t *inst, uint8_t uid, mb_sock_state_t exp_state);
+
+/**
+ * @brief Sends the request to the node and waits for the response with the same TID
+ *
+ * Several tasks can call this function concurrently. Each node accepts up to
+ * MB_TCP_MASTER_INFLIGHT_MAX outstanding requests, the responses are matched by TID
+ * in any order and the response timeout is applied to each request separately.
+ *
+ * @param inst the port object of the TCP master
+ * @param address the UID of the node
+ * @param frame the buffer with MBAP header and request PDU, receives the response frame
+ * @param length the length of the request frame including MBAP header
+ * @param rsp_len the size of the frame buffer on input and the length of response on output
+ * @param tout_ms the response timeout in milliseconds
+ *
+ * @return MB_ENOERR if the response is received, MB_ETIMEDOUT, MB_EBUSY, MB_ENOCONN or MB_EIO otherwise
+ */
+mb_err_enum_t mbm_port_tcp_transfer(mb_port_base_t *inst, uint8_t address, uint8_t *frame,
+                                    uint16_t length, uint16_t *rsp_len, uint32_t tout_ms);
+
+/**
+ * @brief Sends the request to the node without waiting for the response
+ *
+ * This allows to keep the requests to several nodes in flight at the same time.
+ * Every successfully started request must be completed with mbm_port_tcp_transfer_wait().
+ *
+ * @param inst the port object of the TCP master
+ * @param address the UID of the node
+ * @param frame the buffer with MBAP header and request PDU, receives the response frame
+ * @param length the length of the request frame including MBAP header
+ * @param size the size of the frame buffer
+ * @param pending the request object owned by the caller
+ * @param wait_ms the time to wait for the connection and for the free place in the in-flight window,
+ *        zero to fail immediately if the node is not connected or its window is full
+ *
+ * @return MB_ENOERR if the request is started, MB_ETIMEDOUT if the node is quarantined,
+ *         MB_EBUSY, MB_ENOCONN or MB_EINVAL otherwise
+ */
+mb_err_enum_t mbm_port_tcp_transfer_start(mb_port_base_t *inst, uint8_t address, uint8_t *frame, uint16_t length,
+                                            uint16_t size, mbm_tcp_pending_t *pending, uint32_t wait_ms);
+
+/**
+ * @brief Waits for the response to the request started with mbm_port_tcp_transfer_start()
+ *
+ * @param inst the port object of the TCP master
+ * @param pending the started request
+ * @param rsp_len returns the length of response frame
+ * @param tout_ms the response timeout in milliseconds counted from the moment the request is sent,
+ *        the shorter adaptive timeout of the node is used if it is enabled and no other request
+ *        to the node was in flight when the request is started
+ *
+ * @return MB_ENOERR if the response is received, MB_ETIMEDOUT, MB_ENOCONN or MB_EIO otherwise
+ */
+mb_err_enum_t mbm_port_tcp_transfer_wait(mb_port_base_t *inst, mbm_tcp_pending_t *pending,
+                                            uint16_t *rsp_len, uint32_t tout_ms);
+
+MB_EVENT_HANDLER(mbm_on_ready);
+MB_EVENT_HANDLER(mbm_on_open);
+MB_EVENT_HANDLER(mbm_on_resolve);
+MB_EVENT_HANDLER(mbm_on_connect);
+MB_EVENT_HANDLER(mbm_on_send_data);
+MB_EVENT_HANDLER(mbm_on_recv_data);
+MB_EVENT_HANDLER(mbm_on_error);
+MB_EVENT_HANDLER(mbm_on_close);
+MB_EVENT_HANDLER(mbm_on_timeout);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -18,6 +18,15 @@
 
 #if (CONFIG_FMB_COMM_MODE_TCP_EN)
 
+// The statistics of the client connection
+typedef struct
+{
+    uint32_t request_count;
+    uint32_t reject_count;
+    uint64_t latency_sum_us;
+    uint32_t latency_max_us;
+} mbs_tcp_client_info_t;
+
 typedef struct
 {
     mb_port_base_t base;
@@ -29,13 +38,52 @@ typedef struct
     port_driver_t *drv_obj;
     transaction_handle_t transaction;
     uint16_t trans_count;
+    // The node of the last started transaction, the queued requests are served in round-robin order of nodes
+    int last_node_id;
+    // The unit identifier of the request taken by the slave
+    uint8_t active_uid;
+    mbs_tcp_client_info_t clients[MB_MAX_FDS];
+#if MB_STATS_ENABLED
+    mb_stats_t stats;
+#endif
 } mbs_tcp_port_t;
 
+// The visitor of the queued requests with its argument
+typedef struct
+{
+    mbs_port_tcp_visitor_fp visitor;
+    void *arg;
+} mbs_tcp_visit_t;
+
 /* ----------------------- Static variables & functions ----------------------*/
 static const char *TAG = "mb_port.tcp.slave";
 
 static uint64_t mbs_port_tcp_sync_event(void *inst, mb_sync_event_t sync_event);
 
+// Returns the transaction which is processed by the slave, only one transaction is processed at a time
+static transaction_item_handle_t mbs_port_tcp_get_active(mbs_tcp_port_t *port_obj)
+{
+    const pending_state_t active_states[] = {ACKNOWLEDGED, CONFIRMED, REPLIED};
+    transaction_item_handle_t item = NULL;
+    for (int i = 0; !item && (i < (sizeof(active_states) / sizeof(active_states[0]))); i++) {
+        item = transaction_dequeue(port_obj->transaction, active_states[i], NULL);
+    }
+    return item;
+}
+
+// Replies the slave device busy exception to the request which does not fit the client queue
+static void mbs_port_tcp_reject(mbs_tcp_port_t *port_obj, mb_node_info_t *pnode, uint8_t *frame)
+{
+    MB_TCP_MBAP_SET_FIELD(frame, MB_TCP_LEN, 3); // UID, function code and exception code
+    frame[MB_TCP_FUNC] |= MB_FUNC_ERROR;
+    frame[MB_TCP_FUNC + 1] = MB_EX_SLAVE_BUSY;
+    if (port_write_poll(pnode, frame, (MB_TCP_FUNC + 2), MB_TCP_SEND_TIMEOUT_MS) < 0) {
+        ESP_LOGE(TAG, "%p, " MB_NODE_FMT(", send busy exception failure."),
+                    port_obj, pnode->index, pnode->sock_id, pnode->addr_info.ip_addr_str);
+    }
+    port_obj->clients[pnode->index].reject_count++;
+}
+
 static esp_err_t mbs_port_tcp_register_handlers(void *ctx)
 {
     port_driver_t *drv_obj = MB_GET_DRV_PTR(ctx);
@@ -111,7 +159,11 @@ mb_err_enum_t mbs_port_tcp_create(mb_tcp_opts_t *tcp_opts, mb_port_base_t **port
 
     // Copy object descriptor from parent object (is used for logging)
     ptcp->base.descr = (*port_obj)->descr;
+#if MB_STATS_ENABLED
+    ptcp->base.stats_obj = &ptcp->stats;
+#endif
     ptcp->drv_obj = NULL;
+    ptcp->last_node_id = UNDEF_FD;
     ptcp->transaction = transaction_init();
     MB_GOTO_ON_FALSE((ptcp->transaction), MB_EILLSTATE, error,
                      TAG, "mb transaction init failed.");
@@ -134,6 +186,8 @@ mb_err_enum_t mbs_port_tcp_create(mb_tcp_opts_t *tcp_opts, mb_port_base_t **port
     ptcp->drv_obj->is_master = false;
     ptcp->drv_obj->event_cbs.mb_sync_event_cb = mbs_port_tcp_sync_event;
     ptcp->drv_obj->event_cbs.port_arg = (void *)ptcp;
+    // The driver task deletes the expired transactions when it advances the timer wheel
+    transaction_set_timer_wheel(ptcp->transaction, ptcp->drv_obj->timer_wheel, MB_DROP_TRANSACTION_TIME_US);
 
 #ifdef MB_MDNS_IS_INCLUDED
 err = port_start_mdns_service(&ptcp->drv_obj->dns_name, false, tcp_opts->uid, ptcp->drv_obj->network_iface_ptr);
@@ -172,6 +226,11 @@ void mbs_port_tcp_delete(mb_port_base_t *inst)
 {
     mbs_tcp_port_t *port_obj = __containerof(inst, mbs_tcp_port_t, base);
     if (port_obj && port_obj->transaction) {
+        if (port_obj->drv_obj) {
+            mb_drv_lock(port_obj->drv_obj);
+            transaction_set_timer_wheel(port_obj->transaction, NULL, 0);
+            mb_drv_unlock(port_obj->drv_obj);
+        }
         transaction_destroy(port_obj->transaction);
     }
     if (port_obj && port_obj->drv_obj) {
@@ -210,18 +269,24 @@ bool mbs_port_tcp_recv_data(mb_port_base_t *inst, uint8_t **frame, uint16_t *len
     bool status = false;
     transaction_item_handle_t item;
 
-    if (length && frame && *frame) {
+    if (length && frame) {
         mb_drv_lock(drv_obj);
-        item = transaction_get_first(port_obj->transaction);
-        if (item && (transaction_item_get_state(item) == ACKNOWLEDGED)) {
+        item = transaction_dequeue(port_obj->transaction, ACKNOWLEDGED, NULL);
+        if (item) {
             uint16_t tid = 0;
             int node_id = 0;
             size_t len = 0;
-            uint8_t *buf = transaction_item_get_data(item, &len, &tid, &node_id);
+            uint8_t *buf = NULL;
+            (void)transaction_item_get_data(item, &len, &tid, &node_id);
             pnode = mb_drv_get_node(drv_obj, node_id);
-            if (buf && pnode && (MB_GET_NODE_STATE(pnode) >= MB_SOCK_STATE_CONNECTED)) {
-                memcpy(*frame, buf, len);
+            if (pnode && (MB_GET_NODE_STATE(pnode) >= MB_SOCK_STATE_CONNECTED)) {
+                // Pass the frame buffer received from socket to the caller without copy
+                buf = transaction_item_take_data(item, &len);
+            }
+            if (buf) {
+                *frame = buf;
                 *length = (uint16_t)len;
+                port_obj->active_uid = buf[MB_TCP_UID];
                 status = true;
                 ESP_LOGD(TAG, "%p, " MB_NODE_FMT(", read packet, TID: 0x%04" PRIx16 ", %p."),
                          port_obj, pnode->index, pnode->sock_id,
@@ -230,12 +295,6 @@ bool mbs_port_tcp_recv_data(mb_port_base_t *inst, uint8_t **frame, uint16_t *len
                     ESP_LOGE(TAG, "transaction queue set state fail.");
                 }
             }
-        } else {
-            // Delete expired frames
-            int frame_cnt = transaction_delete_expired(port_obj->transaction, port_get_timestamp(), MB_DROP_TRANSACTION_TIME_US);
-            if (frame_cnt) {
-                ESP_LOGE(TAG, "Deleted %d expired frames.", frame_cnt);
-            }
         }
         mb_drv_unlock(drv_obj);
     }
@@ -254,14 +313,14 @@ bool mbs_port_tcp_send_data(mb_port_base_t *inst, uint8_t *frame, uint16_t lengt
     transaction_item_handle_t item;
 
     mb_drv_lock(drv_obj);
-    item = transaction_get_first(port_obj->transaction);
-    if (item && transaction_item_get_state(item) == CONFIRMED) {
+    item = transaction_dequeue(port_obj->transaction, CONFIRMED, NULL);
+    if (item) {
         uint16_t msg_id = 0;
         int node_id = 0;
         mb_node_info_t *pnode = NULL;
-        uint8_t *buf = transaction_item_get_data(item, NULL, &msg_id, &node_id);
+        (void)transaction_item_get_data(item, NULL, &msg_id, &node_id);
         pnode = mb_drv_get_node(drv_obj, node_id);
-        if (pnode && buf && (tid == msg_id)) {
+        if (pnode && (tid == msg_id)) {
             int write_length = mb_drv_write(drv_obj, node_id, frame, length);
             if (pnode && write_length) {
                 frame_sent = true;
@@ -295,6 +354,77 @@ bool mbs_port_tcp_send_data(mb_port_base_t *inst, uint8_t *frame, uint16_t lengt
     return frame_sent;
 }
 
+uint16_t mbs_port_tcp_get_client_stats(mb_port_base_t *inst, mb_tcp_client_stats_t *stats, uint16_t max_count)
+{
+    mbs_tcp_port_t *port_obj = __containerof(inst, mbs_tcp_port_t, base);
+    port_driver_t *drv_obj = port_obj->drv_obj;
+    uint16_t count = 0;
+
+    mb_drv_lock(drv_obj);
+    for (int fd = 0; (fd < MB_MAX_FDS) && (count < max_count); fd++) {
+        mb_node_info_t *pnode = mb_drv_get_node(drv_obj, fd);
+        if (!pnode || (MB_GET_NODE_STATE(pnode) < MB_SOCK_STATE_CONNECTED)) {
+            continue;
+        }
+        mbs_tcp_client_info_t *client = &port_obj->clients[fd];
+        mb_tcp_client_stats_t *client_stats = &stats[count++];
+        memset(client_stats, 0, sizeof(mb_tcp_client_stats_t));
+        client_stats->index = (uint16_t)fd;
+        if (pnode->addr_info.ip_addr_str) {
+            strncpy(client_stats->ip_addr_str, pnode->addr_info.ip_addr_str, (MB_CLIENT_ADDR_STR_MAX_LEN - 1));
+        }
+        client_stats->queue_depth = (uint16_t)transaction_get_node_count(port_obj->transaction, fd);
+        client_stats->request_count = client->request_count;
+        client_stats->reject_count = client->reject_count;
+        client_stats->latency_avg_us = client->request_count ? (uint32_t)(client->latency_sum_us / client->request_count) : 0;
+        client_stats->latency_max_us = client->latency_max_us;
+    }
+    mb_drv_unlock(drv_obj);
+    return count;
+}
+
+bool mbs_port_tcp_get_request_info(mb_port_base_t *inst, uint8_t *uid, uint64_t *tick)
+{
+    mbs_tcp_port_t *port_obj = __containerof(inst, mbs_tcp_port_t, base);
+    bool status = false;
+
+    mb_drv_lock(port_obj->drv_obj);
+    transaction_item_handle_t item = mbs_port_tcp_get_active(port_obj);
+    if (item) {
+        *uid = port_obj->active_uid;
+        *tick = transaction_item_get_tick(item);
+        status = true;
+    }
+    mb_drv_unlock(port_obj->drv_obj);
+    return status;
+}
+
+// Passes the MBAP fields and the PDU of the queued frame to the visitor
+static bool mbs_port_tcp_visit_item(transaction_item_handle_t item, void *arg)
+{
+    mbs_tcp_visit_t *visit = (mbs_tcp_visit_t *)arg;
+    size_t len = 0;
+    uint8_t *buf = transaction_item_get_data(item, &len, NULL, NULL);
+    if (!buf || (len <= MB_TCP_FUNC)) {
+        return true;
+    }
+    return visit->visitor(visit->arg, buf[MB_TCP_UID], transaction_item_get_tick(item),
+                            &buf[MB_TCP_FUNC], (uint16_t)(len - MB_TCP_FUNC));
+}
+
+uint16_t mbs_port_tcp_foreach_queued(mb_port_base_t *inst, mbs_port_tcp_visitor_fp visitor, void *arg)
+{
+    mbs_tcp_port_t *port_obj = __containerof(inst, mbs_tcp_port_t, base);
+    mbs_tcp_visit_t visit = {.visitor = visitor, .arg = arg};
+    uint16_t count = 0;
+
+    MB_RETURN_ON_FALSE(visitor, 0, TAG, "incorrect arguments.");
+    mb_drv_lock(port_obj->drv_obj);
+    count = (uint16_t)transaction_foreach(port_obj->transaction, QUEUED, mbs_port_tcp_visit_item, &visit);
+    mb_drv_unlock(port_obj->drv_obj);
+    return count;
+}
+
 static uint64_t mbs_port_tcp_sync_event(void *inst, mb_sync_event_t sync_event)
 {
     switch (sync_event)
@@ -390,13 +520,15 @@ MB_EVENT_HANDLER(mbs_on_connect)
         return;
     }
     (void)port_keep_alive_enable(pnode->sock_id, CONFIG_FMB_TCP_KEEP_ALIVE_TOUT_SEC);
-    mb_drv_lock(ctx);
+    mbs_tcp_port_t *port_obj = __containerof(drv_obj->parent, mbs_tcp_port_t, base);
+    mb_drv_lock(drv_obj);
+    memset(&port_obj->clients[pnode->index], 0, sizeof(mbs_tcp_client_info_t));
+    mb_drv_unlock(drv_obj);
     MB_SET_NODE_STATE(pnode, MB_SOCK_STATE_CONNECTED);
-    FD_SET(pnode->sock_id, &drv_obj->conn_set);
-    if (drv_obj->node_conn_count < MB_MAX_FDS) {
-        drv_obj->node_conn_count++;
+    if (!mb_drv_conn_add(drv_obj, pnode)) {
+        ESP_LOGE(TAG, "%p, "MB_NODE_FMT(", unable to add connection."), ctx, (int)pnode->fd,
+                    (int)pnode->sock_id, pnode->addr_info.ip_addr_str);
     }
-    mb_drv_unlock(ctx);
 }
 
 MB_EVENT_HANDLER(mbs_on_recv_data)
@@ -419,44 +551,76 @@ MB_EVENT_HANDLER(mbs_on_recv_data)
                          drv_obj, pnode->index, pnode->sock_id,
                          pnode->addr_info.ip_addr_str, (unsigned)tid_counter, frame_entry.buf, frame_entry.len);
                 mb_drv_lock(drv_obj);
-                transaction_message_t msg;
-                msg.buffer = frame_entry.buf;
-                msg.len = frame_entry.len;
-                msg.msg_id = frame_entry.tid;
-                msg.node_id = pnode->index;
-                msg.pnode = pnode;
-                // Enqueue the transaction, keep time of receiving.
-                item = transaction_enqueue(port_obj->transaction, &msg, port_get_timestamp());
-                pnode->tid_counter = tid_counter; // assign the TID from frame to use it on send
+                if (transaction_get_node_count(port_obj->transaction, pnode->index) < MB_TCP_SLAVE_CLIENT_QUEUE_MAX) {
+                    transaction_message_t msg;
+                    msg.buffer = frame_entry.buf;
+                    msg.len = frame_entry.len;
+                    msg.msg_id = frame_entry.tid;
+                    msg.node_id = pnode->index;
+                    msg.pnode = pnode;
+                    // Enqueue the transaction, keep time of receiving.
+                    item = transaction_enqueue(port_obj->transaction, &msg, port_get_timestamp());
+                } else {
+                    ESP_LOGW(TAG, "%p, " MB_NODE_FMT(", queue is full, reject packet TID: 0x%04" PRIx16 "."),
+                             drv_obj, pnode->index, pnode->sock_id,
+                             pnode->addr_info.ip_addr_str, (unsigned)tid_counter);
+                    mbs_port_tcp_reject(port_obj, pnode, frame_entry.buf);
+                    mb_port_frame_free(frame_entry.buf);
+                }
                 mb_drv_unlock(drv_obj);
+            } else {
+                mb_port_frame_free(frame_entry.buf);
             }
         }
-        item = transaction_get_first(port_obj->transaction);
+        mb_drv_lock(drv_obj);
+        item = mbs_port_tcp_get_active(port_obj);
+        if (!item) {
+            // Take the oldest request of the next client which has the queued requests
+            item = transaction_dequeue_next_node(port_obj->transaction, QUEUED, port_obj->last_node_id);
+        }
+        bool is_queued = (item && (transaction_item_get_state(item) == QUEUED));
+        transaction_tick_t item_tick = transaction_item_get_tick(item);
+        uint16_t item_msg_id = 0;
+        int item_node_id = UNDEF_FD;
+        if (is_queued) {
+            (void)transaction_item_get_data(item, NULL, &item_msg_id, &item_node_id);
+        }
+        mb_drv_unlock(drv_obj);
         if (item) {
-            if (transaction_item_get_state(item) == QUEUED) {
+            if (is_queued) {
                 // Check if the main FSM is not busy
                 if (mb_port_event_res_take(&port_obj->base, TRANSACTION_TICKS)) {
                     (void)mb_drv_clear_status_flag(drv_obj, MB_FLAG_TRANSACTION_READY);
                 } else {
-                    if (port_get_timestamp() - transaction_item_get_tick(item) > MB_DROP_TRANSACTION_TIME_US) {
-                        ESP_LOGD(TAG, "Transaction TID:0x%04" PRIx16 " is expired.", transaction_item_get_id(item));
+                    if (port_get_timestamp() - item_tick > MB_DROP_TRANSACTION_TIME_US) {
+                        ESP_LOGD(TAG, "Transaction TID:0x%04" PRIx16 " is expired.", item_msg_id);
                     } else {
                         // postpone the packet processing to next cycle
-                        DRIVER_SEND_EVENT(ctx, MB_EVENT_RECV_DATA, pnode->index);
+                        DRIVER_SEND_EVENT(ctx, MB_EVENT_RECV_DATA, item_node_id);
                     }
-                    mb_drv_lock(drv_obj);
-                    transaction_delete_expired(port_obj->transaction, port_get_timestamp(), MB_DROP_TRANSACTION_TIME_US);
-                    mb_drv_unlock(drv_obj);
                     mb_drv_check_suspend_shutdown(ctx);
                     return;
                 }
-                // send receive event to modbus object to get the new data
-                drv_obj->event_cbs.mb_sync_event_cb(drv_obj->event_cbs.port_arg, MB_SYNC_EVENT_RECV_OK);
                 mb_drv_lock(drv_obj);
+                // The handlers of the shared event loop run in several driver tasks, so the item
+                // could be started and removed by other handler while this one waited for the FSM
+                item = mbs_port_tcp_get_active(port_obj) ? NULL
+                        : transaction_dequeue_next_node(port_obj->transaction, QUEUED, port_obj->last_node_id);
+                if (!item) {
+                    mb_drv_unlock(drv_obj);
+                    mb_port_event_res_release(&port_obj->base);
+                    (void)mb_drv_set_status_flag(drv_obj, MB_FLAG_TRANSACTION_READY);
+                    mb_drv_check_suspend_shutdown(ctx);
+                    return;
+                }
                 uint16_t msg_id = 0;
                 int node_id = 0;
                 (void)transaction_item_get_data(item, NULL, &msg_id, &node_id);
                 pnode = mb_drv_get_node(drv_obj, node_id);
+                // The node can send several requests without waiting of responses,
+                // so assign the TID to use it on send when the transaction is started.
+                pnode->tid_counter = msg_id;
+                port_obj->last_node_id = node_id;
                 ESP_LOGD(TAG, "%p, " MB_NODE_FMT(", acknoledged packet TID: 0x%04" PRIx16 ", start transaction."),
                              drv_obj, pnode->index, pnode->sock_id,
                              pnode->addr_info.ip_addr_str, (unsigned)msg_id);
@@ -466,13 +630,9 @@ MB_EVENT_HANDLER(mbs_on_recv_data)
                              pnode->addr_info.ip_addr_str, (unsigned)msg_id);
                 }
                 mb_drv_unlock(drv_obj);
-            } else {
-                if (transaction_item_get_state(item) != TRANSMITTED) {
-                    // Transaction procesing is ongoing, just delete expired transactions
-                    mb_drv_lock(drv_obj);
-                    transaction_delete_expired(port_obj->transaction, port_get_timestamp(), MB_DROP_TRANSACTION_TIME_US);
-                    mb_drv_unlock(drv_obj);
-                }
+                // send receive event to modbus object to get the new data,
+                // the frame must be acknowledged before the object tries to get it
+                drv_obj->event_cbs.mb_sync_event_cb(drv_obj->event_cbs.port_arg, MB_SYNC_EVENT_RECV_OK);
             }
         } else {
             ESP_LOGD(TAG, "%p, no queued items found", ctx);
@@ -497,8 +657,10 @@ MB_EVENT_HANDLER(mbs_on_send_data)
         if (sz) {
             uint16_t tid = MB_TCP_MBAP_GET_FIELD(frame_entry.buf, MB_TCP_TID);
             // Try to find actual transaction for current TID,
-            // if not found just ignore the frame as expired
-            item = transaction_get_first(port_obj->transaction);
+            // if not found just ignore the frame as expired.
+            // The item is inspected under the lock, so it can not be deleted meanwhile
+            mb_drv_lock(drv_obj);
+            item = mbs_port_tcp_get_active(port_obj);
             if (item && pnode) {
                 uint16_t msg_id = 0;
                 int node_id = 0;
@@ -507,16 +669,16 @@ MB_EVENT_HANDLER(mbs_on_send_data)
                 // If not, means the slave was not able to process the previous transaction on time.
                 // The reason is too much active connections or incorrect response time or request rate in the master.
                 if ((node_id != pnode->index) || (tid != msg_id) || (tid != pnode->tid_counter) || (MB_GET_NODE_STATE(pnode) < MB_SOCK_STATE_CONNECTED)) {
-                    mb_drv_lock(drv_obj);
-                    err = transaction_delete(port_obj->transaction, tid);
+                    // Several clients can queue the same TID, so remove the active item itself
+                    uint64_t tick = (transaction_tick_t)transaction_item_get_tick(item);
+                    err = transaction_delete_item(port_obj->transaction, item);
                     mb_drv_unlock(drv_obj);
                     if (err != ESP_OK) {
-                        ESP_LOGE(TAG, "Failed to remove queued TID:0x%04" PRIx16, (int)tid);
+                        ESP_LOGE(TAG, "Failed to remove queued TID:0x%04" PRIx16, (int)msg_id);
                     } else {
-                        ESP_LOGD(TAG, "Remove the message TID:0x%04" PRIx16, (int)tid);
+                        ESP_LOGD(TAG, "Remove the message TID:0x%04" PRIx16, (int)msg_id);
                     }
                     (void)mb_drv_set_status_flag(drv_obj, MB_FLAG_TRANSACTION_READY);
-                    uint64_t tick = (transaction_tick_t)transaction_item_get_tick(item);
                     uint64_t time_div_us = (esp_timer_get_time() - tick);
                     ESP_LOGD(TAG, "%p, " MB_NODE_FMT(", frame TID:0x%04" PRIx16 "!=0x%04" PRIx16 ", slave is busy."),
                                 ctx, (int)pnode->index, (int)pnode->sock_id,
@@ -527,7 +689,12 @@ MB_EVENT_HANDLER(mbs_on_send_data)
                     // Hard hack to fix the expired frames (unsafe in some cases, do not implement)
                     // MB_TCP_MBAP_SET_FIELD(frame_entry.buf, MB_TCP_TID, pnode->tid_counter);
                 } else {
-                    mb_drv_lock(drv_obj);
+                    // Update the client statistics before the response is seen by the client
+                    mbs_tcp_client_info_t *client = &port_obj->clients[pnode->index];
+                    uint32_t latency = (uint32_t)(port_get_timestamp() - transaction_item_get_tick(item));
+                    client->request_count++;
+                    client->latency_sum_us += latency;
+                    client->latency_max_us = (latency > client->latency_max_us) ? latency : client->latency_max_us;
                     int ret = port_write_poll(pnode, frame_entry.buf, sz, MB_TCP_SEND_TIMEOUT_MS);
                     if (ret < 0) {
                         ESP_LOGE(TAG, "%p, " MB_NODE_FMT(", send data failure, err(errno) = %d(%u)."),
@@ -540,7 +707,7 @@ MB_EVENT_HANDLER(mbs_on_send_data)
                         ESP_LOG_BUFFER_HEX_LEVEL("SENT", frame_entry.buf, ret, ESP_LOG_DEBUG);
                     }
                     (void)mb_drv_set_status_flag(drv_obj, MB_FLAG_TRANSACTION_READY);
-                    err = transaction_set_state(port_obj->transaction, tid, TRANSMITTED);
+                    err = transaction_item_set_state(item, TRANSMITTED);
                     if (err == ESP_OK) {
                         ESP_LOGD(TAG, "%p, " MB_NODE_FMT(", sent packet TID: 0x%04" PRIx16 ", %p."),
                                     drv_obj, pnode->index, pnode->sock_id,
@@ -557,9 +724,19 @@ MB_EVENT_HANDLER(mbs_on_send_data)
                     }
                     pnode->send_time = port_get_timestamp();
                     pnode->send_counter = (pnode->send_counter < (USHRT_MAX - 1)) ? (pnode->send_counter + 1) : 0;
+                    // Start the next queued transaction, the requests may be received in one read
+                    item = transaction_dequeue_next_node(port_obj->transaction, QUEUED, port_obj->last_node_id);
+                    int node_id = UNDEF_FD;
+                    if (item) {
+                        (void)transaction_item_get_data(item, NULL, NULL, &node_id);
+                    }
                     mb_drv_unlock(drv_obj);
+                    if (node_id != UNDEF_FD) {
+                        DRIVER_SEND_EVENT(ctx, MB_EVENT_RECV_DATA, node_id);
+                    }
                 }
             } else {
+                mb_drv_unlock(drv_obj);
                 // It looks like no current registered transaction. It might be happen if the transaction has deleted as expired.
                 // Note: the transaction processing time is increased proportional to a number of connected Masters.
                 // If it is still needed to connect several number of Masters simultaneously,
@@ -573,7 +750,7 @@ MB_EVENT_HANDLER(mbs_on_send_data)
             ESP_LOGE(TAG, "%p, "MB_NODE_FMT(", frame is invalid, drop data."),
                         ctx, (int)pnode->index, (int)pnode->sock_id, pnode->addr_info.ip_addr_str);
         }
-        free(frame_entry.buf);
+        mb_port_frame_free(frame_entry.buf);
     }
     mb_drv_check_suspend_shutdown(ctx);
 }
@@ -642,28 +819,26 @@ MB_EVENT_HANDLER(mbs_on_close)
 
 MB_EVENT_HANDLER(mbs_on_timeout)
 {
-    // Slave timeout triggered
-    //mb_event_info_t *event_info = (mb_event_info_t *)data;
+    // The keep alive timer of the node is expired or the driver task is idle (UNDEF_FD)
+    mb_event_info_t *event_info = (mb_event_info_t *)data;
     port_driver_t *drv_obj = MB_GET_DRV_PTR(ctx);
     mbs_tcp_port_t *port_obj = __containerof(drv_obj->parent, mbs_tcp_port_t, base);
-    static int curr_fd = 0;
-    mb_node_info_t *pnode = mb_drv_get_node(drv_obj, curr_fd);
-    ESP_LOGD(TAG, "%s %s: fd: %d, count: %d", (char *)base, __func__, (int)curr_fd, drv_obj->node_conn_count);
+    int fd = event_info->opt_fd;
+    ESP_LOGD(TAG, "%s %s: fd: %d, count: %d", (char *)base, __func__, fd, drv_obj->node_conn_count);
     mb_drv_check_suspend_shutdown(ctx);
-    int ret = mb_drv_check_node_state(drv_obj, &curr_fd, MB_TCP_KEEP_ALIVE_TOUT_MS);
-    if ((ret != ERR_OK) && (ret != ERR_TIMEOUT)) {
+    if (!MB_CHECK_FD_RANGE(fd)) {
+        return;
+    }
+    int ret = mb_drv_check_node_state(drv_obj, &fd, MB_TCP_KEEP_ALIVE_TOUT_MS);
+    mb_node_info_t *pnode = mb_drv_get_node(drv_obj, fd);
+    if (pnode && (ret != ERR_OK) && (ret != ERR_TIMEOUT)) {
         ESP_LOGE(TAG, "%p, " MB_NODE_FMT(", connection lost, err=%d, drop connection."),
                         port_obj, pnode->index, pnode->sock_id,
                         pnode->addr_info.ip_addr_str, (int)ret);
         mb_drv_lock(drv_obj);
-        (void)transaction_delete_by_node_id(port_obj->transaction, curr_fd);
+        (void)transaction_delete_by_node_id(port_obj->transaction, fd);
         mb_drv_unlock(drv_obj);
-        mb_drv_close(drv_obj, curr_fd);
-    }
-    if ((curr_fd + 1) >= (drv_obj->node_conn_count)) {
-        curr_fd = 0;
-    } else {
-        curr_fd++;
+        mb_drv_close(drv_obj, fd);
     }
 }
 
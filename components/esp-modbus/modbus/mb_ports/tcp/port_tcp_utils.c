@@ -76,6 +76,7 @@ bool port_close_connection(mb_node_info_t *info_ptr)
 
     // Empty tcp buffer before shutdown
     (void)recv(info_ptr->sock_id, &tmp_buff[0], MB_PDU_SIZE_MAX, MSG_DONTWAIT);
+    port_reset_rx_buffer(info_ptr);
     queue_flush(info_ptr->rx_queue);
     queue_flush(info_ptr->tx_queue);
 
@@ -115,9 +116,9 @@ int port_enqueue_packet(QueueHandle_t queue, uint8_t *buf, uint16_t len)
         if (len != frame_info.len) {
             ESP_LOGE(TAG, "Packet TID (%x), length in frame %u != %u expected.", frame_info.tid, frame_info.len, len);
         }
-        assert(xPortGetFreeHeapSize() > frame_info.len);
-
-        ret = queue_push(queue, buf, frame_info.len, &frame_info);
+        // The queue takes the ownership of the frame buffer, no copy is performed
+        frame_info.buf = buf;
+        ret = queue_push(queue, NULL, 0, &frame_info);
         if (ret != ESP_OK) {
             ESP_LOGE(TAG, "Packet TID (%x), data enqueue failed.", frame_info.tid);
             // The packet send fail or the task which is waiting for event is already unblocked
@@ -150,110 +151,136 @@ int port_dequeue_packet(QueueHandle_t queue, frame_entry_t *frame_info_ptr)
     return ERR_BUF;
 }
 
-static int port_get_buf(mb_node_info_t *info_ptr, uint8_t *pdst_buf, uint16_t len, uint16_t read_tick_ms)
+// Extracts all complete frames from the receive buffer of the node and passes them to the receive queue.
+// The frames are parsed in place, the buffer which holds just one frame is passed to the queue as is,
+// otherwise each frame is copied to its own buffer and the tail of the next frame is moved to the start once.
+static int port_extract_frames(mb_node_info_t *info_ptr)
 {
-    int ret = 0;
-    uint8_t *buf = pdst_buf;
-    uint16_t bytes_left = len;
-    struct timeval time_val;
-
-    MB_RETURN_ON_FALSE((info_ptr && (info_ptr->sock_id > UNDEF_FD)), -1, TAG, "Try to read incorrect socket = #%d.", info_ptr->sock_id);
-
-    // Set receive timeout for socket <= slave respond time
-    time_val.tv_sec = read_tick_ms / 1000;
-    time_val.tv_usec = (read_tick_ms % 1000) * 1000;
-    setsockopt(info_ptr->sock_id, SOL_SOCKET, SO_RCVTIMEO, &time_val, sizeof(time_val));
-
-    // blocking read of data from socket
-    ret = recv(info_ptr->sock_id, buf, bytes_left, 0);
-    if (ret < 0) {
-        if (errno == EINPROGRESS || errno == EAGAIN || errno == EWOULDBLOCK) {
-            // Read timeout occurred, check the timeout and return
-            return 0;
+    int frame_cnt = 0;
+    int err = ERR_OK;
+    uint16_t offset = 0;
+
+    while (info_ptr->rx_buf && ((info_ptr->rx_len - offset) >= MB_TCP_UID)) {
+        uint8_t *frame_ptr = &info_ptr->rx_buf[offset];
+        uint16_t len = MB_TCP_MBAP_GET_FIELD(frame_ptr, MB_TCP_LEN);
+        if ((MB_TCP_MBAP_GET_FIELD(frame_ptr, MB_TCP_PID) != 0)
+                || (len < (MB_TCP_FUNC - MB_TCP_UID + 1)) || (len > (MB_TCP_BUFF_MAX_SIZE - MB_TCP_UID))) {
+            // The stream is out of sync, drop the received data
+            ESP_LOGD(TAG, "node #%d, socket(#%d)(%s), incorrect packet header, length: %u.",
+                        info_ptr->fd, info_ptr->sock_id, info_ptr->addr_info.ip_addr_str, (unsigned)len);
+            ESP_LOG_BUFFER_HEX_LEVEL(TAG, frame_ptr, MB_TCP_FUNC, ESP_LOG_DEBUG);
+            info_ptr->rx_len = 0;
+            info_ptr->recv_err = ERR_BUF;
+            return frame_cnt ? frame_cnt : ERR_BUF;
         }
-        if ((errno == ENOTCONN) || (errno == ECONNRESET)) {
-            ESP_LOGD(TAG, "socket(#%d)(%s) connection closed, ret=%d, errno=%d.", 
-                            info_ptr->sock_id, info_ptr->addr_info.ip_addr_str, ret, (int)errno);
-            // Socket connection closed
-            return ERR_CONN;
+        uint16_t frame_len = len + MB_TCP_UID;
+        if ((info_ptr->rx_len - offset) < frame_len) {
+            // Wait for the rest of the frame
+            break;
+        }
+        if (frame_ptr[MB_TCP_UID] > MB_ADDRESS_MAX) {
+            info_ptr->recv_err = ERR_BUF;
+            offset += frame_len;
+            continue;
+        }
+        uint8_t *buf = NULL;
+        if (!offset && (frame_len == info_ptr->rx_len)) {
+            buf = info_ptr->rx_buf;
+            info_ptr->rx_buf = NULL;
+            info_ptr->rx_len = 0;
+        } else {
+            buf = mb_port_frame_alloc(MB_TCP_BUFF_MAX_SIZE);
+            if (!buf) {
+                // The frame stays in the buffer until the next read
+                info_ptr->recv_err = ERR_MEM;
+                err = ERR_MEM;
+                break;
+            }
+            memcpy(buf, frame_ptr, frame_len);
+            offset += frame_len;
+        }
+        if (port_enqueue_packet(info_ptr->rx_queue, buf, frame_len) < 0) {
+            info_ptr->recv_err = ERR_BUF;
+            mb_port_frame_free(buf);
+            continue;
         }
-        // Other error occurred during receiving
-        ESP_LOGD(TAG, "Socket(#%d)(%s) receive error, ret = %d, errno = %d(%s)",
-                    info_ptr->sock_id, info_ptr->addr_info.ip_addr_str, ret, (int)errno, strerror(errno));
-        ret = -1;
-    } 
-    return ret;
+        info_ptr->recv_counter++;
+        frame_cnt++;
+    }
+    if (info_ptr->rx_buf && offset) {
+        info_ptr->rx_len -= offset;
+        memmove(info_ptr->rx_buf, &info_ptr->rx_buf[offset], info_ptr->rx_len);
+    }
+    return frame_cnt ? frame_cnt : err;
 }
 
+// Reads the available data from the socket without blocking and queues the completed frames.
+// The frame buffers are allocated from the frame pool, their ownership is passed to the receive queue.
+// The frame may be received partially and completed by the next read, one read may contain several frames.
 int port_read_packet(mb_node_info_t *info_ptr)
 {
-    uint16_t temp = 0;
     int ret = 0;
-    uint8_t ptemp_buf[MB_TCP_BUFF_MAX_SIZE] = {0};
+    int64_t start_time = esp_timer_get_time();
 
     // Receive data from connected client
     if (info_ptr) {
         MB_RETURN_ON_FALSE((info_ptr->sock_id > 0), -1, TAG, "try to read incorrect socket = #%d", info_ptr->sock_id);
-        // Read packet header
-        ret = port_get_buf(info_ptr, ptemp_buf, MB_TCP_UID, MB_READ_TICK);
-        if (ret < 0) {
-            info_ptr->recv_err = ret;
-            return ret;
-        } 
-        
-        if (ret != MB_TCP_UID) {
-            ESP_LOGD(TAG, "node #%d, Socket (#%d)(%s), fail to read modbus header, err=%d",
-                        info_ptr->fd, info_ptr->sock_id, info_ptr->addr_info.ip_addr_str, ret);
-            info_ptr->recv_err = ERR_VAL;
-            return ERR_VAL;
-        }
-
-        temp = MB_TCP_MBAP_GET_FIELD(ptemp_buf, MB_TCP_PID);
-        if (temp != 0) {
-            info_ptr->recv_err = ERR_BUF;
-            return ERR_BUF;
-        }
-
-        // If we have received the MBAP header we can analyze it and calculate
-        // the number of bytes left to complete the current response.
-        temp = MB_TCP_MBAP_GET_FIELD(ptemp_buf, MB_TCP_LEN);
-        if (temp > MB_TCP_BUFF_MAX_SIZE) {
-            ESP_LOGD(TAG, "Incorrect packet length: %d", temp);
-            ESP_LOG_BUFFER_HEX_LEVEL(TAG, ptemp_buf, MB_TCP_FUNC, ESP_LOG_DEBUG);
-            info_ptr->recv_err = ERR_BUF;
-            temp = MB_TCP_BUFF_MAX_SIZE; // read all remaining data from buffer
+        if (!info_ptr->rx_buf) {
+            info_ptr->rx_buf = mb_port_frame_alloc(MB_TCP_BUFF_MAX_SIZE);
+            info_ptr->rx_len = 0;
+            if (!info_ptr->rx_buf) {
+                info_ptr->recv_err = ERR_MEM;
+                return ERR_MEM;
+            }
         }
-
-        ret = port_get_buf(info_ptr, &ptemp_buf[MB_TCP_UID], temp, MB_READ_TICK);
+        ret = recv(info_ptr->sock_id, &info_ptr->rx_buf[info_ptr->rx_len],
+                    (MB_TCP_BUFF_MAX_SIZE - info_ptr->rx_len), MSG_DONTWAIT);
         if (ret < 0) {
-            info_ptr->recv_err = ret;
-            return ret;
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINPROGRESS)) {
+                // No data is available in the socket
+                return ERR_TIMEOUT;
+            }
+            if ((errno == ENOTCONN) || (errno == ECONNRESET)) {
+                ESP_LOGD(TAG, "socket(#%d)(%s) connection closed, ret=%d, errno=%d.", 
+                                info_ptr->sock_id, info_ptr->addr_info.ip_addr_str, ret, (int)errno);
+                info_ptr->recv_err = ERR_CONN;
+                return ERR_CONN;
+            }
+            // Other error occurred during receiving
+            ESP_LOGD(TAG, "Socket(#%d)(%s) receive error, ret = %d, errno = %d(%s)",
+                        info_ptr->sock_id, info_ptr->addr_info.ip_addr_str, ret, (int)errno, strerror(errno));
+            info_ptr->recv_err = -1;
+            return -1;
         }
-        
-        if (ret != temp) {
-            info_ptr->recv_err = ERR_VAL;
-            return ERR_VAL;
+        if (ret == 0) {
+            // The connection is closed by peer
+            info_ptr->recv_err = ERR_CONN;
+            return ERR_CONN;
         }
-
-        if (ptemp_buf[MB_TCP_UID] > MB_ADDRESS_MAX) {
-            info_ptr->recv_err = ERR_BUF;
-            return ERR_BUF;
+        info_ptr->rx_len += ret;
+        ret = port_extract_frames(info_ptr);
+        info_ptr->recv_time_us += (esp_timer_get_time() - start_time);
+        if (ret == 0) {
+            // The frame is incomplete, the rest is read when it is available
+            return ERR_INPROGRESS;
         }
-
-        ret = port_enqueue_packet(info_ptr->rx_queue, ptemp_buf, temp + MB_TCP_UID);
-        if (ret < 0) {
-            info_ptr->recv_err = ret;
-            return ret;
+        if (ret > 0) {
+            info_ptr->recv_err = ERR_OK;
         }
-
-        info_ptr->recv_counter++;
-
-        info_ptr->recv_err = ERR_OK;
-        return ret + MB_TCP_FUNC;
+        return ret;
     }
     return -1;
 }
 
+void port_reset_rx_buffer(mb_node_info_t *info_ptr)
+{
+    if (info_ptr) {
+        mb_port_frame_free(info_ptr->rx_buf);
+        info_ptr->rx_buf = NULL;
+        info_ptr->rx_len = 0;
+    }
+}
+
 err_t port_set_blocking(mb_node_info_t *info_ptr, bool is_blocking)
 {
     if (!info_ptr) {
@@ -0,0 +1,179 @@
+/*
+ * SPDX-FileCopyrightText: 2021-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "ascii_lrc.h"
+
+/* ----------------------- functions ---------------------------------*/
+uint8_t mb_char2bin(uint8_t char_val)
+{
+    uint8_t symb = 0xFF;
+    if ((char_val >= '0') && (char_val <= '9')) {
+        symb = (uint8_t)(char_val - '0');
+    } else if ((char_val >= 'A') && (char_val <= 'F')) {
+        symb = (uint8_t)(char_val - 'A' + 0x0A);
+    }
+    return symb;
+}
+
+uint8_t mb_bin2char(uint8_t byte_val)
+{
+    uint8_t symb = '0';
+    if (byte_val <= 0x09) {
+        symb = (uint8_t)('0' + byte_val);
+    } else if ((byte_val >= 0x0A) && (byte_val <= 0x0F)) {
+        symb = (uint8_t)(byte_val - 0x0A + 'A');
+    } else {
+        /* Programming error. */
+        assert(0);
+    }
+    return symb;
+}
+
+uint8_t __attribute__ ((unused)) mb_lrc(uint8_t *frame, uint16_t length)
+{
+    uint8_t lrc = 0; /* LRC char initialized */
+
+    while (length--) {
+        lrc += *frame++; /* Add buffer byte without carry */
+    }
+
+    /* Return twos complement */
+    lrc = (uint8_t)(-((char)lrc));
+    return lrc;
+}
+
+// The frame is converted by words of MB_ASCII_WORD_BYTES binary bytes (two characters per byte),
+// the lanes of the word are converted at once and the LRC is added in the same pass
+#if (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define MB_ASCII_WORD_BYTES     (4)
+#else
+#define MB_ASCII_WORD_BYTES     (0)
+#endif
+
+#define MB_ASCII_REP8(val)      ((uint64_t)(val) * 0x0101010101010101ULL)
+#define MB_ASCII_REP16(val)     ((uint64_t)(val) * 0x0001000100010001ULL)
+
+// Returns the sum of the bytes of the word modulo 256
+static inline uint8_t mb_ascii_word_sum(uint32_t word)
+{
+    word = (word & 0x00FF00FFUL) + ((word >> 8) & 0x00FF00FFUL);
+    return (uint8_t)(word + (word >> 16));
+}
+
+// Converts each nibble of the 8 lanes of the word to its character
+static inline uint64_t mb_ascii_nibbles_to_chars(uint64_t nibbles)
+{
+    // The lane 0x0A..0x0F gets the high bit after adding 0x76, the letters are shifted by 7 from the digits
+    uint64_t letters = ((nibbles + MB_ASCII_REP8(0x76)) & MB_ASCII_REP8(0x80)) >> 7;
+    return nibbles + MB_ASCII_REP8('0') + (letters * 7);
+}
+
+// Converts 8 characters to the nibbles, returns false if any of them is not the hex character
+static inline bool mb_ascii_chars_to_nibbles(uint64_t chars, uint64_t *nibbles)
+{
+    // The lanes are below 0x80, so adding the constant does not carry to the next lane
+    if (chars & MB_ASCII_REP8(0x80)) {
+        return false;
+    }
+    uint64_t digits = (chars + MB_ASCII_REP8(0x80 - '0')) & ~(chars + MB_ASCII_REP8(0x7F - '9'));
+    uint64_t letters = (chars + MB_ASCII_REP8(0x80 - 'A')) & ~(chars + MB_ASCII_REP8(0x7F - 'F'));
+    if (((digits | letters) & MB_ASCII_REP8(0x80)) != MB_ASCII_REP8(0x80)) {
+        return false;
+    }
+    *nibbles = (chars & MB_ASCII_REP8(0x0F)) + (((letters & MB_ASCII_REP8(0x80)) >> 7) * 9);
+    return true;
+}
+
+// The helper function to fill ASCII frame buffer
+int mb_ascii_set_buf(const uint8_t *data_ptr, uint8_t *buf, int bin_length)
+{
+    int bin_idx = 0;
+    int frm_idx = 1;
+    uint8_t lrc = 0;
+
+    assert(data_ptr && buf);
+
+    buf[0] = MB_ASCII_START;
+#if (MB_ASCII_WORD_BYTES)
+    for (; (bin_idx + MB_ASCII_WORD_BYTES) <= bin_length; bin_idx += MB_ASCII_WORD_BYTES) {
+        uint32_t word = 0;
+        memcpy(&word, &data_ptr[bin_idx], sizeof(word));
+        lrc += mb_ascii_word_sum(word);
+        // Spread the bytes to the 16 bit lanes, the high nibble goes to the first character
+        uint64_t bytes = word;
+        bytes = (bytes | (bytes << 16)) & 0x0000FFFF0000FFFFULL;
+        bytes = (bytes | (bytes << 8)) & MB_ASCII_REP16(0x00FF);
+        uint64_t nibbles = ((bytes >> 4) & MB_ASCII_REP16(0x000F)) | ((bytes & MB_ASCII_REP16(0x000F)) << 8);
+        uint64_t chars = mb_ascii_nibbles_to_chars(nibbles);
+        memcpy(&buf[frm_idx], &chars, sizeof(chars));
+        frm_idx += sizeof(chars);
+    }
+#endif
+    for (; (bin_idx < bin_length); bin_idx++) {
+        buf[frm_idx++] = mb_bin2char((uint8_t)(data_ptr[bin_idx] >> 4));   // High nibble
+        buf[frm_idx++] = mb_bin2char((uint8_t)(data_ptr[bin_idx] & 0X0F)); // Low nibble
+        lrc += data_ptr[bin_idx];
+    }
+    lrc = (uint8_t)(-((char)lrc));
+    buf[frm_idx++] = mb_bin2char((uint8_t)(lrc >> 4));
+    buf[frm_idx++] = mb_bin2char((uint8_t)(lrc & 0X0F));
+    buf[frm_idx++] = MB_ASCII_CR;
+    buf[frm_idx++] = MB_ASCII_LF;
+
+    return frm_idx;
+}
+
+// Converts the frame in place, the binary data is placed from the start of the buffer.
+// The frame with the character which is not the upper case hex digit is dropped.
+int mb_ascii_get_binary_buf(uint8_t *data_ptr, int length)
+{
+    int bin_idx = 0;
+    int str_idx = 1;
+    uint8_t lrc = 0;
+
+    assert(data_ptr);
+
+    if ((length < 3) || (data_ptr[0] != MB_ASCII_START)
+            || (data_ptr[length - 1] != MB_ASCII_LF) || (data_ptr[length - 2] != MB_ASCII_CR)
+            || ((length - 3) & 1)) {
+        return -1;
+    }
+    int str_end = length - 2;
+#if (MB_ASCII_WORD_BYTES)
+    for (; (str_idx + (MB_ASCII_WORD_BYTES * 2)) <= str_end; str_idx += (MB_ASCII_WORD_BYTES * 2)) {
+        uint64_t chars = 0;
+        uint64_t nibbles = 0;
+        memcpy(&chars, &data_ptr[str_idx], sizeof(chars));
+        if (!mb_ascii_chars_to_nibbles(chars, &nibbles)) {
+            return -1;
+        }
+        // Join the nibbles of each 16 bit lane and gather the low bytes of the lanes
+        uint64_t bytes = ((nibbles & MB_ASCII_REP16(0x000F)) << 4) | ((nibbles >> 8) & MB_ASCII_REP16(0x000F));
+        bytes = (bytes | (bytes >> 8)) & 0x0000FFFF0000FFFFULL;
+        uint32_t word = (uint32_t)(bytes | (bytes >> 16));
+        // The binary data is written behind the characters which are not converted yet
+        memcpy(&data_ptr[bin_idx], &word, sizeof(word));
+        bin_idx += sizeof(word);
+        lrc += mb_ascii_word_sum(word);
+    }
+#endif
+    for (; (str_idx < str_end); str_idx += 2) {
+        uint8_t high = mb_char2bin(data_ptr[str_idx]);
+        uint8_t low = mb_char2bin(data_ptr[str_idx + 1]);
+        if ((high | low) & 0xF0) {
+            return -1;
+        }
+        data_ptr[bin_idx] = (uint8_t)((high << 4) | low);
+        lrc += data_ptr[bin_idx++];
+    }
+
+    lrc = (uint8_t)(-((char)lrc));
+    return (lrc == 0) ? bin_idx : -1;
+}
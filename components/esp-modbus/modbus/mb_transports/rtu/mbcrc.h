@@ -37,5 +37,46 @@
 
 #pragma once
 
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (CONFIG_FMB_CRC16_SLICE_BY_8)
+#define MB_CRC16_SLICES (8)
+#elif (CONFIG_FMB_CRC16_SLICE_BY_4)
+#define MB_CRC16_SLICES (4)
+#else
+#define MB_CRC16_SLICES (1)
+#endif
+
+#define MB_CRC16_INIT   (0xFFFF)
+
+/**
+ * @brief Calculates the CRC16 of the frame
+ *
+ * @param frame_ptr the frame data
+ * @param len_buf the length of the frame
+ * @return the CRC16, the low byte is sent first; zero if the frame includes its valid CRC
+ */
 uint16_t mb_crc16(uint8_t *frame_ptr, uint16_t len_buf);
 
+/**
+ * @brief Continues the CRC16 calculation with the next part of the frame
+ *
+ * The CRC of the frame received in several parts is the same as the CRC of the whole frame:
+ * start from MB_CRC16_INIT and pass each part in order.
+ *
+ * @param crc the CRC of the previous parts of the frame or MB_CRC16_INIT
+ * @param frame_ptr the next part of the frame
+ * @param len_buf the length of the part
+ * @return the CRC16 of the frame up to the end of the part
+ */
+uint16_t mb_crc16_update(uint16_t crc, const uint8_t *frame_ptr, uint16_t len_buf);
+
+#ifdef __cplusplus
+}
+#endif
+
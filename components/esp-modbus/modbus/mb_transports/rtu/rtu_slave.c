@@ -16,7 +16,7 @@ typedef struct
     mb_port_base_t *port_obj;
     
     uint8_t snd_buf[MB_RTU_SER_PDU_SIZE_MAX]; // pdu_buf
-    uint8_t rcv_buf[MB_RTU_SER_PDU_SIZE_MAX];
+    uint8_t *rcv_buf;                   // The frame in the slot of the port, it is not copied
     uint16_t snd_pdu_len;
     uint8_t *snd_buf_cur;
     uint16_t snd_buf_cnt;
@@ -133,7 +133,7 @@ static mb_err_enum_t mbs_rtu_transp_receive(mb_trans_base_t *inst, uint8_t *recv
     mbs_rtu_transp_t *transp = __containerof(inst, mbs_rtu_transp_t, base);
     mb_err_enum_t status = MB_ENOERR;
 
-    uint8_t *buf = (uint8_t *)transp->rcv_buf;
+    uint8_t *buf = NULL;
     uint16_t length = *buf_len;
 
     if (mb_port_ser_recv_data(inst->port_obj, &buf, &length) == false){
@@ -146,7 +146,7 @@ static mb_err_enum_t mbs_rtu_transp_receive(mb_trans_base_t *inst, uint8_t *recv
 
     /* Check length and CRC checksum */
     if ((length >= MB_RTU_SER_PDU_SIZE_MIN)
-        && (mb_crc16(buf, length) == 0)) {
+        && mb_port_ser_check_crc16(inst->port_obj, buf, length)) {
         /* Save the address field. All frames are passed to the upper layed
          * and the decision if a frame is used is done there.
          */
@@ -156,6 +156,7 @@ static mb_err_enum_t mbs_rtu_transp_receive(mb_trans_base_t *inst, uint8_t *recv
          * size of address field and CRC checksum.
          */
         *buf_len = (uint16_t)(length - MB_SER_PDU_PDU_OFF - MB_SER_PDU_SIZE_CRC);
+        transp->rcv_buf = buf;
         transp->rcv_buf_pos = length;
 
         /* Return the start of the Modbus PDU to the caller. */
@@ -234,7 +235,7 @@ void mbs_rtu_transp_get_rcv_buf(mb_trans_base_t *inst, uint8_t **frame_buf)
 {
     mbs_rtu_transp_t *transp = __containerof(inst, mbs_rtu_transp_t, base);
     CRITICAL_SECTION(inst->lock) {
-        *frame_buf = &transp->rcv_buf[MB_PDU_FUNC_OFF];
+        *frame_buf = transp->rcv_buf ? &transp->rcv_buf[MB_PDU_FUNC_OFF] : NULL;
     }
 }
 
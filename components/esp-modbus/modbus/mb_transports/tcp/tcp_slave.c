@@ -15,7 +15,7 @@ typedef struct
 {
     mb_trans_base_t base;
     mb_port_base_t *port_obj;
-    uint8_t recv_buf[MB_TCP_BUF_SIZE];
+    uint8_t *recv_frame;                /*!< received frame owned by transport until the next receive */
     uint8_t send_buf[MB_TCP_BUF_SIZE];
     mb_tcp_state_enum_t state;
     uint16_t snd_pdu_len;
@@ -94,6 +94,8 @@ bool mbs_tcp_transp_delete(mb_trans_base_t *inst)
         mb_port_timer_delete(inst->port_obj);
         mb_port_event_delete(inst->port_obj);
         mbs_port_tcp_delete(inst->port_obj);
+        mb_port_frame_free(transp->recv_frame);
+        transp->recv_frame = NULL;
     }
     CRITICAL_SECTION_CLOSE(inst->lock);
     free(transp);
@@ -127,12 +129,22 @@ static mb_err_enum_t mbs_tcp_transp_receive(mb_trans_base_t *inst, uint8_t *rcv_
 
     mbs_tcp_transp_t *transp = __containerof(inst, mbs_tcp_transp_t, base);
 
-    uint8_t *frame_ptr = (uint8_t *)transp->recv_buf;
+    uint8_t *frame_ptr = NULL;
     uint16_t length = *buf_len;
     mb_err_enum_t status = MB_EIO;
     uint16_t pid;
 
+    // The previous request is completed, release its frame and take the ownership of the new one.
+    // The request is parsed and the response is built in place in the received frame buffer.
+    CRITICAL_SECTION(inst->lock) {
+        mb_port_frame_free(transp->recv_frame);
+        transp->recv_frame = NULL;
+    }
+
     if (mbs_port_tcp_recv_data(inst->port_obj, &frame_ptr, &length) != false) {
+        CRITICAL_SECTION(inst->lock) {
+            transp->recv_frame = frame_ptr;
+        }
         pid = frame_ptr[MB_TCP_PID] << 8U;
         pid |= frame_ptr[MB_TCP_PID + 1];
 
@@ -216,7 +228,7 @@ static void mbs_tcp_transp_get_rcv_buf(mb_trans_base_t *inst, uint8_t **frame_bu
 {
     mbs_tcp_transp_t *transp = __containerof(inst, mbs_tcp_transp_t, base);
     CRITICAL_SECTION(inst->lock) {
-        *frame_buf = transp->recv_buf + MB_TCP_FUNC;
+        *frame_buf = transp->recv_frame ? (transp->recv_frame + MB_TCP_FUNC) : NULL;
     }
 }
 
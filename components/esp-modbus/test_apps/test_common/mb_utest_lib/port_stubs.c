@@ -18,6 +18,7 @@
 #include "port_common.h"
 #include "mb_config.h"
 #include "port_serial_common.h"
+#include "mbcrc.h"
 #include "port_tcp_common.h"
 #include "port_adapter.h"
 #include "port_stubs.h"
@@ -59,6 +60,11 @@ bool __wrap_mb_port_ser_send_data(mb_port_base_t *inst, uint8_t *frame, uint16_t
     return mb_port_adapter_send_data(inst, 0, frame, length);
 }
 
+bool __wrap_mb_port_ser_check_crc16(mb_port_base_t *inst, uint8_t *frame, uint16_t length)
+{
+    return (mb_crc16(frame, length) == 0);
+}
+
 void __wrap_mb_port_ser_enable(mb_port_base_t *inst)
 {
     mb_port_adapter_enable(inst);
@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "sdkconfig.h"
+#include "ascii_lrc.h"
+
+#define TAG "MB_ASCII_TEST"
+
+#define TEST_BIN_SIZE_MAX 252
+#define TEST_ASCII_SIZE_MAX ((TEST_BIN_SIZE_MAX + 1) * 2 + 3)
+#define TEST_FRAME_COUNT 64
+#define TEST_CHAR_FRAME_SIZE 13
+#define TEST_BENCH_LOOPS 2000
+
+// The nibble per call conversion with the separate LRC pass is the reference for the codec
+static int test_ascii_set_buf_ref(const uint8_t *data_ptr, uint8_t *buf, int bin_length)
+{
+    int frm_idx = 0;
+    uint8_t lrc = mb_lrc((uint8_t *)data_ptr, (uint16_t)bin_length);
+
+    buf[frm_idx++] = MB_ASCII_START;
+    for (int bin_idx = 0; bin_idx < bin_length; bin_idx++) {
+        buf[frm_idx++] = mb_bin2char((uint8_t)(data_ptr[bin_idx] >> 4));
+        buf[frm_idx++] = mb_bin2char((uint8_t)(data_ptr[bin_idx] & 0x0F));
+    }
+    buf[frm_idx++] = mb_bin2char((uint8_t)(lrc >> 4));
+    buf[frm_idx++] = mb_bin2char((uint8_t)(lrc & 0x0F));
+    buf[frm_idx++] = MB_ASCII_CR;
+    buf[frm_idx++] = MB_ASCII_LF;
+    return frm_idx;
+}
+
+static int test_ascii_get_binary_buf_ref(uint8_t *data_ptr, int length)
+{
+    int bin_idx = 0;
+
+    if ((data_ptr[0] == ':') && (data_ptr[length - 1] == '\n') && (data_ptr[length - 2] == '\r')) {
+        for (int str_idx = 1; (str_idx < length) && (data_ptr[str_idx] > ' '); str_idx += 2) {
+            data_ptr[bin_idx] = (mb_char2bin(data_ptr[str_idx]) << 4);
+            data_ptr[bin_idx++] |= mb_char2bin(data_ptr[str_idx + 1]);
+        }
+    }
+    return ((mb_lrc(data_ptr, (uint16_t)bin_idx) == 0) && (bin_idx == ((length - 3) >> 1))) ? bin_idx : -1;
+}
+
+static void test_fill_random(uint8_t *buf, int len)
+{
+    for (int i = 0; i < len; i++) {
+        buf[i] = (uint8_t)rand();
+    }
+}
+
+// Encodes the data with both methods, checks the frames are equal and decodes the frame back
+static void test_check_frame(const uint8_t *data, int len)
+{
+    uint8_t ascii[TEST_ASCII_SIZE_MAX];
+    uint8_t ascii_ref[TEST_ASCII_SIZE_MAX];
+
+    int ascii_len = mb_ascii_set_buf(data, ascii, len);
+    TEST_ASSERT_EQUAL(test_ascii_set_buf_ref(data, ascii_ref, len), ascii_len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ascii_ref, ascii, ascii_len);
+    TEST_ASSERT_EQUAL(len + 1, mb_ascii_get_binary_buf(ascii, ascii_len));
+    if (len) {
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(data, ascii, len);
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, mb_lrc(ascii, (uint16_t)(len + 1)));
+}
+
+TEST_CASE("Test ascii codec of all two byte frames matches the reference.", "[MB_ASCII]")
+{
+    uint8_t data[2];
+    for (int value = 0; value <= 0xFFFF; value++) {
+        data[0] = (uint8_t)(value >> 8);
+        data[1] = (uint8_t)value;
+        test_check_frame(data, 2);
+        if (!data[0]) {
+            test_check_frame(&data[1], 1);
+        }
+    }
+}
+
+TEST_CASE("Test ascii codec of all frame lengths matches the reference.", "[MB_ASCII]")
+{
+    uint8_t data[TEST_BIN_SIZE_MAX];
+    srand(3);
+    for (int frame = 0; frame < TEST_FRAME_COUNT; frame++) {
+        for (int len = 0; len <= TEST_BIN_SIZE_MAX; len++) {
+            test_fill_random(data, len);
+            test_check_frame(data, len);
+        }
+    }
+}
+
+TEST_CASE("Test ascii decoder checks every character of the frame.", "[MB_ASCII]")
+{
+    uint8_t data[TEST_CHAR_FRAME_SIZE];
+    uint8_t ascii[TEST_ASCII_SIZE_MAX];
+    uint8_t ascii_ref[TEST_ASCII_SIZE_MAX];
+    uint8_t ref[TEST_ASCII_SIZE_MAX];
+    srand(4);
+    test_fill_random(data, sizeof(data));
+    int ascii_len = mb_ascii_set_buf(data, ascii_ref, sizeof(data));
+
+    // Each position of the words and of the tail gets every character value
+    for (int pos = 1; pos < (ascii_len - 2); pos++) {
+        for (int symb = 0; symb <= 0xFF; symb++) {
+            memcpy(ascii, ascii_ref, ascii_len);
+            ascii[pos] = (uint8_t)symb;
+            bool is_hex = ((symb >= '0') && (symb <= '9')) || ((symb >= 'A') && (symb <= 'F'));
+            memcpy(ref, ascii, ascii_len);
+            int ret = mb_ascii_get_binary_buf(ascii, ascii_len);
+            if (!is_hex) {
+                TEST_ASSERT_EQUAL(-1, ret);
+                continue;
+            }
+            int ret_ref = test_ascii_get_binary_buf_ref(ref, ascii_len);
+            TEST_ASSERT_EQUAL(ret_ref, ret);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(ref, ascii, (ascii_len - 3) / 2);
+        }
+    }
+}
+
+TEST_CASE("Test ascii decoder drops the broken frames.", "[MB_ASCII]")
+{
+    const uint8_t data[] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x0A};
+    uint8_t ascii[TEST_ASCII_SIZE_MAX];
+    uint8_t frame[TEST_ASCII_SIZE_MAX];
+
+    int ascii_len = mb_ascii_set_buf(data, ascii, sizeof(data));
+    TEST_ASSERT_EQUAL_STRING_LEN(":01030000000AF2\r\n", ascii, ascii_len);
+
+    memcpy(frame, ":\r\n", 3);
+    TEST_ASSERT_EQUAL(0, mb_ascii_get_binary_buf(frame, 3));
+    // The frame without start, CR or LF, with the odd number of characters or wrong LRC
+    memcpy(frame, ascii, ascii_len);
+    frame[0] = '0';
+    TEST_ASSERT_EQUAL(-1, mb_ascii_get_binary_buf(frame, ascii_len));
+    memcpy(frame, ascii, ascii_len);
+    TEST_ASSERT_EQUAL(-1, mb_ascii_get_binary_buf(frame, ascii_len - 1));
+    memcpy(frame, ascii, ascii_len);
+    frame[ascii_len - 2] = '\n';
+    TEST_ASSERT_EQUAL(-1, mb_ascii_get_binary_buf(frame, ascii_len));
+    memcpy(frame, ascii, ascii_len);
+    memmove(&frame[2], &frame[3], ascii_len - 3);
+    TEST_ASSERT_EQUAL(-1, mb_ascii_get_binary_buf(frame, ascii_len - 1));
+    memcpy(frame, ascii, ascii_len);
+    frame[4] = '1';
+    TEST_ASSERT_EQUAL(-1, mb_ascii_get_binary_buf(frame, ascii_len));
+    // The lower case hex digits are not allowed by the protocol
+    memcpy(frame, ascii, ascii_len);
+    frame[12] = 'a';
+    TEST_ASSERT_EQUAL(-1, mb_ascii_get_binary_buf(frame, ascii_len));
+}
+
+TEST_CASE("Test ascii codec speed.", "[MB_ASCII]")
+{
+    uint8_t data[TEST_BIN_SIZE_MAX];
+    uint8_t ascii[TEST_ASCII_SIZE_MAX];
+    int ascii_len = 0;
+    test_fill_random(data, sizeof(data));
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < TEST_BENCH_LOOPS; i++) {
+        ascii_len = mb_ascii_set_buf(data, ascii, sizeof(data));
+        TEST_ASSERT_EQUAL(sizeof(data) + 1, mb_ascii_get_binary_buf(ascii, ascii_len));
+    }
+    int64_t codec_time = esp_timer_get_time() - start;
+    start = esp_timer_get_time();
+    for (int i = 0; i < TEST_BENCH_LOOPS; i++) {
+        ascii_len = test_ascii_set_buf_ref(data, ascii, sizeof(data));
+        TEST_ASSERT_EQUAL(sizeof(data) + 1, test_ascii_get_binary_buf_ref(ascii, ascii_len));
+    }
+    int64_t ref_time = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "frame: %d bytes, encode + decode: %" PRId64 " ns/frame, nibble per call: %" PRId64 " ns/frame",
+                TEST_BIN_SIZE_MAX, (codec_time * 1000) / TEST_BENCH_LOOPS, (ref_time * 1000) / TEST_BENCH_LOOPS);
+}
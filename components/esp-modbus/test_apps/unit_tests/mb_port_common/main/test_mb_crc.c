@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "sdkconfig.h"
+#include "mbcrc.h"
+
+#define TAG "MB_CRC_TEST"
+
+#define TEST_FRAME_SIZE 256
+#define TEST_FRAME_COUNT 64
+#define TEST_BENCH_LOOPS 2000
+
+// The bitwise calculation of CRC-16/MODBUS is the reference for the table methods
+static uint16_t test_crc16_bitwise(const uint8_t *buf, uint16_t len)
+{
+    uint16_t crc = MB_CRC16_INIT;
+    while (len--) {
+        crc ^= *(buf++);
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 1) ? ((crc >> 1) ^ 0xA001) : (crc >> 1);
+        }
+    }
+    return crc;
+}
+
+static void test_fill_random(uint8_t *buf, uint16_t len)
+{
+    for (int i = 0; i < len; i++) {
+        buf[i] = (uint8_t)rand();
+    }
+}
+
+TEST_CASE("Test crc16 matches the reference values.", "[MB_CRC]")
+{
+    uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    uint8_t frame[] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x0A, 0xC5, 0xCD};
+
+    ESP_LOGI(TAG, "crc16 method: %d byte(s) per iteration", MB_CRC16_SLICES);
+    TEST_ASSERT_EQUAL_HEX16(0x4B37, mb_crc16(check, sizeof(check)));
+    TEST_ASSERT_EQUAL_HEX16(MB_CRC16_INIT, mb_crc16(check, 0));
+    // The CRC is sent low byte first, so the CRC of the frame with its CRC is zero
+    TEST_ASSERT_EQUAL_HEX16(0xCDC5, mb_crc16(frame, sizeof(frame) - 2));
+    TEST_ASSERT_EQUAL_HEX16(0, mb_crc16(frame, sizeof(frame)));
+    frame[3] ^= 0x10;
+    TEST_ASSERT_NOT_EQUAL(0, mb_crc16(frame, sizeof(frame)));
+}
+
+TEST_CASE("Test crc16 of all lengths and alignments matches the bitwise calculation.", "[MB_CRC]")
+{
+    uint8_t *buf = malloc(TEST_FRAME_SIZE + 8);
+    TEST_ASSERT_NOT_NULL(buf);
+    srand(1);
+    for (int frame = 0; frame < TEST_FRAME_COUNT; frame++) {
+        test_fill_random(buf, TEST_FRAME_SIZE + 8);
+        for (int offset = 0; offset < 8; offset++) {
+            for (int len = 0; len <= TEST_FRAME_SIZE; len += ((frame & 1) ? 1 : 7)) {
+                TEST_ASSERT_EQUAL_HEX16(test_crc16_bitwise(&buf[offset], len), mb_crc16(&buf[offset], len));
+            }
+        }
+    }
+    free(buf);
+}
+
+TEST_CASE("Test crc16 updated by parts is equal to the crc16 of the frame.", "[MB_CRC]")
+{
+    uint8_t buf[TEST_FRAME_SIZE];
+    srand(2);
+    for (int frame = 0; frame < TEST_FRAME_COUNT; frame++) {
+        uint16_t len = (uint16_t)(4 + (rand() % (TEST_FRAME_SIZE - 6)));
+        test_fill_random(buf, len);
+        uint16_t crc = mb_crc16(buf, len);
+        buf[len] = (uint8_t)(crc & 0xFF);
+        buf[len + 1] = (uint8_t)(crc >> 8);
+        // The frame is received in the random parts like the data events of UART
+        uint16_t part_crc = MB_CRC16_INIT;
+        for (uint16_t pos = 0; pos < (len + 2); ) {
+            uint16_t part = (uint16_t)(1 + (rand() % 40));
+            part = ((pos + part) > (len + 2)) ? (len + 2 - pos) : part;
+            part_crc = mb_crc16_update(part_crc, &buf[pos], part);
+            pos += part;
+            if (pos == len) {
+                TEST_ASSERT_EQUAL_HEX16(crc, part_crc);
+            }
+        }
+        TEST_ASSERT_EQUAL_HEX16(0, part_crc);
+    }
+}
+
+TEST_CASE("Test crc16 calculation speed.", "[MB_CRC]")
+{
+    uint8_t buf[TEST_FRAME_SIZE];
+    volatile uint16_t crc = 0;
+    test_fill_random(buf, sizeof(buf));
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < TEST_BENCH_LOOPS; i++) {
+        crc ^= mb_crc16(buf, sizeof(buf));
+    }
+    int64_t table_time = esp_timer_get_time() - start;
+    start = esp_timer_get_time();
+    for (int i = 0; i < TEST_BENCH_LOOPS; i++) {
+        crc ^= test_crc16_bitwise(buf, sizeof(buf));
+    }
+    int64_t bitwise_time = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "frame: %d bytes, %d byte(s) per iteration: %" PRId64 " ns/frame, bitwise: %" PRId64 " ns/frame",
+                TEST_FRAME_SIZE, MB_CRC16_SLICES, (table_time * 1000) / TEST_BENCH_LOOPS,
+                (bitwise_time * 1000) / TEST_BENCH_LOOPS);
+}
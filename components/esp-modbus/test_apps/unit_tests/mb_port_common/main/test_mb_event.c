@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "sdkconfig.h"
+#include "port_common.h"
+
+#define TAG "MB_EVENT_TEST"
+
+#define TEST_TASK_COUNT 3
+#define TEST_TASK_EVENTS 200
+#define TEST_TASK_STACK_SIZE 4096
+#define TEST_DONE_TOUT_MS 10000
+
+typedef struct {
+    mb_port_base_t *port;
+    int index;
+    int errors;
+    SemaphoreHandle_t done_sema;
+} test_event_task_t;
+
+// The lane keeps the queue length rounded up to the power of two
+static uint32_t test_lane_size(void)
+{
+    uint32_t size = 1;
+    while (size < CONFIG_FMB_QUEUE_LENGTH) {
+        size <<= 1;
+    }
+    return size;
+}
+
+static void test_port_create(mb_port_base_t *port)
+{
+    memset(port, 0, sizeof(mb_port_base_t));
+    port->descr.parent_name = "test_port";
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_port_event_create(port));
+}
+
+static void test_event_task(void *arg)
+{
+    test_event_task_t *task_ptr = (test_event_task_t *)arg;
+    for (int i = 0; i < TEST_TASK_EVENTS; i++) {
+        // The length carries the producer and the sequence number of the event
+        uint16_t tag = (uint16_t)((task_ptr->index << 12) | i);
+        if (!mb_port_event_post(task_ptr->port, EVENT(EV_FRAME_RECEIVED, tag))) {
+            task_ptr->errors++;
+        }
+    }
+    xSemaphoreGive(task_ptr->done_sema);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Test port events of several producers keep the order of each producer.", "[MB_EVENT]")
+{
+    mb_port_base_t port;
+    test_event_task_t tasks[TEST_TASK_COUNT] = {0};
+    int next[TEST_TASK_COUNT] = {0};
+    mb_port_event_stats_t stats = {0};
+    mb_event_t event = {0};
+
+    test_port_create(&port);
+    for (int i = 0; i < TEST_TASK_COUNT; i++) {
+        tasks[i].port = &port;
+        tasks[i].index = i;
+        tasks[i].done_sema = xSemaphoreCreateBinary();
+        TEST_ASSERT_NOT_NULL(tasks[i].done_sema);
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(test_event_task, "mb_test_task", TEST_TASK_STACK_SIZE,
+                                                &tasks[i], (CONFIG_FMB_PORT_TASK_PRIO - 1), NULL));
+    }
+    for (int i = 0; i < (TEST_TASK_COUNT * TEST_TASK_EVENTS); i++) {
+        TEST_ASSERT_TRUE(mb_port_event_get(&port, &event));
+        TEST_ASSERT_EQUAL(EV_FRAME_RECEIVED, event.event);
+        int index = event.length >> 12;
+        TEST_ASSERT_TRUE(index < TEST_TASK_COUNT);
+        TEST_ASSERT_EQUAL(next[index], (event.length & 0xFFF));
+        next[index]++;
+    }
+    int errors = 0;
+    for (int i = 0; i < TEST_TASK_COUNT; i++) {
+        TEST_ASSERT_TRUE(xSemaphoreTake(tasks[i].done_sema, pdMS_TO_TICKS(TEST_DONE_TOUT_MS)));
+        vSemaphoreDelete(tasks[i].done_sema);
+        errors += tasks[i].errors;
+    }
+    mb_port_event_get_stats(&port, &stats);
+    uint32_t hist_count = 0;
+    for (int i = 0; i < MB_EVENT_LATENCY_BUCKETS; i++) {
+        hist_count += stats.latency_hist[i];
+    }
+    ESP_LOGI(TAG, "events: %u, overflows: %u, max latency: %u us", (unsigned)stats.received,
+                (unsigned)stats.overflows, (unsigned)stats.max_latency_us);
+    mb_port_event_delete(&port);
+    TEST_ASSERT_EQUAL(0, errors);
+    TEST_ASSERT_EQUAL(TEST_TASK_COUNT * TEST_TASK_EVENTS, stats.posted);
+    TEST_ASSERT_EQUAL(TEST_TASK_COUNT * TEST_TASK_EVENTS, stats.received);
+    TEST_ASSERT_EQUAL(stats.received, hist_count);
+    TEST_ASSERT_EQUAL(0, stats.dropped);
+}
+
+static void test_overflow_task(void *arg)
+{
+    test_event_task_t *task_ptr = (test_event_task_t *)arg;
+    if (!mb_port_event_post(task_ptr->port, EVENT(EV_FRAME_SENT, 0xFFF))) {
+        task_ptr->errors++;
+    }
+    xSemaphoreGive(task_ptr->done_sema);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Test port error events go first and the full queue holds the poster.", "[MB_EVENT]")
+{
+    mb_port_base_t port;
+    test_event_task_t task = {0};
+    mb_port_event_stats_t stats = {0};
+    mb_event_t event = {0};
+    uint32_t size = test_lane_size();
+
+    test_port_create(&port);
+    for (uint32_t i = 0; i < size; i++) {
+        TEST_ASSERT_TRUE(mb_port_event_post(&port, EVENT(EV_FRAME_RECEIVED, (uint16_t)i)));
+    }
+    // The error lane is separate, the error event overtakes the queued transport events
+    TEST_ASSERT_TRUE(mb_port_event_post(&port, EVENT(EV_ERROR_PROCESS)));
+    TEST_ASSERT_TRUE(mb_port_event_get(&port, &event));
+    TEST_ASSERT_EQUAL(EV_ERROR_PROCESS, event.event);
+
+    // The transport lane is full, the producer waits for the consumer
+    task.port = &port;
+    task.done_sema = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(task.done_sema);
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(test_overflow_task, "mb_test_task", TEST_TASK_STACK_SIZE,
+                                            &task, (CONFIG_FMB_PORT_TASK_PRIO - 1), NULL));
+    TEST_ASSERT_FALSE(xSemaphoreTake(task.done_sema, pdMS_TO_TICKS(50)));
+    mb_port_event_get_stats(&port, &stats);
+    TEST_ASSERT_EQUAL(1, stats.overflows);
+
+    // No queued event is lost and the waiting event goes last
+    for (uint32_t i = 0; i < size; i++) {
+        TEST_ASSERT_TRUE(mb_port_event_get(&port, &event));
+        TEST_ASSERT_EQUAL(EV_FRAME_RECEIVED, event.event);
+        TEST_ASSERT_EQUAL(i, event.length);
+    }
+    TEST_ASSERT_TRUE(xSemaphoreTake(task.done_sema, pdMS_TO_TICKS(TEST_DONE_TOUT_MS)));
+    vSemaphoreDelete(task.done_sema);
+    TEST_ASSERT_TRUE(mb_port_event_get(&port, &event));
+    TEST_ASSERT_EQUAL(EV_FRAME_SENT, event.event);
+    TEST_ASSERT_EQUAL(0xFFF, event.length);
+
+    mb_port_event_get_stats(&port, &stats);
+    mb_port_event_delete(&port);
+    TEST_ASSERT_EQUAL(0, task.errors);
+    TEST_ASSERT_EQUAL(size + 2, stats.received);
+    TEST_ASSERT_EQUAL(0, stats.dropped);
+}
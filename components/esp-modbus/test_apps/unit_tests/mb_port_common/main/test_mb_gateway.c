@@ -0,0 +1,348 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "sdkconfig.h"
+#include "esp_modbus_master.h"
+#include "esp_modbus_slave.h"
+#include "esp_modbus_gateway.h"
+
+#if (CONFIG_FMB_COMM_MODE_TCP_EN && CONFIG_FMB_CONTROLLER_GATEWAY_ENABLE)
+
+#define TAG "MB_GATEWAY_TEST"
+
+#define TEST_TCP_PORT_NUM 1502
+#define TEST_SLAVE_UID 1
+#define TEST_BUS_SLAVE_COUNT 2
+#define TEST_BUS_FIRST_ADDR 11
+#define TEST_BUS_DELAY_MS 5
+#define TEST_REG_COUNT 32
+#define TEST_TASK_COUNT 4
+#define TEST_MASTER_COUNT 2
+#define TEST_TASK_LOOPS 20
+#define TEST_TASK_STACK_SIZE 4096
+#define TEST_RESPOND_TOUT_MS 2000
+#define TEST_BUS_TOUT_MS 200
+#define TEST_BUS_HANG_MS 1000
+#define TEST_DONE_TOUT_MS 60000
+#define TEST_CONNECT_DELAY_MS 500
+
+// The registers of the slaves on the simulated serial bus
+typedef struct {
+    uint16_t regs[TEST_BUS_SLAVE_COUNT][TEST_REG_COUNT];
+    int active;                         // number of the transfers on the bus at the same time
+    int overlaps;
+    int transfers;
+    uint32_t delay_ms;                  // the delay of the transfer, 0 - TEST_BUS_DELAY_MS
+} test_bus_t;
+
+static test_bus_t test_bus;
+
+static const mb_parameter_descriptor_t test_descriptors[] = {
+    {0, "hold_reg-0", "Data", TEST_SLAVE_UID, MB_PARAM_HOLDING, 0, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+    {1, "hold_reg-1", "Data", (TEST_SLAVE_UID + 1), MB_PARAM_HOLDING, 1, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+    {2, "hold_reg-2", "Data", (TEST_SLAVE_UID + 2), MB_PARAM_HOLDING, 2, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+};
+
+typedef struct {
+    void *master_handle;
+    int index;
+    int errors;
+    SemaphoreHandle_t done_sema;
+} test_gateway_task_t;
+
+// Stands in for the serial line, the holding registers of the slaves answer with the bus delay
+static esp_err_t test_bus_transfer(void *arg, uint8_t slave_addr, const uint8_t *request, uint16_t request_len,
+                                    uint8_t *response, uint16_t *response_len)
+{
+    test_bus_t *bus = (test_bus_t *)arg;
+    int index = slave_addr - TEST_BUS_FIRST_ADDR;
+    if ((index < 0) || (index >= TEST_BUS_SLAVE_COUNT)) {
+        return ESP_ERR_TIMEOUT;
+    }
+    if (__atomic_fetch_add(&bus->active, 1, __ATOMIC_SEQ_CST)) {
+        bus->overlaps++;
+    }
+    vTaskDelay(pdMS_TO_TICKS(bus->delay_ms ? bus->delay_ms : TEST_BUS_DELAY_MS));
+    uint16_t start = (request[1] << 8) | request[2];
+    uint16_t count = (request[3] << 8) | request[4];
+    esp_err_t err = ESP_OK;
+    response[0] = request[0];
+    if ((request[0] == 0x03) && ((start + count) <= TEST_REG_COUNT)) {
+        response[1] = (uint8_t)(count << 1);
+        for (int i = 0; i < count; i++) {
+            response[2 + (i << 1)] = (uint8_t)(bus->regs[index][start + i] >> 8);
+            response[3 + (i << 1)] = (uint8_t)(bus->regs[index][start + i] & 0xFF);
+        }
+        *response_len = 2 + response[1];
+    } else if ((request[0] == 0x06) && (start < TEST_REG_COUNT)) {
+        bus->regs[index][start] = count;
+        memcpy(response, request, 5);
+        *response_len = 5;
+    } else if ((request[0] == 0x10) && ((start + count) <= TEST_REG_COUNT)) {
+        for (int i = 0; i < count; i++) {
+            bus->regs[index][start + i] = (request[6 + (i << 1)] << 8) | request[7 + (i << 1)];
+        }
+        memcpy(response, request, 5);
+        *response_len = 5;
+    } else {
+        response[0] = request[0] | 0x80;
+        response[1] = 0x02;             // illegal data address
+        *response_len = 2;
+    }
+    bus->transfers++;
+    __atomic_fetch_sub(&bus->active, 1, __ATOMIC_SEQ_CST);
+    return err;
+}
+
+static void test_bus_init(void)
+{
+    memset(&test_bus, 0, sizeof(test_bus));
+    for (int i = 0; i < TEST_REG_COUNT; i++) {
+        test_bus.regs[0][i] = 0x1100 + i;
+        test_bus.regs[1][i] = 0x2200 + i;
+    }
+}
+
+// The gateway takes the response timeout of the bus master if the timeout is not set
+static void *test_gateway_start(void **gateway_handle, void *bus_master_handle)
+{
+    static const mb_gateway_route_t routes[] = {
+        {TEST_SLAVE_UID, TEST_BUS_FIRST_ADDR},
+        {(TEST_SLAVE_UID + 1), (TEST_BUS_FIRST_ADDR + 1)},
+    };
+    void *slave_handle = NULL;
+    mb_communication_info_t slave_comm = {
+        .tcp_opts.mode = MB_TCP,
+        .tcp_opts.port = TEST_TCP_PORT_NUM,
+        .tcp_opts.uid = TEST_SLAVE_UID,
+        .tcp_opts.addr_type = MB_IPV4,
+        .tcp_opts.ip_addr_table = (void *)"127.0.0.1",
+        .tcp_opts.response_tout_ms = TEST_RESPOND_TOUT_MS
+    };
+    test_bus_init();
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_create_tcp(&slave_comm, &slave_handle));
+    mb_gateway_config_t config = {
+        .slave_handle = slave_handle,
+        .routes = routes,
+        .route_count = (sizeof(routes) / sizeof(routes[0])),
+        .master_handle = bus_master_handle,
+        .transfer = test_bus_transfer,
+        .transfer_arg = &test_bus
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_gateway_create(&config, gateway_handle));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, mbc_gateway_create(&config, &config.transfer_arg));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_start(slave_handle));
+    return slave_handle;
+}
+
+static void *test_master_create(char **ip_table, uint32_t response_tout_ms)
+{
+    void *master_handle = NULL;
+    mb_communication_info_t master_comm = {
+        .tcp_opts.mode = MB_TCP,
+        .tcp_opts.port = TEST_TCP_PORT_NUM,
+        .tcp_opts.addr_type = MB_IPV4,
+        .tcp_opts.ip_addr_table = (void *)ip_table,
+        .tcp_opts.response_tout_ms = response_tout_ms
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_create_tcp(&master_comm, &master_handle));
+    return master_handle;
+}
+
+static void *test_master_start(char **ip_table, const mb_parameter_descriptor_t *descr, uint16_t descr_count)
+{
+    void *master_handle = test_master_create(ip_table, TEST_RESPOND_TOUT_MS);
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_set_descriptor(master_handle, descr, descr_count));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_start(master_handle));
+    return master_handle;
+}
+
+static void test_network_init(void)
+{
+    esp_err_t err = esp_netif_init();
+    TEST_ASSERT_TRUE((err == ESP_OK) || (err == ESP_ERR_INVALID_STATE));
+    err = esp_event_loop_create_default();
+    TEST_ASSERT_TRUE((err == ESP_OK) || (err == ESP_ERR_INVALID_STATE));
+}
+
+static esp_err_t test_send(void *master_handle, uint8_t uid, uint8_t command, uint16_t start,
+                            uint16_t size, uint16_t *data)
+{
+    mb_param_request_t request = {
+        .slave_addr = uid,
+        .command = command,
+        .reg_start = start,
+        .reg_size = size
+    };
+    return mbc_master_send_request(master_handle, &request, data);
+}
+
+TEST_CASE("Test gateway routes the units to the slaves on the bus.", "[MB_GATEWAY]")
+{
+    char *ip_table[] = {"01;127.0.0.1;1502", "02;127.0.0.1;1502", "03;127.0.0.1;1502", NULL};
+    uint16_t data[TEST_REG_COUNT] = {0};
+    mb_gateway_stats_t stats = {0};
+    void *gateway_handle = NULL;
+
+    test_network_init();
+    void *slave_handle = test_gateway_start(&gateway_handle, NULL);
+    vTaskDelay(pdMS_TO_TICKS(TEST_CONNECT_DELAY_MS));
+    void *master_handle = test_master_start(ip_table, &test_descriptors[0], 3);
+
+    for (int i = 0; i < TEST_BUS_SLAVE_COUNT; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, test_send(master_handle, TEST_SLAVE_UID + i, 0x03, 4, 8, data));
+        TEST_ASSERT_EQUAL_HEX16_ARRAY(&test_bus.regs[i][4], data, 8);
+    }
+    // The write goes to the second slave only and the next read returns it
+    uint16_t values[] = {0xA5A5, 0x5A5A};
+    TEST_ASSERT_EQUAL(ESP_OK, test_send(master_handle, TEST_SLAVE_UID + 1, 0x10, 2, 2, values));
+    TEST_ASSERT_EQUAL(ESP_OK, test_send(master_handle, TEST_SLAVE_UID + 1, 0x03, 2, 2, data));
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(values, data, 2);
+    TEST_ASSERT_EQUAL_HEX16(0x1102, test_bus.regs[0][2]);
+    values[0] = 0x1234;
+    TEST_ASSERT_EQUAL(ESP_OK, test_send(master_handle, TEST_SLAVE_UID, 0x06, 3, 1, values));
+    TEST_ASSERT_EQUAL_HEX16(0x1234, test_bus.regs[0][3]);
+
+    // The unit without the route and the exception of the bus slave fail the request
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, test_send(master_handle, TEST_SLAVE_UID + 2, 0x03, 0, 1, data));
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, test_send(master_handle, TEST_SLAVE_UID, 0x03, TEST_REG_COUNT, 1, data));
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_gateway_get_stats(gateway_handle, &stats));
+    TEST_ASSERT_EQUAL(0, test_bus.overlaps);
+    TEST_ASSERT_EQUAL(7, stats.request_count);
+    TEST_ASSERT_EQUAL(6, stats.transfer_count);
+    TEST_ASSERT_EQUAL(1, stats.error_count);
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_delete(master_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_stop(slave_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_gateway_delete(gateway_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+}
+
+// Each task reads the windows which other tasks read at the same time
+static void test_gateway_task(void *arg)
+{
+    test_gateway_task_t *task_ptr = (test_gateway_task_t *)arg;
+    uint16_t data[TEST_REG_COUNT] = {0};
+
+    for (int i = 0; i < TEST_TASK_LOOPS; i++) {
+        uint16_t start = (i % 4) << 2;
+        uint16_t size = 8;
+        uint8_t uid = TEST_SLAVE_UID + ((i >> 2) & 1);
+        esp_err_t err = test_send(task_ptr->master_handle, uid, 0x03, start, size, data);
+        if ((err != ESP_OK) || memcmp(data, &test_bus.regs[uid - TEST_SLAVE_UID][start], size << 1)) {
+            ESP_LOGE(TAG, "task %d, request %d, start: %u, size: %u, err = 0x%x",
+                        task_ptr->index, i, (unsigned)start, (unsigned)size, (int)err);
+            task_ptr->errors++;
+        }
+    }
+    xSemaphoreGive(task_ptr->done_sema);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Test gateway answers the identical reads of several clients by one transfer.", "[MB_GATEWAY]")
+{
+    char *ip_table[] = {"01;127.0.0.1;1502", "02;127.0.0.1;1502", NULL};
+    test_gateway_task_t tasks[TEST_TASK_COUNT] = {0};
+    void *master_handles[TEST_MASTER_COUNT] = {0};
+    mb_gateway_stats_t stats = {0};
+    void *gateway_handle = NULL;
+
+    test_network_init();
+    void *slave_handle = test_gateway_start(&gateway_handle, NULL);
+    vTaskDelay(pdMS_TO_TICKS(TEST_CONNECT_DELAY_MS));
+    for (int i = 0; i < TEST_MASTER_COUNT; i++) {
+        master_handles[i] = test_master_start(ip_table, &test_descriptors[0], 2);
+    }
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < TEST_TASK_COUNT; i++) {
+        tasks[i].master_handle = master_handles[i % TEST_MASTER_COUNT];
+        tasks[i].index = i;
+        tasks[i].done_sema = xSemaphoreCreateBinary();
+        TEST_ASSERT_NOT_NULL(tasks[i].done_sema);
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(test_gateway_task, "mb_test_task", TEST_TASK_STACK_SIZE,
+                                                &tasks[i], (CONFIG_FMB_PORT_TASK_PRIO - 1), NULL));
+    }
+    int errors = 0;
+    for (int i = 0; i < TEST_TASK_COUNT; i++) {
+        TEST_ASSERT_TRUE(xSemaphoreTake(tasks[i].done_sema, pdMS_TO_TICKS(TEST_DONE_TOUT_MS)));
+        vSemaphoreDelete(tasks[i].done_sema);
+        errors += tasks[i].errors;
+    }
+    int64_t time = esp_timer_get_time() - start;
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_gateway_get_stats(gateway_handle, &stats));
+    ESP_LOGI(TAG, "requests: %u, transfers: %u, merged: %u, prefetched: %u, bus busy: %" PRIu64 " us, gap: %" PRIu64
+                " us, %" PRId64 " us/request", (unsigned)stats.request_count, (unsigned)stats.transfer_count,
+                (unsigned)stats.merged_count, (unsigned)stats.prefetch_count, stats.busy_time_us,
+                stats.gap_time_us, time / (TEST_TASK_COUNT * TEST_TASK_LOOPS));
+
+    for (int i = 0; i < TEST_MASTER_COUNT; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_master_delete(master_handles[i]));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_stop(slave_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_gateway_delete(gateway_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+    TEST_ASSERT_EQUAL(0, errors);
+    TEST_ASSERT_EQUAL(0, test_bus.overlaps);
+    TEST_ASSERT_EQUAL(0, stats.error_count);
+    TEST_ASSERT_EQUAL((TEST_TASK_COUNT * TEST_TASK_LOOPS), stats.request_count);
+    TEST_ASSERT_EQUAL(stats.transfer_count, test_bus.transfers);
+    TEST_ASSERT_TRUE(stats.merged_count > 0);
+    TEST_ASSERT_TRUE(stats.transfer_count < stats.request_count);
+}
+
+TEST_CASE("Test gateway waits for the bus no longer than the response timeout of the bus master.", "[MB_GATEWAY]")
+{
+    char *ip_table[] = {"01;127.0.0.1;1502", NULL};
+    uint16_t data[TEST_REG_COUNT] = {0};
+    mb_gateway_stats_t stats = {0};
+    void *gateway_handle = NULL;
+
+    test_network_init();
+    // The bus master only gives its response timeout to the gateway, the test transfer stands in for the bus
+    void *bus_master_handle = test_master_create(ip_table, TEST_BUS_TOUT_MS);
+    void *slave_handle = test_gateway_start(&gateway_handle, bus_master_handle);
+    vTaskDelay(pdMS_TO_TICKS(TEST_CONNECT_DELAY_MS));
+    void *master_handle = test_master_start(ip_table, &test_descriptors[0], 1);
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_set_descriptor(bus_master_handle, &test_descriptors[0], 1));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_start(bus_master_handle));
+
+    TEST_ASSERT_EQUAL(ESP_OK, test_send(master_handle, TEST_SLAVE_UID, 0x03, 0, 4, data));
+    // The slave on the bus does not answer in time, the client gets the gateway exception
+    test_bus.delay_ms = TEST_BUS_HANG_MS;
+    int64_t start = esp_timer_get_time();
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, test_send(master_handle, TEST_SLAVE_UID, 0x03, 0, 4, data));
+    int64_t time_ms = (esp_timer_get_time() - start) / 1000;
+    ESP_LOGI(TAG, "bus timeout: %u ms, answered in %u ms", (unsigned)TEST_BUS_TOUT_MS, (unsigned)time_ms);
+    TEST_ASSERT_TRUE(time_ms >= (TEST_BUS_TOUT_MS - 10));
+    TEST_ASSERT_TRUE(time_ms < TEST_BUS_HANG_MS);
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_gateway_get_stats(gateway_handle, &stats));
+    TEST_ASSERT_EQUAL(1, stats.error_count);
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_delete(master_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_delete(bus_master_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_stop(slave_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_gateway_delete(gateway_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+}
+
+#endif
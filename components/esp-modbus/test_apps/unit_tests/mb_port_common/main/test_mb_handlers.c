@@ -0,0 +1,152 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "sdkconfig.h"
+#include "mb_common.h"
+
+#define TAG "MB_HANDLERS_TEST"
+
+#define TEST_FUNC_CODE 0x41
+#define TEST_REPLACE_COUNT 20000
+#define TEST_YIELD_COUNT 1000
+#define TEST_TASK_STACK_SIZE 4096
+#define TEST_DONE_TOUT_MS 10000
+
+typedef struct {
+    handler_descriptor_t *descriptor;
+    atomic_bool stop;
+    int lookups;
+    int errors;
+    SemaphoreHandle_t done_sema;
+} test_lookup_task_t;
+
+static mb_exception_t test_handler_a(void *inst, uint8_t *frame_ptr, uint16_t *len_buf)
+{
+    return MB_EX_ILLEGAL_FUNCTION;
+}
+
+static mb_exception_t test_handler_b(void *inst, uint8_t *frame_ptr, uint16_t *len_buf)
+{
+    return MB_EX_ILLEGAL_DATA_ADDRESS;
+}
+
+static void test_descriptor_init(handler_descriptor_t *descriptor, void *instance)
+{
+    memset(descriptor, 0, sizeof(handler_descriptor_t));
+    descriptor->instance = instance;
+}
+
+TEST_CASE("Test function handler table registers, replaces and removes the handlers.", "[MB_HANDLERS]")
+{
+    handler_descriptor_t descriptor;
+    mb_fn_handler_fp handler = NULL;
+    test_descriptor_init(&descriptor, &descriptor);
+
+    // The function codes out of the range of the table are rejected
+    TEST_ASSERT_EQUAL(MB_EINVAL, mb_set_handler(&descriptor, 0, test_handler_a));
+    TEST_ASSERT_EQUAL(MB_EINVAL, mb_set_handler(&descriptor, MB_FUNC_CODE_MAX + 1, test_handler_a));
+    TEST_ASSERT_EQUAL(MB_EINVAL, mb_get_handler(&descriptor, MB_FUNC_CODE_MAX + 1, &handler));
+    TEST_ASSERT_EQUAL(MB_EINVAL, mb_set_handler(&descriptor, TEST_FUNC_CODE, NULL));
+    TEST_ASSERT_EQUAL(MB_ENORES, mb_get_handler(&descriptor, TEST_FUNC_CODE, &handler));
+    TEST_ASSERT_EQUAL(MB_EINVAL, mb_delete_handler(&descriptor, TEST_FUNC_CODE));
+
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_set_handler(&descriptor, TEST_FUNC_CODE, test_handler_a));
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_set_handler(&descriptor, MB_FUNC_CODE_MAX, test_handler_b));
+    TEST_ASSERT_EQUAL(2, descriptor.count);
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_get_handler(&descriptor, TEST_FUNC_CODE, &handler));
+    TEST_ASSERT_EQUAL_PTR(test_handler_a, handler);
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_get_handler(&descriptor, MB_FUNC_CODE_MAX, &handler));
+    TEST_ASSERT_EQUAL_PTR(test_handler_b, handler);
+    TEST_ASSERT_EQUAL(MB_ENORES, mb_get_handler(&descriptor, TEST_FUNC_CODE + 1, &handler));
+
+    // The replaced handler takes the slot of the function, the count is not changed
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_set_handler(&descriptor, TEST_FUNC_CODE, test_handler_b));
+    TEST_ASSERT_EQUAL(2, descriptor.count);
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_get_handler(&descriptor, TEST_FUNC_CODE, &handler));
+    TEST_ASSERT_EQUAL_PTR(test_handler_b, handler);
+
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_delete_handler(&descriptor, TEST_FUNC_CODE));
+    TEST_ASSERT_EQUAL(1, descriptor.count);
+    TEST_ASSERT_EQUAL(MB_ENORES, mb_get_handler(&descriptor, TEST_FUNC_CODE, &handler));
+    TEST_ASSERT_EQUAL(MB_ENORES, mb_delete_handler(&descriptor, TEST_FUNC_CODE));
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_get_handler(&descriptor, MB_FUNC_CODE_MAX, &handler));
+    TEST_ASSERT_EQUAL_PTR(test_handler_b, handler);
+
+    // The table takes the limited number of handlers, the replacement of the handler is still allowed
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_delete_command_handlers(&descriptor));
+    TEST_ASSERT_EQUAL(0, descriptor.count);
+    for (int func_code = MB_FUNC_CODE_MIN; func_code < (MB_FUNC_CODE_MIN + MB_FUNC_HANDLERS_MAX); func_code++) {
+        TEST_ASSERT_EQUAL(MB_ENOERR, mb_set_handler(&descriptor, func_code, test_handler_a));
+    }
+    TEST_ASSERT_EQUAL(MB_FUNC_HANDLERS_MAX, descriptor.count);
+    if ((MB_FUNC_CODE_MIN + MB_FUNC_HANDLERS_MAX) <= MB_FUNC_CODE_MAX) {
+        TEST_ASSERT_EQUAL(MB_ENORES, mb_set_handler(&descriptor, MB_FUNC_CODE_MAX, test_handler_a));
+    }
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_set_handler(&descriptor, MB_FUNC_CODE_MIN, test_handler_b));
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_get_handler(&descriptor, MB_FUNC_CODE_MIN, &handler));
+    TEST_ASSERT_EQUAL_PTR(test_handler_b, handler);
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_delete_command_handlers(&descriptor));
+    for (int func_code = MB_FUNC_CODE_MIN; func_code <= MB_FUNC_CODE_MAX; func_code++) {
+        TEST_ASSERT_EQUAL(MB_ENORES, mb_get_handler(&descriptor, func_code, &handler));
+    }
+}
+
+// The lookup does not take the semaphore and must see one of the registered handlers
+static void test_lookup_task(void *arg)
+{
+    test_lookup_task_t *task = (test_lookup_task_t *)arg;
+    mb_fn_handler_fp handler = NULL;
+
+    while (!atomic_load(&task->stop)) {
+        if ((mb_get_handler(task->descriptor, TEST_FUNC_CODE, &handler) != MB_ENOERR)
+                || ((handler != test_handler_a) && (handler != test_handler_b))) {
+            task->errors++;
+        }
+        // The writer gets the core on the single core target
+        if (!(++task->lookups % TEST_YIELD_COUNT)) {
+            vTaskDelay(1);
+        }
+    }
+    xSemaphoreGive(task->done_sema);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Test function handler lookup sees the old or the new handler while it is replaced.", "[MB_HANDLERS]")
+{
+    handler_descriptor_t descriptor;
+    test_lookup_task_t task = {.descriptor = &descriptor};
+    test_descriptor_init(&descriptor, &descriptor);
+
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_set_handler(&descriptor, TEST_FUNC_CODE, test_handler_a));
+    task.done_sema = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(task.done_sema);
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(test_lookup_task, "mb_test_task", TEST_TASK_STACK_SIZE,
+                                            &task, (CONFIG_FMB_PORT_TASK_PRIO - 1), NULL));
+    for (int i = 0; i < TEST_REPLACE_COUNT; i++) {
+        TEST_ASSERT_EQUAL(MB_ENOERR, mb_set_handler(&descriptor, TEST_FUNC_CODE,
+                                                    (i & 1) ? test_handler_a : test_handler_b));
+        if (!(i % TEST_YIELD_COUNT)) {
+            vTaskDelay(1);
+        }
+    }
+    atomic_store(&task.stop, true);
+    TEST_ASSERT_TRUE(xSemaphoreTake(task.done_sema, pdMS_TO_TICKS(TEST_DONE_TOUT_MS)));
+    vSemaphoreDelete(task.done_sema);
+    ESP_LOGI(TAG, "replacements: %d, lookups: %d", TEST_REPLACE_COUNT, task.lookups);
+    TEST_ASSERT_EQUAL(0, task.errors);
+    TEST_ASSERT_TRUE(task.lookups > 0);
+    TEST_ASSERT_EQUAL(1, descriptor.count);
+}
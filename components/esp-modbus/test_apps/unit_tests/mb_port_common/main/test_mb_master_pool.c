@@ -0,0 +1,408 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "sdkconfig.h"
+#include "esp_modbus_master.h"
+#include "esp_modbus_slave.h"
+#include "esp_modbus_master_pool.h"
+#include "mbc_master.h"
+
+#if (CONFIG_FMB_COMM_MODE_TCP_EN && CONFIG_FMB_CONTROLLER_POOL_ENABLE)
+
+#define TAG "MB_MASTER_POOL_TEST"
+
+// Each master is the client of its own slave and stands for the bus with one slave
+#define TEST_TCP_PORT_NUM 1502
+#define TEST_BUS_COUNT 2
+#define TEST_BUS_MAX 3
+#define TEST_BUS_DELAY_MS 20
+#define TEST_IP_STR_SIZE 24
+#define TEST_REG_COUNT 32
+#define TEST_RESPOND_TOUT_MS 1000
+#define TEST_CONNECT_DELAY_MS 500
+#define TEST_DONE_TOUT_MS 30000
+#define TEST_ASYNC_COUNT 40
+#define TEST_PARAM_COUNT (sizeof(test_descriptors) / sizeof(test_descriptors[0]))
+#define TEST_CID_UNKNOWN 100
+
+static uint16_t holding_regs[TEST_REG_COUNT];
+
+static const uint8_t test_bus_addrs[TEST_BUS_MAX][1] = {{1}, {2}, {3}};
+
+static const mb_parameter_descriptor_t test_descriptors[] = {
+    {0, "hold_reg-0", "Data", 1, MB_PARAM_HOLDING, 0, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+    {1, "hold_reg-1", "Data", 2, MB_PARAM_HOLDING, 1, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+    {2, "hold_reg-10", "Data", 1, MB_PARAM_HOLDING, 10, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+    {3, "hold_reg-20", "Data", 2, MB_PARAM_HOLDING, 20, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+};
+
+// The characteristic per bus for the throughput of the buses
+static const mb_parameter_descriptor_t test_bus_descriptors[TEST_BUS_MAX] = {
+    {0, "bus_reg-0", "Data", 1, MB_PARAM_HOLDING, 0, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+    {1, "bus_reg-1", "Data", 2, MB_PARAM_HOLDING, 1, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+    {2, "bus_reg-2", "Data", 3, MB_PARAM_HOLDING, 2, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+};
+
+static mb_fn_handler_fp test_read_holding_handler = NULL;
+
+typedef struct {
+    uint16_t bus_count;
+    void *slave_handles[TEST_BUS_MAX];
+    void *master_handles[TEST_BUS_MAX];
+    void *pool_handle;
+} test_pool_env_t;
+
+typedef struct {
+    atomic_int done;
+    atomic_int errors;
+    SemaphoreHandle_t done_sema;
+} test_async_state_t;
+
+static void test_network_init(void)
+{
+    esp_err_t err = esp_netif_init();
+    TEST_ASSERT_TRUE((err == ESP_OK) || (err == ESP_ERR_INVALID_STATE));
+    err = esp_event_loop_create_default();
+    TEST_ASSERT_TRUE((err == ESP_OK) || (err == ESP_ERR_INVALID_STATE));
+}
+
+static void *test_slave_start(uint16_t port)
+{
+    void *slave_handle = NULL;
+    for (int i = 0; i < TEST_REG_COUNT; i++) {
+        holding_regs[i] = 0x2200 + i;
+    }
+    mb_communication_info_t slave_comm = {
+        .tcp_opts.mode = MB_TCP,
+        .tcp_opts.port = port,
+        .tcp_opts.uid = 1,
+        .tcp_opts.addr_type = MB_IPV4,
+        .tcp_opts.ip_addr_table = (void *)"127.0.0.1",
+        .tcp_opts.response_tout_ms = TEST_RESPOND_TOUT_MS
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_create_tcp(&slave_comm, &slave_handle));
+    mb_register_area_descriptor_t area = {
+        .type = MB_PARAM_HOLDING,
+        .start_offset = 0,
+        .address = (void *)holding_regs,
+        .size = sizeof(holding_regs)
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_set_descriptor(slave_handle, area));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_start(slave_handle));
+    return slave_handle;
+}
+
+// The slave of the bus answers the read of the registers after the delay
+static mb_exception_t test_read_holding_slow(void *inst, uint8_t *frame_ptr, uint16_t *len_buf)
+{
+    vTaskDelay(pdMS_TO_TICKS(TEST_BUS_DELAY_MS));
+    return test_read_holding_handler(inst, frame_ptr, len_buf);
+}
+
+// Starts the slave and the master of each bus and the pool, the table is not set
+static void test_pool_create(test_pool_env_t *env, uint16_t bus_count)
+{
+    static char ip_strs[TEST_BUS_MAX][TEST_IP_STR_SIZE];
+    static char *ip_tables[TEST_BUS_MAX][2];
+    mb_master_pool_bus_t buses[TEST_BUS_MAX] = {0};
+
+    test_network_init();
+    env->bus_count = bus_count;
+    for (int i = 0; i < bus_count; i++) {
+        env->slave_handles[i] = test_slave_start(TEST_TCP_PORT_NUM + i);
+    }
+    vTaskDelay(pdMS_TO_TICKS(TEST_CONNECT_DELAY_MS));
+    for (int i = 0; i < bus_count; i++) {
+        snprintf(ip_strs[i], TEST_IP_STR_SIZE, "%02u;127.0.0.1;%u", (unsigned)test_bus_addrs[i][0],
+                    (unsigned)(TEST_TCP_PORT_NUM + i));
+        ip_tables[i][0] = ip_strs[i];
+        ip_tables[i][1] = NULL;
+        mb_communication_info_t master_comm = {
+            .tcp_opts.mode = MB_TCP,
+            .tcp_opts.port = TEST_TCP_PORT_NUM + i,
+            .tcp_opts.addr_type = MB_IPV4,
+            .tcp_opts.ip_addr_table = (void *)ip_tables[i],
+            .tcp_opts.response_tout_ms = TEST_RESPOND_TOUT_MS
+        };
+        env->master_handles[i] = NULL;
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_master_create_tcp(&master_comm, &env->master_handles[i]));
+        buses[i] = (mb_master_pool_bus_t){.master_handle = env->master_handles[i],
+                                            .slave_addrs = test_bus_addrs[i], .slave_count = 1};
+    }
+    mb_master_pool_config_t config = {.buses = buses, .bus_count = bus_count};
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_create(&config, &env->pool_handle));
+}
+
+// The pool splits the table between the masters, the TCP master needs its part to start
+static void test_pool_start(test_pool_env_t *env, uint16_t bus_count,
+                            const mb_parameter_descriptor_t *descriptors, uint16_t num_elements)
+{
+    test_pool_create(env, bus_count);
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_set_descriptor(env->pool_handle, descriptors, num_elements));
+    for (int i = 0; i < bus_count; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_master_start(env->master_handles[i]));
+    }
+}
+
+static void test_pool_stop(test_pool_env_t *env)
+{
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_delete(env->pool_handle));
+    for (int i = 0; i < env->bus_count; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_master_delete(env->master_handles[i]));
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(env->slave_handles[i]));
+    }
+}
+
+static void test_async_done(void *arg, esp_err_t error)
+{
+    test_async_state_t *state = (test_async_state_t *)arg;
+    if (error != ESP_OK) {
+        atomic_fetch_add(&state->errors, 1);
+    }
+    if (atomic_fetch_add(&state->done, 1) == (TEST_ASYNC_COUNT - 1)) {
+        xSemaphoreGive(state->done_sema);
+    }
+}
+
+// Sends the reads to the buses in turn, returns the number of the requests rejected by the full queues
+static int test_pool_read_async(test_pool_env_t *env, uint16_t (*data)[4], test_async_state_t *state)
+{
+    int rejected = 0;
+    for (int i = 0; i < TEST_ASYNC_COUNT; i++) {
+        mb_param_request_t request = {.slave_addr = test_bus_addrs[i % env->bus_count][0], .command = 0x03,
+                                        .reg_start = i % (TEST_REG_COUNT - 4), .reg_size = 4};
+        esp_err_t err = mbc_master_pool_send_request_async(env->pool_handle, &request, data[i], test_async_done, state);
+        // The full queue of the bus rejects the request, it is sent again when the queue moves
+        while (err == ESP_ERR_NO_MEM) {
+            rejected++;
+            vTaskDelay(1);
+            err = mbc_master_pool_send_request_async(env->pool_handle, &request, data[i], test_async_done, state);
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+    }
+    return rejected;
+}
+
+TEST_CASE("Test master pool routes the requests and characteristics to the buses.", "[MB_MASTER_POOL]")
+{
+    test_pool_env_t env = {0};
+    uint16_t data[TEST_REG_COUNT] = {0};
+    uint16_t values[TEST_PARAM_COUNT + 1] = {0};
+    mb_param_poll_t params[TEST_PARAM_COUNT + 1];
+    uint8_t type = 0;
+
+    static const uint8_t dup_addrs[] = {1, 1};
+    mb_master_pool_bus_t dup_bus = {.master_handle = (void *)&env, .slave_addrs = dup_addrs, .slave_count = 2};
+    mb_master_pool_config_t dup_config = {.buses = &dup_bus, .bus_count = 1};
+    void *dup_handle = NULL;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, mbc_master_pool_create(&dup_config, &dup_handle));
+
+    test_pool_start(&env, TEST_BUS_COUNT, test_descriptors, TEST_PARAM_COUNT);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, mbc_master_pool_set_descriptor(env.pool_handle, test_descriptors, TEST_PARAM_COUNT));
+
+    for (uint8_t addr = 1; addr <= TEST_BUS_COUNT; addr++) {
+        mb_param_request_t request = {.slave_addr = addr, .command = 0x03, .reg_start = addr, .reg_size = 8};
+        memset(data, 0, sizeof(data));
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_send_request(env.pool_handle, &request, data));
+        TEST_ASSERT_EQUAL_HEX16_ARRAY(&holding_regs[addr], data, 8);
+    }
+    mb_param_request_t request = {.slave_addr = 3, .command = 0x03, .reg_start = 0, .reg_size = 1};
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, mbc_master_pool_send_request(env.pool_handle, &request, data));
+
+    for (int i = 0; i < TEST_PARAM_COUNT; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_get_parameter(env.pool_handle, i, (uint8_t *)&values[i], &type));
+        TEST_ASSERT_EQUAL(PARAM_TYPE_U16, type);
+        TEST_ASSERT_EQUAL_HEX16(holding_regs[test_descriptors[i].mb_reg_start], values[i]);
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, mbc_master_pool_get_parameter(env.pool_handle, TEST_CID_UNKNOWN,
+                                                                        (uint8_t *)&values[0], &type));
+    values[0] = 0x5AA5;
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_set_parameter(env.pool_handle, 3, (uint8_t *)&values[0], &type));
+    TEST_ASSERT_EQUAL_HEX16(0x5AA5, holding_regs[test_descriptors[3].mb_reg_start]);
+
+    // The set is read by both buses, the unknown characteristic does not stop the others
+    for (int i = 0; i <= TEST_PARAM_COUNT; i++) {
+        values[i] = 0;
+        params[i] = (mb_param_poll_t){.cid = (i < TEST_PARAM_COUNT) ? (TEST_PARAM_COUNT - 1 - i) : TEST_CID_UNKNOWN,
+                                        .value = (uint8_t *)&values[i]};
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, mbc_master_pool_get_parameters(env.pool_handle, params, TEST_PARAM_COUNT + 1));
+    for (int i = 0; i < TEST_PARAM_COUNT; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, params[i].error);
+        TEST_ASSERT_EQUAL(PARAM_TYPE_U16, params[i].type);
+        TEST_ASSERT_EQUAL_HEX16(holding_regs[test_descriptors[params[i].cid].mb_reg_start], values[i]);
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, params[TEST_PARAM_COUNT].error);
+
+#if CONFIG_FMB_PORT_STATS_ENABLE
+    // Each bus counts its own requests, the pool adds them up
+    mb_stats_info_t info[TEST_BUS_COUNT + 1] = {0};
+    uint16_t count = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_get_stats(env.pool_handle, MB_STATS_NODE, info, TEST_BUS_COUNT + 1, &count));
+    TEST_ASSERT_EQUAL(TEST_BUS_COUNT, count);
+    uint32_t node_requests = info[0].requests + info[1].requests;
+    TEST_ASSERT_TRUE((info[0].key == 1) || (info[1].key == 1));
+    TEST_ASSERT_TRUE((info[0].key == 2) || (info[1].key == 2));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_get_stats(env.pool_handle, MB_STATS_TOTAL, info, 1, &count));
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL_UINT32(node_requests, info[0].requests);
+    uint32_t bus_requests = 0;
+    for (int i = 0; i < TEST_BUS_COUNT; i++) {
+        mb_stats_info_t bus_info = {0};
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_get_stats(env.master_handles[i], MB_STATS_TOTAL, &bus_info, 1, &count));
+        TEST_ASSERT_TRUE(bus_info.requests > 0);
+        bus_requests += bus_info.requests;
+    }
+    TEST_ASSERT_EQUAL_UINT32(bus_requests, info[0].requests);
+    TEST_ASSERT_EQUAL_UINT32(info[0].requests, info[0].latency_count);
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_reset_stats(env.pool_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_get_stats(env.pool_handle, MB_STATS_NODE, NULL, 0, &count));
+    TEST_ASSERT_EQUAL(0, count);
+#endif
+
+    test_pool_stop(&env);
+}
+
+TEST_CASE("Test master pool completes the asynchronous requests of all buses.", "[MB_MASTER_POOL]")
+{
+    test_pool_env_t env = {0};
+    uint16_t data[TEST_ASYNC_COUNT][4] = {0};
+    test_async_state_t state = {0};
+
+    test_pool_start(&env, TEST_BUS_COUNT, test_descriptors, TEST_PARAM_COUNT);
+    state.done_sema = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(state.done_sema);
+    int rejected = test_pool_read_async(&env, data, &state);
+    TEST_ASSERT_TRUE(xSemaphoreTake(state.done_sema, pdMS_TO_TICKS(TEST_DONE_TOUT_MS)));
+    TEST_ASSERT_EQUAL(0, atomic_load(&state.errors));
+    for (int i = 0; i < TEST_ASYNC_COUNT; i++) {
+        TEST_ASSERT_EQUAL_HEX16_ARRAY(&holding_regs[i % (TEST_REG_COUNT - 4)], data[i], 4);
+    }
+    ESP_LOGI(TAG, "requests: %d, rejected by the full queue: %d", TEST_ASYNC_COUNT, rejected);
+
+    // The read of the characteristic is completed by the bus of its slave
+    uint16_t value = 0;
+    atomic_store(&state.done, TEST_ASYNC_COUNT - 1);
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_get_parameter_async(env.pool_handle, 2, (uint8_t *)&value,
+                                                                    test_async_done, &state));
+    TEST_ASSERT_TRUE(xSemaphoreTake(state.done_sema, pdMS_TO_TICKS(TEST_DONE_TOUT_MS)));
+    TEST_ASSERT_EQUAL(0, atomic_load(&state.errors));
+    TEST_ASSERT_EQUAL_HEX16(holding_regs[test_descriptors[2].mb_reg_start], value);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, mbc_master_pool_set_parameter_async(env.pool_handle, TEST_CID_UNKNOWN,
+                                                                                (uint8_t *)&value, test_async_done, &state));
+
+    vSemaphoreDelete(state.done_sema);
+    test_pool_stop(&env);
+}
+
+TEST_CASE("Test master pool gives the masters their tables back when a bus rejects its part.", "[MB_MASTER_POOL]")
+{
+    test_pool_env_t env = {0};
+    // The third bus rejects the duplicated characteristic
+    const mb_parameter_descriptor_t wrong_descriptors[] = {
+        test_bus_descriptors[0], test_bus_descriptors[1], test_bus_descriptors[2], test_bus_descriptors[2]
+    };
+    const mb_parameter_descriptor_t own_descriptors[] = {test_descriptors[2]};
+
+    test_pool_create(&env, TEST_BUS_MAX);
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_set_descriptor(env.master_handles[0], own_descriptors, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, mbc_master_pool_set_descriptor(env.pool_handle, wrong_descriptors,
+                                                                            sizeof(wrong_descriptors) / sizeof(wrong_descriptors[0])));
+    mb_master_options_t *mbm_opts = MB_MASTER_GET_OPTS(env.master_handles[0]);
+    TEST_ASSERT_EQUAL_PTR(own_descriptors, mbm_opts->param_descriptor_table);
+    TEST_ASSERT_EQUAL(1, mbm_opts->mbm_param_descriptor_size);
+    TEST_ASSERT_EQUAL(0, mbc_master_index_get(mbm_opts, test_descriptors[2].cid));
+    mbm_opts = MB_MASTER_GET_OPTS(env.master_handles[1]);
+    TEST_ASSERT_NULL(mbm_opts->param_descriptor_table);
+    TEST_ASSERT_EQUAL(0, mbm_opts->mbm_param_descriptor_size);
+
+    // The table of the pool stays unset, so the correct table is accepted
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_set_descriptor(env.pool_handle, test_bus_descriptors, TEST_BUS_MAX));
+    for (int i = 0; i < TEST_BUS_MAX; i++) {
+        mbm_opts = MB_MASTER_GET_OPTS(env.master_handles[i]);
+        TEST_ASSERT_EQUAL(1, mbm_opts->mbm_param_descriptor_size);
+        TEST_ASSERT_EQUAL(test_bus_descriptors[i].cid, mbm_opts->param_descriptor_table[0].cid);
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_master_start(env.master_handles[i]));
+    }
+    uint16_t value = 0;
+    uint8_t type = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_get_parameter(env.pool_handle, test_bus_descriptors[2].cid,
+                                                            (uint8_t *)&value, &type));
+    TEST_ASSERT_EQUAL_HEX16(holding_regs[test_bus_descriptors[2].mb_reg_start], value);
+
+    // The deleted pool gives the masters their tables back as well
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_pool_delete(env.pool_handle));
+    mbm_opts = MB_MASTER_GET_OPTS(env.master_handles[0]);
+    TEST_ASSERT_EQUAL_PTR(own_descriptors, mbm_opts->param_descriptor_table);
+    TEST_ASSERT_EQUAL(1, mbm_opts->mbm_param_descriptor_size);
+    TEST_ASSERT_EQUAL(0, mbc_master_index_get(mbm_opts, test_descriptors[2].cid));
+    for (int i = 1; i < TEST_BUS_MAX; i++) {
+        mbm_opts = MB_MASTER_GET_OPTS(env.master_handles[i]);
+        TEST_ASSERT_NULL(mbm_opts->param_descriptor_table);
+        TEST_ASSERT_EQUAL(0, mbm_opts->mbm_param_descriptor_size);
+    }
+    for (int i = 0; i < TEST_BUS_MAX; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_master_delete(env.master_handles[i]));
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(env.slave_handles[i]));
+    }
+}
+
+TEST_CASE("Test master pool throughput grows with the number of buses.", "[MB_MASTER_POOL]")
+{
+    uint16_t data[TEST_ASYNC_COUNT][4] = {0};
+    int64_t times[TEST_BUS_MAX + 1] = {0};
+
+    for (uint16_t bus_count = 1; bus_count <= TEST_BUS_MAX; bus_count++) {
+        test_pool_env_t env = {0};
+        test_async_state_t state = {0};
+        test_pool_start(&env, bus_count, test_bus_descriptors, bus_count);
+        // Each slave takes the same time to answer, the buses wait for their slaves at the same time
+        for (int i = 0; i < bus_count; i++) {
+            TEST_ASSERT_EQUAL(ESP_OK, mbc_get_handler(env.slave_handles[i], 0x03, &test_read_holding_handler));
+            TEST_ASSERT_EQUAL(ESP_OK, mbc_set_handler(env.slave_handles[i], 0x03, test_read_holding_slow));
+        }
+        state.done_sema = xSemaphoreCreateBinary();
+        TEST_ASSERT_NOT_NULL(state.done_sema);
+        int64_t start = esp_timer_get_time();
+        (void)test_pool_read_async(&env, data, &state);
+        TEST_ASSERT_TRUE(xSemaphoreTake(state.done_sema, pdMS_TO_TICKS(TEST_DONE_TOUT_MS)));
+        times[bus_count] = esp_timer_get_time() - start;
+        TEST_ASSERT_EQUAL(0, atomic_load(&state.errors));
+        for (int i = 0; i < TEST_ASYNC_COUNT; i++) {
+            TEST_ASSERT_EQUAL_HEX16_ARRAY(&holding_regs[i % (TEST_REG_COUNT - 4)], data[i], 4);
+        }
+        ESP_LOGI(TAG, "buses: %u, requests: %d, time: %" PRId64 " ms, %" PRId64 " requests/s", (unsigned)bus_count,
+                    TEST_ASYNC_COUNT, times[bus_count] / 1000, (TEST_ASYNC_COUNT * 1000000LL) / times[bus_count]);
+        vSemaphoreDelete(state.done_sema);
+        test_pool_stop(&env);
+        // The time of one bus is split by the buses, the margin is the half of the time per bus
+        TEST_ASSERT_LESS_THAN(times[1] * 3 / (2 * bus_count) + 1, times[bus_count]);
+    }
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_log.h"
+
+#include "sdkconfig.h"
+#include "port_common.h"
+#include "mb_pool.h"
+
+#define TAG "MB_POOL_TEST"
+
+#define TEST_BLOCK_SIZE 20
+#define TEST_BLOCK_COUNT 4
+#define TEST_QUEUE_LEN 8
+#define TEST_FRAME_LEN 12
+
+MB_POOL_DEFINE_STATIC(test_pool, TEST_BLOCK_SIZE, TEST_BLOCK_COUNT);
+
+TEST_CASE("Test fixed block pool allocation and heap fallback.", "[MB_POOL]")
+{
+    void *blocks[TEST_BLOCK_COUNT + 1] = {0};
+    mb_pool_stats_t initial = {0};
+    mb_pool_stats_t stats = {0};
+
+    mb_pool_get_stats(&test_pool, &initial);
+
+    for (int i = 0; i < (TEST_BLOCK_COUNT + 1); i++) {
+        blocks[i] = mb_pool_alloc(&test_pool, TEST_BLOCK_SIZE);
+        TEST_ASSERT_NOT_NULL(blocks[i]);
+        memset(blocks[i], i, TEST_BLOCK_SIZE);
+    }
+    mb_pool_get_stats(&test_pool, &stats);
+#if CONFIG_FMB_PORT_POOL_ENABLE
+    TEST_ASSERT_EQUAL_UINT32(MB_POOL_ALIGN(TEST_BLOCK_SIZE), stats.block_size);
+    TEST_ASSERT_EQUAL_UINT32(TEST_BLOCK_COUNT, stats.used);
+    TEST_ASSERT_EQUAL_UINT32(TEST_BLOCK_COUNT, stats.high_water);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.heap_used);
+    for (int i = 0; i < TEST_BLOCK_COUNT; i++) {
+        TEST_ASSERT_TRUE(mb_pool_is_owner(&test_pool, blocks[i]));
+    }
+    TEST_ASSERT_FALSE(mb_pool_is_owner(&test_pool, blocks[TEST_BLOCK_COUNT]));
+#endif
+    // The buffer bigger than block is always allocated from heap
+    void *big = mb_pool_alloc(&test_pool, TEST_BLOCK_SIZE * 2);
+    TEST_ASSERT_NOT_NULL(big);
+    TEST_ASSERT_FALSE(mb_pool_is_owner(&test_pool, big));
+    mb_pool_free(&test_pool, big);
+
+    for (int i = 0; i < (TEST_BLOCK_COUNT + 1); i++) {
+        mb_pool_free(&test_pool, blocks[i]);
+    }
+    mb_pool_free(&test_pool, NULL);
+    mb_pool_get_stats(&test_pool, &stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.used);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.heap_used);
+
+    // Freed blocks are reused, the high water mark is kept
+    void *block = mb_pool_alloc(&test_pool, 1);
+    TEST_ASSERT_NOT_NULL(block);
+    mb_pool_free(&test_pool, block);
+    mb_pool_get_stats(&test_pool, &stats);
+#if CONFIG_FMB_PORT_POOL_ENABLE
+    TEST_ASSERT_EQUAL_UINT32(TEST_BLOCK_COUNT, stats.high_water);
+    TEST_ASSERT_EQUAL_UINT32(initial.heap_allocs + 2, stats.heap_allocs);
+#else
+    TEST_ASSERT_EQUAL_UINT32(initial.heap_allocs + TEST_BLOCK_COUNT + 3, stats.heap_allocs);
+#endif
+}
+
+TEST_CASE("Test frame queue does not use heap in steady state.", "[MB_POOL]")
+{
+    uint8_t frame[TEST_FRAME_LEN] = {0};
+    uint8_t data[TEST_FRAME_LEN] = {0};
+    mb_pool_stats_t before = {0};
+    mb_pool_stats_t after = {0};
+
+    QueueHandle_t queue = queue_create(TEST_QUEUE_LEN);
+    TEST_ASSERT_NOT_NULL(queue);
+    mb_port_frame_get_stats(&before);
+    for (int cycle = 0; cycle < 100; cycle++) {
+        for (int i = 0; i < TEST_QUEUE_LEN; i++) {
+            frame[0] = (uint8_t)i;
+            TEST_ASSERT_EQUAL(ESP_OK, queue_push(queue, frame, sizeof(frame), NULL));
+        }
+        for (int i = 0; i < TEST_QUEUE_LEN; i++) {
+            TEST_ASSERT_EQUAL(TEST_FRAME_LEN, queue_pop(queue, data, sizeof(data), NULL));
+            TEST_ASSERT_EQUAL_UINT8(i, data[0]);
+        }
+    }
+    // The frames are owned by the caller when the frame entry is requested
+    frame_entry_t entry = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, queue_push(queue, frame, sizeof(frame), NULL));
+    TEST_ASSERT_EQUAL(TEST_FRAME_LEN, queue_pop(queue, NULL, sizeof(data), &entry));
+    TEST_ASSERT_NOT_NULL(entry.buf);
+    mb_port_frame_free(entry.buf);
+    TEST_ASSERT_EQUAL(ESP_OK, queue_push(queue, frame, sizeof(frame), NULL));
+    queue_delete(queue);
+    mb_port_frame_get_stats(&after);
+    TEST_ASSERT_EQUAL_UINT32(before.used, after.used);
+#if CONFIG_FMB_PORT_POOL_ENABLE
+    TEST_ASSERT_EQUAL_UINT32(before.heap_allocs, after.heap_allocs);
+#endif
+    ESP_LOGI(TAG, "frame pool: block size: %" PRIu32 ", blocks: %" PRIu32 ", high water: %" PRIu32 ", heap allocations: %" PRIu32,
+                after.block_size, after.block_count, after.high_water, after.heap_allocs);
+}
@@ -0,0 +1,294 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "driver/uart.h"
+
+#include "sdkconfig.h"
+#include "port_common.h"
+#include "port_serial_common.h"
+#include "mb_stats.h"
+
+#if CONFIG_FMB_COMM_MODE_RTU_EN
+
+#define TAG "MB_PORT_SERIAL_TEST"
+
+#define TEST_UART_PORT (UART_NUM_1)
+#define TEST_UART_BUF_SIZE (MB_BUFFER_SIZE * 2)
+#define TEST_T35_TICKS (35)
+#define TEST_IDLE_TOUT_MS (1000)
+#define TEST_FRAME_SIZE (8)
+
+// The UART driver functions are wrapped by the linker (see CMakeLists.txt), the wrappers of
+// the test port serve the bytes put by the test, the other ports use the real driver.
+esp_err_t __real_uart_driver_install(uart_port_t uart_num, int rx_buffer_size, int tx_buffer_size,
+                                        int queue_size, QueueHandle_t *uart_queue, int intr_alloc_flags);
+esp_err_t __real_uart_get_buffered_data_len(uart_port_t uart_num, size_t *size);
+int __real_uart_read_bytes(uart_port_t uart_num, void *buf, uint32_t length, TickType_t ticks_to_wait);
+esp_err_t __real_uart_flush_input(uart_port_t uart_num);
+int __real_uart_write_bytes(uart_port_t uart_num, const void *src, size_t size);
+esp_err_t __real_uart_wait_tx_done(uart_port_t uart_num, TickType_t ticks_to_wait);
+
+typedef struct {
+    _lock_t lock;
+    bool is_active;
+    QueueHandle_t queue;                // the event queue of the port task
+    uint8_t data[TEST_UART_BUF_SIZE];   // the received bytes not read by the port yet
+    size_t rd_pos;
+    size_t wr_pos;
+    mb_port_base_t *flush_port;         // the port is flushed from the next read of the port task
+    bool is_flushed;
+    int written;
+} test_uart_t;
+
+static test_uart_t test_uart;
+
+static bool test_uart_is_stub(uart_port_t uart_num)
+{
+    return (test_uart.is_active && (uart_num == TEST_UART_PORT));
+}
+
+esp_err_t __wrap_uart_driver_install(uart_port_t uart_num, int rx_buffer_size, int tx_buffer_size,
+                                        int queue_size, QueueHandle_t *uart_queue, int intr_alloc_flags)
+{
+    esp_err_t err = __real_uart_driver_install(uart_num, rx_buffer_size, tx_buffer_size,
+                                                queue_size, uart_queue, intr_alloc_flags);
+    if (test_uart_is_stub(uart_num) && uart_queue) {
+        test_uart.queue = *uart_queue;
+    }
+    return err;
+}
+
+esp_err_t __wrap_uart_get_buffered_data_len(uart_port_t uart_num, size_t *size)
+{
+    if (!test_uart_is_stub(uart_num)) {
+        return __real_uart_get_buffered_data_len(uart_num, size);
+    }
+    CRITICAL_SECTION(test_uart.lock) {
+        *size = test_uart.wr_pos - test_uart.rd_pos;
+    }
+    return ESP_OK;
+}
+
+int __wrap_uart_read_bytes(uart_port_t uart_num, void *buf, uint32_t length, TickType_t ticks_to_wait)
+{
+    if (!test_uart_is_stub(uart_num)) {
+        return __real_uart_read_bytes(uart_num, buf, length, ticks_to_wait);
+    }
+    size_t count = 0;
+    mb_port_base_t *flush_port = NULL;
+    CRITICAL_SECTION(test_uart.lock) {
+        count = ((test_uart.wr_pos - test_uart.rd_pos) < length) ? (test_uart.wr_pos - test_uart.rd_pos) : length;
+        memcpy(buf, &test_uart.data[test_uart.rd_pos], count);
+        test_uart.rd_pos += count;
+        flush_port = test_uart.flush_port;
+        test_uart.flush_port = NULL;
+    }
+    // The request sent by other task flushes the port while the bytes are copied to the slot
+    if (flush_port) {
+        uint8_t request[TEST_FRAME_SIZE] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x01, 0x84, 0x0A};
+        test_uart.is_flushed = mb_port_ser_send_data(flush_port, request, sizeof(request));
+    }
+    return (int)count;
+}
+
+esp_err_t __wrap_uart_flush_input(uart_port_t uart_num)
+{
+    if (!test_uart_is_stub(uart_num)) {
+        return __real_uart_flush_input(uart_num);
+    }
+    CRITICAL_SECTION(test_uart.lock) {
+        test_uart.rd_pos = 0;
+        test_uart.wr_pos = 0;
+    }
+    return ESP_OK;
+}
+
+int __wrap_uart_write_bytes(uart_port_t uart_num, const void *src, size_t size)
+{
+    if (!test_uart_is_stub(uart_num)) {
+        return __real_uart_write_bytes(uart_num, src, size);
+    }
+    test_uart.written += (int)size;
+    return (int)size;
+}
+
+esp_err_t __wrap_uart_wait_tx_done(uart_port_t uart_num, TickType_t ticks_to_wait)
+{
+    if (!test_uart_is_stub(uart_num)) {
+        return __real_uart_wait_tx_done(uart_num, ticks_to_wait);
+    }
+    return ESP_OK;
+}
+
+// Waits while the port task reads the bytes and handles the events
+static void test_uart_wait_idle(void)
+{
+    size_t count = 0;
+    int64_t start = esp_timer_get_time();
+    do {
+        vTaskDelay(1);
+        CRITICAL_SECTION(test_uart.lock) {
+            count = test_uart.wr_pos - test_uart.rd_pos;
+        }
+        TEST_ASSERT_TRUE((esp_timer_get_time() - start) < (TEST_IDLE_TOUT_MS * 1000));
+    } while (count || uxQueueMessagesWaiting(test_uart.queue));
+    vTaskDelay(1);
+}
+
+// Puts the bytes into the UART buffer and sends the data event to the port task,
+// the RX timeout of the event ends the frame
+static void test_uart_receive(const uint8_t *data, size_t length, bool is_timeout)
+{
+    test_uart_wait_idle();
+    CRITICAL_SECTION(test_uart.lock) {
+        TEST_ASSERT_TRUE((test_uart.wr_pos + length) <= TEST_UART_BUF_SIZE);
+        memcpy(&test_uart.data[test_uart.wr_pos], data, length);
+        test_uart.wr_pos += length;
+    }
+    uart_event_t event = {.type = UART_DATA, .size = length, .timeout_flag = is_timeout};
+    TEST_ASSERT_EQUAL(pdTRUE, xQueueSend(test_uart.queue, &event, portMAX_DELAY));
+    test_uart_wait_idle();
+}
+
+static mb_port_base_t *test_port_create(void)
+{
+    mb_port_base_t port_descr = {0};
+    mb_port_base_t *port = &port_descr;
+    mb_serial_opts_t ser_opts = {
+        .mode = MB_RTU,
+        .port = TEST_UART_PORT,
+        .uid = 1,
+        .baudrate = 115200,
+        .parity = UART_PARITY_DISABLE,
+        .data_bits = UART_DATA_8_BITS,
+        .stop_bits = UART_STOP_BITS_1
+    };
+    memset(&test_uart, 0, sizeof(test_uart));
+    CRITICAL_SECTION_INIT(test_uart.lock);
+    test_uart.is_active = true;
+    port_descr.descr.parent_name = "test_serial";
+    port_descr.descr.is_master = false;
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_port_ser_create(&ser_opts, &port));
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_port_timer_create(port, TEST_T35_TICKS));
+    TEST_ASSERT_EQUAL(MB_ENOERR, mb_port_event_create(port));
+    TEST_ASSERT_NOT_NULL(test_uart.queue);
+    mb_port_ser_enable(port);
+    return port;
+}
+
+static void test_port_delete(mb_port_base_t *port)
+{
+    mb_port_ser_disable(port);
+    mb_port_timer_delete(port);
+    mb_port_event_delete(port);
+    mb_port_ser_delete(port);
+    test_uart.is_active = false;
+    CRITICAL_SECTION_CLOSE(test_uart.lock);
+}
+
+// Takes the frame which is ready in the port, the frame stays in the slot of the port
+static uint8_t *test_port_take_frame(mb_port_base_t *port, uint16_t length)
+{
+    mb_event_t event = {0};
+    uint8_t *frame = NULL;
+    uint16_t frame_length = 0;
+    TEST_ASSERT_TRUE(mb_port_event_get(port, &event));
+    TEST_ASSERT_EQUAL(EV_FRAME_RECEIVED, event.event);
+    TEST_ASSERT_EQUAL(length, event.length);
+    TEST_ASSERT_TRUE(mb_port_ser_recv_data(port, &frame, &frame_length));
+    TEST_ASSERT_EQUAL(length, frame_length);
+    TEST_ASSERT_NOT_NULL(frame);
+    return frame;
+}
+
+static void test_frame_fill(uint8_t *frame, uint16_t length, uint8_t seed)
+{
+    for (uint16_t i = 0; i < length; i++) {
+        frame[i] = (uint8_t)(seed + i);
+    }
+}
+
+TEST_CASE("Test serial port skips the frame longer than the buffer and counts it.", "[MB_PORT_SERIAL]")
+{
+    uint8_t data[MB_BUFFER_SIZE] = {0};
+    uint8_t frame[TEST_FRAME_SIZE] = {0};
+    mb_port_base_t *port = test_port_create();
+
+    // The second part does not fit the slot, the rest of the frame is skipped up to the RX timeout
+    test_frame_fill(data, sizeof(data), 0x10);
+    test_uart_receive(data, MB_BUFFER_SIZE - TEST_FRAME_SIZE, false);
+    test_uart_receive(data, TEST_FRAME_SIZE + 1, false);
+    test_uart_receive(data, TEST_FRAME_SIZE, true);
+#if MB_STATS_ENABLED
+    mb_stats_info_t info = {0};
+    TEST_ASSERT_EQUAL(1, mb_stats_get(port->stats_obj, MB_STATS_TOTAL, &info, 1));
+    TEST_ASSERT_EQUAL(1, info.frame_errors);
+#endif
+
+    // The next frame is received from the start of the slot
+    test_frame_fill(frame, sizeof(frame), 0x80);
+    test_uart_receive(frame, sizeof(frame), true);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(frame, test_port_take_frame(port, sizeof(frame)), sizeof(frame));
+    test_port_delete(port);
+}
+
+TEST_CASE("Test serial port drops the bytes read while the port is flushed.", "[MB_PORT_SERIAL]")
+{
+    uint8_t stale[TEST_FRAME_SIZE / 2] = {0};
+    uint8_t frame[TEST_FRAME_SIZE] = {0};
+    mb_port_base_t *port = test_port_create();
+
+    // The bytes of the previous transaction are read when the request flushes the port
+    test_frame_fill(stale, sizeof(stale), 0xA0);
+    CRITICAL_SECTION(test_uart.lock) {
+        test_uart.flush_port = port;
+    }
+    test_uart_receive(stale, sizeof(stale), false);
+    TEST_ASSERT_TRUE(test_uart.is_flushed);
+    TEST_ASSERT_EQUAL(TEST_FRAME_SIZE, test_uart.written);
+
+    // The response does not get the stale bytes in front of it
+    test_frame_fill(frame, sizeof(frame), 0x20);
+    test_uart_receive(frame, sizeof(frame), true);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(frame, test_port_take_frame(port, sizeof(frame)), sizeof(frame));
+    test_port_delete(port);
+}
+
+TEST_CASE("Test serial port replaces the ready frame and keeps the frame used by the stack.", "[MB_PORT_SERIAL]")
+{
+    uint8_t frames[3][TEST_FRAME_SIZE] = {0};
+    mb_port_base_t *port = test_port_create();
+
+    for (int i = 0; i < 3; i++) {
+        test_frame_fill(frames[i], TEST_FRAME_SIZE, (uint8_t)(0x30 * (i + 1)));
+    }
+    test_uart_receive(frames[0], TEST_FRAME_SIZE, true);
+    uint8_t *held_frame = test_port_take_frame(port, TEST_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(frames[0], held_frame, TEST_FRAME_SIZE);
+
+    // The second frame is not taken, the third one takes its slot since the first one is held
+    test_uart_receive(frames[1], TEST_FRAME_SIZE, true);
+    test_uart_receive(frames[2], TEST_FRAME_SIZE, true);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(frames[0], held_frame, TEST_FRAME_SIZE);
+    mb_event_t event = {0};
+    TEST_ASSERT_TRUE(mb_port_event_get(port, &event));
+    TEST_ASSERT_EQUAL(EV_FRAME_RECEIVED, event.event);
+    uint8_t *ready_frame = test_port_take_frame(port, TEST_FRAME_SIZE);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(frames[2], ready_frame, TEST_FRAME_SIZE);
+    TEST_ASSERT_TRUE(ready_frame != held_frame);
+    test_port_delete(port);
+}
+
+#endif
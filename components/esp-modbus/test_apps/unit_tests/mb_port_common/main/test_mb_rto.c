@@ -0,0 +1,211 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_log.h"
+
+#include "sdkconfig.h"
+#include "mb_rto.h"
+
+#if MB_RTO_ENABLED
+
+#define TAG "MB_RTO_TEST"
+
+#define TEST_CEILING_MS 10000
+#define TEST_RTT_US 200000
+#define TEST_START_US 1000000ULL
+
+static uint32_t test_timeout(mb_rto_t *rto, uint8_t node, uint32_t ceiling_ms, uint64_t now_us)
+{
+    uint32_t tout_ms = 0;
+    TEST_ASSERT_TRUE(mb_rto_request(rto, node, ceiling_ms, now_us, &tout_ms));
+    return tout_ms;
+}
+
+// Feeds the same round trip time until the variation is below the granularity
+static void test_converge(mb_rto_t *rto, uint8_t node, uint32_t rtt_us, uint16_t frame_bytes, uint64_t now_us)
+{
+    for (int i = 0; i < 40; i++) {
+        (void)test_timeout(rto, node, TEST_CEILING_MS, now_us);
+        mb_rto_response(rto, node, MB_RTO_RESULT_RESPONSE, rtt_us, frame_bytes, now_us);
+    }
+}
+
+TEST_CASE("Test rto converges to the round trip time of the node.", "[MB_RTO]")
+{
+    mb_rto_t *rto = calloc(1, sizeof(mb_rto_t));
+    mb_rto_info_t info = {0};
+    TEST_ASSERT_NOT_NULL(rto);
+    // The frame takes 25.6 ms, the wire time of 100 bytes is excluded from the sample
+    mb_rto_init(rto, 100, 256);
+
+    // The ceiling is used until the node responds
+    TEST_ASSERT_EQUAL(TEST_CEILING_MS, test_timeout(rto, 1, TEST_CEILING_MS, TEST_START_US));
+    TEST_ASSERT_FALSE(mb_rto_get(rto, 2, TEST_CEILING_MS, TEST_START_US, &info));
+
+    // RFC 6298: the first sample sets the variation to the half of the time
+    mb_rto_response(rto, 1, MB_RTO_RESULT_RESPONSE, TEST_RTT_US + 10000, 100, TEST_START_US);
+    TEST_ASSERT_TRUE(mb_rto_get(rto, 1, TEST_CEILING_MS, TEST_START_US, &info));
+    TEST_ASSERT_EQUAL(1, info.samples);
+    TEST_ASSERT_EQUAL(TEST_RTT_US, info.srtt_us);
+    TEST_ASSERT_EQUAL(TEST_RTT_US / 2, info.rttvar_us);
+    TEST_ASSERT_EQUAL(200 + 400 + 26, info.timeout_ms);
+
+    // The variation decays, the timeout keeps the half of the round trip time above it
+    test_converge(rto, 1, TEST_RTT_US + 10000, 100, TEST_START_US);
+    TEST_ASSERT_TRUE(mb_rto_get(rto, 1, TEST_CEILING_MS, TEST_START_US, &info));
+    TEST_ASSERT_EQUAL(TEST_RTT_US, info.srtt_us);
+    TEST_ASSERT_LESS_THAN(250, info.rttvar_us);
+    TEST_ASSERT_EQUAL(200 + 100 + 26, info.timeout_ms);
+    TEST_ASSERT_EQUAL(200 + 100 + 26, test_timeout(rto, 1, TEST_CEILING_MS, TEST_START_US));
+
+    // The slower responses move the time and widen the variation
+    mb_rto_response(rto, 1, MB_RTO_RESULT_RESPONSE, (2 * TEST_RTT_US) + 10000, 100, TEST_START_US);
+    TEST_ASSERT_TRUE(mb_rto_get(rto, 1, TEST_CEILING_MS, TEST_START_US, &info));
+    TEST_ASSERT_EQUAL(TEST_RTT_US + (TEST_RTT_US / 8), info.srtt_us);
+    TEST_ASSERT_GREATER_OR_EQUAL(TEST_RTT_US / 4, info.rttvar_us);
+    TEST_ASSERT_GREATER_THAN(450, info.timeout_ms);
+
+    // The request without response does not take the node entry
+    mb_rto_response(rto, 2, MB_RTO_RESULT_RESPONSE, TEST_RTT_US, 0, TEST_START_US);
+    TEST_ASSERT_FALSE(mb_rto_get(rto, 2, TEST_CEILING_MS, TEST_START_US, &info));
+
+    // The port without adaptive timeouts always uses the ceiling
+    TEST_ASSERT_EQUAL(TEST_CEILING_MS, test_timeout(NULL, 1, TEST_CEILING_MS, TEST_START_US));
+    mb_rto_response(NULL, 1, MB_RTO_RESULT_TIMEOUT, 0, 0, TEST_START_US);
+    free(rto);
+}
+
+TEST_CASE("Test rto keeps the timeout between the floor and the ceiling.", "[MB_RTO]")
+{
+    mb_rto_t *rto = calloc(1, sizeof(mb_rto_t));
+    TEST_ASSERT_NOT_NULL(rto);
+    mb_rto_init(rto, 0, 0);
+
+    // The fast node gets the floor
+    test_converge(rto, 1, 100, 0, TEST_START_US);
+    TEST_ASSERT_EQUAL(CONFIG_FMB_MASTER_TIMEOUT_MS_FLOOR, test_timeout(rto, 1, TEST_CEILING_MS, TEST_START_US));
+
+    // The slow node gets the ceiling
+    test_converge(rto, 2, (TEST_CEILING_MS + 1000) * 1000, 0, TEST_START_US);
+    TEST_ASSERT_EQUAL(TEST_CEILING_MS, test_timeout(rto, 2, TEST_CEILING_MS, TEST_START_US));
+
+    // The ceiling wins if it is below the floor
+    TEST_ASSERT_EQUAL(CONFIG_FMB_MASTER_TIMEOUT_MS_FLOOR - 1,
+                        test_timeout(rto, 1, CONFIG_FMB_MASTER_TIMEOUT_MS_FLOOR - 1, TEST_START_US));
+
+    // The wire time is not subtracted below zero
+    mb_rto_init(rto, 1000, 10);
+    TEST_ASSERT_EQUAL(TEST_CEILING_MS, test_timeout(rto, 3, TEST_CEILING_MS, TEST_START_US));
+    mb_rto_response(rto, 3, MB_RTO_RESULT_RESPONSE, 1000, 100, TEST_START_US);
+    mb_rto_info_t info = {0};
+    TEST_ASSERT_TRUE(mb_rto_get(rto, 3, TEST_CEILING_MS, TEST_START_US, &info));
+    TEST_ASSERT_EQUAL(0, info.srtt_us);
+    TEST_ASSERT_EQUAL(CONFIG_FMB_MASTER_TIMEOUT_MS_FLOOR, info.timeout_ms);
+    free(rto);
+}
+
+TEST_CASE("Test rto backs off and quarantines the failing node.", "[MB_RTO]")
+{
+    mb_rto_t *rto = calloc(1, sizeof(mb_rto_t));
+    mb_rto_info_t info = {0};
+    uint32_t tout_ms = 0;
+    uint64_t now_us = TEST_START_US;
+    TEST_ASSERT_NOT_NULL(rto);
+    mb_rto_init(rto, 0, 0);
+    test_converge(rto, 1, TEST_RTT_US, 0, now_us);
+    uint32_t base_ms = test_timeout(rto, 1, TEST_CEILING_MS, now_us);
+    TEST_ASSERT_EQUAL(300, base_ms);
+
+    // The timeout is doubled after each consecutive timeout
+    for (int i = 1; i < CONFIG_FMB_MASTER_QUARANTINE_FAILS; i++) {
+        mb_rto_response(rto, 1, MB_RTO_RESULT_TIMEOUT, 0, 0, now_us);
+        uint32_t exp_ms = ((base_ms << i) < TEST_CEILING_MS) ? (base_ms << i) : TEST_CEILING_MS;
+        TEST_ASSERT_EQUAL(exp_ms, test_timeout(rto, 1, TEST_CEILING_MS, now_us));
+    }
+
+    // The node is quarantined, its requests fail without being sent
+    mb_rto_response(rto, 1, MB_RTO_RESULT_TIMEOUT, 0, 0, now_us);
+    TEST_ASSERT_TRUE(mb_rto_get(rto, 1, TEST_CEILING_MS, now_us, &info));
+    TEST_ASSERT_EQUAL(CONFIG_FMB_MASTER_QUARANTINE_FAILS, info.fails);
+    TEST_ASSERT_EQUAL(CONFIG_FMB_MASTER_QUARANTINE_MS, info.quarantine_ms);
+    TEST_ASSERT_FALSE(mb_rto_request(rto, 1, TEST_CEILING_MS, now_us + 1000, &tout_ms));
+    TEST_ASSERT_FALSE(mb_rto_request(rto, 1, TEST_CEILING_MS, now_us + (CONFIG_FMB_MASTER_QUARANTINE_MS * 1000ULL) - 1, &tout_ms));
+    // The other nodes are not affected
+    TEST_ASSERT_EQUAL(TEST_CEILING_MS, test_timeout(rto, 2, TEST_CEILING_MS, now_us));
+
+    // One probe request is sent after the quarantine, other requests wait for its outcome
+    now_us += CONFIG_FMB_MASTER_QUARANTINE_MS * 1000ULL;
+    tout_ms = test_timeout(rto, 1, TEST_CEILING_MS, now_us);
+    TEST_ASSERT_GREATER_OR_EQUAL(base_ms, tout_ms);
+    TEST_ASSERT_FALSE(mb_rto_request(rto, 1, TEST_CEILING_MS, now_us + 1000, &tout_ms));
+
+    // The failed probe doubles the quarantine
+    mb_rto_response(rto, 1, MB_RTO_RESULT_TIMEOUT, 0, 0, now_us);
+    TEST_ASSERT_TRUE(mb_rto_get(rto, 1, TEST_CEILING_MS, now_us, &info));
+    uint32_t exp_ms = ((CONFIG_FMB_MASTER_QUARANTINE_MS * 2) < CONFIG_FMB_MASTER_QUARANTINE_MAX_MS)
+                        ? (CONFIG_FMB_MASTER_QUARANTINE_MS * 2) : CONFIG_FMB_MASTER_QUARANTINE_MAX_MS;
+    TEST_ASSERT_EQUAL(exp_ms, info.quarantine_ms);
+
+    // The quarantine does not exceed the maximum
+    for (int i = 0; i < 20; i++) {
+        now_us += (uint64_t)CONFIG_FMB_MASTER_QUARANTINE_MAX_MS * 1000;
+        (void)test_timeout(rto, 1, TEST_CEILING_MS, now_us);
+        mb_rto_response(rto, 1, MB_RTO_RESULT_TIMEOUT, 0, 0, now_us);
+    }
+    TEST_ASSERT_TRUE(mb_rto_get(rto, 1, TEST_CEILING_MS, now_us, &info));
+    TEST_ASSERT_EQUAL(CONFIG_FMB_MASTER_QUARANTINE_MAX_MS, info.quarantine_ms);
+
+    // The response to the probe releases the node and restores the learned timeout
+    now_us += (uint64_t)CONFIG_FMB_MASTER_QUARANTINE_MAX_MS * 1000;
+    (void)test_timeout(rto, 1, TEST_CEILING_MS, now_us);
+    mb_rto_response(rto, 1, MB_RTO_RESULT_RESPONSE, TEST_RTT_US, 0, now_us);
+    TEST_ASSERT_TRUE(mb_rto_get(rto, 1, TEST_CEILING_MS, now_us, &info));
+    TEST_ASSERT_EQUAL(0, info.fails);
+    TEST_ASSERT_EQUAL(0, info.quarantine_ms);
+    TEST_ASSERT_EQUAL(base_ms, test_timeout(rto, 1, TEST_CEILING_MS, now_us + 1000));
+
+    // The broken response shows the node is alive, it resets the back-off without the sample
+    mb_rto_response(rto, 1, MB_RTO_RESULT_TIMEOUT, 0, 0, now_us);
+    mb_rto_response(rto, 1, MB_RTO_RESULT_FRAME_ERROR, 0, 0, now_us);
+    TEST_ASSERT_TRUE(mb_rto_get(rto, 1, TEST_CEILING_MS, now_us, &info));
+    TEST_ASSERT_EQUAL(0, info.fails);
+    TEST_ASSERT_EQUAL(base_ms, info.timeout_ms);
+    free(rto);
+}
+
+TEST_CASE("Test rto replaces the least recently used node.", "[MB_RTO]")
+{
+    mb_rto_t *rto = calloc(1, sizeof(mb_rto_t));
+    mb_rto_info_t info = {0};
+    TEST_ASSERT_NOT_NULL(rto);
+    mb_rto_init(rto, 0, 0);
+
+    for (int node = 1; node <= MB_RTO_NODES; node++) {
+        (void)test_timeout(rto, node, TEST_CEILING_MS, TEST_START_US + node);
+        mb_rto_response(rto, node, MB_RTO_RESULT_RESPONSE, TEST_RTT_US, 0, TEST_START_US + node);
+    }
+    // The first node is used again, so the second one is the least recently used
+    (void)test_timeout(rto, 1, TEST_CEILING_MS, TEST_START_US + 1000);
+    TEST_ASSERT_EQUAL(TEST_CEILING_MS, test_timeout(rto, 200, TEST_CEILING_MS, TEST_START_US + 1001));
+
+    TEST_ASSERT_TRUE(mb_rto_get(rto, 1, TEST_CEILING_MS, TEST_START_US, &info));
+    TEST_ASSERT_TRUE(mb_rto_get(rto, 200, TEST_CEILING_MS, TEST_START_US, &info));
+    TEST_ASSERT_EQUAL(0, info.samples);
+    if (MB_RTO_NODES > 1) {
+        TEST_ASSERT_FALSE(mb_rto_get(rto, 2, TEST_CEILING_MS, TEST_START_US, &info));
+        // The late response of the replaced node is ignored
+        mb_rto_response(rto, 2, MB_RTO_RESULT_TIMEOUT, 0, 0, TEST_START_US + 1002);
+        TEST_ASSERT_FALSE(mb_rto_get(rto, 2, TEST_CEILING_MS, TEST_START_US, &info));
+    }
+    free(rto);
+}
+
+#endif
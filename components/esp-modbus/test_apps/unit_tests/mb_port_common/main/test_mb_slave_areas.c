@@ -0,0 +1,392 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "sdkconfig.h"
+#include "esp_modbus_slave.h"
+#include "mbc_slave.h"
+
+#if (CONFIG_FMB_COMM_MODE_TCP_EN)
+
+#define TAG "MB_SLAVE_AREAS_TEST"
+
+#define TEST_TCP_PORT_NUM 1502
+#define TEST_SLAVE_UID 1
+#define TEST_AREA_REGS 2
+#define TEST_AREA_STEP 3
+#define TEST_AREA_COUNT_MAX 1000
+#define TEST_BENCH_LOOKUPS 10000
+#define TEST_PUBLISH_REGS 16
+#define TEST_PUBLISH_FRAMES 2000
+#define TEST_TASK_STACK_SIZE 4096
+#define TEST_DONE_TOUT_MS 10000
+
+static uint16_t test_area_regs[TEST_AREA_COUNT_MAX][TEST_AREA_REGS];
+
+static void *test_slave_create(void)
+{
+    void *slave_handle = NULL;
+    mb_communication_info_t slave_comm = {
+        .tcp_opts.mode = MB_TCP,
+        .tcp_opts.port = TEST_TCP_PORT_NUM,
+        .tcp_opts.uid = TEST_SLAVE_UID,
+        .tcp_opts.addr_type = MB_IPV4,
+        .tcp_opts.ip_addr_table = (void *)"127.0.0.1",
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_create_tcp(&slave_comm, &slave_handle));
+    return slave_handle;
+}
+
+// The areas are placed with the gap of one register and added in the order
+// different from the order of addresses (the count is not a multiple of 7)
+static void test_slave_add_areas(void *slave_handle, int count, mb_param_access_t access)
+{
+    for (int i = 0; i < count; i++) {
+        int index = (i * 7) % count;
+        mb_register_area_descriptor_t area = {
+            .type = MB_PARAM_HOLDING,
+            .start_offset = (uint16_t)(index * TEST_AREA_STEP),
+            .address = (void *)&test_area_regs[index][0],
+            .size = sizeof(test_area_regs[0]),
+            .access = access
+        };
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_set_descriptor(slave_handle, area));
+    }
+}
+
+TEST_CASE("Test slave finds the register areas by address.", "[MB_SLAVE_AREAS]")
+{
+    void *slave_handle = test_slave_create();
+    mb_base_t *inst = MB_SLAVE_GET_IFACE(slave_handle)->mb_base;
+    uint8_t reg_buffer[TEST_AREA_REGS * 2 * 2] = {0};
+    int count = 10;
+
+    test_slave_add_areas(slave_handle, count, MB_ACCESS_WO);
+    mb_slave_options_t *mbs_opts = MB_SLAVE_GET_OPTS(slave_handle);
+    TEST_ASSERT_EQUAL(count, mbs_opts->area_descriptors[MB_PARAM_HOLDING].count);
+    for (int i = 1; i < count; i++) {
+        TEST_ASSERT_TRUE(mbs_opts->area_descriptors[MB_PARAM_HOLDING].items[i - 1]->start_offset
+                            < mbs_opts->area_descriptors[MB_PARAM_HOLDING].items[i]->start_offset);
+    }
+
+    // The area is found if the registers are inside it (the write only area returns MB_EINVAL on read)
+    for (int i = 0; i < count; i++) {
+        uint16_t address = (uint16_t)(i * TEST_AREA_STEP) + 1; // the callback address is +1
+        TEST_ASSERT_EQUAL(MB_EINVAL, mbc_reg_holding_slave_cb(inst, reg_buffer, address, TEST_AREA_REGS, MB_REG_READ));
+        TEST_ASSERT_EQUAL(MB_EINVAL, mbc_reg_holding_slave_cb(inst, reg_buffer, address + 1, 1, MB_REG_READ));
+        TEST_ASSERT_EQUAL(MB_ENOREG, mbc_reg_holding_slave_cb(inst, reg_buffer, address + 1, 2, MB_REG_READ));
+        TEST_ASSERT_EQUAL(MB_ENOREG, mbc_reg_holding_slave_cb(inst, reg_buffer, address + 2, 1, MB_REG_READ));
+    }
+    TEST_ASSERT_EQUAL(MB_ENOREG, mbc_reg_input_slave_cb(inst, reg_buffer, 1, 1));
+
+    // The area fits the gap between two areas, the overlapped areas are rejected
+    mb_register_area_descriptor_t area = {
+        .type = MB_PARAM_HOLDING,
+        .start_offset = TEST_AREA_STEP - 1,
+        .address = (void *)&test_area_regs[0][0],
+        .size = sizeof(uint16_t),
+        .access = MB_ACCESS_RW
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_set_descriptor(slave_handle, area));
+    area.size = sizeof(test_area_regs[0]);
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, mbc_slave_set_descriptor(slave_handle, area));
+    area.start_offset = TEST_AREA_STEP + 1;
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, mbc_slave_set_descriptor(slave_handle, area));
+    area.start_offset = (TEST_AREA_STEP * 2) - 1;
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, mbc_slave_set_descriptor(slave_handle, area));
+    TEST_ASSERT_EQUAL(count + 1, mbs_opts->area_descriptors[MB_PARAM_HOLDING].count);
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+}
+
+TEST_CASE("Test slave area lookup cost for 10, 100, 1000 areas.", "[MB_SLAVE_AREAS]")
+{
+    const int counts[] = {10, 100, 1000};
+    uint8_t reg_buffer[TEST_AREA_REGS * 2] = {0};
+
+    for (int c = 0; c < (sizeof(counts) / sizeof(counts[0])); c++) {
+        void *slave_handle = test_slave_create();
+        mb_base_t *inst = MB_SLAVE_GET_IFACE(slave_handle)->mb_base;
+
+        int64_t start = esp_timer_get_time();
+        test_slave_add_areas(slave_handle, counts[c], MB_ACCESS_WO);
+        int64_t insert_time = esp_timer_get_time() - start;
+
+        start = esp_timer_get_time();
+        for (int i = 0; i < TEST_BENCH_LOOKUPS; i++) {
+            uint16_t address = (uint16_t)((i % counts[c]) * TEST_AREA_STEP) + 1;
+            TEST_ASSERT_EQUAL(MB_EINVAL, mbc_reg_holding_slave_cb(inst, reg_buffer, address, TEST_AREA_REGS, MB_REG_READ));
+        }
+        int64_t lookup_time = esp_timer_get_time() - start;
+        ESP_LOGI(TAG, "areas: %d, insert: %" PRId64 " ns/area, lookup: %" PRId64 " ns/op", counts[c],
+                    (insert_time * 1000) / counts[c], (lookup_time * 1000) / TEST_BENCH_LOOKUPS);
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+    }
+}
+
+typedef struct {
+    void *slave_handle;
+    SemaphoreHandle_t done_sema;
+    int errors;
+} test_publish_task_t;
+
+// Publishes the frames where all registers are equal to the frame number
+static void test_publish_task(void *arg)
+{
+    test_publish_task_t *task_ptr = (test_publish_task_t *)arg;
+    uint16_t frame[TEST_PUBLISH_REGS];
+
+    for (uint16_t n = 1; n <= TEST_PUBLISH_FRAMES; n++) {
+        for (int i = 0; i < TEST_PUBLISH_REGS; i++) {
+            frame[i] = n;
+        }
+        if (mbc_slave_publish(task_ptr->slave_handle, MB_PARAM_INPUT, 0, frame, sizeof(frame)) != ESP_OK) {
+            task_ptr->errors++;
+        }
+        if (!(n & 0x0F)) {
+            taskYIELD();
+        }
+    }
+    xSemaphoreGive(task_ptr->done_sema);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Test slave reads the consistent data of the published area.", "[MB_SLAVE_AREAS]")
+{
+    void *slave_handle = test_slave_create();
+    mb_base_t *inst = MB_SLAVE_GET_IFACE(slave_handle)->mb_base;
+    static uint16_t input_regs[TEST_PUBLISH_REGS] = {0};
+    static uint16_t holding_regs[TEST_PUBLISH_REGS] = {0};
+    uint16_t frame[TEST_PUBLISH_REGS] = {0};
+    uint8_t reg_buffer[TEST_PUBLISH_REGS * 2] = {0};
+    mb_param_info_t reg_info = {0};
+    // The slave is not started, the parameter info of reads is taken from the queue directly
+    QueueHandle_t info_queue = MB_SLAVE_GET_OPTS(slave_handle)->notification_queue_handle;
+
+    mb_register_area_descriptor_t area = {
+        .type = MB_PARAM_INPUT,
+        .start_offset = 0,
+        .address = (void *)input_regs,
+        .size = sizeof(input_regs),
+        .access = MB_ACCESS_RW
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_set_descriptor(slave_handle, area));
+    area.type = MB_PARAM_HOLDING;
+    area.address = (void *)holding_regs;
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_set_descriptor(slave_handle, area));
+
+    // Only the areas which master can not write are published
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, mbc_slave_enable_publish(slave_handle, MB_PARAM_HOLDING, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, mbc_slave_enable_publish(slave_handle, MB_PARAM_INPUT, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, mbc_slave_publish(slave_handle, MB_PARAM_INPUT, 0, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_enable_publish(slave_handle, MB_PARAM_INPUT, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, mbc_slave_publish(slave_handle, MB_PARAM_INPUT, 0, frame, 2));
+
+    // The read returns the last published frame (the callback address is +1)
+    for (uint16_t n = 1; n <= 3; n++) {
+        for (int i = 0; i < TEST_PUBLISH_REGS; i++) {
+            frame[i] = n;
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_publish(slave_handle, MB_PARAM_INPUT, 0, frame, sizeof(frame)));
+        TEST_ASSERT_EQUAL(MB_ENOERR, mbc_reg_input_slave_cb(inst, reg_buffer, 1, TEST_PUBLISH_REGS));
+        TEST_ASSERT_EQUAL(n, (reg_buffer[0] << 8) | reg_buffer[1]);
+        TEST_ASSERT_EQUAL(n, (reg_buffer[sizeof(reg_buffer) - 2] << 8) | reg_buffer[sizeof(reg_buffer) - 1]);
+        TEST_ASSERT_TRUE(xQueueReceive(info_queue, &reg_info, 0));
+        TEST_ASSERT_EQUAL_PTR(&input_regs[0], reg_info.address);
+    }
+
+    // The reads concurrent with the publishing task never see the registers of different frames
+    test_publish_task_t task = {.slave_handle = slave_handle, .done_sema = xSemaphoreCreateBinary()};
+    TEST_ASSERT_NOT_NULL(task.done_sema);
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(test_publish_task, "mb_test_task", TEST_TASK_STACK_SIZE,
+                                            &task, (CONFIG_FMB_PORT_TASK_PRIO - 1), NULL));
+    int torn = 0;
+    do {
+        TEST_ASSERT_EQUAL(MB_ENOERR, mbc_reg_input_slave_cb(inst, reg_buffer, 1, TEST_PUBLISH_REGS));
+        (void)xQueueReceive(info_queue, &reg_info, 0);
+        for (int i = 1; i < TEST_PUBLISH_REGS; i++) {
+            if ((reg_buffer[i * 2] != reg_buffer[0]) || (reg_buffer[(i * 2) + 1] != reg_buffer[1])) {
+                torn++;
+                break;
+            }
+        }
+    } while (!xSemaphoreTake(task.done_sema, 0));
+    vSemaphoreDelete(task.done_sema);
+    TEST_ASSERT_EQUAL(0, task.errors);
+    TEST_ASSERT_EQUAL(0, torn);
+    TEST_ASSERT_EQUAL(MB_ENOERR, mbc_reg_input_slave_cb(inst, reg_buffer, 1, TEST_PUBLISH_REGS));
+    TEST_ASSERT_EQUAL(TEST_PUBLISH_FRAMES, (reg_buffer[0] << 8) | reg_buffer[1]);
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+}
+
+#if CONFIG_FMB_CONTROLLER_SLAVE_RESPONSE_CACHE
+
+// Reads the holding registers and returns the value of the first register
+static uint16_t test_read_holding(mb_base_t *inst, QueueHandle_t info_queue, uint16_t address, uint16_t n_regs)
+{
+    uint8_t reg_buffer[TEST_PUBLISH_REGS * 2] = {0};
+    mb_param_info_t reg_info = {0};
+    TEST_ASSERT_EQUAL(MB_ENOERR, mbc_reg_holding_slave_cb(inst, reg_buffer, address, n_regs, MB_REG_READ));
+    (void)xQueueReceive(info_queue, &reg_info, 0);
+    return (uint16_t)((reg_buffer[0] << 8) | reg_buffer[1]);
+}
+
+TEST_CASE("Test slave answers the repeated reads from the response cache.", "[MB_SLAVE_AREAS]")
+{
+    void *slave_handle = test_slave_create();
+    mb_base_t *inst = MB_SLAVE_GET_IFACE(slave_handle)->mb_base;
+    QueueHandle_t info_queue = MB_SLAVE_GET_OPTS(slave_handle)->notification_queue_handle;
+    static uint16_t holding_regs[TEST_PUBLISH_REGS] = {0};
+    static uint16_t input_regs[TEST_PUBLISH_REGS] = {0};
+    uint8_t reg_buffer[TEST_PUBLISH_REGS * 2] = {0x12, 0x34};
+    mb_param_info_t reg_info = {0};
+    mb_cache_stats_t stats = {0};
+
+    mb_register_area_descriptor_t area = {
+        .type = MB_PARAM_HOLDING,
+        .start_offset = 0,
+        .address = (void *)holding_regs,
+        .size = sizeof(holding_regs),
+        .access = MB_ACCESS_RW
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_set_descriptor(slave_handle, area));
+    area.type = MB_PARAM_INPUT;
+    area.address = (void *)input_regs;
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_set_descriptor(slave_handle, area));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_enable_publish(slave_handle, MB_PARAM_INPUT, 0));
+
+    // The repeated request is a hit, the request with other count is a miss (the callback address is +1)
+    holding_regs[4] = 0x0102;
+    TEST_ASSERT_EQUAL_HEX16(0x0102, test_read_holding(inst, info_queue, 5, 4));
+    TEST_ASSERT_EQUAL_HEX16(0x0102, test_read_holding(inst, info_queue, 5, 4));
+    TEST_ASSERT_EQUAL_HEX16(0x0102, test_read_holding(inst, info_queue, 5, 2));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_get_cache_stats(slave_handle, &stats));
+    TEST_ASSERT_EQUAL(1, stats.hit_count);
+    TEST_ASSERT_EQUAL(2, stats.miss_count);
+
+    // The write of master drops the overlapped requests only
+    TEST_ASSERT_EQUAL_HEX16(0x0000, test_read_holding(inst, info_queue, 1, 2));
+    TEST_ASSERT_EQUAL(MB_ENOERR, mbc_reg_holding_slave_cb(inst, reg_buffer, 8, 1, MB_REG_WRITE));
+    (void)xQueueReceive(info_queue, &reg_info, 0);
+    TEST_ASSERT_EQUAL_HEX16(0x0102, test_read_holding(inst, info_queue, 5, 4));
+    TEST_ASSERT_EQUAL_HEX16(0x0000, test_read_holding(inst, info_queue, 1, 2));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_get_cache_stats(slave_handle, &stats));
+    TEST_ASSERT_EQUAL(2, stats.hit_count);
+    TEST_ASSERT_EQUAL(4, stats.miss_count);
+
+    // The update of application under the lock drops the cache
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_lock(slave_handle));
+    holding_regs[4] = 0x0304;
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_unlock(slave_handle));
+    TEST_ASSERT_EQUAL_HEX16(0x0304, test_read_holding(inst, info_queue, 5, 4));
+
+    // The published area is dropped from the cache
+    uint16_t frame[TEST_PUBLISH_REGS] = {0x0506};
+    TEST_ASSERT_EQUAL(MB_ENOERR, mbc_reg_input_slave_cb(inst, reg_buffer, 1, 1));
+    TEST_ASSERT_TRUE(xQueueReceive(info_queue, &reg_info, 0));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_publish(slave_handle, MB_PARAM_INPUT, 0, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL(MB_ENOERR, mbc_reg_input_slave_cb(inst, reg_buffer, 1, 1));
+    TEST_ASSERT_TRUE(xQueueReceive(info_queue, &reg_info, 0));
+    TEST_ASSERT_EQUAL_HEX16(0x0506, (reg_buffer[0] << 8) | reg_buffer[1]);
+    TEST_ASSERT_EQUAL_PTR(&input_regs[0], reg_info.address);
+
+    // Compare the time of the request answered from the cache and from the area
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < TEST_BENCH_LOOKUPS; i++) {
+        (void)test_read_holding(inst, info_queue, 1, TEST_PUBLISH_REGS);
+    }
+    int64_t hit_time = esp_timer_get_time() - start;
+    start = esp_timer_get_time();
+    for (int i = 0; i < TEST_BENCH_LOOKUPS; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_lock(slave_handle));
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_unlock(slave_handle));
+        (void)test_read_holding(inst, info_queue, 1, TEST_PUBLISH_REGS);
+    }
+    int64_t miss_time = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "registers: %d, hit: %" PRId64 " ns/op, miss: %" PRId64 " ns/op", TEST_PUBLISH_REGS,
+                (hit_time * 1000) / TEST_BENCH_LOOKUPS, (miss_time * 1000) / TEST_BENCH_LOOKUPS);
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+}
+
+#endif
+
+#if CONFIG_FMB_CONTROLLER_SLAVE_CHANGE_TRACKING
+
+TEST_CASE("Test slave collects the register writes into the changed ranges.", "[MB_SLAVE_AREAS]")
+{
+    void *slave_handle = test_slave_create();
+    mb_base_t *inst = MB_SLAVE_GET_IFACE(slave_handle)->mb_base;
+    uint8_t reg_buffer[TEST_AREA_REGS * 2] = {0x12, 0x34, 0x56, 0x78};
+    static uint16_t holding_regs[40] = {0};
+    static uint8_t coils[8] = {0};
+    mb_param_info_t changes[4] = {0};
+    uint16_t count = 0;
+
+    mb_register_area_descriptor_t area = {
+        .type = MB_PARAM_HOLDING,
+        .start_offset = 100,
+        .address = (void *)holding_regs,
+        .size = sizeof(holding_regs),
+        .access = MB_ACCESS_RW
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_set_descriptor(slave_handle, area));
+    area.type = MB_PARAM_COIL;
+    area.start_offset = 0;
+    area.address = (void *)coils;
+    area.size = sizeof(coils);
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_set_descriptor(slave_handle, area));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_get_changes(slave_handle, changes, 4, &count));
+    TEST_ASSERT_EQUAL(0, count);
+
+    // The repeated writes of the same registers are collapsed, the adjacent ranges are merged
+    // (the callback address is +1), the range crosses the word boundary of the bitmap
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL(MB_ENOERR, mbc_reg_holding_slave_cb(inst, reg_buffer, 101, 2, MB_REG_WRITE));
+    }
+    TEST_ASSERT_EQUAL(MB_ENOERR, mbc_reg_holding_slave_cb(inst, reg_buffer, 103, 1, MB_REG_WRITE));
+    TEST_ASSERT_EQUAL(MB_ENOERR, mbc_reg_holding_slave_cb(inst, reg_buffer, 131, 2, MB_REG_WRITE));
+    TEST_ASSERT_EQUAL(MB_ENOERR, mbc_reg_holding_slave_cb(inst, reg_buffer, 133, 2, MB_REG_WRITE));
+    TEST_ASSERT_EQUAL(MB_ENOERR, mbc_reg_coils_slave_cb(inst, reg_buffer, 3, 5, MB_REG_WRITE));
+    TEST_ASSERT_EQUAL_HEX16(0x1234, holding_regs[0]);
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_get_changes(slave_handle, changes, 2, &count));
+    TEST_ASSERT_EQUAL(2, count);
+    TEST_ASSERT_EQUAL(MB_EVENT_HOLDING_REG_WR, changes[0].type);
+    TEST_ASSERT_EQUAL(100, changes[0].mb_offset);
+    TEST_ASSERT_EQUAL(3, changes[0].size);
+    TEST_ASSERT_EQUAL_PTR(&holding_regs[0], changes[0].address);
+    TEST_ASSERT_EQUAL(130, changes[1].mb_offset);
+    TEST_ASSERT_EQUAL(4, changes[1].size);
+    TEST_ASSERT_EQUAL_PTR(&holding_regs[30], changes[1].address);
+
+    // The range which does not fit the array is returned by the next call
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_get_changes(slave_handle, changes, 4, &count));
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL(MB_EVENT_COILS_WR, changes[0].type);
+    TEST_ASSERT_EQUAL(2, changes[0].mb_offset);
+    TEST_ASSERT_EQUAL(5, changes[0].size);
+    TEST_ASSERT_EQUAL_PTR(&coils[0], changes[0].address);
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_get_changes(slave_handle, changes, 4, &count));
+    TEST_ASSERT_EQUAL(0, count);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, mbc_slave_get_changes(slave_handle, NULL, 4, &count));
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+}
+
+#endif
+
+#endif
@@ -0,0 +1,227 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "sdkconfig.h"
+#include "mb_stats.h"
+
+#if MB_STATS_ENABLED
+
+#define TAG "MB_STATS_TEST"
+
+#define TEST_TASK_COUNT 4
+#define TEST_TASK_LOOPS 1000
+#define TEST_TASK_STACK_SIZE 4096
+#define TEST_DONE_TOUT_MS 10000
+
+typedef struct {
+    mb_stats_t *stats;
+    uint16_t node;
+    SemaphoreHandle_t done_sema;
+} test_stats_task_t;
+
+static mb_stats_info_t *test_find(mb_stats_info_t *info, uint16_t count, uint16_t key)
+{
+    for (int i = 0; i < count; i++) {
+        if (info[i].key == key) {
+            return &info[i];
+        }
+    }
+    return NULL;
+}
+
+TEST_CASE("Test stats counts the transactions per node and function.", "[MB_STATS]")
+{
+    mb_stats_t *stats = calloc(1, sizeof(mb_stats_t));
+    mb_stats_info_t info[MB_STATS_FUNCS] = {0};
+    TEST_ASSERT_NOT_NULL(stats);
+
+    mb_stats_record(stats, 1, 0x03, MB_STATS_RESULT_OK, 5, 41, 2000);
+    mb_stats_record(stats, 1, 0x03, MB_STATS_RESULT_OK, 5, 41, 3000);
+    mb_stats_record(stats, 1, 0x10, MB_STATS_RESULT_EXCEPTION, 2, 10, 1000);
+    mb_stats_record(stats, 2, 0x83, MB_STATS_RESULT_TIMEOUT, 0, 5, 0);
+    mb_stats_record(stats, 2, 0x41, MB_STATS_RESULT_FRAME_ERROR, 0, 5, 0);
+    mb_stats_record(stats, MB_STATS_NO_NODE, MB_STATS_NO_FUNC, MB_STATS_RESULT_FRAME_ERROR, 0, 0, 0);
+    mb_stats_record(NULL, 1, 0x03, MB_STATS_RESULT_OK, 5, 41, 2000);
+
+    // The broken frame without function is counted in the total only
+    TEST_ASSERT_EQUAL(1, mb_stats_get(stats, MB_STATS_TOTAL, info, 1));
+    TEST_ASSERT_EQUAL_UINT32(5, info[0].requests);
+    TEST_ASSERT_EQUAL_UINT32(1, info[0].exceptions);
+    TEST_ASSERT_EQUAL_UINT32(1, info[0].timeouts);
+    TEST_ASSERT_EQUAL_UINT32(2, info[0].frame_errors);
+    TEST_ASSERT_EQUAL_UINT32(12, info[0].bytes_in);
+    TEST_ASSERT_EQUAL_UINT32(102, info[0].bytes_out);
+    TEST_ASSERT_EQUAL_UINT32(3, info[0].latency_count);
+    TEST_ASSERT_EQUAL_UINT32(3000, info[0].latency_max_us);
+
+    TEST_ASSERT_EQUAL(2, mb_stats_get(stats, MB_STATS_NODE, NULL, 0));
+    TEST_ASSERT_EQUAL(2, mb_stats_get(stats, MB_STATS_NODE, info, MB_STATS_FUNCS));
+    mb_stats_info_t *entry = test_find(info, 2, 1);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL_UINT32(3, entry->requests);
+    TEST_ASSERT_EQUAL_UINT32(1, entry->exceptions);
+    TEST_ASSERT_EQUAL_UINT32(3, entry->latency_count);
+    entry = test_find(info, 2, 2);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL_UINT32(2, entry->requests);
+    TEST_ASSERT_EQUAL_UINT32(1, entry->timeouts);
+    TEST_ASSERT_EQUAL_UINT32(1, entry->frame_errors);
+    TEST_ASSERT_EQUAL_UINT32(0, entry->latency_count);
+    TEST_ASSERT_EQUAL_UINT32(0, entry->latency_p99_us);
+
+    // The exception bit is ignored, the unknown functions share the last entry
+    uint16_t count = mb_stats_get(stats, MB_STATS_FUNC, info, MB_STATS_FUNCS);
+    TEST_ASSERT_EQUAL(3, count);
+    entry = test_find(info, count, 0x03);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL_UINT32(3, entry->requests);
+    TEST_ASSERT_EQUAL_UINT32(1, entry->timeouts);
+    entry = test_find(info, count, 0x10);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL_UINT32(1, entry->exceptions);
+    entry = test_find(info, count, MB_STATS_NO_FUNC);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL_UINT32(1, entry->frame_errors);
+
+    // The snapshot is limited by the size of the array
+    memset(info, 0, sizeof(info));
+    TEST_ASSERT_EQUAL(3, mb_stats_get(stats, MB_STATS_FUNC, info, 1));
+    TEST_ASSERT_NOT_EQUAL(0, info[0].requests);
+    TEST_ASSERT_EQUAL_UINT32(0, info[1].requests);
+
+    // The node entries are kept on reset, so the node can not take the second entry
+    mb_stats_reset(stats);
+    TEST_ASSERT_EQUAL(1, mb_stats_get(stats, MB_STATS_TOTAL, info, 1));
+    TEST_ASSERT_EQUAL_UINT32(0, info[0].requests);
+    TEST_ASSERT_EQUAL_UINT32(0, info[0].latency_count);
+    TEST_ASSERT_EQUAL_UINT32(0, info[0].latency_max_us);
+    TEST_ASSERT_EQUAL(0, mb_stats_get(stats, MB_STATS_NODE, info, MB_STATS_FUNCS));
+    TEST_ASSERT_EQUAL(0, mb_stats_get(stats, MB_STATS_FUNC, info, MB_STATS_FUNCS));
+    mb_stats_record(stats, 2, 0x03, MB_STATS_RESULT_OK, 5, 41, 2000);
+    TEST_ASSERT_EQUAL(1, mb_stats_get(stats, MB_STATS_NODE, info, MB_STATS_FUNCS));
+    TEST_ASSERT_EQUAL(2, info[0].key);
+    free(stats);
+}
+
+TEST_CASE("Test stats counts the nodes above the limit in the total only.", "[MB_STATS]")
+{
+    mb_stats_t *stats = calloc(1, sizeof(mb_stats_t));
+    mb_stats_info_t *info = calloc(MB_STATS_NODES, sizeof(mb_stats_info_t));
+    TEST_ASSERT_NOT_NULL(stats);
+    TEST_ASSERT_NOT_NULL(info);
+
+    for (int i = 0; i < (MB_STATS_NODES + 2); i++) {
+        mb_stats_record(stats, i + 1, 0x04, MB_STATS_RESULT_OK, 3, 5, 500);
+    }
+    TEST_ASSERT_EQUAL(MB_STATS_NODES, mb_stats_get(stats, MB_STATS_NODE, info, MB_STATS_NODES));
+    for (int i = 0; i < MB_STATS_NODES; i++) {
+        TEST_ASSERT_NOT_NULL(test_find(info, MB_STATS_NODES, i + 1));
+    }
+    TEST_ASSERT_EQUAL(1, mb_stats_get(stats, MB_STATS_TOTAL, info, 1));
+    TEST_ASSERT_EQUAL_UINT32(MB_STATS_NODES + 2, info[0].requests);
+    free(info);
+    free(stats);
+}
+
+TEST_CASE("Test stats gets the latency percentiles from the histogram.", "[MB_STATS]")
+{
+    mb_stats_t *stats = calloc(1, sizeof(mb_stats_t));
+    mb_stats_info_t info = {0};
+    TEST_ASSERT_NOT_NULL(stats);
+
+    // The bucket of 1000 uS ends at 1024 uS, the bucket of 50000 uS ends above the maximum
+    for (int i = 0; i < 98; i++) {
+        mb_stats_record(stats, 1, 0x03, MB_STATS_RESULT_OK, 5, 5, 1000);
+    }
+    mb_stats_record(stats, 1, 0x03, MB_STATS_RESULT_OK, 5, 5, 50000);
+    mb_stats_record(stats, 1, 0x03, MB_STATS_RESULT_OK, 5, 5, 50000);
+    TEST_ASSERT_EQUAL(1, mb_stats_get(stats, MB_STATS_TOTAL, &info, 1));
+    TEST_ASSERT_EQUAL_UINT32(100, info.latency_count);
+    TEST_ASSERT_EQUAL_UINT32(1024, info.latency_p50_us);
+    TEST_ASSERT_EQUAL_UINT32(1024, info.latency_p95_us);
+    TEST_ASSERT_EQUAL_UINT32(50000, info.latency_p99_us);
+    TEST_ASSERT_EQUAL_UINT32(50000, info.latency_max_us);
+
+    // The percentile is not below the exact value and exceeds it by less than the bucket width
+    mb_stats_reset(stats);
+    for (uint32_t i = 1; i <= 1000; i++) {
+        mb_stats_record(stats, 1, 0x03, MB_STATS_RESULT_OK, 5, 5, i * 37);
+    }
+    TEST_ASSERT_EQUAL(1, mb_stats_get(stats, MB_STATS_TOTAL, &info, 1));
+    TEST_ASSERT_GREATER_OR_EQUAL(500 * 37, info.latency_p50_us);
+    TEST_ASSERT_LESS_OR_EQUAL(500 * 37 * 5 / 4, info.latency_p50_us);
+    TEST_ASSERT_GREATER_OR_EQUAL(950 * 37, info.latency_p95_us);
+    TEST_ASSERT_LESS_OR_EQUAL(950 * 37 * 5 / 4, info.latency_p95_us);
+    TEST_ASSERT_GREATER_OR_EQUAL(990 * 37, info.latency_p99_us);
+    TEST_ASSERT_LESS_OR_EQUAL(1000 * 37, info.latency_p99_us);
+    TEST_ASSERT_EQUAL_UINT32(1000 * 37, info.latency_max_us);
+
+    // The latencies above the last bucket are limited by the maximum
+    mb_stats_record(stats, 1, 0x03, MB_STATS_RESULT_OK, 5, 5, UINT32_MAX);
+    TEST_ASSERT_EQUAL(1, mb_stats_get(stats, MB_STATS_TOTAL, &info, 1));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, info.latency_max_us);
+    TEST_ASSERT_EQUAL_UINT32(1001, info.latency_count);
+    TEST_ASSERT_LESS_THAN(1000 * 37 * 5 / 4, info.latency_p99_us);
+    free(stats);
+}
+
+static void test_stats_task(void *arg)
+{
+    test_stats_task_t *task_ptr = (test_stats_task_t *)arg;
+    for (int i = 0; i < TEST_TASK_LOOPS; i++) {
+        mb_stats_record(task_ptr->stats, task_ptr->node, 0x03, MB_STATS_RESULT_OK, 5, 41, i);
+        if (!(i % 100)) {
+            taskYIELD();
+        }
+    }
+    xSemaphoreGive(task_ptr->done_sema);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Test stats counts the transactions of several tasks.", "[MB_STATS]")
+{
+    mb_stats_t *stats = calloc(1, sizeof(mb_stats_t));
+    test_stats_task_t tasks[TEST_TASK_COUNT] = {0};
+    mb_stats_info_t info[TEST_TASK_COUNT] = {0};
+    TEST_ASSERT_NOT_NULL(stats);
+
+    // Two tasks share each node, so they race for the same node entry
+    for (int i = 0; i < TEST_TASK_COUNT; i++) {
+        tasks[i].stats = stats;
+        tasks[i].node = 1 + (i >> 1);
+        tasks[i].done_sema = xSemaphoreCreateBinary();
+        TEST_ASSERT_NOT_NULL(tasks[i].done_sema);
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(test_stats_task, "mb_stats_task", TEST_TASK_STACK_SIZE,
+                                                &tasks[i], (CONFIG_FMB_PORT_TASK_PRIO - 1), NULL));
+    }
+    for (int i = 0; i < TEST_TASK_COUNT; i++) {
+        TEST_ASSERT_TRUE(xSemaphoreTake(tasks[i].done_sema, pdMS_TO_TICKS(TEST_DONE_TOUT_MS)));
+        vSemaphoreDelete(tasks[i].done_sema);
+    }
+    TEST_ASSERT_EQUAL(1, mb_stats_get(stats, MB_STATS_TOTAL, info, 1));
+    TEST_ASSERT_EQUAL_UINT32(TEST_TASK_COUNT * TEST_TASK_LOOPS, info[0].requests);
+    TEST_ASSERT_EQUAL_UINT32(TEST_TASK_COUNT * TEST_TASK_LOOPS, info[0].latency_count);
+    TEST_ASSERT_EQUAL_UINT32(TEST_TASK_COUNT * TEST_TASK_LOOPS * 41, info[0].bytes_out);
+    TEST_ASSERT_EQUAL_UINT32(TEST_TASK_LOOPS - 1, info[0].latency_max_us);
+    TEST_ASSERT_EQUAL(TEST_TASK_COUNT / 2, mb_stats_get(stats, MB_STATS_NODE, info, TEST_TASK_COUNT));
+    for (int i = 0; i < (TEST_TASK_COUNT / 2); i++) {
+        TEST_ASSERT_EQUAL_UINT32(2 * TEST_TASK_LOOPS, info[i].requests);
+    }
+    ESP_LOGI(TAG, "p50: %" PRIu32 " us, p99: %" PRIu32 " us", info[0].latency_p50_us, info[0].latency_p99_us);
+    free(stats);
+}
+
+#endif
@@ -0,0 +1,375 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_netif.h"
+
+#include "sdkconfig.h"
+#include "port_common.h"
+#include "port_tcp_driver.h"
+
+#if (CONFIG_FMB_COMM_MODE_TCP_EN)
+
+#define TAG "MB_TCP_DRIVER_TEST"
+
+#define TEST_BENCH_LOOPS 10000
+#define TEST_SOCK_ID(index) ((index) + 1)
+#define TEST_QUEUE_LEN 40
+#define TEST_FUZZ_FRAMES 300
+#define TEST_FUZZ_CHUNK_MAX 600
+#define TEST_THROUGHPUT_FRAMES 3000
+#define TEST_THROUGHPUT_CHUNK 1024
+#define TEST_READ_TOUT_MS 1000
+#define TEST_FRAME_MIN_LEN (MB_TCP_FUNC + 1)
+#define TEST_FRAME_SHORT_LEN 12
+
+static port_driver_t *test_driver_create(mb_node_info_t *nodes, int count)
+{
+    port_driver_t *drv_obj = calloc(1, sizeof(port_driver_t));
+    TEST_ASSERT_NOT_NULL(drv_obj);
+    *drv_obj = (port_driver_t)MB_DRIVER_CONFIG_DEFAULT;
+    CRITICAL_SECTION_INIT(drv_obj->lock);
+    drv_obj->mb_nodes = calloc(MB_MAX_FDS, sizeof(mb_node_info_t *));
+    drv_obj->conn_nodes = calloc(MB_MAX_FDS, sizeof(int));
+    drv_obj->alive_nodes = calloc(MB_MAX_FDS, sizeof(int));
+    TEST_ASSERT_NOT_NULL(drv_obj->mb_nodes);
+    TEST_ASSERT_NOT_NULL(drv_obj->conn_nodes);
+    TEST_ASSERT_NOT_NULL(drv_obj->alive_nodes);
+    drv_obj->timer_wheel = calloc(1, sizeof(mb_timer_wheel_t));
+    TEST_ASSERT_NOT_NULL(drv_obj->timer_wheel);
+    mb_timer_wheel_init(drv_obj->timer_wheel, esp_timer_get_time());
+    FD_ZERO(&drv_obj->open_set);
+    FD_ZERO(&drv_obj->conn_set);
+    for (int i = 0; i < count; i++) {
+        memset(&nodes[i], 0, sizeof(mb_node_info_t));
+        nodes[i].index = i;
+        nodes[i].fd = i;
+        nodes[i].sock_id = TEST_SOCK_ID(i);
+        MB_SET_NODE_STATE(&nodes[i], MB_SOCK_STATE_CONNECTED);
+        drv_obj->mb_nodes[i] = &nodes[i];
+    }
+    return drv_obj;
+}
+
+static void test_driver_destroy(port_driver_t *drv_obj)
+{
+    CRITICAL_SECTION_CLOSE(drv_obj->lock);
+    free(drv_obj->timer_wheel);
+    free(drv_obj->alive_nodes);
+    free(drv_obj->conn_nodes);
+    free(drv_obj->mb_nodes);
+    free(drv_obj);
+}
+
+TEST_CASE("Test tcp driver keeps the connection set incrementally.", "[MB_TCP_DRIVER]")
+{
+    mb_node_info_t nodes[MB_MAX_FDS];
+    TEST_ASSERT_TRUE(TEST_SOCK_ID(MB_MAX_FDS) < FD_SETSIZE);
+    port_driver_t *drv_obj = test_driver_create(nodes, MB_MAX_FDS);
+
+    for (int i = 0; i < MB_MAX_FDS; i++) {
+        TEST_ASSERT_TRUE(mb_drv_conn_add(drv_obj, &nodes[i]));
+        TEST_ASSERT_TRUE(FD_ISSET(nodes[i].sock_id, &drv_obj->conn_set));
+        // The slave checks the connection when the node does not receive data during the keep alive timeout
+        TEST_ASSERT_TRUE(mb_timer_node_is_armed(&nodes[i].alive_timer));
+    }
+    TEST_ASSERT_EQUAL_UINT32(MB_MAX_FDS, drv_obj->timer_wheel->count);
+    // The node is added only once
+    TEST_ASSERT_TRUE(mb_drv_conn_add(drv_obj, &nodes[0]));
+    TEST_ASSERT_EQUAL(MB_MAX_FDS, drv_obj->node_conn_count);
+    TEST_ASSERT_EQUAL(TEST_SOCK_ID(MB_MAX_FDS - 1), drv_obj->conn_max_fd);
+
+    // The maximum descriptor is updated when the last socket is removed
+    TEST_ASSERT_TRUE(mb_drv_conn_del(drv_obj, &nodes[MB_MAX_FDS - 1]));
+    TEST_ASSERT_FALSE(mb_drv_conn_del(drv_obj, &nodes[MB_MAX_FDS - 1]));
+    TEST_ASSERT_FALSE(FD_ISSET(nodes[MB_MAX_FDS - 1].sock_id, &drv_obj->conn_set));
+    TEST_ASSERT_FALSE(mb_timer_node_is_armed(&nodes[MB_MAX_FDS - 1].alive_timer));
+    TEST_ASSERT_EQUAL(MB_MAX_FDS - 1, drv_obj->node_conn_count);
+    TEST_ASSERT_EQUAL((MB_MAX_FDS > 1) ? TEST_SOCK_ID(MB_MAX_FDS - 2) : UNDEF_FD, drv_obj->conn_max_fd);
+
+    // Only the ready sockets of the connected nodes are returned
+    fd_set readset;
+    FD_ZERO(&readset);
+    FD_SET(nodes[0].sock_id, &readset);
+    FD_SET(nodes[MB_MAX_FDS - 1].sock_id, &readset);
+    int pos = 0;
+    TEST_ASSERT_EQUAL_PTR(&nodes[0], mb_drv_get_next_ready_node(drv_obj, &pos, &readset));
+    pos++;
+    TEST_ASSERT_NULL(mb_drv_get_next_ready_node(drv_obj, &pos, &readset));
+
+    for (int i = 0; i < MB_MAX_FDS; i++) {
+        (void)mb_drv_conn_del(drv_obj, &nodes[i]);
+    }
+    TEST_ASSERT_EQUAL(0, drv_obj->node_conn_count);
+    TEST_ASSERT_EQUAL(UNDEF_FD, drv_obj->conn_max_fd);
+    TEST_ASSERT_EQUAL_UINT32(0, drv_obj->timer_wheel->count);
+    test_driver_destroy(drv_obj);
+}
+
+TEST_CASE("Test tcp driver keeps the expired keep alive nodes once.", "[MB_TCP_DRIVER]")
+{
+    mb_node_info_t nodes[MB_MAX_FDS];
+    port_driver_t *drv_obj = test_driver_create(nodes, MB_MAX_FDS);
+
+    for (int i = 0; i < MB_MAX_FDS; i++) {
+        // The nodes did not receive data during the keep alive timeout
+        nodes[i].recv_time = esp_timer_get_time() - MB_KEEP_ALIVE_TIME_US - MB_TIMER_WHEEL_TICK_US;
+        TEST_ASSERT_TRUE(mb_drv_conn_add(drv_obj, &nodes[i]));
+    }
+    uint64_t time_now = esp_timer_get_time();
+    (void)mb_timer_wheel_advance(drv_obj->timer_wheel, time_now);
+    TEST_ASSERT_EQUAL(MB_MAX_FDS, drv_obj->alive_count);
+    // The timers are armed again, the node which expires twice before the driver task takes it is kept once
+    TEST_ASSERT_EQUAL_UINT32(MB_MAX_FDS, drv_obj->timer_wheel->count);
+    (void)mb_timer_wheel_advance(drv_obj->timer_wheel, time_now + MB_KEEP_ALIVE_TIME_US + 1);
+    TEST_ASSERT_EQUAL(MB_MAX_FDS, drv_obj->alive_count);
+
+    // The removed node is not checked
+    TEST_ASSERT_TRUE(mb_drv_conn_del(drv_obj, &nodes[0]));
+    TEST_ASSERT_EQUAL(MB_MAX_FDS - 1, drv_obj->alive_count);
+    for (int i = 0; i < drv_obj->alive_count; i++) {
+        TEST_ASSERT_NOT_EQUAL(nodes[0].index, drv_obj->alive_nodes[i]);
+    }
+    for (int i = 1; i < MB_MAX_FDS; i++) {
+        TEST_ASSERT_TRUE(mb_drv_conn_del(drv_obj, &nodes[i]));
+    }
+    TEST_ASSERT_EQUAL(0, drv_obj->alive_count);
+    TEST_ASSERT_EQUAL_UINT32(0, drv_obj->timer_wheel->count);
+    test_driver_destroy(drv_obj);
+}
+
+TEST_CASE("Test tcp driver ready node lookup scales with connection count.", "[MB_TCP_DRIVER][BENCHMARK]")
+{
+    mb_node_info_t nodes[MB_MAX_FDS];
+    const int counts[] = {1, (MB_MAX_FDS + 3) / 4, (MB_MAX_FDS + 1) / 2, MB_MAX_FDS};
+
+    for (int i = 0; i < (sizeof(counts) / sizeof(counts[0])); i++) {
+        port_driver_t *drv_obj = test_driver_create(nodes, MB_MAX_FDS);
+        for (int j = 0; j < counts[i]; j++) {
+            TEST_ASSERT_TRUE(mb_drv_conn_add(drv_obj, &nodes[j]));
+        }
+        // The last connected socket is ready, this is the worst case for the lookup
+        fd_set readset;
+        FD_ZERO(&readset);
+        FD_SET(nodes[counts[i] - 1].sock_id, &readset);
+        int64_t start = esp_timer_get_time();
+        for (int j = 0; j < TEST_BENCH_LOOPS; j++) {
+            int pos = 0;
+            TEST_ASSERT_EQUAL_PTR(&nodes[counts[i] - 1], mb_drv_get_next_ready_node(drv_obj, &pos, &readset));
+        }
+        int64_t ready_time = esp_timer_get_time() - start;
+        // Connection churn: remove and add back the first node
+        start = esp_timer_get_time();
+        for (int j = 0; j < TEST_BENCH_LOOPS; j++) {
+            TEST_ASSERT_TRUE(mb_drv_conn_del(drv_obj, &nodes[0]));
+            TEST_ASSERT_TRUE(mb_drv_conn_add(drv_obj, &nodes[0]));
+        }
+        int64_t churn_time = esp_timer_get_time() - start;
+        ESP_LOGI(TAG, "connections: %d (max: %d), ready lookup: %" PRId64 " ns/op, del + add: %" PRId64 " ns/op",
+                    counts[i], MB_MAX_FDS, (ready_time * 1000) / TEST_BENCH_LOOPS, (churn_time * 1000) / TEST_BENCH_LOOPS);
+        TEST_ASSERT_EQUAL(counts[i], drv_obj->node_conn_count);
+        test_driver_destroy(drv_obj);
+    }
+}
+
+// Connects the client socket to the server socket through the loopback interface
+static void test_loopback_connect(int *client_ptr, int *server_ptr)
+{
+    struct sockaddr_in addr = {0};
+    socklen_t addr_len = sizeof(addr);
+    int no_delay = 1;
+
+    esp_err_t err = esp_netif_init();
+    TEST_ASSERT_TRUE((err == ESP_OK) || (err == ESP_ERR_INVALID_STATE));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    int listen_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    TEST_ASSERT_TRUE(listen_sock >= 0);
+    TEST_ASSERT_EQUAL(0, bind(listen_sock, (struct sockaddr *)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL(0, listen(listen_sock, 1));
+    TEST_ASSERT_EQUAL(0, getsockname(listen_sock, (struct sockaddr *)&addr, &addr_len));
+    *client_ptr = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    TEST_ASSERT_TRUE(*client_ptr >= 0);
+    TEST_ASSERT_EQUAL(0, connect(*client_ptr, (struct sockaddr *)&addr, sizeof(addr)));
+    // Send the fragments as is, without coalescing
+    setsockopt(*client_ptr, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+    *server_ptr = accept(listen_sock, NULL, NULL);
+    TEST_ASSERT_TRUE(*server_ptr >= 0);
+    close(listen_sock);
+}
+
+// Builds the stream of frames with random length and content, returns the stream length
+static size_t test_stream_build(uint8_t *stream, size_t *offsets, int count, bool is_random_len)
+{
+    size_t stream_len = 0;
+    for (int i = 0; i < count; i++) {
+        uint8_t *frame_ptr = &stream[stream_len];
+        uint16_t len = is_random_len ? (2 + (rand() % (MB_TCP_BUFF_MAX_SIZE - TEST_FRAME_MIN_LEN))) : (TEST_FRAME_SHORT_LEN - MB_TCP_UID);
+        frame_ptr[MB_TCP_TID] = (uint8_t)(i >> 8);
+        frame_ptr[MB_TCP_TID + 1] = (uint8_t)(i & 0xFF);
+        frame_ptr[MB_TCP_PID] = 0;
+        frame_ptr[MB_TCP_PID + 1] = 0;
+        frame_ptr[MB_TCP_LEN] = (uint8_t)(len >> 8);
+        frame_ptr[MB_TCP_LEN + 1] = (uint8_t)(len & 0xFF);
+        frame_ptr[MB_TCP_UID] = (uint8_t)(1 + (rand() % MB_ADDRESS_MAX));
+        for (int j = MB_TCP_FUNC; j < (len + MB_TCP_UID); j++) {
+            frame_ptr[j] = (uint8_t)rand();
+        }
+        offsets[i] = stream_len;
+        stream_len += (len + MB_TCP_UID);
+    }
+    offsets[count] = stream_len;
+    return stream_len;
+}
+
+// Sends the stream by chunks and checks the frames extracted by the reader
+static void test_stream_transfer(int client, mb_node_info_t *node_ptr, const uint8_t *stream,
+                                    const size_t *offsets, int count, int chunk_min, int chunk_max)
+{
+    size_t sent = 0;
+    int received = 0;
+    while (received < count) {
+        if (sent < offsets[count]) {
+            size_t chunk = chunk_min + ((chunk_max > chunk_min) ? (rand() % (chunk_max - chunk_min + 1)) : 0);
+            chunk = ((sent + chunk) > offsets[count]) ? (offsets[count] - sent) : chunk;
+            TEST_ASSERT_EQUAL((int)chunk, send(client, &stream[sent], chunk, 0));
+            sent += chunk;
+        }
+        int complete = received;
+        while ((complete < count) && (offsets[complete + 1] <= sent)) {
+            complete++;
+        }
+        int64_t start = esp_timer_get_time();
+        while (received < complete) {
+            fd_set readset;
+            struct timeval tv = {.tv_sec = 0, .tv_usec = 10000};
+            FD_ZERO(&readset);
+            FD_SET(node_ptr->sock_id, &readset);
+            if (select(node_ptr->sock_id + 1, &readset, NULL, NULL, &tv) > 0) {
+                int ret = port_read_packet(node_ptr);
+                TEST_ASSERT_TRUE((ret > 0) || (ret == ERR_INPROGRESS) || (ret == ERR_TIMEOUT));
+            }
+            frame_entry_t entry = {0};
+            while (!queue_is_empty(node_ptr->rx_queue)) {
+                TEST_ASSERT_TRUE(queue_pop(node_ptr->rx_queue, NULL, MB_TCP_BUFF_MAX_SIZE, &entry) > 0);
+                TEST_ASSERT_TRUE(received < count);
+                size_t frame_len = offsets[received + 1] - offsets[received];
+                TEST_ASSERT_EQUAL(frame_len, entry.len);
+                TEST_ASSERT_EQUAL_HEX16(received, entry.tid);
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(&stream[offsets[received]], entry.buf, frame_len);
+                mb_port_frame_free(entry.buf);
+                received++;
+            }
+            TEST_ASSERT_TRUE((esp_timer_get_time() - start) < (TEST_READ_TOUT_MS * 1000));
+        }
+    }
+}
+
+// Reads the socket until the result is different from the incomplete or empty read
+static int test_stream_read_result(mb_node_info_t *node_ptr)
+{
+    int ret = ERR_TIMEOUT;
+    int64_t start = esp_timer_get_time();
+    while (((ret == ERR_TIMEOUT) || (ret == ERR_INPROGRESS))
+                && ((esp_timer_get_time() - start) < (TEST_READ_TOUT_MS * 1000))) {
+        ret = port_read_packet(node_ptr);
+    }
+    return ret;
+}
+
+static void test_stream_node_init(mb_node_info_t *node_ptr, int sock_id)
+{
+    memset(node_ptr, 0, sizeof(mb_node_info_t));
+    node_ptr->sock_id = sock_id;
+    node_ptr->addr_info.ip_addr_str = "127.0.0.1";
+    node_ptr->rx_queue = queue_create(TEST_QUEUE_LEN);
+    TEST_ASSERT_NOT_NULL(node_ptr->rx_queue);
+}
+
+TEST_CASE("Test tcp frames are reassembled from fragmented and coalesced stream.", "[MB_TCP_DRIVER]")
+{
+    int client = -1, server = -1;
+    size_t *offsets = calloc(TEST_FUZZ_FRAMES + 1, sizeof(size_t));
+    uint8_t *stream = calloc(TEST_FUZZ_FRAMES, MB_TCP_BUFF_MAX_SIZE);
+    TEST_ASSERT_NOT_NULL(offsets);
+    TEST_ASSERT_NOT_NULL(stream);
+    mb_node_info_t node;
+    srand(0x1502);
+
+    test_loopback_connect(&client, &server);
+    test_stream_node_init(&node, server);
+    // The frames split into single bytes
+    size_t len = test_stream_build(stream, offsets, TEST_FUZZ_FRAMES / 10, true);
+    test_stream_transfer(client, &node, stream, offsets, TEST_FUZZ_FRAMES / 10, 1, 1);
+    // The frames split randomly, several frames can be received by one read
+    len = test_stream_build(stream, offsets, TEST_FUZZ_FRAMES, true);
+    test_stream_transfer(client, &node, stream, offsets, TEST_FUZZ_FRAMES, 1, TEST_FUZZ_CHUNK_MAX);
+    // The short frames coalesced into one chunk
+    len = test_stream_build(stream, offsets, TEST_FUZZ_FRAMES, false);
+    test_stream_transfer(client, &node, stream, offsets, TEST_FUZZ_FRAMES, MB_TCP_BUFF_MAX_SIZE, MB_TCP_BUFF_MAX_SIZE);
+    TEST_ASSERT_EQUAL(0, node.rx_len);
+
+    // The incorrect header drops the received data, the next frame is received correctly
+    len = test_stream_build(stream, offsets, 1, true);
+    stream[MB_TCP_PID] = 0xFF;
+    TEST_ASSERT_EQUAL((int)len, send(client, stream, len, 0));
+    int ret = test_stream_read_result(&node);
+    TEST_ASSERT_EQUAL(ERR_BUF, ret);
+    TEST_ASSERT_EQUAL(0, node.rx_len);
+    // Drain the rest of the incorrect frame if it was not read at once
+    vTaskDelay(pdMS_TO_TICKS(10));
+    (void)port_read_packet(&node);
+    port_reset_rx_buffer(&node);
+    len = test_stream_build(stream, offsets, 1, true);
+    test_stream_transfer(client, &node, stream, offsets, 1, len, len);
+
+    // The closed connection is reported
+    close(client);
+    ret = test_stream_read_result(&node);
+    TEST_ASSERT_EQUAL(ERR_CONN, ret);
+    port_reset_rx_buffer(&node);
+    queue_delete(node.rx_queue);
+    close(server);
+    free(stream);
+    free(offsets);
+}
+
+TEST_CASE("Test tcp frame reassembly throughput.", "[MB_TCP_DRIVER][BENCHMARK]")
+{
+    int client = -1, server = -1;
+    size_t *offsets = calloc(TEST_THROUGHPUT_FRAMES + 1, sizeof(size_t));
+    uint8_t *stream = calloc(TEST_THROUGHPUT_FRAMES, MB_TCP_BUFF_MAX_SIZE);
+    TEST_ASSERT_NOT_NULL(offsets);
+    TEST_ASSERT_NOT_NULL(stream);
+    mb_node_info_t node;
+    const bool is_random_len[] = {false, true};
+
+    test_loopback_connect(&client, &server);
+    for (int i = 0; i < (sizeof(is_random_len) / sizeof(is_random_len[0])); i++) {
+        test_stream_node_init(&node, server);
+        size_t len = test_stream_build(stream, offsets, TEST_THROUGHPUT_FRAMES, is_random_len[i]);
+        int64_t start = esp_timer_get_time();
+        test_stream_transfer(client, &node, stream, offsets, TEST_THROUGHPUT_FRAMES, TEST_THROUGHPUT_CHUNK, TEST_THROUGHPUT_CHUNK);
+        int64_t total_time = esp_timer_get_time() - start;
+        ESP_LOGI(TAG, "frames: %d, bytes: %u, read time: %" PRIu64 " us, %" PRIu64 " ns/frame, transfer time: %" PRId64 " us",
+                    (int)node.recv_counter, (unsigned)len, node.recv_time_us,
+                    (node.recv_time_us * 1000) / TEST_THROUGHPUT_FRAMES, total_time);
+        TEST_ASSERT_EQUAL(TEST_THROUGHPUT_FRAMES, node.recv_counter);
+        port_reset_rx_buffer(&node);
+        queue_delete(node.rx_queue);
+    }
+    close(client);
+    close(server);
+    free(stream);
+    free(offsets);
+}
+
+#endif
@@ -0,0 +1,449 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "sdkconfig.h"
+#include "esp_modbus_master.h"
+#include "esp_modbus_slave.h"
+
+#if (CONFIG_FMB_COMM_MODE_TCP_EN)
+
+#define TAG "MB_TCP_MASTER_TEST"
+
+#define TEST_TCP_PORT_NUM 1502
+#define TEST_SLAVE_UID 1
+#define TEST_REG_COUNT 64
+#define TEST_TASK_COUNT 4
+#define TEST_TASK_LOOPS 50
+#define TEST_TASK_STACK_SIZE 4096
+#define TEST_RESPOND_TOUT_MS 1000
+#define TEST_DONE_TOUT_MS 60000
+#define TEST_CONNECT_DELAY_MS 500
+#define TEST_SWEEP_LOOPS 20
+#define TEST_PARAM_COUNT (sizeof(test_descriptors) / sizeof(test_descriptors[0]))
+#define TEST_PLAN_COUNT 48
+#define TEST_PLAN_GAP 8
+#define TEST_EVENT_TOUT_MS 200
+#define TEST_CACHE_AGE_MS 60000
+
+// The plan table has two groups of adjacent registers divided by the gap
+#if CONFIG_FMB_MASTER_READ_PLAN_ENABLE
+#define TEST_PLAN_REQUESTS ((CONFIG_FMB_MASTER_READ_PLAN_GAP_MAX >= TEST_PLAN_GAP) ? 1 : 2)
+#endif
+
+static uint16_t holding_regs[TEST_REG_COUNT];
+
+static const mb_parameter_descriptor_t test_descriptors[] = {
+    {0, "hold_reg-0", "Data", TEST_SLAVE_UID, MB_PARAM_HOLDING, 0, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+    {1, "hold_reg-1", "Data", (TEST_SLAVE_UID + 1), MB_PARAM_HOLDING, 1, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+    {2, "hold_reg-10", "Data", TEST_SLAVE_UID, MB_PARAM_HOLDING, 10, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+    {3, "hold_reg-20", "Data", (TEST_SLAVE_UID + 1), MB_PARAM_HOLDING, 20, 1,
+        0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+};
+
+typedef struct {
+    void *master_handle;
+    uint8_t slave_addr;
+    int index;
+    int errors;
+    SemaphoreHandle_t done_sema;
+} test_master_task_t;
+
+static void *test_slave_start(void)
+{
+    void *slave_handle = NULL;
+    for (int i = 0; i < TEST_REG_COUNT; i++) {
+        holding_regs[i] = 0x1100 + i;
+    }
+    mb_communication_info_t slave_comm = {
+        .tcp_opts.mode = MB_TCP,
+        .tcp_opts.port = TEST_TCP_PORT_NUM,
+        .tcp_opts.uid = TEST_SLAVE_UID,
+        .tcp_opts.addr_type = MB_IPV4,
+        .tcp_opts.ip_addr_table = (void *)"127.0.0.1",
+        .tcp_opts.response_tout_ms = TEST_RESPOND_TOUT_MS
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_create_tcp(&slave_comm, &slave_handle));
+    mb_register_area_descriptor_t area = {
+        .type = MB_PARAM_HOLDING,
+        .start_offset = 0,
+        .address = (void *)holding_regs,
+        .size = sizeof(holding_regs)
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_set_descriptor(slave_handle, area));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_start(slave_handle));
+    return slave_handle;
+}
+
+static void *test_master_start(char **ip_table, const mb_parameter_descriptor_t *descr, uint16_t descr_count)
+{
+    void *master_handle = NULL;
+    mb_communication_info_t master_comm = {
+        .tcp_opts.mode = MB_TCP,
+        .tcp_opts.port = TEST_TCP_PORT_NUM,
+        .tcp_opts.addr_type = MB_IPV4,
+        .tcp_opts.ip_addr_table = (void *)ip_table,
+        .tcp_opts.response_tout_ms = TEST_RESPOND_TOUT_MS
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_create_tcp(&master_comm, &master_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_set_descriptor(master_handle, descr, descr_count));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_start(master_handle));
+    return master_handle;
+}
+
+static void test_network_init(void)
+{
+    esp_err_t err = esp_netif_init();
+    TEST_ASSERT_TRUE((err == ESP_OK) || (err == ESP_ERR_INVALID_STATE));
+    err = esp_event_loop_create_default();
+    TEST_ASSERT_TRUE((err == ESP_OK) || (err == ESP_ERR_INVALID_STATE));
+}
+
+// Each task reads its own window of holding registers through the shared master object
+static void test_master_task(void *arg)
+{
+    test_master_task_t *task_ptr = (test_master_task_t *)arg;
+    uint16_t data[TEST_REG_COUNT] = {0};
+
+    for (int i = 0; i < TEST_TASK_LOOPS; i++) {
+        uint16_t size = 1 + ((task_ptr->index + i) % (TEST_REG_COUNT / 2));
+        uint16_t start = (task_ptr->index * 7 + i) % (TEST_REG_COUNT - size);
+        mb_param_request_t request = {
+            .slave_addr = task_ptr->slave_addr,
+            .command = 0x03,                    // read holding registers
+            .reg_start = start,
+            .reg_size = size
+        };
+        esp_err_t err = mbc_master_send_request(task_ptr->master_handle, &request, data);
+        if ((err != ESP_OK) || memcmp(data, &holding_regs[start], size << 1)) {
+            ESP_LOGE(TAG, "task %d, request %d, start: %u, size: %u, err = 0x%x",
+                        task_ptr->index, i, (unsigned)start, (unsigned)size, (int)err);
+            task_ptr->errors++;
+        }
+    }
+    xSemaphoreGive(task_ptr->done_sema);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Test tcp master pipelines requests from several tasks.", "[MB_TCP_MASTER]")
+{
+    char *ip_table[] = {"01;127.0.0.1;1502", NULL};
+    test_master_task_t tasks[TEST_TASK_COUNT] = {0};
+
+    test_network_init();
+    void *slave_handle = test_slave_start();
+    vTaskDelay(pdMS_TO_TICKS(TEST_CONNECT_DELAY_MS));
+    void *master_handle = test_master_start(ip_table, &test_descriptors[0], 1);
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < TEST_TASK_COUNT; i++) {
+        tasks[i].master_handle = master_handle;
+        tasks[i].slave_addr = TEST_SLAVE_UID;
+        tasks[i].index = i;
+        tasks[i].done_sema = xSemaphoreCreateBinary();
+        TEST_ASSERT_NOT_NULL(tasks[i].done_sema);
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(test_master_task, "mb_test_task", TEST_TASK_STACK_SIZE,
+                                                &tasks[i], (CONFIG_FMB_PORT_TASK_PRIO - 1), NULL));
+    }
+    int errors = 0;
+    for (int i = 0; i < TEST_TASK_COUNT; i++) {
+        TEST_ASSERT_TRUE(xSemaphoreTake(tasks[i].done_sema, pdMS_TO_TICKS(TEST_DONE_TOUT_MS)));
+        vSemaphoreDelete(tasks[i].done_sema);
+        errors += tasks[i].errors;
+    }
+    int64_t time = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "tasks: %d, in-flight window: %d, requests: %d, %" PRId64 " us/request",
+                TEST_TASK_COUNT, CONFIG_FMB_TCP_MASTER_INFLIGHT_MAX, (TEST_TASK_COUNT * TEST_TASK_LOOPS),
+                time / (TEST_TASK_COUNT * TEST_TASK_LOOPS));
+
+#if CONFIG_FMB_PORT_STATS_ENABLE
+    // Both sides count each request once, the master keeps it under the UID of the slave
+    mb_stats_info_t info = {0};
+    uint16_t count = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_get_stats(master_handle, MB_STATS_NODE, &info, 1, &count));
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL(TEST_SLAVE_UID, info.key);
+    TEST_ASSERT_EQUAL_UINT32((TEST_TASK_COUNT * TEST_TASK_LOOPS), info.requests);
+    TEST_ASSERT_EQUAL_UINT32((TEST_TASK_COUNT * TEST_TASK_LOOPS - errors), info.latency_count);
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_get_stats(slave_handle, MB_STATS_FUNC, &info, 1, &count));
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL(0x03, info.key);
+    TEST_ASSERT_EQUAL_UINT32((TEST_TASK_COUNT * TEST_TASK_LOOPS), info.requests);
+    TEST_ASSERT_EQUAL_UINT32((TEST_TASK_COUNT * TEST_TASK_LOOPS) * 5, info.bytes_in);
+    ESP_LOGI(TAG, "slave latency p50: %" PRIu32 " us, p99: %" PRIu32 " us, max: %" PRIu32 " us",
+                info.latency_p50_us, info.latency_p99_us, info.latency_max_us);
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_reset_stats(master_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_get_stats(master_handle, MB_STATS_NODE, NULL, 0, &count));
+    TEST_ASSERT_EQUAL(0, count);
+#endif
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_delete(master_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+    TEST_ASSERT_EQUAL(0, errors);
+}
+
+// The slave does not check the UID, so each UID of the master is an independent client of the slave
+TEST_CASE("Test tcp slave serves the requests of several clients in turn.", "[MB_TCP_MASTER]")
+{
+    char *ip_table[] = {"01;127.0.0.1;1502", "02;127.0.0.1;1502", NULL};
+    test_master_task_t tasks[TEST_TASK_COUNT] = {0};
+    mb_tcp_client_stats_t stats[CONFIG_FMB_TCP_PORT_MAX_CONN] = {0};
+    uint16_t count = 0;
+
+    test_network_init();
+    void *slave_handle = test_slave_start();
+    vTaskDelay(pdMS_TO_TICKS(TEST_CONNECT_DELAY_MS));
+    void *master_handle = test_master_start(ip_table, &test_descriptors[0], 2);
+
+    for (int i = 0; i < TEST_TASK_COUNT; i++) {
+        tasks[i].master_handle = master_handle;
+        tasks[i].slave_addr = TEST_SLAVE_UID + (i & 1);
+        tasks[i].index = i;
+        tasks[i].done_sema = xSemaphoreCreateBinary();
+        TEST_ASSERT_NOT_NULL(tasks[i].done_sema);
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(test_master_task, "mb_test_task", TEST_TASK_STACK_SIZE,
+                                                &tasks[i], (CONFIG_FMB_PORT_TASK_PRIO - 1), NULL));
+    }
+    int errors = 0;
+    for (int i = 0; i < TEST_TASK_COUNT; i++) {
+        TEST_ASSERT_TRUE(xSemaphoreTake(tasks[i].done_sema, pdMS_TO_TICKS(TEST_DONE_TOUT_MS)));
+        vSemaphoreDelete(tasks[i].done_sema);
+        errors += tasks[i].errors;
+    }
+
+    // Each client has half of the requests, the queue of each client is empty
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_get_client_stats(slave_handle, stats, CONFIG_FMB_TCP_PORT_MAX_CONN, &count));
+    TEST_ASSERT_EQUAL(2, count);
+    for (int i = 0; i < count; i++) {
+        ESP_LOGI(TAG, "client #%u (%s): requests: %" PRIu32 ", rejected: %" PRIu32 ", latency avg: %" PRIu32 " us, max: %" PRIu32 " us",
+                    (unsigned)stats[i].index, stats[i].ip_addr_str, stats[i].request_count, stats[i].reject_count,
+                    stats[i].latency_avg_us, stats[i].latency_max_us);
+        TEST_ASSERT_EQUAL_STRING("127.0.0.1", stats[i].ip_addr_str);
+        TEST_ASSERT_EQUAL(0, stats[i].queue_depth);
+        TEST_ASSERT_EQUAL(0, stats[i].reject_count);
+        TEST_ASSERT_EQUAL((TEST_TASK_COUNT / 2) * TEST_TASK_LOOPS, stats[i].request_count);
+        TEST_ASSERT_TRUE(stats[i].latency_max_us >= stats[i].latency_avg_us);
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, mbc_slave_get_client_stats(slave_handle, NULL, 1, &count));
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_delete(master_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+    TEST_ASSERT_EQUAL(0, errors);
+}
+
+// The slave does not check the UID, so each UID of the master is an independent connection to it
+TEST_CASE("Test tcp master reads the parameters of several slaves at once.", "[MB_TCP_MASTER]")
+{
+    char *ip_table[] = {"01;127.0.0.1;1502", "02;127.0.0.1;1502", NULL};
+    uint16_t values[TEST_PARAM_COUNT];
+    mb_param_poll_t params[TEST_PARAM_COUNT];
+
+    test_network_init();
+    void *slave_handle = test_slave_start();
+    vTaskDelay(pdMS_TO_TICKS(TEST_CONNECT_DELAY_MS));
+    void *master_handle = test_master_start(ip_table, &test_descriptors[0], TEST_PARAM_COUNT);
+
+    int64_t start = esp_timer_get_time();
+    for (int loop = 0; loop < TEST_SWEEP_LOOPS; loop++) {
+        for (int i = 0; i < TEST_PARAM_COUNT; i++) {
+            values[i] = 0;
+            params[i] = (mb_param_poll_t){.cid = i, .value = (uint8_t *)&values[i]};
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_parameters(master_handle, params, TEST_PARAM_COUNT));
+        for (int i = 0; i < TEST_PARAM_COUNT; i++) {
+            TEST_ASSERT_EQUAL(ESP_OK, params[i].error);
+            TEST_ASSERT_EQUAL(test_descriptors[i].param_type, params[i].type);
+            TEST_ASSERT_EQUAL_HEX16(holding_regs[test_descriptors[i].mb_reg_start], values[i]);
+        }
+    }
+    int64_t time = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "parameters: %d, %" PRId64 " us/sweep", (int)TEST_PARAM_COUNT, time / TEST_SWEEP_LOOPS);
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_delete(master_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+}
+
+// Counts the read requests processed by the slave
+static int test_slave_read_count(void *slave_handle)
+{
+    mb_param_info_t reg_info;
+    int count = 0;
+    while (mbc_slave_get_param_info(slave_handle, &reg_info, TEST_EVENT_TOUT_MS) == ESP_OK) {
+        count += (reg_info.type == MB_EVENT_HOLDING_REG_RD);
+    }
+    return count;
+}
+
+TEST_CASE("Test tcp master coalesces the reads of neighbouring parameters.", "[MB_TCP_MASTER]")
+{
+    char *ip_table[] = {"01;127.0.0.1;1502", NULL};
+    static mb_parameter_descriptor_t plan_descriptors[TEST_PLAN_COUNT];
+    uint16_t values[TEST_PLAN_COUNT];
+    mb_param_poll_t params[TEST_PLAN_COUNT];
+
+    for (int i = 0; i < TEST_PLAN_COUNT; i++) {
+        uint16_t reg = (i < (TEST_PLAN_COUNT / 2)) ? i : (i + TEST_PLAN_GAP);
+        plan_descriptors[i] = (mb_parameter_descriptor_t){i, "plan_reg", "Data", TEST_SLAVE_UID, MB_PARAM_HOLDING,
+                                                            reg, 1, 0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER};
+    }
+    test_network_init();
+    void *slave_handle = test_slave_start();
+    vTaskDelay(pdMS_TO_TICKS(TEST_CONNECT_DELAY_MS));
+    void *master_handle = test_master_start(ip_table, &plan_descriptors[0], TEST_PLAN_COUNT);
+    (void)test_slave_read_count(slave_handle);
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < TEST_PLAN_COUNT; i++) {
+        values[i] = 0;
+        params[i] = (mb_param_poll_t){.cid = i, .value = (uint8_t *)&values[i]};
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_parameters(master_handle, params, TEST_PLAN_COUNT));
+    int64_t time = esp_timer_get_time() - start;
+    for (int i = 0; i < TEST_PLAN_COUNT; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, params[i].error);
+        TEST_ASSERT_EQUAL_HEX16(holding_regs[plan_descriptors[i].mb_reg_start], values[i]);
+    }
+    int requests = test_slave_read_count(slave_handle);
+    ESP_LOGI(TAG, "parameters: %d, requests: %d, %" PRId64 " us/sweep", TEST_PLAN_COUNT, requests, time);
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_delete(master_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+#if CONFIG_FMB_MASTER_READ_PLAN_ENABLE
+    TEST_ASSERT_EQUAL(TEST_PLAN_REQUESTS, requests);
+#endif
+}
+
+TEST_CASE("Test tcp master takes the values from the cache until they expire.", "[MB_TCP_MASTER]")
+{
+    char *ip_table[] = {"01;127.0.0.1;1502", NULL};
+    mb_parameter_descriptor_t cache_descriptors[] = {
+        {0, "cached_reg", "Data", TEST_SLAVE_UID, MB_PARAM_HOLDING, 4, 1,
+            0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER, TEST_CACHE_AGE_MS},
+        {1, "direct_reg", "Data", TEST_SLAVE_UID, MB_PARAM_HOLDING, 8, 1,
+            0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER, 0},
+    };
+    mb_cache_stats_t stats = {0};
+    uint16_t value = 0;
+    uint8_t type = 0;
+
+    test_network_init();
+    void *slave_handle = test_slave_start();
+    vTaskDelay(pdMS_TO_TICKS(TEST_CONNECT_DELAY_MS));
+    void *master_handle = test_master_start(ip_table, &cache_descriptors[0], 2);
+    (void)test_slave_read_count(slave_handle);
+
+    // The first read goes to the slave, the next one is taken from the cache
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_parameter(master_handle, 0, (uint8_t *)&value, &type));
+    TEST_ASSERT_EQUAL_HEX16(holding_regs[4], value);
+    value = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_parameter(master_handle, 0, (uint8_t *)&value, &type));
+    TEST_ASSERT_EQUAL_HEX16(holding_regs[4], value);
+    TEST_ASSERT_EQUAL(PARAM_TYPE_U16, type);
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_cache_stats(master_handle, &stats));
+    TEST_ASSERT_EQUAL(1, stats.hit_count);
+    TEST_ASSERT_EQUAL(1, stats.miss_count);
+    TEST_ASSERT_EQUAL(1, test_slave_read_count(slave_handle));
+
+    // The parameter without max age is always read from the slave
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_parameter(master_handle, 1, (uint8_t *)&value, &type));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_parameter(master_handle, 1, (uint8_t *)&value, &type));
+    TEST_ASSERT_EQUAL(2, test_slave_read_count(slave_handle));
+
+    // The write and explicit invalidation drop the cached value
+    value = 0x5A5A;
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_set_parameter(master_handle, 0, (uint8_t *)&value, &type));
+    value = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_parameter(master_handle, 0, (uint8_t *)&value, &type));
+    TEST_ASSERT_EQUAL_HEX16(0x5A5A, value);
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_invalidate_cache(master_handle, 0));
+    mb_param_poll_t param = {.cid = 0, .value = (uint8_t *)&value};
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_parameters(master_handle, &param, 1));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_parameters(master_handle, &param, 1));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_cache_stats(master_handle, &stats));
+    TEST_ASSERT_EQUAL(2, stats.hit_count);
+    TEST_ASSERT_EQUAL(3, stats.miss_count);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, mbc_master_invalidate_cache(master_handle, 2));
+    ESP_LOGI(TAG, "cache hits: %" PRIu32 ", misses: %" PRIu32, stats.hit_count, stats.miss_count);
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_delete(master_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+}
+
+TEST_CASE("Test tcp master finds the characteristics by sparse cid and key.", "[MB_TCP_MASTER]")
+{
+    char *ip_table[] = {"01;127.0.0.1;1502", NULL};
+    mb_parameter_descriptor_t index_descriptors[] = {
+        {100, "fan_on", "On/Off", TEST_SLAVE_UID, MB_PARAM_HOLDING, 2, 1,
+            0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+        {7, "45", "Data", TEST_SLAVE_UID, MB_PARAM_HOLDING, 5, 1,
+            0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+        {4000, "temp_out", "C", TEST_SLAVE_UID, MB_PARAM_HOLDING, 9, 1,
+            0, PARAM_TYPE_U16, 2, {0}, PAR_PERMS_READ_WRITE_TRIGGER},
+    };
+    const char *keys[] = {"temp_out", "missing", "fan_on", "45"};
+    uint16_t cids[4] = {0};
+    const mb_parameter_descriptor_t *info = NULL;
+    uint16_t value = 0;
+    uint8_t type = 0;
+    uint16_t cid = 0;
+
+    test_network_init();
+    void *slave_handle = test_slave_start();
+    vTaskDelay(pdMS_TO_TICKS(TEST_CONNECT_DELAY_MS));
+    void *master_handle = test_master_start(ip_table, &index_descriptors[0], 3);
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_cid_by_key(master_handle, "45", &cid));
+    TEST_ASSERT_EQUAL(7, cid);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, mbc_master_get_cid_by_key(master_handle, "fan_off", &cid));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, mbc_master_get_cids_by_keys(master_handle, keys, cids, 4));
+    TEST_ASSERT_EQUAL(4000, cids[0]);
+    TEST_ASSERT_EQUAL(MB_PARAM_CID_NONE, cids[1]);
+    TEST_ASSERT_EQUAL(100, cids[2]);
+    TEST_ASSERT_EQUAL(7, cids[3]);
+
+    // The sparse cids address the characteristics without the empty slots in the table
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_cid_info(master_handle, 4000, &info));
+    TEST_ASSERT_EQUAL_STRING("temp_out", info->param_key);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, mbc_master_get_cid_info(master_handle, 2, &info));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_parameter(master_handle, 4000, (uint8_t *)&value, &type));
+    TEST_ASSERT_EQUAL_HEX16(holding_regs[9], value);
+    mb_param_poll_t params[] = {{.cid = 100, .value = (uint8_t *)&value}, {.cid = 8}};
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, mbc_master_get_parameters(master_handle, params, 2));
+    TEST_ASSERT_EQUAL(ESP_OK, params[0].error);
+    TEST_ASSERT_EQUAL_HEX16(holding_regs[2], value);
+
+    // The table with duplicated cid is rejected and the current table is kept
+    mb_parameter_descriptor_t duplicated_descriptors[3];
+    memcpy(duplicated_descriptors, index_descriptors, sizeof(index_descriptors));
+    duplicated_descriptors[2].cid = 7;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, mbc_master_set_descriptor(master_handle, &duplicated_descriptors[0], 3));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_cid_info(master_handle, 4000, &info));
+    TEST_ASSERT_EQUAL_PTR(&index_descriptors[2], info);
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_cid_by_key(master_handle, "temp_out", &cid));
+    TEST_ASSERT_EQUAL(4000, cid);
+    value = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_get_parameter(master_handle, 4000, (uint8_t *)&value, &type));
+    TEST_ASSERT_EQUAL_HEX16(holding_regs[9], value);
+
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_master_delete(master_handle));
+    TEST_ASSERT_EQUAL(ESP_OK, mbc_slave_delete(slave_handle));
+}
+
+#endif
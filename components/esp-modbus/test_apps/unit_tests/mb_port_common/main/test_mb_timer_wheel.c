@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_log.h"
+
+#include "sdkconfig.h"
+#include "mb_timer_wheel.h"
+
+#define TAG "MB_TIMER_WHEEL_TEST"
+
+#define TEST_START_US 123450000ULL
+#define TEST_MAX_WAIT_MS 1000
+#define TEST_PERIOD_US 100000ULL
+#define TEST_PERIOD_COUNT 5
+
+typedef struct {
+    mb_timer_node_t timer;
+    uint64_t expire_us;
+    uint64_t fired_us;
+    int fired_count;
+    int order;
+} test_timer_t;
+
+// The timers fire on the time of the wheel advance
+static uint64_t test_now_us;
+static int test_fired_count;
+
+static void test_timer_cb(mb_timer_node_t *timer, void *arg)
+{
+    test_timer_t *test_timer = (test_timer_t *)arg;
+    test_timer->fired_us = test_now_us;
+    test_timer->fired_count++;
+    test_timer->order = test_fired_count++;
+}
+
+static void test_periodic_cb(mb_timer_node_t *timer, void *arg)
+{
+    mb_timer_wheel_t *wheel = (mb_timer_wheel_t *)arg;
+    test_timer_t *test_timer = __containerof(timer, test_timer_t, timer);
+    test_timer->fired_us = test_now_us;
+    if (++test_timer->fired_count < TEST_PERIOD_COUNT) {
+        test_timer->expire_us += TEST_PERIOD_US;
+        mb_timer_wheel_arm(wheel, timer, test_timer->expire_us);
+    }
+}
+
+// Runs the wheel the way the driver task does, waits for the next expiration and advances the wheel
+static void test_run_until(mb_timer_wheel_t *wheel, uint64_t end_us)
+{
+    while (test_now_us < end_us) {
+        uint32_t wait_ms = mb_timer_wheel_next_ms(wheel, test_now_us, TEST_MAX_WAIT_MS);
+        test_now_us += wait_ms ? (wait_ms * 1000ULL) : 1000ULL;
+        (void)mb_timer_wheel_advance(wheel, test_now_us);
+    }
+}
+
+TEST_CASE("Test timer wheel expires the timers of all levels in order.", "[MB_TIMER_WHEEL]")
+{
+    // The delays cover the level 0, the cascades of the levels 1 - 3 and the clamped timeout
+    const uint64_t delays_us[] = {0, 5000, 10000, 630000, 650000, 655000, 41000000, 50000000,
+                                    3600000000ULL, 2700000ULL, 20000ULL, 1000ULL};
+    const int count = sizeof(delays_us) / sizeof(delays_us[0]);
+    test_timer_t timers[sizeof(delays_us) / sizeof(delays_us[0])] = {0};
+    test_timer_t disarmed = {0};
+    mb_timer_wheel_t wheel;
+
+    test_now_us = TEST_START_US;
+    test_fired_count = 0;
+    mb_timer_wheel_init(&wheel, test_now_us);
+    TEST_ASSERT_EQUAL_UINT32(TEST_MAX_WAIT_MS, mb_timer_wheel_next_ms(&wheel, test_now_us, TEST_MAX_WAIT_MS));
+    for (int i = 0; i < count; i++) {
+        timers[i].expire_us = test_now_us + delays_us[i];
+        mb_timer_node_init(&timers[i].timer, test_timer_cb, &timers[i]);
+        mb_timer_wheel_arm(&wheel, &timers[i].timer, timers[i].expire_us);
+        TEST_ASSERT_TRUE(mb_timer_node_is_armed(&timers[i].timer));
+    }
+    mb_timer_node_init(&disarmed.timer, test_timer_cb, &disarmed);
+    mb_timer_wheel_arm(&wheel, &disarmed.timer, test_now_us + 20000);
+    TEST_ASSERT_EQUAL_UINT32(count + 1, wheel.count);
+    mb_timer_wheel_disarm(&wheel, &disarmed.timer);
+    mb_timer_wheel_disarm(&wheel, &disarmed.timer);
+    TEST_ASSERT_FALSE(mb_timer_node_is_armed(&disarmed.timer));
+    TEST_ASSERT_EQUAL_UINT32(count, wheel.count);
+    // The due timer expires on the next advance
+    TEST_ASSERT_EQUAL_UINT32(0, mb_timer_wheel_next_ms(&wheel, test_now_us, TEST_MAX_WAIT_MS));
+
+    test_run_until(&wheel, TEST_START_US + 3600000000ULL + MB_TIMER_WHEEL_TICK_US);
+    TEST_ASSERT_EQUAL_UINT32(0, wheel.count);
+    TEST_ASSERT_EQUAL(0, disarmed.fired_count);
+    for (int i = 0; i < count; i++) {
+        // Not earlier than the time and not later than one tick after it
+        TEST_ASSERT_EQUAL(1, timers[i].fired_count);
+        TEST_ASSERT_TRUE(timers[i].fired_us >= timers[i].expire_us);
+        TEST_ASSERT_TRUE(timers[i].fired_us < (timers[i].expire_us + MB_TIMER_WHEEL_TICK_US + 1000));
+        for (int j = 0; j < count; j++) {
+            if ((timers[j].expire_us / MB_TIMER_WHEEL_TICK_US) > ((timers[i].expire_us + MB_TIMER_WHEEL_TICK_US - 1) / MB_TIMER_WHEEL_TICK_US)) {
+                TEST_ASSERT_TRUE(timers[i].order < timers[j].order);
+            }
+        }
+    }
+}
+
+TEST_CASE("Test timer wheel moves, clamps and arms the timers from the callback.", "[MB_TIMER_WHEEL]")
+{
+    test_timer_t periodic = {0};
+    test_timer_t moved = {0};
+    test_timer_t far = {0};
+    mb_timer_wheel_t wheel;
+
+    test_now_us = TEST_START_US;
+    test_fired_count = 0;
+    mb_timer_wheel_init(&wheel, test_now_us);
+
+    periodic.expire_us = test_now_us + TEST_PERIOD_US;
+    mb_timer_node_init(&periodic.timer, test_periodic_cb, &wheel);
+    mb_timer_wheel_arm(&wheel, &periodic.timer, periodic.expire_us);
+
+    // The armed timer is moved to the new time
+    mb_timer_node_init(&moved.timer, test_timer_cb, &moved);
+    mb_timer_wheel_arm(&wheel, &moved.timer, test_now_us + 10000000);
+    moved.expire_us = test_now_us + 50000;
+    mb_timer_wheel_arm(&wheel, &moved.timer, moved.expire_us);
+    TEST_ASSERT_EQUAL_UINT32(2, wheel.count);
+    TEST_ASSERT_EQUAL_UINT32(50, mb_timer_wheel_next_ms(&wheel, test_now_us, TEST_MAX_WAIT_MS));
+    TEST_ASSERT_EQUAL_UINT32(20, mb_timer_wheel_next_ms(&wheel, test_now_us, 20));
+
+    test_run_until(&wheel, TEST_START_US + (TEST_PERIOD_US * (TEST_PERIOD_COUNT + 1)));
+    TEST_ASSERT_EQUAL(1, moved.fired_count);
+    TEST_ASSERT_TRUE(moved.fired_us >= moved.expire_us);
+    TEST_ASSERT_TRUE(moved.fired_us < (moved.expire_us + MB_TIMER_WHEEL_TICK_US + 1000));
+    TEST_ASSERT_EQUAL(TEST_PERIOD_COUNT, periodic.fired_count);
+    TEST_ASSERT_TRUE(periodic.fired_us >= periodic.expire_us);
+    TEST_ASSERT_TRUE(periodic.fired_us < (periodic.expire_us + MB_TIMER_WHEEL_TICK_US + 1000));
+    TEST_ASSERT_EQUAL_UINT32(0, wheel.count);
+
+    // The empty wheel jumps over the idle time, the timeout longer than the wheel is clamped
+    test_now_us += 7200000000ULL;
+    TEST_ASSERT_EQUAL_UINT32(0, mb_timer_wheel_advance(&wheel, test_now_us));
+    mb_timer_node_init(&far.timer, test_timer_cb, &far);
+    mb_timer_wheel_arm(&wheel, &far.timer, test_now_us + (MB_TIMER_WHEEL_MAX_TICKS * MB_TIMER_WHEEL_TICK_US * 2));
+    TEST_ASSERT_EQUAL_UINT32(0, mb_timer_wheel_advance(&wheel, test_now_us + (MB_TIMER_WHEEL_MAX_TICKS - 1) * MB_TIMER_WHEEL_TICK_US));
+    TEST_ASSERT_EQUAL_UINT32(1, mb_timer_wheel_advance(&wheel, test_now_us + (MB_TIMER_WHEEL_MAX_TICKS + 1) * MB_TIMER_WHEEL_TICK_US));
+    TEST_ASSERT_EQUAL(1, far.fired_count);
+}
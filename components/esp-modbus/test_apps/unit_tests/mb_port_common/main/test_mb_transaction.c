@@ -0,0 +1,242 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include "unity.h"
+#include "test_utils.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "sdkconfig.h"
+#include "mb_transaction.h"
+#include "port_common.h"
+
+#define TAG "MB_TRANSACTION_TEST"
+
+#define TEST_FRAME_LEN 12
+#define TEST_BENCH_LOOKUPS 10000
+
+static transaction_item_handle_t test_enqueue(transaction_handle_t transaction, uint16_t msg_id, int node_id, transaction_tick_t tick)
+{
+    transaction_message_t msg = {
+        .buffer = calloc(1, TEST_FRAME_LEN),
+        .len = TEST_FRAME_LEN,
+        .msg_id = msg_id,
+        .node_id = node_id,
+        .pnode = NULL
+    };
+    TEST_ASSERT_NOT_NULL(msg.buffer);
+    transaction_item_handle_t item = transaction_enqueue(transaction, &msg, tick);
+    TEST_ASSERT_NOT_NULL(item);
+    return item;
+}
+
+static void test_fill(transaction_handle_t transaction, int count)
+{
+    for (int i = 0; i < count; i++) {
+        test_enqueue(transaction, (uint16_t)i, (i % 4), (transaction_tick_t)i);
+    }
+}
+
+TEST_CASE("Test transaction lookup by TID and state.", "[MB_TRANSACTION]")
+{
+    transaction_handle_t transaction = transaction_init();
+    TEST_ASSERT_NOT_NULL(transaction);
+    test_fill(transaction, 100);
+    TEST_ASSERT_EQUAL_UINT32(100, transaction_get_count(transaction));
+    TEST_ASSERT_EQUAL_UINT64(100 * TEST_FRAME_LEN, transaction_get_size(transaction));
+
+    for (int i = 0; i < 100; i++) {
+        transaction_item_handle_t item = transaction_get(transaction, (uint16_t)i);
+        TEST_ASSERT_NOT_NULL(item);
+        TEST_ASSERT_EQUAL_UINT16(i, transaction_item_get_id(item));
+        TEST_ASSERT_EQUAL(QUEUED, transaction_item_get_state(item));
+    }
+    TEST_ASSERT_NULL(transaction_get(transaction, 1000));
+    TEST_ASSERT_EQUAL_UINT16(0, transaction_item_get_id(transaction_get_first(transaction)));
+
+    // The state lists keep the order in which the items changed state
+    transaction_item_handle_t item_a = transaction_get(transaction, 50);
+    transaction_item_handle_t item_b = transaction_get(transaction, 10);
+    TEST_ASSERT_EQUAL(ESP_OK, transaction_item_set_state(item_a, ACKNOWLEDGED));
+    TEST_ASSERT_EQUAL(ESP_OK, transaction_set_state(transaction, 10, ACKNOWLEDGED));
+    transaction_tick_t tick = 0;
+    TEST_ASSERT_EQUAL_PTR(item_a, transaction_dequeue(transaction, ACKNOWLEDGED, &tick));
+    TEST_ASSERT_EQUAL_UINT64(50, tick);
+    TEST_ASSERT_EQUAL(ESP_OK, transaction_item_set_state(item_a, CONFIRMED));
+    TEST_ASSERT_EQUAL_PTR(item_b, transaction_dequeue(transaction, ACKNOWLEDGED, NULL));
+    TEST_ASSERT_EQUAL_PTR(item_a, transaction_dequeue(transaction, CONFIRMED, NULL));
+    TEST_ASSERT_NULL(transaction_dequeue(transaction, REPLIED, NULL));
+
+    // Delete by handle and by TID removes the item from all indexes
+    TEST_ASSERT_EQUAL(ESP_OK, transaction_delete_item(transaction, item_a));
+    TEST_ASSERT_NULL(transaction_get(transaction, 50));
+    // The item of other transaction is not a member
+    transaction_handle_t other = transaction_init();
+    TEST_ASSERT_NOT_NULL(other);
+    transaction_item_handle_t other_item = test_enqueue(other, 50, 0, 0);
+    TEST_ASSERT_EQUAL(ESP_FAIL, transaction_delete_item(transaction, other_item));
+    TEST_ASSERT_EQUAL(ESP_OK, transaction_delete_item(other, other_item));
+    transaction_destroy(other);
+    TEST_ASSERT_NULL(transaction_dequeue(transaction, CONFIRMED, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, transaction_delete(transaction, 10));
+    TEST_ASSERT_EQUAL(ESP_FAIL, transaction_delete(transaction, 10));
+    // The stale handle of the pool item is not a member
+    TEST_ASSERT_EQUAL(ESP_FAIL, transaction_delete_item(transaction, item_b));
+    TEST_ASSERT_NULL(transaction_dequeue(transaction, ACKNOWLEDGED, NULL));
+    TEST_ASSERT_EQUAL_UINT32(98, transaction_get_count(transaction));
+
+    // Duplicated TIDs from different nodes are resolved in the order of arrival
+    transaction_item_handle_t dup = test_enqueue(transaction, 20, 7, 200);
+    TEST_ASSERT_TRUE(dup != transaction_get(transaction, 20));
+    TEST_ASSERT_EQUAL(ESP_OK, transaction_delete(transaction, 20));
+    TEST_ASSERT_EQUAL_PTR(dup, transaction_get(transaction, 20));
+
+    TEST_ASSERT_EQUAL(25, transaction_delete_by_node_id(transaction, 1));
+    TEST_ASSERT_EQUAL(1, transaction_delete_by_node_id(transaction, 7));
+    TEST_ASSERT_EQUAL_UINT16(0, transaction_delete_single_expired(transaction, 100, 50));
+    TEST_ASSERT_EQUAL(13, transaction_delete_expired(transaction, 100, 80));
+    transaction_delete_all_items(transaction);
+    TEST_ASSERT_EQUAL_UINT32(0, transaction_get_count(transaction));
+    TEST_ASSERT_EQUAL_UINT64(0, transaction_get_size(transaction));
+    TEST_ASSERT_NULL(transaction_get_first(transaction));
+    transaction_destroy(transaction);
+}
+
+TEST_CASE("Test transaction serves the nodes in round-robin order.", "[MB_TRANSACTION]")
+{
+    // Node 0 floods the queue, nodes 1 and 2 have a few requests
+    const int node_ids[] = {0, 0, 0, 0, 1, 0, 2, 1, 0};
+    const int node_order[] = {0, 1, 2, 0, 1, 0, 0, 0, 0};
+    const uint16_t msg_order[] = {0, 4, 6, 1, 7, 2, 3, 5, 8};
+    const int count = sizeof(node_ids) / sizeof(node_ids[0]);
+    transaction_handle_t transaction = transaction_init();
+    TEST_ASSERT_NOT_NULL(transaction);
+    for (int i = 0; i < count; i++) {
+        test_enqueue(transaction, (uint16_t)i, node_ids[i], (transaction_tick_t)i);
+    }
+    TEST_ASSERT_EQUAL_UINT32(6, transaction_get_node_count(transaction, 0));
+    TEST_ASSERT_EQUAL_UINT32(2, transaction_get_node_count(transaction, 1));
+    TEST_ASSERT_EQUAL_UINT32(0, transaction_get_node_count(transaction, 3));
+
+    int last_node_id = -1;
+    for (int i = 0; i < count; i++) {
+        transaction_item_handle_t item = transaction_dequeue_next_node(transaction, QUEUED, last_node_id);
+        TEST_ASSERT_NOT_NULL(item);
+        TEST_ASSERT_EQUAL_UINT16(msg_order[i], transaction_item_get_id(item));
+        (void)transaction_item_get_data(item, NULL, NULL, &last_node_id);
+        TEST_ASSERT_EQUAL(node_order[i], last_node_id);
+        TEST_ASSERT_EQUAL(ESP_OK, transaction_item_set_state(item, ACKNOWLEDGED));
+        TEST_ASSERT_EQUAL(ESP_OK, transaction_delete_item(transaction, item));
+    }
+    TEST_ASSERT_NULL(transaction_dequeue_next_node(transaction, QUEUED, last_node_id));
+    // The node counters follow the deleted items
+    TEST_ASSERT_EQUAL_UINT32(0, transaction_get_node_count(transaction, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, transaction_get_node_count(transaction, 1));
+    test_enqueue(transaction, 100, 20, 0);
+    TEST_ASSERT_EQUAL_UINT32(1, transaction_get_node_count(transaction, 20));
+    TEST_ASSERT_EQUAL(1, transaction_delete_by_node_id(transaction, 20));
+    TEST_ASSERT_EQUAL_UINT32(0, transaction_get_node_count(transaction, 20));
+    transaction_destroy(transaction);
+}
+
+TEST_CASE("Test transaction lookup cost for 10, 100, 1000 items.", "[MB_TRANSACTION][BENCHMARK]")
+{
+    const int counts[] = {10, 100, 1000};
+    for (int i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); i++) {
+        transaction_handle_t transaction = transaction_init();
+        TEST_ASSERT_NOT_NULL(transaction);
+        test_fill(transaction, counts[i]);
+        int64_t start = esp_timer_get_time();
+        for (int j = 0; j < TEST_BENCH_LOOKUPS; j++) {
+            uint16_t msg_id = (uint16_t)((j * 7) % counts[i]);
+            transaction_item_handle_t item = transaction_get(transaction, msg_id);
+            TEST_ASSERT_EQUAL(ESP_OK, transaction_item_set_state(item, (j & 1) ? CONFIRMED : ACKNOWLEDGED));
+        }
+        int64_t lookup_time = esp_timer_get_time() - start;
+        start = esp_timer_get_time();
+        for (int j = 0; j < counts[i]; j++) {
+            TEST_ASSERT_EQUAL(ESP_OK, transaction_delete(transaction, (uint16_t)j));
+        }
+        int64_t delete_time = esp_timer_get_time() - start;
+        ESP_LOGI(TAG, "items: %d, get + set state: %" PRId64 " ns/op, delete: %" PRId64 " ns/op",
+                    counts[i], (lookup_time * 1000) / TEST_BENCH_LOOKUPS, (delete_time * 1000) / counts[i]);
+        TEST_ASSERT_EQUAL_UINT32(0, transaction_get_count(transaction));
+        transaction_destroy(transaction);
+    }
+}
+
+TEST_CASE("Test transaction passes the frame ownership without copy.", "[MB_TRANSACTION]")
+{
+    transaction_handle_t transaction = transaction_init();
+    TEST_ASSERT_NOT_NULL(transaction);
+    uint8_t *frame = mb_port_frame_alloc(CONFIG_FMB_BUFFER_SIZE);
+    TEST_ASSERT_NOT_NULL(frame);
+    transaction_message_t msg = {
+        .buffer = frame,
+        .len = TEST_FRAME_LEN,
+        .msg_id = 1,
+        .node_id = 0,
+        .pnode = NULL
+    };
+    transaction_item_handle_t item = transaction_enqueue(transaction, &msg, 0);
+    TEST_ASSERT_NOT_NULL(item);
+
+    // The buffer taken from the item is the same buffer read from socket
+    size_t len = 0;
+    TEST_ASSERT_EQUAL_PTR(frame, transaction_item_take_data(item, &len));
+    TEST_ASSERT_EQUAL(TEST_FRAME_LEN, len);
+    TEST_ASSERT_NULL(transaction_item_take_data(item, NULL));
+    TEST_ASSERT_NULL(transaction_item_get_data(item, NULL, NULL, NULL));
+
+    // The item does not release the detached buffer on delete
+    TEST_ASSERT_EQUAL(ESP_OK, transaction_delete(transaction, 1));
+    memset(frame, 0xA5, CONFIG_FMB_BUFFER_SIZE);
+    mb_port_frame_free(frame);
+    transaction_destroy(transaction);
+}
+
+TEST_CASE("Test transaction items expire on the timer wheel.", "[MB_TRANSACTION]")
+{
+    const transaction_tick_t timeout = 1000000;
+    const transaction_tick_t start = 5000000;
+    mb_timer_wheel_t wheel;
+    mb_timer_wheel_init(&wheel, start);
+    transaction_handle_t transaction = transaction_init();
+    TEST_ASSERT_NOT_NULL(transaction);
+
+    // The items queued before the wheel is set are armed as well
+    test_enqueue(transaction, 1, 0, start);
+    transaction_set_timer_wheel(transaction, &wheel, timeout);
+    test_enqueue(transaction, 2, 1, start + 300000);
+    test_enqueue(transaction, 3, 2, start + 600000);
+    TEST_ASSERT_EQUAL(ESP_OK, transaction_set_tick(transaction, 3, start + 900000));
+    TEST_ASSERT_EQUAL_UINT32(3, wheel.count);
+
+    // The deleted item is disarmed
+    TEST_ASSERT_EQUAL(ESP_OK, transaction_delete(transaction, 2));
+    TEST_ASSERT_EQUAL_UINT32(2, wheel.count);
+
+    TEST_ASSERT_EQUAL_UINT32(0, mb_timer_wheel_advance(&wheel, start + timeout - 1));
+    TEST_ASSERT_EQUAL_UINT32(1, mb_timer_wheel_advance(&wheel, start + timeout));
+    TEST_ASSERT_NULL(transaction_get(transaction, 1));
+    TEST_ASSERT_NOT_NULL(transaction_get(transaction, 3));
+
+    // The tick of the item moves its expiration
+    TEST_ASSERT_EQUAL_UINT32(0, mb_timer_wheel_advance(&wheel, start + 600000 + timeout));
+    TEST_ASSERT_EQUAL_UINT32(1, mb_timer_wheel_advance(&wheel, start + 900000 + timeout));
+    TEST_ASSERT_EQUAL_UINT32(0, transaction_get_count(transaction));
+    TEST_ASSERT_EQUAL_UINT32(0, wheel.count);
+
+    // The NULL wheel disarms the queued items
+    test_enqueue(transaction, 4, 0, start + 2 * timeout);
+    TEST_ASSERT_EQUAL_UINT32(1, wheel.count);
+    transaction_set_timer_wheel(transaction, NULL, 0);
+    TEST_ASSERT_EQUAL_UINT32(0, wheel.count);
+    TEST_ASSERT_EQUAL_UINT32(0, mb_timer_wheel_advance(&wheel, start + 4 * timeout));
+    TEST_ASSERT_EQUAL_UINT32(1, transaction_get_count(transaction));
+    transaction_destroy(transaction);
+}
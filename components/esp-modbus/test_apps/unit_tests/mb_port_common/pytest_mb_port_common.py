@@ -0,0 +1,12 @@
+# SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: CC0-1.0
+
+import pytest
+from pytest_embedded import Dut
+
+
+@pytest.mark.parametrize('target', ['esp32'], indirect=True)
+@pytest.mark.parametrize('config', ['default', 'slave_tracking', 'slave_cache', 'crc_table', 'crc_slice8'], indirect=True)
+@pytest.mark.multi_dut_modbus_generic
+def test_mb_port_common(dut: Dut) -> None:
+    dut.run_all_single_board_cases()
@@ -39,6 +39,9 @@ esp_err_t web_server_register_api_handler(const char* uri, httpd_method_t method
 // 静态文件服务
 esp_err_t web_server_register_static_handler(const char* base_path, const char* root_path);
 
+// Modbus统计: 设置提供 /api/modbus/stats 数据的Modbus控制器句柄, NULL表示取消
+esp_err_t web_server_set_modbus_handle(void* mb_handle);
+
 // 工具函数
 char* web_server_get_query_param(httpd_req_t* req, const char* param_name);
 esp_err_t web_server_send_json_response(httpd_req_t* req, int status_code, const char* json_data);
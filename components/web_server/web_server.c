@@ -8,9 +8,11 @@
 #include "esp_spiffs.h"
 #include "esp_http_server.h"
 #include "cJSON.h"
+#include "esp_modbus_common.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "include/web_server.h"
+#include <sys/lock.h>
 
 static const char *TAG = "WEB_SERVER";
 
@@ -18,6 +20,10 @@ static const char *TAG = "WEB_SERVER";
 static httpd_handle_t server_handle = NULL;
 static web_server_config_t server_config;
 
+// Modbus控制器句柄, 控制器删除前必须先清除, 锁保证请求处理期间句柄有效
+static void *modbus_handle = NULL;
+static _lock_t modbus_handle_lock;
+
 /**
  * 根路径处理器 - 提供HTML页面
  */
@@ -144,6 +150,91 @@ static esp_err_t api_led_control_handler(httpd_req_t *req) {
     return ESP_OK;
 }
 
+/**
+ * Modbus统计项转换为JSON对象
+ */
+static cJSON *modbus_stats_to_json(const mb_stats_info_t *info, const char *key_name) {
+    cJSON *item = cJSON_CreateObject();
+    if (key_name) {
+        cJSON_AddNumberToObject(item, key_name, info->key);
+    }
+    cJSON_AddNumberToObject(item, "requests", info->requests);
+    cJSON_AddNumberToObject(item, "exceptions", info->exceptions);
+    cJSON_AddNumberToObject(item, "timeouts", info->timeouts);
+    cJSON_AddNumberToObject(item, "frame_errors", info->frame_errors);
+    cJSON_AddNumberToObject(item, "bytes_in", info->bytes_in);
+    cJSON_AddNumberToObject(item, "bytes_out", info->bytes_out);
+    cJSON *latency = cJSON_AddObjectToObject(item, "latency_us");
+    cJSON_AddNumberToObject(latency, "count", info->latency_count);
+    cJSON_AddNumberToObject(latency, "p50", info->latency_p50_us);
+    cJSON_AddNumberToObject(latency, "p95", info->latency_p95_us);
+    cJSON_AddNumberToObject(latency, "p99", info->latency_p99_us);
+    cJSON_AddNumberToObject(latency, "max", info->latency_max_us);
+    return item;
+}
+
+/**
+ * 读取一组Modbus统计, 调用者持有句柄锁
+ */
+static esp_err_t modbus_stats_add_group(cJSON *array, mb_stats_group_t group, const char *key_name) {
+    uint16_t count = 0;
+    esp_err_t ret = mbc_get_stats(modbus_handle, group, NULL, 0, &count);
+    if ((ret != ESP_OK) || !count) {
+        return ret;
+    }
+    mb_stats_info_t *info = calloc(count, sizeof(mb_stats_info_t));
+    if (info == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    // 读取期间可能出现新的条目, 只输出数组能容纳的部分
+    uint16_t size = count;
+    ret = mbc_get_stats(modbus_handle, group, info, size, &count);
+    for (int i = 0; (ret == ESP_OK) && (i < MIN(count, size)); i++) {
+        cJSON_AddItemToArray(array, modbus_stats_to_json(&info[i], key_name));
+    }
+    free(info);
+    return ret;
+}
+
+/**
+ * Modbus统计API
+ */
+static esp_err_t api_modbus_stats_handler(httpd_req_t *req) {
+    cJSON *root = cJSON_CreateObject();
+    mb_stats_info_t total = {0};
+    uint16_t count = 0;
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+
+    _lock_acquire(&modbus_handle_lock);
+    if (modbus_handle != NULL) {
+        ret = mbc_get_stats(modbus_handle, MB_STATS_TOTAL, &total, 1, &count);
+        if (ret == ESP_OK) {
+            cJSON_AddItemToObject(root, "total", modbus_stats_to_json(&total, NULL));
+            ret = modbus_stats_add_group(cJSON_AddArrayToObject(root, "nodes"), MB_STATS_NODE, "uid");
+        }
+        if (ret == ESP_OK) {
+            ret = modbus_stats_add_group(cJSON_AddArrayToObject(root, "functions"), MB_STATS_FUNC, "func");
+        }
+    }
+    _lock_release(&modbus_handle_lock);
+
+    if (ret != ESP_OK) {
+        cJSON_Delete(root);
+        ESP_LOGW(TAG, "Modbus统计不可用: %s", esp_err_to_name(ret));
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Modbus statistics are not available");
+        return ESP_OK;
+    }
+
+    char *json_str = cJSON_Print(root);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json_str, strlen(json_str));
+
+    cJSON_Delete(root);
+    free(json_str);
+
+    return ESP_OK;
+}
+
 /**
  * 文件上传处理器
  */
@@ -288,6 +379,13 @@ static const httpd_uri_t uri_handlers[] = {
         .handler   = api_led_control_handler,
         .user_ctx  = NULL
     },
+    // Modbus统计
+    {
+        .uri       = "/api/modbus/stats",
+        .method    = HTTP_GET,
+        .handler   = api_modbus_stats_handler,
+        .user_ctx  = NULL
+    },
     // 文件上传
     {
         .uri       = "/api/upload",
@@ -383,6 +481,16 @@ esp_err_t web_server_stop(void) {
     return ret;
 }
 
+/**
+ * 设置Modbus控制器句柄
+ */
+esp_err_t web_server_set_modbus_handle(void* mb_handle) {
+    _lock_acquire(&modbus_handle_lock);
+    modbus_handle = mb_handle;
+    _lock_release(&modbus_handle_lock);
+    return ESP_OK;
+}
+
 /**
  * 获取查询参数
  */
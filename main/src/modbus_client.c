@@ -5,6 +5,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "mbcontroller.h"
+#include "web_server.h"
 
 static const char *TAG = "MODBUS_MINIMAL";
 
@@ -15,7 +16,56 @@ static const char *TAG = "MODBUS_MINIMAL";
 
 const static char *ip_table[2] = {"1;10.101.69.42;502",NULL};
 
-void read_modbus_registers(void) {
+// 主站启动需要参数表, 这里只描述读取的起始寄存器
+static const mb_parameter_descriptor_t device_parameters[] = {
+    { 0, "Reg800", "", 1, MB_PARAM_HOLDING, START_REG, 1,
+        0, PARAM_TYPE_U16, 2, { 0 }, PAR_PERMS_READ },
+};
+
+static void *modbus_master_start(mb_communication_info_t *comm) {
+    void *master = NULL;
+    esp_err_t ret = mbc_master_create_tcp(comm, &master);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Modbus TCP创建失败: %d", ret);
+        return NULL;
+    }
+    ret = mbc_master_set_descriptor(master, &device_parameters[0],
+                                    (sizeof(device_parameters) / sizeof(device_parameters[0])));
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Modbus参数表设置失败: %d", ret);
+        mbc_master_delete(master);
+        return NULL;
+    }
+    ret = mbc_master_start(master);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Modbus启动失败: %d", ret);
+        mbc_master_delete(master);
+        return NULL;
+    }
+    return master;
+}
+
+static void read_modbus_registers(void *master) {
+    uint16_t buffer[NUM_REGS];
+    mb_param_request_t req = {
+        .slave_addr = 1,
+        .command = 0x03, // 读取保持寄存器
+        .reg_start = START_REG,
+        .reg_size = NUM_REGS
+    };
+     ESP_LOGI(TAG, "开始读取Modbus寄存器...");
+    esp_err_t ret = mbc_master_send_request(master, &req, buffer);
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "读取成功:");
+        for (int i = 0; i < NUM_REGS; i++) {
+            printf("Reg %d: %d\n", START_REG + i, buffer[i]);
+        }
+    }else {
+        ESP_LOGE(TAG, "读取寄存器失败: %d", ret);
+    }
+}
+
+void modbus_tcp_client_task(void *param) {
     ESP_LOGI(TAG, "启动Modbus...");
     
     // 配置TCP地址
@@ -32,43 +82,21 @@ void read_modbus_registers(void) {
         .tcp_opts.uid = 1,
     };
     
+    // 主站启动后在任务中一直保留, 统计数据才能跨周期累计
     void *master = NULL;
-    esp_err_t ret = mbc_master_create_tcp(&comm, &master);
-    
-    if (ret == ESP_OK) {
-        ret = mbc_master_start(master);
-        if (ret == ESP_OK) {
-            uint16_t buffer[NUM_REGS];
-            mb_param_request_t req = {
-                .slave_addr = 1,
-                .command = 0x03, // 读取保持寄存器
-                .reg_start = START_REG,
-                .reg_size = NUM_REGS
-            };
-             ESP_LOGI(TAG, "开始读取Modbus寄存器...");
-            ret = mbc_master_send_request(master, &req, buffer);
-            if (ret == ESP_OK) {
-                ESP_LOGI(TAG, "读取成功:");
-                for (int i = 0; i < NUM_REGS; i++) {
-                    printf("Reg %d: %d\n", START_REG + i, buffer[i]);
-                }
-            }else {
-                ESP_LOGE(TAG, "读取寄存器失败: %d", ret);
-            }
-        }else {
-            ESP_LOGE(TAG, "Modbus启动失败: %d", ret);
-        }
-        mbc_master_stop(master);
-        mbc_master_delete(master);
-    }else {
-        ESP_LOGE(TAG, "Modbus TCP创建失败: %d", ret);
-    }
-}
 
-void modbus_tcp_client_task(void *param) {
-    // 或者周期性读取
+    // 周期性读取, 创建或启动失败时下个周期重试
     while(1) {
-        read_modbus_registers();
+        if (master == NULL) {
+            master = modbus_master_start(&comm);
+            if (master != NULL) {
+                // 统计通过 /api/modbus/stats 提供
+                web_server_set_modbus_handle(master);
+            }
+        }
+        if (master != NULL) {
+            read_modbus_registers(master);
+        }
         vTaskDelay(pdMS_TO_TICKS(10000)); // 10秒间隔
     }
-}
\ No newline at end of file
+}